@@ -11,6 +11,8 @@
 
 #include <assert.h>
 
+#include <QDateTime>
+#include <QDir>
 #include <QProcess>
 #include <QSharedMemory>
 #include <QThread>
@@ -52,7 +54,9 @@ AssignmentClient::AssignmentClient(Assignment::Type requestAssignmentType, QStri
 {
     LogUtils::init();
 
-    DependencyManager::set<tracing::Tracer>();
+    auto tracer = DependencyManager::set<tracing::Tracer>();
+    // keep the last few seconds of trace events around, to be dumped when the monitor asks for them
+    tracer->startFlightRecorder();
     DependencyManager::set<StatTracker>();
     DependencyManager::set<AccountManager>();
 
@@ -129,6 +133,7 @@ AssignmentClient::AssignmentClient(Assignment::Type requestAssignmentType, QStri
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
     packetReceiver.registerListener(PacketType::CreateAssignment, this, "handleCreateAssignmentPacket");
     packetReceiver.registerListener(PacketType::StopNode, this, "handleStopNodePacket");
+    packetReceiver.registerListener(PacketType::TraceDumpRequest, this, "handleTraceDumpRequestPacket");
 }
 
 void AssignmentClient::stopAssignmentClient() {
@@ -282,6 +287,24 @@ void AssignmentClient::handleStopNodePacket(QSharedPointer<ReceivedMessage> mess
     }
 }
 
+void AssignmentClient::handleTraceDumpRequestPacket(QSharedPointer<ReceivedMessage> message) {
+    const HifiSockAddr& senderSockAddr = message->getSenderSockAddr();
+
+    if (senderSockAddr.getAddress() == QHostAddress::LocalHost ||
+        senderSockAddr.getAddress() == QHostAddress::LocalHostIPv6) {
+
+        // the packet holds the directory to dump into
+        QDir directory(QString::fromUtf8(message->readAll()));
+        QString filename = QString("trace-%1-%2.json.gz").arg(QCoreApplication::applicationPid())
+            .arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss"));
+
+        qCDebug(assignment_client) << "AssignmentClientMonitor at" << senderSockAddr << "requested a trace dump to" << directory.absolutePath();
+        DependencyManager::get<tracing::Tracer>()->dumpFlightRecorder(directory.absoluteFilePath(filename));
+    } else {
+        qCWarning(assignment_client) << "Got a trace dump request from other than localhost.";
+    }
+}
+
 void AssignmentClient::handleAuthenticationRequest() {
     const QString DATA_SERVER_USERNAME_ENV = "HIFI_AC_USERNAME";
     const QString DATA_SERVER_PASSWORD_ENV = "HIFI_AC_PASSWORD";
@@ -41,6 +41,7 @@ public slots:
 private slots:
     void handleCreateAssignmentPacket(QSharedPointer<ReceivedMessage> message);
     void handleStopNodePacket(QSharedPointer<ReceivedMessage> message);
+    void handleTraceDumpRequestPacket(QSharedPointer<ReceivedMessage> message);
 
 private:
     void setUpStatusToMonitor();
@@ -23,6 +23,8 @@
 #include "AssignmentClientApp.h"
 #include "AssignmentClientChildData.h"
 #include "SharedUtil.h"
+#include <UUID.h>
+#include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
 
 const QString ASSIGNMENT_CLIENT_MONITOR_TARGET_NAME = "assignment-client-monitor";
@@ -355,6 +357,30 @@ bool AssignmentClientMonitor::handleHTTPRequest(HTTPConnection* connection, cons
 
         QJsonDocument document { status };
 
+        connection->respond(HTTPConnection::StatusCode200, document.toJson());
+    } else if (url.path() == "/trace") {
+        // ask every child to dump its trace flight recorder next to its logs, they write them in the background
+        QDir traceDirectory = _wantsChildFileLogging ? _logDirectory : QDir(QDir::tempPath());
+        QByteArray directoryPath = traceDirectory.absolutePath().toUtf8();
+
+        auto nodeList = DependencyManager::get<NodeList>();
+        QJsonArray children;
+        nodeList->eachNode([&](const SharedNodePointer& node) {
+            node->activateLocalSocket();
+
+            auto dumpPacket = NLPacket::create(PacketType::TraceDumpRequest, directoryPath.size());
+            dumpPacket->write(directoryPath);
+            nodeList->sendPacket(std::move(dumpPacket), *node);
+
+            children.append(uuidStringWithoutCurlyBraces(node->getUUID()));
+        });
+
+        QJsonObject trace;
+        trace["directory"] = traceDirectory.absolutePath();
+        trace["children"] = children;
+
+        QJsonDocument document { trace };
+
         connection->respond(HTTPConnection::StatusCode200, document.toJson());
     } else {
         connection->respond(HTTPConnection::StatusCode404);
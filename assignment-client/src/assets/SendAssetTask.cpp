@@ -11,7 +11,9 @@
 
 #include "SendAssetTask.h"
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 #include <QFile>
 
@@ -26,6 +28,23 @@
 #include "ByteRange.h"
 #include "ClientServerUtils.h"
 
+static const qint64 FILE_READ_CHUNK_SIZE = 64 * 1024;
+
+// copies size bytes from the current position in file straight into the packet list a chunk at a time,
+// rather than reading the whole range into memory first
+static void writeFromFile(QFile& file, NLPacketList& packetList, qint64 size) {
+    std::vector<char> chunk(std::min(size, FILE_READ_CHUNK_SIZE));
+
+    while (size > 0) {
+        auto bytesRead = file.read(chunk.data(), std::min(size, (qint64)chunk.size()));
+        if (bytesRead <= 0) {
+            break;
+        }
+        packetList.write(chunk.data(), bytesRead);
+        size -= bytesRead;
+    }
+}
+
 SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir) :
     QRunnable(),
     _message(message),
@@ -88,7 +107,7 @@ void SendAssetTask::run() {
                     file.seek(byteRange.fromInclusive);
                     replyPacketList->writePrimitive(AssetServerError::NoError);
                     replyPacketList->writePrimitive(size);
-                    replyPacketList->write(file.read(size));
+                    writeFromFile(file, *replyPacketList, size);
                 } else {
                     // this range is negative, at least the first part of the read will be back into the end of the file
 
@@ -99,7 +118,7 @@ void SendAssetTask::run() {
                     replyPacketList->writePrimitive(size);
 
                     // first write everything from the negative range to the end of the file
-                    replyPacketList->write(file.read(size));
+                    writeFromFile(file, *replyPacketList, size);
                 }
 
                 qCDebug(networking) << "Sending asset: " << hexHash;
@@ -11,7 +11,7 @@
 
 #include "UploadAssetTask.h"
 
-#include <QtCore/QBuffer>
+#include <QtCore/QCryptographicHash>
 #include <QtCore/QFile>
 
 #include <AssetUtils.h>
@@ -32,16 +32,11 @@ UploadAssetTask::UploadAssetTask(QSharedPointer<ReceivedMessage> receivedMessage
 }
 
 void UploadAssetTask::run() {
-    auto data = _receivedMessage->getMessage();
-    
-    QBuffer buffer { &data };
-    buffer.open(QIODevice::ReadOnly);
-    
     MessageID messageID;
-    buffer.read(reinterpret_cast<char*>(&messageID), sizeof(messageID));
+    _receivedMessage->readPrimitive(&messageID);
     
     uint64_t fileSize;
-    buffer.read(reinterpret_cast<char*>(&fileSize), sizeof(fileSize));
+    _receivedMessage->readPrimitive(&fileSize);
     
     qDebug() << "UploadAssetTask reading a file of " << fileSize << "bytes from"
         << uuidStringWithoutCurlyBraces(_senderNode->getUUID());
@@ -52,9 +47,14 @@ void UploadAssetTask::run() {
     if (fileSize > _filesizeLimit) {
         replyPacket->writePrimitive(AssetServerError::AssetTooLarge);
     } else {
-        QByteArray fileData = buffer.read(fileSize);
+        // stream the file out of the packets it arrived in rather than flattening the message
+        auto fileData = _receivedMessage->readViews(fileSize);
         
-        auto hash = hashData(fileData);
+        QCryptographicHash hasher { QCryptographicHash::Sha256 };
+        for (const auto& view : fileData) {
+            hasher.addData(view);
+        }
+        auto hash = hasher.result();
         auto hexHash = hash.toHex();
         
         qDebug() << "Hash for uploaded file from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID())
@@ -80,7 +80,18 @@ void UploadAssetTask::run() {
         }
 
         if (!existingCorrectFile) {
-            if (file.open(QIODevice::WriteOnly) && file.write(fileData) == qint64(fileSize)) {
+            qint64 bytesWritten = 0;
+            if (file.open(QIODevice::WriteOnly)) {
+                for (const auto& view : fileData) {
+                    auto written = file.write(view);
+                    if (written != view.size()) {
+                        break;
+                    }
+                    bytesWritten += written;
+                }
+            }
+
+            if (bytesWritten == qint64(fileSize)) {
                 qDebug() << "Wrote file" << hexHash << "to disk. Upload complete";
                 file.close();
 
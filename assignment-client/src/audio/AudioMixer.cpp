@@ -21,6 +21,9 @@
 #include <NodeList.h>
 #include <Node.h>
 #include <OctreeConstants.h>
+#include <ResourceCache.h>
+#include <ResourceManager.h>
+#include <SoundCache.h>
 #include <plugins/PluginManager.h>
 #include <plugins/CodecPlugin.h>
 #include <udt/PacketHeaders.h>
@@ -32,7 +35,9 @@
 #include "AudioHelpers.h"
 #include "AudioRingBuffer.h"
 #include "AudioMixerClientData.h"
+#include "AudioMixerSoundCache.h"
 #include "AvatarAudioStream.h"
+#include "CachedSoundStream.h"
 #include "InjectedAudioStream.h"
 
 #include "AudioMixer.h"
@@ -70,6 +75,12 @@ AudioMixer::AudioMixer(ReceivedMessage& message) :
             _availableCodecs[codec->getName()] = codec;
         });
 
+    // injectors can ask us to play sounds out of our own cache, see CachedSoundStream
+    DependencyManager::set<ResourceManager>();
+    DependencyManager::set<ResourceCacheSharedItems>();
+    DependencyManager::set<SoundCache>();
+    DependencyManager::set<AudioMixerSoundCache>();
+
     auto nodeList = DependencyManager::get<NodeList>();
     auto& packetReceiver = nodeList->getPacketReceiver();
 
@@ -78,6 +89,7 @@ AudioMixer::AudioMixer(ReceivedMessage& message) :
             PacketType::MicrophoneAudioNoEcho,
             PacketType::MicrophoneAudioWithEcho,
             PacketType::InjectAudio,
+            PacketType::InjectCachedSound,
             PacketType::AudioStreamStats,
             PacketType::SilentAudioFrame,
             PacketType::NegotiateAudioFormat,
@@ -261,6 +273,8 @@ void AudioMixer::sendStatsPacket() {
         return;
     }
 
+    float statsSeconds = _numStatFrames * AudioConstants::NETWORK_FRAME_SECS;
+
     // general stats
     statsObject["useDynamicJitterBuffers"] = _numStaticJitterFrames == DISABLE_STATIC_JITTER_FRAMES;
 
@@ -295,6 +309,8 @@ void AudioMixer::sendStatsPacket() {
 
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     timingStats["ns_per_mix"] = (_stats.totalMixes > 0) ?  (float)(_stats.mixTime / _stats.totalMixes) : 0;
+    // limiting, encoding and sending, once per listener
+    timingStats["ns_per_post_mix"] = (_stats.sumListeners > 0) ?  (float)(_stats.postMixTime / _stats.sumListeners) : 0;
 #endif
 
     // call it "avg_..." to keep it higher in the display, sorted alphabetically
@@ -321,6 +337,9 @@ void AudioMixer::sendStatsPacket() {
     auto nodeList = DependencyManager::get<NodeList>();
     QJsonObject listenerStats;
 
+    int numCachedInjectors = 0;
+    qint64 cachedInjectorsSavedBytes = 0;
+
     nodeList->eachNode([&](const SharedNodePointer& node) {
         AudioMixerClientData* clientData = static_cast<AudioMixerClientData*>(node->getLinkedData());
         if (clientData) {
@@ -332,6 +351,27 @@ void AudioMixer::sendStatsPacket() {
 
             nodeStats["jitter"] = clientData->getAudioStreamStats();
 
+            // what each injector playing out of our sound cache would have streamed to us, minus its control packets
+            QJsonObject injectorStats;
+            for (auto& streamPair : clientData->getAudioStreams()) {
+                auto cachedSoundStream = dynamic_cast<CachedSoundStream*>(streamPair.second.get());
+                if (cachedSoundStream) {
+                    qint64 savedBytes = (qint64)cachedSoundStream->takeRenderedFrames() * cachedSoundStream->getStreamedFrameBytes()
+                        - cachedSoundStream->takeControlBytesReceived();
+
+                    QJsonObject cachedInjectorStats;
+                    cachedInjectorStats["sound"] = cachedSoundStream->getSound()->getURL().toDisplayString();
+                    cachedInjectorStats["saved_kbps"] = (savedBytes * 8) / (statsSeconds * 1000.0f);
+                    injectorStats[uuidStringWithoutCurlyBraces(streamPair.first)] = cachedInjectorStats;
+
+                    ++numCachedInjectors;
+                    cachedInjectorsSavedBytes += savedBytes;
+                }
+            }
+            if (!injectorStats.isEmpty()) {
+                nodeStats["cached_injectors"] = injectorStats;
+            }
+
             listenerStats[uuidString] = nodeStats;
         }
     });
@@ -339,6 +379,15 @@ void AudioMixer::sendStatsPacket() {
     // add the listeners object to the root object
     statsObject["z_listeners"] = listenerStats;
 
+    // cached sound injection stats
+    QJsonObject cachedSoundStats;
+    auto soundCacheStats = DependencyManager::get<AudioMixerSoundCache>()->getStats();
+    cachedSoundStats["sounds"] = soundCacheStats.numSounds;
+    cachedSoundStats["cache_bytes"] = soundCacheStats.numBytes;
+    cachedSoundStats["injectors"] = numCachedInjectors;
+    cachedSoundStats["saved_kbps"] = (cachedInjectorsSavedBytes * 8) / (statsSeconds * 1000.0f);
+    statsObject["cached_sound_stats"] = cachedSoundStats;
+
     // send off the stats packets
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject);
 }
@@ -355,6 +404,14 @@ void AudioMixer::run() {
     ThreadedAssignment::commonInit(AUDIO_MIXER_LOGGING_TARGET_NAME, NodeType::AudioMixer);
 }
 
+void AudioMixer::aboutToFinish() {
+    DependencyManager::get<ResourceManager>()->cleanup();
+
+    DependencyManager::destroy<AudioMixerSoundCache>();
+    DependencyManager::destroy<ResourceCacheSharedItems>();
+    DependencyManager::destroy<SoundCache>();
+}
+
 AudioMixerClientData* AudioMixer::getOrCreateClientData(Node* node) {
     auto clientData = dynamic_cast<AudioMixerClientData*>(node->getLinkedData());
 
@@ -373,7 +430,8 @@ void AudioMixer::start() {
     // prepare the NodeList
     nodeList->addSetOfNodeTypesToNodeInterestSet({
         NodeType::Agent, NodeType::EntityScriptServer,
-        NodeType::UpstreamAudioMixer, NodeType::DownstreamAudioMixer
+        NodeType::UpstreamAudioMixer, NodeType::DownstreamAudioMixer,
+        NodeType::AssetServer // for the ATP sounds of cached injectors
     });
     nodeList->linkedDataCreateCallback = [&](Node* node) { getOrCreateClientData(node); };
 
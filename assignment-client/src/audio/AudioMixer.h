@@ -32,6 +32,8 @@ class AudioMixer : public ThreadedAssignment {
 public:
     AudioMixer(ReceivedMessage& message);
 
+    void aboutToFinish() override;
+
     struct ZoneSettings {
         QString source;
         QString listener;
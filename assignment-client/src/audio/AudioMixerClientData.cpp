@@ -9,6 +9,7 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <random>
 
 #include <QtCore/QDebug>
@@ -22,6 +23,7 @@
 #include "AudioHelpers.h"
 #include "AudioMixer.h"
 #include "AudioMixerClientData.h"
+#include "CachedSoundStream.h"
 
 
 AudioMixerClientData::AudioMixerClientData(const QUuid& nodeID) :
@@ -86,6 +88,15 @@ void AudioMixerClientData::processPackets() {
 
                 break;
             }
+            case PacketType::InjectCachedSound: {
+                // interface clients and scripts may ask, parseCachedSoundInjection() only fetches from the asset server
+                if (node->getType() == NodeType::Agent || node->getType() == NodeType::EntityScriptServer) {
+                    QMutexLocker lock(&getMutex());
+                    parseData(*packet);
+                }
+
+                break;
+            }
             case PacketType::NegotiateAudioFormat:
                 negotiateAudioFormat(*packet, node);
                 break;
@@ -248,6 +259,9 @@ int AudioMixerClientData::parseData(ReceivedMessage& message) {
 
         return message.getPosition();
 
+    } else if (packetType == PacketType::InjectCachedSound) {
+        return parseCachedSoundInjection(message);
+
     } else {
         SharedStreamPointer matchingStream;
 
@@ -348,6 +362,62 @@ int AudioMixerClientData::parseData(ReceivedMessage& message) {
     return 0;
 }
 
+// how many sounds one node can have us play out of the cache at once
+static const int MAX_CACHED_SOUND_STREAMS_PER_NODE = 64;
+
+int AudioMixerClientData::parseCachedSoundInjection(ReceivedMessage& message) {
+    auto properties = CachedSoundStream::readProperties(message);
+
+    QWriteLocker writeLock { &_streamsLock };
+
+    auto streamIt = _audioStreams.find(properties.streamIdentifier);
+
+    if (properties.flags & AudioConstants::CACHED_SOUND_STOP) {
+        if (streamIt != _audioStreams.end()) {
+            _audioStreams.erase(streamIt);
+            writeLock.unlock();
+
+            // let the listeners drop their HRTFs for it
+            emit injectorStreamFinished(properties.streamIdentifier);
+        }
+        return message.getPosition();
+    }
+
+    if (streamIt == _audioStreams.end()) {
+        if (!CachedSoundStream::isAllowedURL(properties.url)) {
+            qDebug() << "Ignoring cached sound injection from" << message.getSourceID() << "for" << properties.url;
+            return message.getPosition();
+        }
+
+        auto isCachedSoundStream = [](const AudioStreamMap::value_type& stream) {
+            return dynamic_cast<CachedSoundStream*>(stream.second.get()) != nullptr;
+        };
+        int numCachedSoundStreams = (int)std::count_if(_audioStreams.cbegin(), _audioStreams.cend(), isCachedSoundStream);
+        if (numCachedSoundStreams >= MAX_CACHED_SOUND_STREAMS_PER_NODE) {
+            qDebug() << "Ignoring cached sound injection from" << message.getSourceID() << "- it already plays"
+                << numCachedSoundStreams << "cached sounds";
+            return message.getPosition();
+        }
+
+        auto sound = DependencyManager::get<AudioMixerSoundCache>()->getSound(properties.url);
+        bool isStereo = (properties.flags & AudioConstants::CACHED_SOUND_STEREO);
+
+        auto emplaced = _audioStreams.emplace(
+            properties.streamIdentifier,
+            std::unique_ptr<CachedSoundStream> { new CachedSoundStream(properties.streamIdentifier, sound, isStereo) }
+        );
+
+        streamIt = emplaced.first;
+    }
+
+    auto cachedSoundStream = dynamic_cast<CachedSoundStream*>(streamIt->second.get());
+    if (cachedSoundStream) {
+        cachedSoundStream->updateProperties(properties, (int)message.getSize());
+    }
+
+    return message.getPosition();
+}
+
 int AudioMixerClientData::checkBuffersBeforeFrameSend() {
     QWriteLocker writeLocker { &_streamsLock };
 
@@ -355,6 +425,12 @@ int AudioMixerClientData::checkBuffersBeforeFrameSend() {
     while (it != _audioStreams.end()) {
         SharedStreamPointer stream = it->second;
 
+        auto cachedSoundStream = dynamic_cast<CachedSoundStream*>(stream.get());
+        if (cachedSoundStream) {
+            // the frame we are about to pop comes out of the mixer's sound cache, not the network
+            cachedSoundStream->renderNextFrame();
+        }
+
         if (stream->popFrames(1, true) > 0) {
             stream->updateLastPopOutputLoudnessAndTrailingLoudness();
         }
@@ -363,8 +439,11 @@ int AudioMixerClientData::checkBuffersBeforeFrameSend() {
 
         // if we don't have new data for an injected stream in the last INJECTOR_MAX_INACTIVE_BLOCKS then
         // we remove the injector from our streams
-        if (stream->getType() == PositionalAudioStream::Injector
-            && stream->getConsecutiveNotMixedCount() > INJECTOR_MAX_INACTIVE_BLOCKS) {
+        // cached sound streams are not mixed while their sound loads, they go away once played or timed out
+        bool isFinished = cachedSoundStream ? cachedSoundStream->hasFinished()
+            : stream->getConsecutiveNotMixedCount() > INJECTOR_MAX_INACTIVE_BLOCKS;
+
+        if (stream->getType() == PositionalAudioStream::Injector && isFinished) {
             // this is an inactive injector, pull it from our streams
 
             // first emit that it is finished so that the HRTF objects for this source can be cleaned up
@@ -452,6 +531,10 @@ QJsonObject AudioMixerClientData::getAudioStreamStats() {
     downstreamStats["overflows"] = (double) streamStats._overflowCount;
     downstreamStats["lost%"] = streamStats._packetStreamStats.getLostRate() * 100.0f;
     downstreamStats["lost%_30s"] = streamStats._packetStreamWindowStats.getLostRate() * 100.0f;
+    downstreamStats["target_delay_ms"] = streamStats._targetDelayMs;
+    downstreamStats["concealed"] = (double) streamStats._framesConcealed;
+    downstreamStats["concealed%_30s"] = streamStats._concealedRate * 100.0f;
+    downstreamStats["stretched%_30s"] = streamStats._stretchedRate * 100.0f;
     downstreamStats["min_gap"] = formatUsecTime(streamStats._timeGapMin);
     downstreamStats["max_gap"] = formatUsecTime(streamStats._timeGapMax);
     downstreamStats["avg_gap"] = formatUsecTime(streamStats._timeGapAverage);
@@ -478,6 +561,10 @@ QJsonObject AudioMixerClientData::getAudioStreamStats() {
         upstreamStats["silents_dropped"] = (double) streamStats._framesDropped;
         upstreamStats["lost%"] = streamStats._packetStreamStats.getLostRate() * 100.0f;
         upstreamStats["lost%_30s"] = streamStats._packetStreamWindowStats.getLostRate() * 100.0f;
+        upstreamStats["target_delay_ms"] = streamStats._targetDelayMs;
+        upstreamStats["concealed"] = (double) streamStats._framesConcealed;
+        upstreamStats["concealed%_30s"] = streamStats._concealedRate * 100.0f;
+        upstreamStats["stretched%_30s"] = streamStats._stretchedRate * 100.0f;
         upstreamStats["min_gap"] = formatUsecTime(streamStats._timeGapMin);
         upstreamStats["max_gap"] = formatUsecTime(streamStats._timeGapMax);
         upstreamStats["avg_gap"] = formatUsecTime(streamStats._timeGapAverage);
@@ -508,6 +595,10 @@ QJsonObject AudioMixerClientData::getAudioStreamStats() {
             upstreamStats["silents_dropped"] = (double) streamStats._framesDropped;
             upstreamStats["lost%"] = streamStats._packetStreamStats.getLostRate() * 100.0f;
             upstreamStats["lost%_30s"] = streamStats._packetStreamWindowStats.getLostRate() * 100.0f;
+            upstreamStats["target_delay_ms"] = streamStats._targetDelayMs;
+            upstreamStats["concealed"] = (double) streamStats._framesConcealed;
+            upstreamStats["concealed%_30s"] = streamStats._concealedRate * 100.0f;
+            upstreamStats["stretched%_30s"] = streamStats._stretchedRate * 100.0f;
             upstreamStats["min_gap"] = formatUsecTime(streamStats._timeGapMin);
             upstreamStats["max_gap"] = formatUsecTime(streamStats._timeGapMax);
             upstreamStats["avg_gap"] = formatUsecTime(streamStats._timeGapAverage);
@@ -535,16 +626,20 @@ void AudioMixerClientData::sendSelectAudioFormat(SharedNodePointer node, const Q
     nodeList->sendPacket(std::move(replyPacket), *node);
 }
 
-void AudioMixerClientData::encodeFrameOfZeros(QByteArray& encodedZeros) {
-    static QByteArray zeros(AudioConstants::NETWORK_FRAME_BYTES_STEREO, 0);
+int AudioMixerClientData::encodeFrameOfZeros(char* encodedBuffer, int maxEncodedSize) {
+    static const int16_t zeros[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO] = {};
+    int encodedSize = 0;
     if (_shouldFlushEncoder) {
         if (_encoder) {
-            _encoder->encode(zeros, encodedZeros);
+            encodedSize = _encoder->encodeInto(zeros, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO,
+                                               encodedBuffer, maxEncodedSize);
         } else {
-            encodedZeros = zeros;
+            encodedSize = std::min(AudioConstants::NETWORK_FRAME_BYTES_STEREO, maxEncodedSize);
+            memset(encodedBuffer, 0, encodedSize);
         }
     }
     _shouldFlushEncoder = false;
+    return encodedSize;
 }
 
 void AudioMixerClientData::setupCodec(CodecPluginPointer codec, const QString& codecName) {
@@ -62,6 +62,7 @@ public:
 
     // packet parsers
     int parseData(ReceivedMessage& message) override;
+    int parseCachedSoundInjection(ReceivedMessage& message);
     void negotiateAudioFormat(ReceivedMessage& message, const SharedNodePointer& node);
     void parseRequestsDomainListData(ReceivedMessage& message);
     void parsePerAvatarGainSet(ReceivedMessage& message, const SharedNodePointer& node);
@@ -87,16 +88,21 @@ public:
 
     void setupCodec(CodecPluginPointer codec, const QString& codecName);
     void cleanupCodec();
-    void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) {
+    // encodes a frame of mixed samples straight into encodedBuffer (the outbound packet), returns the encoded size
+    int encode(const int16_t* decodedSamples, char* encodedBuffer, int maxEncodedSize) {
+        int encodedSize;
         if (_encoder) {
-            _encoder->encode(decodedBuffer, encodedBuffer);
+            encodedSize = _encoder->encodeInto(decodedSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO,
+                                               encodedBuffer, maxEncodedSize);
         } else {
-            encodedBuffer = decodedBuffer;
+            encodedSize = std::min(AudioConstants::NETWORK_FRAME_BYTES_STEREO, maxEncodedSize);
+            memcpy(encodedBuffer, decodedSamples, encodedSize);
         }
         // once you have encoded, you need to flush eventually.
         _shouldFlushEncoder = true;
+        return encodedSize;
     }
-    void encodeFrameOfZeros(QByteArray& encodedZeros);
+    int encodeFrameOfZeros(char* encodedBuffer, int maxEncodedSize);
     bool shouldFlushEncoder() { return _shouldFlushEncoder; }
 
     QString getCodecName() { return _selectedCodecName; }
@@ -40,7 +40,7 @@ using AudioStreamMap = AudioMixerClientData::AudioStreamMap;
 
 // packet helpers
 std::unique_ptr<NLPacket> createAudioPacket(PacketType type, int size, quint16 sequence, QString codec);
-void sendMixPacket(const SharedNodePointer& node, AudioMixerClientData& data, QByteArray& buffer);
+void sendMixPacket(const SharedNodePointer& node, AudioMixerClientData& data, const int16_t* mixSamples);
 void sendSilentPacket(const SharedNodePointer& node, AudioMixerClientData& data);
 void sendMutePacket(const SharedNodePointer& node, AudioMixerClientData&);
 void sendEnvironmentPacket(const SharedNodePointer& node, AudioMixerClientData& data);
@@ -94,26 +94,32 @@ void AudioMixerSlave::mix(const SharedNodePointer& node) {
         ++stats.sumListeners;
 
         // mix the audio
-        bool mixHasAudio = prepareMix(node);
+        prepareMix(node);
+
+#ifdef HIFI_AUDIO_MIXER_DEBUG
+        auto postMixStart = p_high_resolution_clock::now();
+#endif
+
+        // use the per listener AudioLimiter to render the mixed data,
+        // it checks for silence on the way in since its dither can only guarantee abs(sample) <= 1
+        bool mixHasAudio = data->audioLimiter.render(_mixSamples, _bufferSamples,
+                AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
 
         // send audio packet
         if (mixHasAudio || data->shouldFlushEncoder()) {
-            QByteArray encodedBuffer;
-            if (mixHasAudio) {
-                // encode the audio
-                QByteArray decodedBuffer(reinterpret_cast<char*>(_bufferSamples), AudioConstants::NETWORK_FRAME_BYTES_STEREO);
-                data->encode(decodedBuffer, encodedBuffer);
-            } else {
-                // time to flush (resets shouldFlush until the next encode)
-                data->encodeFrameOfZeros(encodedBuffer);
-            }
-
-            sendMixPacket(node, *data, encodedBuffer);
+            // without audio it is time to flush (resets shouldFlush until the next encode)
+            sendMixPacket(node, *data, mixHasAudio ? _bufferSamples : nullptr);
         } else {
             ++stats.sumListenersSilent;
             sendSilentPacket(node, *data);
         }
 
+#ifdef HIFI_AUDIO_MIXER_DEBUG
+        auto postMixEnd = p_high_resolution_clock::now();
+        auto postMixTime = std::chrono::duration_cast<std::chrono::nanoseconds>(postMixEnd - postMixStart);
+        stats.postMixTime += postMixTime.count();
+#endif
+
         // send environment packet
         sendEnvironmentPacket(node, *data);
 
@@ -125,7 +131,7 @@ void AudioMixerSlave::mix(const SharedNodePointer& node) {
     }
 }
 
-bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
+void AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
     AvatarAudioStream* listenerAudioStream = static_cast<AudioMixerClientData*>(listener->getLinkedData())->getAvatarAudioStream();
     AudioMixerClientData* listenerData = static_cast<AudioMixerClientData*>(listener->getLinkedData());
 
@@ -225,21 +231,6 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
     auto mixTime = std::chrono::duration_cast<std::chrono::nanoseconds>(mixEnd - mixStart);
     stats.mixTime += mixTime.count();
 #endif
-
-    // check for silent audio before limiting
-    // limiting uses a dither and can only guarantee abs(sample) <= 1
-    bool hasAudio = false;
-    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; ++i) {
-        if (_mixSamples[i] != 0.0f) {
-            hasAudio = true;
-            break;
-        }
-    }
-
-    // use the per listener AudioLimiter to render the mixed data
-    listenerData->audioLimiter.render(_mixSamples, _bufferSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
-
-    return hasAudio;
 }
 
 void AudioMixerSlave::throttleStream(AudioMixerClientData& listenerNodeData, const QUuid& sourceNodeID,
@@ -368,15 +359,19 @@ std::unique_ptr<NLPacket> createAudioPacket(PacketType type, int size, quint16 s
     return audioPacket;
 }
 
-void sendMixPacket(const SharedNodePointer& node, AudioMixerClientData& data, QByteArray& buffer) {
+void sendMixPacket(const SharedNodePointer& node, AudioMixerClientData& data, const int16_t* mixSamples) {
     const int MIX_PACKET_SIZE =
         sizeof(quint16) + AudioConstants::MAX_CODEC_NAME_LENGTH_ON_WIRE + AudioConstants::NETWORK_FRAME_BYTES_STEREO;
     quint16 sequence = data.getOutgoingSequenceNumber();
     QString codec = data.getCodecName();
     auto mixPacket = createAudioPacket(PacketType::MixedAudio, MIX_PACKET_SIZE, sequence, codec);
 
-    // pack samples
-    mixPacket->write(buffer.constData(), buffer.size());
+    // encode the samples straight into the packet, no samples flushes the encoder with a frame of zeros
+    char* encodedBuffer = mixPacket->getPayload() + mixPacket->pos();
+    int maxEncodedSize = (int)mixPacket->bytesAvailableForWrite();
+    int encodedSize = mixSamples ? data.encode(mixSamples, encodedBuffer, maxEncodedSize) :
+        data.encodeFrameOfZeros(encodedBuffer, maxEncodedSize);
+    mixPacket->setPayloadSize(mixPacket->pos() + encodedSize);
 
     // send packet
     DependencyManager::get<NodeList>()->sendPacket(std::move(mixPacket), *node);
@@ -43,8 +43,8 @@ public:
     AudioMixerStats stats;
 
 private:
-    // create mix, returns true if mix has audio
-    bool prepareMix(const SharedNodePointer& listener);
+    // create mix, left unlimited in _mixSamples
+    void prepareMix(const SharedNodePointer& listener);
     void throttleStream(AudioMixerClientData& listenerData, const QUuid& streamerID,
             const AvatarAudioStream& listenerStream, const PositionalAudioStream& streamer);
     void mixStream(AudioMixerClientData& listenerData, const QUuid& streamerID,
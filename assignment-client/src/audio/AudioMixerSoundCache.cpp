@@ -0,0 +1,92 @@
+//
+//  AudioMixerSoundCache.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioMixerSoundCache.h"
+
+#include <QtCore/QDebug>
+
+#include <SoundCache.h>
+
+CachedSoundPointer AudioMixerSoundCache::getSound(const QUrl& url) {
+    std::lock_guard<std::mutex> lock(_soundsMutex);
+
+    auto cachedSound = _sounds.value(url).lock();
+    if (!cachedSound) {
+        cachedSound = std::make_shared<CachedSound>(url);
+        _sounds[url] = cachedSound;
+
+        // packets are parsed on the slave threads, the SoundCache lives on the mixer thread
+        QMetaObject::invokeMethod(this, "loadSound", Qt::QueuedConnection, Q_ARG(QUrl, url));
+    }
+    return cachedSound;
+}
+
+void AudioMixerSoundCache::loadSound(const QUrl& url) {
+    CachedSoundPointer cachedSound;
+    {
+        std::lock_guard<std::mutex> lock(_soundsMutex);
+        cachedSound = _sounds.value(url).lock();
+    }
+
+    if (!cachedSound) {
+        // every stream playing it went away before we got to it
+        return;
+    }
+
+    auto sound = DependencyManager::get<SoundCache>()->getSound(url);
+    if (!sound) {
+        cachedSound->_hasFailed.store(true, std::memory_order_release);
+        return;
+    }
+    cachedSound->_sound = sound;
+
+    std::weak_ptr<CachedSound> weakCachedSound = cachedSound;
+    auto soundReady = [weakCachedSound, sound] {
+        if (auto cachedSound = weakCachedSound.lock()) {
+            cachedSound->_samples = sound->getByteArray();
+            cachedSound->_isStereo = sound->isStereo();
+            cachedSound->_isReady.store(true, std::memory_order_release);
+            qDebug() << "Cached" << cachedSound->_samples.size() << "bytes for injected sound" << sound->getURL();
+        }
+    };
+    auto soundFailed = [weakCachedSound, sound] {
+        if (auto cachedSound = weakCachedSound.lock()) {
+            cachedSound->_hasFailed.store(true, std::memory_order_release);
+            qWarning() << "Failed to load injected sound" << sound->getURL();
+        }
+    };
+
+    if (sound->isReady()) {
+        soundReady();
+    } else {
+        connect(sound.data(), &Sound::ready, this, soundReady);
+        connect(sound.data(), &Resource::failed, this, soundFailed);
+    }
+}
+
+AudioMixerSoundCache::Stats AudioMixerSoundCache::getStats() {
+    Stats stats;
+
+    std::lock_guard<std::mutex> lock(_soundsMutex);
+    auto it = _sounds.begin();
+    while (it != _sounds.end()) {
+        auto cachedSound = it.value().lock();
+        if (!cachedSound) {
+            it = _sounds.erase(it);
+            continue;
+        }
+        if (cachedSound->isReady()) {
+            ++stats.numSounds;
+            stats.numBytes += cachedSound->getSamples().size();
+        }
+        ++it;
+    }
+    return stats;
+}
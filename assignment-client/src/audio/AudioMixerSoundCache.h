@@ -0,0 +1,81 @@
+//
+//  AudioMixerSoundCache.h
+//  assignment-client/src/audio
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerSoundCache_h
+#define hifi_AudioMixerSoundCache_h
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QUrl>
+
+#include <DependencyManager.h>
+#include <Sound.h>
+
+// A sound decoded once on the mixer, shared by every cached injector stream playing it
+class CachedSound {
+public:
+    CachedSound(const QUrl& url) : _url(url) {}
+
+    const QUrl& getURL() const { return _url; }
+
+    bool isReady() const { return _isReady.load(std::memory_order_acquire); }
+    bool hasFailed() const { return _hasFailed.load(std::memory_order_acquire); }
+
+    // only valid once the sound is ready
+    const QByteArray& getSamples() const { return _samples; }
+    bool isStereo() const { return _isStereo; }
+
+private:
+    friend class AudioMixerSoundCache;
+
+    const QUrl _url;
+    SharedSoundPointer _sound;
+    QByteArray _samples;
+    bool _isStereo { false };
+    std::atomic<bool> _isReady { false };
+    std::atomic<bool> _hasFailed { false };
+};
+
+using CachedSoundPointer = std::shared_ptr<CachedSound>;
+
+// Hands out the sounds played by cached injector streams.
+// Sounds are fetched through the SoundCache on the mixer thread and live for as long as a stream plays them, after that
+// the SoundCache's own unused resource cache decides how long they stick around.
+class AudioMixerSoundCache : public QObject, public Dependency {
+    Q_OBJECT
+    SINGLETON_DEPENDENCY
+
+public:
+    // thread-safe, the returned sound is not ready until its download and decode finished on the mixer thread
+    CachedSoundPointer getSound(const QUrl& url);
+
+    struct Stats {
+        int numSounds { 0 };
+        qint64 numBytes { 0 };
+    };
+
+    // drops sounds nobody plays anymore and returns what is left
+    Stats getStats();
+
+private slots:
+    void loadSound(const QUrl& url);
+
+private:
+    AudioMixerSoundCache() {}
+
+    std::mutex _soundsMutex;
+    QHash<QUrl, std::weak_ptr<CachedSound>> _sounds;
+};
+
+#endif // hifi_AudioMixerSoundCache_h
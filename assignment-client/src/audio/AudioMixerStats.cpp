@@ -23,6 +23,7 @@ void AudioMixerStats::reset() {
     manualEchoMixes = 0;
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     mixTime = 0;
+    postMixTime = 0;
 #endif
 }
 
@@ -38,5 +39,6 @@ void AudioMixerStats::accumulate(const AudioMixerStats& otherStats) {
     manualEchoMixes += otherStats.manualEchoMixes;
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     mixTime += otherStats.mixTime;
+    postMixTime += otherStats.postMixTime;
 #endif
 }
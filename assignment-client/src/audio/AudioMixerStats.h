@@ -32,6 +32,7 @@ struct AudioMixerStats {
 
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     uint64_t mixTime { 0 };
+    uint64_t postMixTime { 0 };
 #endif
 
     void reset();
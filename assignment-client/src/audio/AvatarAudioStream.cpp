@@ -14,7 +14,10 @@
 #include "AvatarAudioStream.h"
 
 AvatarAudioStream::AvatarAudioStream(bool isStereo, int numStaticJitterFrames) :
-    PositionalAudioStream(PositionalAudioStream::Microphone, isStereo, numStaticJitterFrames) {}
+    PositionalAudioStream(PositionalAudioStream::Microphone, isStereo, numStaticJitterFrames) {
+    // the mixer pops on its own thread between parses, so an underrun can be filled in right away
+    setConcealUnderruns(true);
+}
 
 int AvatarAudioStream::parseStreamProperties(PacketType type, const QByteArray& packetAfterSeqNum, int& numAudioSamples) {
     int readBytes = 0;
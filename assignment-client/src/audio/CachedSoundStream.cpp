@@ -0,0 +1,141 @@
+//
+//  CachedSoundStream.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CachedSoundStream.h"
+
+#include <NLPacket.h>
+#include <ResourceManager.h>
+#include <SharedUtil.h>
+#include <UUID.h>
+
+#include "AudioHelpers.h"
+
+// injectors re-send their options every second, give up on one that missed a few
+static const quint64 CACHED_SOUND_TIMEOUT_USECS = 5 * USECS_PER_SECOND;
+
+// everything an InjectAudio packet carries besides its samples, see AudioInjector::injectNextFrame()
+static const int INJECT_AUDIO_PROPERTY_BYTES = sizeof(quint16) + sizeof(quint32) + NUM_BYTES_RFC4122_UUID + sizeof(bool) +
+    sizeof(uchar) + 3 * sizeof(glm::vec3) + sizeof(glm::quat) + sizeof(float) + sizeof(quint8) + sizeof(bool);
+
+CachedSoundStream::Properties CachedSoundStream::readProperties(ReceivedMessage& message) {
+    Properties properties;
+    properties.streamIdentifier = QUuid::fromRfc4122(message.readWithoutCopy(NUM_BYTES_RFC4122_UUID));
+    message.readPrimitive(&properties.flags);
+    message.readPrimitive(&properties.generation);
+    message.readPrimitive(&properties.frameOffset);
+    message.readPrimitive(&properties.position);
+    message.readPrimitive(&properties.orientation);
+    message.readPrimitive(&properties.volume);
+    properties.url = QUrl(message.readString());
+    return properties;
+}
+
+bool CachedSoundStream::isAllowedURL(const QUrl& url) {
+    return url.isValid() && url.scheme() == URL_SCHEME_ATP;
+}
+
+CachedSoundStream::CachedSoundStream(const QUuid& streamIdentifier, const CachedSoundPointer& sound, bool isStereo) :
+    InjectedAudioStream(streamIdentifier, isStereo),
+    _sound(sound) {}
+
+void CachedSoundStream::updateProperties(const Properties& properties, int packetSize) {
+    _shouldLoop = (properties.flags & AudioConstants::CACHED_SOUND_LOOP);
+    _ignorePenumbra = (properties.flags & AudioConstants::CACHED_SOUND_IGNORE_PENUMBRA);
+    _shouldLoopbackForNode = (properties.flags & AudioConstants::CACHED_SOUND_LOOPBACK);
+
+    // same positional data as a streaming injector sends
+    _position = properties.position;
+    _orientation = properties.orientation;
+    _avatarBoundingBoxCorner = properties.position;
+    _avatarBoundingBoxScale = glm::vec3(0.0f);
+    _attenuationRatio = unpackFloatGainFromByte(properties.volume);
+
+    // the injector was started or restarted, seek to where it wants us to play from
+    if (!_hasGeneration || properties.generation != _generation) {
+        _hasGeneration = true;
+        _generation = properties.generation;
+        _frameOffset = (int)properties.frameOffset;
+        _hasPlayedToEnd = false;
+    }
+
+    _lastUpdateUsecs = usecTimestampNow();
+    _controlBytesReceived += packetSize;
+}
+
+void CachedSoundStream::renderNextFrame() {
+    if (_hasPlayedToEnd || !_sound->isReady()) {
+        return;
+    }
+
+    // the mixer's decode of the sound is what counts
+    if (_sound->isStereo() != _isStereo) {
+        _isStereo = _sound->isStereo();
+        _ringBuffer.resizeForFrameSize(_isStereo
+                                       ? AudioConstants::NETWORK_FRAME_SAMPLES_STEREO
+                                       : AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    }
+
+    const QByteArray& samples = _sound->getSamples();
+    int numChannels = _isStereo ? AudioConstants::STEREO : AudioConstants::MONO;
+    int numSoundFrames = samples.size() / (numChannels * AudioConstants::SAMPLE_SIZE);
+    auto soundSamples = reinterpret_cast<const AudioConstants::AudioSample*>(samples.constData());
+
+    int framesLeft = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+    while (framesLeft > 0) {
+        if (_frameOffset >= numSoundFrames) {
+            if (!_shouldLoop || numSoundFrames == 0) {
+                break;
+            }
+            _frameOffset = 0;
+        }
+
+        int framesToWrite = std::min(framesLeft, numSoundFrames - _frameOffset);
+        _ringBuffer.writeSamples(soundSamples + _frameOffset * numChannels, framesToWrite * numChannels);
+        _frameOffset += framesToWrite;
+        framesLeft -= framesToWrite;
+    }
+
+    if (framesLeft > 0) {
+        _hasPlayedToEnd = true;
+        if (framesLeft == AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL) {
+            // nothing left to play, the pop that follows fails and the stream is dropped
+            return;
+        }
+        // pad out the last frame of the sound
+        _ringBuffer.addSilentSamples(framesLeft * numChannels);
+    }
+
+    // there is never more than the frame about to be popped in the buffer, so no jitter buffering to wait for
+    _isStarved = false;
+    ++_renderedFrames;
+}
+
+bool CachedSoundStream::hasFinished() const {
+    return (_hasPlayedToEnd && !lastPopSucceeded()) || _sound->hasFailed() ||
+        usecTimestampNow() - _lastUpdateUsecs > CACHED_SOUND_TIMEOUT_USECS;
+}
+
+int CachedSoundStream::takeRenderedFrames() {
+    int renderedFrames = _renderedFrames;
+    _renderedFrames = 0;
+    return renderedFrames;
+}
+
+qint64 CachedSoundStream::takeControlBytesReceived() {
+    qint64 controlBytesReceived = _controlBytesReceived;
+    _controlBytesReceived = 0;
+    return controlBytesReceived;
+}
+
+int CachedSoundStream::getStreamedFrameBytes() const {
+    int numChannels = _isStereo ? AudioConstants::STEREO : AudioConstants::MONO;
+    return NLPacket::totalHeaderSize(PacketType::InjectAudio) + INJECT_AUDIO_PROPERTY_BYTES +
+        numChannels * AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL;
+}
@@ -0,0 +1,77 @@
+//
+//  CachedSoundStream.h
+//  assignment-client/src/audio
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CachedSoundStream_h
+#define hifi_CachedSoundStream_h
+
+#include <InjectedAudioStream.h>
+
+#include "AudioMixerSoundCache.h"
+
+// An injector whose sound the mixer plays out of its own cache.
+// Instead of streaming samples the injector only sends InjectCachedSound packets with its options, the stream writes
+// one frame of the cached sound into its ring buffer every mix so the rest of the mixer treats it as any other injector.
+class CachedSoundStream : public InjectedAudioStream {
+public:
+    // the contents of an InjectCachedSound packet
+    struct Properties {
+        QUuid streamIdentifier;
+        quint8 flags { 0 };
+        quint16 generation { 0 };
+        quint32 frameOffset { 0 };
+        glm::vec3 position;
+        glm::quat orientation;
+        quint8 volume { 0 };
+        QUrl url;
+    };
+    static Properties readProperties(ReceivedMessage& message);
+
+    // any interface client can ask for a sound, so the mixer only fetches it from the domain's asset server,
+    // never from the web or its own disk
+    static bool isAllowedURL(const QUrl& url);
+
+    CachedSoundStream(const QUuid& streamIdentifier, const CachedSoundPointer& sound, bool isStereo);
+
+    void updateProperties(const Properties& properties, int packetSize);
+
+    // writes the next frame of the sound ahead of the frame being popped
+    void renderNextFrame();
+
+    const CachedSoundPointer& getSound() const { return _sound; }
+
+    // done playing, or its injector went quiet
+    bool hasFinished() const;
+
+    // frames played and control bytes received since the last call, for the per second mixer stats
+    int takeRenderedFrames();
+    qint64 takeControlBytesReceived();
+
+    // what a streaming injector sends per frame, to estimate the bandwidth we save
+    int getStreamedFrameBytes() const;
+
+private:
+    // disallow copying of CachedSoundStream objects
+    CachedSoundStream(const CachedSoundStream&);
+    CachedSoundStream& operator= (const CachedSoundStream&);
+
+    CachedSoundPointer _sound;
+
+    bool _shouldLoop { false };
+    bool _hasGeneration { false };
+    quint16 _generation { 0 };
+    int _frameOffset { 0 };
+    bool _hasPlayedToEnd { false };
+    quint64 _lastUpdateUsecs { 0 };
+
+    int _renderedFrames { 0 };
+    qint64 _controlBytesReceived { 0 };
+};
+
+#endif // hifi_CachedSoundStream_h
@@ -367,6 +367,15 @@ QString EntityServer::serverSubclassStats() {
     statsString += QString().sprintf("       EntityItem size... %ld bytes\r\n", sizeof(EntityItem));
     statsString += "\r\n\r\n";
 
+    if (_entitySimulation) {
+        statsString += "<b>Entity Server Simulation Statistics</b>\r\n";
+        statsString += QString("   Kinematic Entities Stepped: %1\r\n")
+            .arg(locale.toString(_entitySimulation->getTotalKinematicSteps()).rightJustified(16, ' '));
+        statsString += QString("    Kinematic Steps per msec: %1\r\n")
+            .arg(locale.toString(_entitySimulation->getKinematicStepsPerMsec(), 'f', 2).rightJustified(16, ' '));
+        statsString += "\r\n\r\n";
+    }
+
     statsString += "<b>Entity Server Sending to Viewer Statistics</b>\r\n";
     statsString += "----- Viewer Node ID -----------------    ----- Entity ID ----------------------    "
                    "---------- Last Sent To ----------    ---------- Last Edited -----------\r\n";
@@ -114,6 +114,7 @@
 #include <UpdateSceneTask.h>
 #include <RenderViewTask.h>
 #include <SecondaryCamera.h>
+#include <LoaderScheduler.h>
 #include <ResourceCache.h>
 #include <ResourceRequest.h>
 #include <SandboxUtils.h>
@@ -647,6 +648,7 @@ bool setupEssentials(int& argc, char** argv, bool runningMarkerExisted) {
     DependencyManager::set<DialogsManager>();
     DependencyManager::set<BandwidthRecorder>();
     DependencyManager::set<ResourceCacheSharedItems>();
+    DependencyManager::set<LoaderScheduler>();
     DependencyManager::set<DesktopScriptingInterface>();
     DependencyManager::set<EntityScriptingInterface>(true);
     DependencyManager::set<RecordingScriptingInterface>();
@@ -2114,6 +2116,7 @@ Application::~Application() {
     DependencyManager::destroy<AvatarManager>();
     DependencyManager::destroy<AnimationCache>();
     DependencyManager::destroy<FramebufferCache>();
+    DependencyManager::destroy<LoaderScheduler>();
     DependencyManager::destroy<TextureCache>();
     DependencyManager::destroy<ModelCache>();
     DependencyManager::destroy<GeometryCache>();
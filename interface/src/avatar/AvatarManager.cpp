@@ -12,6 +12,7 @@
 #include <string>
 
 #include <QScriptEngine>
+#include <QThread>
 
 #if defined(__GNUC__) && !defined(__clang__)
 #pragma GCC diagnostic push
@@ -31,6 +32,7 @@
 #include <RegisteredMetaTypes.h>
 #include <Rig.h>
 #include <SettingHandle.h>
+#include <TBBHelpers.h>
 #include <UsersScriptingInterface.h>
 #include <UUID.h>
 #include <avatars-renderer/OtherAvatar.h>
@@ -174,66 +176,81 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
     int numAvatarsUpdated = 0;
     int numAVatarsNotUpdated = 0;
 
-    render::Transaction transaction;
-    while (!sortedAvatars.empty()) {
-        const AvatarPriority& sortData = sortedAvatars.top();
-        const auto& avatar = std::static_pointer_cast<Avatar>(sortData.avatar);
+    // avatars are simulated in priority order, a batch at a time: the rig pose math of a batch runs on the worker
+    // threads, then the model update and other main-thread-only work for that batch runs serially before the budget
+    // is checked again
+    const float OUT_OF_VIEW_THRESHOLD = 0.5f * AvatarData::OUT_OF_VIEW_PENALTY;
+    const int AVATARS_PER_BATCH_PER_THREAD = 2;
+    const size_t batchSize = std::max(1, QThread::idealThreadCount()) * AVATARS_PER_BATCH_PER_THREAD;
+    struct AvatarToSimulate {
+        std::shared_ptr<Avatar> avatar;
+        bool inView;
+    };
+    std::vector<AvatarToSimulate> batch;
+    batch.reserve(batchSize);
 
-        // for ALL avatars...
-        if (_shouldRender) {
-            avatar->ensureInScene(avatar, qApp->getMain3DScene());
-        }
-        if (!avatar->isInPhysicsSimulation()) {
-            ShapeInfo shapeInfo;
-            avatar->computeShapeInfo(shapeInfo);
-            btCollisionShape* shape = const_cast<btCollisionShape*>(ObjectMotionState::getShapeManager()->getShape(shapeInfo));
-            if (shape) {
-                AvatarMotionState* motionState = new AvatarMotionState(avatar, shape);
-                motionState->setMass(avatar->computeMass());
-                avatar->setPhysicsCallback([=] (uint32_t flags) { motionState->addDirtyFlags(flags); });
-                _motionStates.insert(avatar.get(), motionState);
-                _motionStatesToAddToPhysics.insert(motionState);
+    render::Transaction transaction;
+    while (!sortedAvatars.empty() && usecTimestampNow() < updateExpiry) {
+        batch.clear();
+        while (!sortedAvatars.empty() && batch.size() < batchSize) {
+            const AvatarPriority& sortData = sortedAvatars.top();
+            const auto avatar = std::static_pointer_cast<Avatar>(sortData.avatar);
+
+            // for ALL avatars...
+            if (_shouldRender) {
+                avatar->ensureInScene(avatar, qApp->getMain3DScene());
             }
-        }
-        avatar->animateScaleChanges(deltaTime);
-
-        const float OUT_OF_VIEW_THRESHOLD = 0.5f * AvatarData::OUT_OF_VIEW_PENALTY;
-        uint64_t now = usecTimestampNow();
-        if (now < updateExpiry) {
-            // we're within budget
-            bool inView = sortData.priority > OUT_OF_VIEW_THRESHOLD;
-            if (inView && avatar->hasNewJointData()) {
-                numAvatarsUpdated++;
+            if (!avatar->isInPhysicsSimulation()) {
+                ShapeInfo shapeInfo;
+                avatar->computeShapeInfo(shapeInfo);
+                btCollisionShape* shape = const_cast<btCollisionShape*>(ObjectMotionState::getShapeManager()->getShape(shapeInfo));
+                if (shape) {
+                    AvatarMotionState* motionState = new AvatarMotionState(avatar, shape);
+                    motionState->setMass(avatar->computeMass());
+                    avatar->setPhysicsCallback([=] (uint32_t flags) { motionState->addDirtyFlags(flags); });
+                    _motionStates.insert(avatar.get(), motionState);
+                    _motionStatesToAddToPhysics.insert(motionState);
+                }
             }
-            avatar->simulate(deltaTime, inView);
-            avatar->updateRenderItem(transaction);
-            avatar->setLastRenderUpdateTime(startTime);
-        } else {
-            // we've spent our full time budget --> bail on the rest of the avatar updates
-            // --> more avatars may freeze until their priority trickles up
-            // --> some scale or fade animations may glitch
-            // --> some avatar velocity measurements may be a little off
+            avatar->animateScaleChanges(deltaTime);
 
-            // no time simulate, but we take the time to count how many were tragically missed
             bool inView = sortData.priority > OUT_OF_VIEW_THRESHOLD;
-            if (!inView) {
-                break;
-            }
             if (inView && avatar->hasNewJointData()) {
-                numAVatarsNotUpdated++;
+                numAvatarsUpdated++;
             }
+            batch.push_back({ avatar, inView });
             sortedAvatars.pop();
-            while (inView && !sortedAvatars.empty()) {
-                const AvatarPriority& newSortData = sortedAvatars.top();
-                const auto& newAvatar = std::static_pointer_cast<Avatar>(newSortData.avatar);
-                inView = newSortData.priority > OUT_OF_VIEW_THRESHOLD;
-                if (inView && newAvatar->hasNewJointData()) {
-                    numAVatarsNotUpdated++;
+        }
+
+        {
+            PROFILE_RANGE(simulation, "simulateJoints");
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, batch.size(), 1), [&](const tbb::blocked_range<size_t>& range) {
+                for (size_t i = range.begin(); i < range.end(); ++i) {
+                    batch[i].avatar->simulateJoints(deltaTime, batch[i].inView);
                 }
-                sortedAvatars.pop();
-            }
+            });
+        }
+
+        for (auto& entry : batch) {
+            entry.avatar->finishSimulate(deltaTime, entry.inView);
+            entry.avatar->updateRenderItem(transaction);
+            entry.avatar->setLastRenderUpdateTime(startTime);
+        }
+    }
+
+    // we've spent our full time budget --> bail on the rest of the avatar updates
+    // --> more avatars may freeze until their priority trickles up
+    // --> some scale or fade animations may glitch
+    // --> some avatar velocity measurements may be a little off
+    // no time simulate, but we take the time to count how many were tragically missed
+    while (!sortedAvatars.empty()) {
+        const AvatarPriority& sortData = sortedAvatars.top();
+        if (sortData.priority <= OUT_OF_VIEW_THRESHOLD) {
             break;
         }
+        if (std::static_pointer_cast<Avatar>(sortData.avatar)->hasNewJointData()) {
+            numAVatarsNotUpdated++;
+        }
         sortedAvatars.pop();
     }
 
@@ -249,7 +266,7 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
                 ++itr;
             }
         }
-        qApp->getMain3DScene()->enqueueTransaction(transaction);
+        qApp->getMain3DScene()->enqueueTransaction(std::move(transaction));
     }
 
     _numAvatarsUpdated = numAvatarsUpdated;
@@ -3193,6 +3193,14 @@ float MyAvatar::getIKErrorOnLastSolve() const {
     return _skeletonModel->getRig().getIKErrorOnLastSolve();
 }
 
+int MyAvatar::getIKIterationsOnLastSolve() const {
+    return _skeletonModel->getRig().getIKIterationsOnLastSolve();
+}
+
+QVariantMap MyAvatar::getIKChainErrorsOnLastSolve() const {
+    return _skeletonModel->getRig().getIKChainErrorsOnLastSolve();
+}
+
 // thread-safe
 void MyAvatar::addHoldAction(AvatarActionHold* holdAction) {
     std::lock_guard<std::mutex> guard(_holdActionsMutex);
@@ -13,6 +13,7 @@
 
 #include <string>
 #include "AnimationCache.h"
+#include "AnimClipData.h"
 #include "AnimNode.h"
 
 // Playback a single animation timeline.
@@ -24,6 +25,7 @@
 class AnimClip : public AnimNode {
 public:
     friend class AnimTests;
+    friend class AnimGraphTests;
 
     static bool usePreAndPostPoseFromAnim;
 
@@ -59,6 +61,7 @@ protected:
     virtual void setCurrentFrameInternal(float frame) override;
 
     void copyFromNetworkAnim();
+    std::vector<AnimPoseVec> retargetNetworkAnim() const;
     void buildMirrorAnim();
 
     // for AnimDebugDraw rendering
@@ -67,9 +70,9 @@ protected:
     AnimationPointer _networkAnim;
     AnimPoseVec _poses;
 
-    // _anim[frame][joint]
-    std::vector<AnimPoseVec> _anim;
-    std::vector<AnimPoseVec> _mirrorAnim;
+    // shared with every other clip playing the same url on the same kind of skeleton
+    AnimClipData::ConstPointer _anim;
+    AnimClipData::ConstPointer _mirrorAnim;
 
     QString _url;
     float _startFrame;
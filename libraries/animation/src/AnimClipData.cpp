@@ -0,0 +1,320 @@
+//
+//  AnimClipData.cpp
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AnimClipData.h"
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+
+#include <QCryptographicHash>
+#include <QHash>
+
+#include "AnimationLogging.h"
+#include "AnimUtil.h"
+
+namespace {
+    // the three smallest components of a unit quaternion all lie within +/- 1/sqrt(2)
+    const float SMALLEST_THREE_RANGE = 0.70710678f;
+    const float MAX_QUANTIZED_COMPONENT = 32767.0f;
+    const uint16_t COMPONENT_MASK = 0x7fff;
+
+    // worst case error allowed where keys are dropped, these are well below anything visible on an avatar
+    const float ROTATION_TOLERANCE = 0.001f; // radians
+    const float TRANSLATION_TOLERANCE_RATIO = 0.001f; // of the joint's default bone length
+    const float MIN_TRANSLATION_TOLERANCE = 0.0001f;
+    const float SCALE_TOLERANCE = 0.0001f;
+
+    const int MAX_FRAME_COUNT = std::numeric_limits<uint16_t>::max() + 1;
+
+    AnimClipData::QuantizedQuat quantize(const glm::quat& rot) {
+        glm::quat q = glm::normalize(rot);
+        float components[4] = { q.x, q.y, q.z, q.w };
+        int largest = 0;
+        for (int i = 1; i < 4; i++) {
+            if (fabsf(components[i]) > fabsf(components[largest])) {
+                largest = i;
+            }
+        }
+        // q and -q are the same rotation, so flip to make the dropped component positive
+        float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+        AnimClipData::QuantizedQuat result;
+        int j = 0;
+        for (int i = 0; i < 4; i++) {
+            if (i != largest) {
+                float normalized = (sign * components[i] / SMALLEST_THREE_RANGE + 1.0f) * 0.5f;
+                float quantized = glm::clamp(roundf(normalized * MAX_QUANTIZED_COMPONENT), 0.0f, MAX_QUANTIZED_COMPONENT);
+                result.data[j++] = (uint16_t)quantized;
+            }
+        }
+        result.data[0] |= (uint16_t)((largest & 1) << 15);
+        result.data[1] |= (uint16_t)((largest >> 1) << 15);
+        return result;
+    }
+
+    glm::quat dequantize(const AnimClipData::QuantizedQuat& rot) {
+        int largest = (rot.data[0] >> 15) | ((rot.data[1] >> 15) << 1);
+        float components[4];
+        float sumOfSquares = 0.0f;
+        int j = 0;
+        for (int i = 0; i < 4; i++) {
+            if (i != largest) {
+                float normalized = (float)(rot.data[j++] & COMPONENT_MASK) / MAX_QUANTIZED_COMPONENT;
+                components[i] = (normalized * 2.0f - 1.0f) * SMALLEST_THREE_RANGE;
+                sumOfSquares += components[i] * components[i];
+            }
+        }
+        components[largest] = sqrtf(std::max(0.0f, 1.0f - sumOfSquares));
+        return glm::normalize(glm::quat(components[3], components[0], components[1], components[2]));
+    }
+
+    float keyAlpha(int frame, int prevKeyFrame, int nextKeyFrame) {
+        return (float)(frame - prevKeyFrame) / (float)(nextKeyFrame - prevKeyFrame);
+    }
+
+    // Greedily picks the keys of a track: each segment is stretched for as long as interpolating between its end
+    // points (as stored, so after quantization) reproduces every original value inside it within tolerance.
+    template <typename T, typename Lerp, typename Distance>
+    std::vector<uint16_t> chooseKeys(const std::vector<T>& original, const std::vector<T>& stored, float tolerance,
+                                     Lerp lerp, Distance distance) {
+        int count = (int)original.size();
+        std::vector<uint16_t> keys;
+        keys.push_back(0);
+
+        bool isConstant = true;
+        for (int i = 1; i < count && isConstant; i++) {
+            isConstant = distance(stored[0], original[i]) <= tolerance;
+        }
+        if (isConstant) {
+            return keys;
+        }
+
+        auto segmentFits = [&](int start, int end) {
+            for (int i = start + 1; i < end; i++) {
+                if (distance(lerp(stored[start], stored[end], keyAlpha(i, start, end)), original[i]) > tolerance) {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        int start = 0;
+        while (start < count - 1) {
+            int end = start + 1;
+            while (end + 1 < count && segmentFits(start, end + 1)) {
+                end++;
+            }
+            keys.push_back((uint16_t)end);
+            start = end;
+        }
+        return keys;
+    }
+
+    template <typename T>
+    void findKeys(const AnimClipData::Track<T>& track, int frame, int& prevKey, int& nextKey) {
+        auto nextItr = std::upper_bound(track.frames.begin(), track.frames.end(), (uint16_t)frame);
+        nextKey = std::min((int)(nextItr - track.frames.begin()), (int)track.frames.size() - 1);
+        prevKey = std::max(nextKey - 1, 0);
+    }
+
+    float rotationDistance(const glm::quat& a, const glm::quat& b) {
+        return 2.0f * acosf(std::min(fabsf(glm::dot(a, b)), 1.0f));
+    }
+
+    float vectorDistance(const glm::vec3& a, const glm::vec3& b) {
+        return glm::distance(a, b);
+    }
+
+    glm::vec3 vectorLerp(const glm::vec3& a, const glm::vec3& b, float alpha) {
+        return glm::mix(a, b, alpha);
+    }
+
+    std::mutex cacheMutex;
+    QHash<QString, std::weak_ptr<const AnimClipData>> cache;
+
+    const QString MIRROR_KEY_SUFFIX = "#mirror";
+}
+
+AnimClipData::ConstPointer AnimClipData::get(const QString& key, FrameBuilder buildFrames) {
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto itr = cache.find(key);
+        if (itr != cache.end()) {
+            ConstPointer clipData = itr.value().lock();
+            if (clipData) {
+                return clipData;
+            }
+        }
+    }
+
+    // retargeting and compressing is the slow part, so do it unlocked
+    ConstPointer clipData = create(key, buildFrames());
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    for (auto itr = cache.begin(); itr != cache.end();) {
+        if (itr.value().expired()) {
+            itr = cache.erase(itr);
+        } else {
+            ++itr;
+        }
+    }
+    auto& entry = cache[key];
+    ConstPointer existing = entry.lock();
+    if (existing) {
+        // another clip finished the same data first, share that one
+        return existing;
+    }
+    entry = clipData;
+    return clipData;
+}
+
+AnimClipData::ConstPointer AnimClipData::getMirrored(const ConstPointer& clipData, const AnimSkeleton& skeleton) {
+    assert(clipData);
+    return get(clipData->getKey() + MIRROR_KEY_SUFFIX, [&] {
+        std::vector<AnimPoseVec> frames = clipData->decompress();
+        for (auto& relPoses : frames) {
+            skeleton.mirrorRelativePoses(relPoses);
+        }
+        return frames;
+    });
+}
+
+QByteArray AnimClipData::getSkeletonSignature(const AnimSkeleton& skeleton) {
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    auto addPose = [&](const AnimPose& pose) {
+        hash.addData((const char*)&pose.scale(), sizeof(glm::vec3));
+        hash.addData((const char*)&pose.rot(), sizeof(glm::quat));
+        hash.addData((const char*)&pose.trans(), sizeof(glm::vec3));
+    };
+    for (int i = 0; i < skeleton.getNumJoints(); i++) {
+        hash.addData(skeleton.getJointName(i).toUtf8());
+        int parentIndex = skeleton.getParentIndex(i);
+        hash.addData((const char*)&parentIndex, sizeof(parentIndex));
+        addPose(skeleton.getRelativeDefaultPose(i));
+        addPose(skeleton.getRelativeBindPose(i));
+    }
+    return hash.result();
+}
+
+AnimClipData::ConstPointer AnimClipData::create(const QString& key, const std::vector<AnimPoseVec>& frames) {
+    std::shared_ptr<AnimClipData> clipData(new AnimClipData(key));
+    int frameCount = (int)frames.size();
+    if (frameCount > MAX_FRAME_COUNT) {
+        qCWarning(animation) << "animation has" << frameCount << "frames, only the first" << MAX_FRAME_COUNT << "will play, key =" << key;
+        frameCount = MAX_FRAME_COUNT;
+    }
+    if (frameCount == 0) {
+        return clipData;
+    }
+    clipData->_frameCount = frameCount;
+
+    int jointCount = (int)frames[0].size();
+    clipData->_joints.resize(jointCount);
+
+    std::vector<glm::quat> rotations(frameCount);
+    std::vector<glm::quat> storedRotations(frameCount);
+    std::vector<QuantizedQuat> quantizedRotations(frameCount);
+    std::vector<glm::vec3> translations(frameCount);
+    std::vector<glm::vec3> scales(frameCount);
+    for (int joint = 0; joint < jointCount; joint++) {
+        for (int frame = 0; frame < frameCount; frame++) {
+            const AnimPose& pose = frames[frame][joint];
+            rotations[frame] = pose.rot();
+            quantizedRotations[frame] = quantize(pose.rot());
+            storedRotations[frame] = dequantize(quantizedRotations[frame]);
+            translations[frame] = pose.trans();
+            scales[frame] = pose.scale();
+        }
+        JointTracks& tracks = clipData->_joints[joint];
+
+        tracks.rotations.frames = chooseKeys(rotations, storedRotations, ROTATION_TOLERANCE, safeLerp, rotationDistance);
+        for (auto frame : tracks.rotations.frames) {
+            tracks.rotations.keys.push_back(quantizedRotations[frame]);
+        }
+
+        float boneLength = glm::length(translations[0]);
+        float translationTolerance = std::max(TRANSLATION_TOLERANCE_RATIO * boneLength, MIN_TRANSLATION_TOLERANCE);
+        tracks.translations.frames = chooseKeys(translations, translations, translationTolerance, vectorLerp, vectorDistance);
+        for (auto frame : tracks.translations.frames) {
+            tracks.translations.keys.push_back(translations[frame]);
+        }
+
+        tracks.scales.frames = chooseKeys(scales, scales, SCALE_TOLERANCE, vectorLerp, vectorDistance);
+        for (auto frame : tracks.scales.frames) {
+            tracks.scales.keys.push_back(scales[frame]);
+        }
+
+        tracks.rotations.frames.shrink_to_fit();
+        tracks.rotations.keys.shrink_to_fit();
+        tracks.translations.frames.shrink_to_fit();
+        tracks.translations.keys.shrink_to_fit();
+        tracks.scales.frames.shrink_to_fit();
+        tracks.scales.keys.shrink_to_fit();
+    }
+    return clipData;
+}
+
+size_t AnimClipData::getUncompressedSize(int frameCount, int jointCount) {
+    return sizeof(std::vector<AnimPoseVec>) + frameCount * (sizeof(AnimPoseVec) + jointCount * sizeof(AnimPose));
+}
+
+size_t AnimClipData::getSize() const {
+    size_t size = sizeof(AnimClipData) + _key.size() * sizeof(QChar) + _joints.capacity() * sizeof(JointTracks);
+    for (const auto& tracks : _joints) {
+        size += tracks.rotations.getSize() + tracks.translations.getSize() + tracks.scales.getSize();
+    }
+    return size;
+}
+
+glm::quat AnimClipData::sampleRotation(const Track<QuantizedQuat>& track, int frame) const {
+    int prevKey, nextKey;
+    findKeys(track, frame, prevKey, nextKey);
+    glm::quat prevRot = dequantize(track.keys[prevKey]);
+    if (prevKey == nextKey || track.frames[prevKey] == frame) {
+        return prevRot;
+    }
+    return safeLerp(prevRot, dequantize(track.keys[nextKey]), keyAlpha(frame, track.frames[prevKey], track.frames[nextKey]));
+}
+
+glm::vec3 AnimClipData::sampleVector(const Track<glm::vec3>& track, int frame) const {
+    int prevKey, nextKey;
+    findKeys(track, frame, prevKey, nextKey);
+    if (prevKey == nextKey || track.frames[prevKey] == frame) {
+        return track.keys[prevKey];
+    }
+    return vectorLerp(track.keys[prevKey], track.keys[nextKey], keyAlpha(frame, track.frames[prevKey], track.frames[nextKey]));
+}
+
+AnimPose AnimClipData::getPose(int frame, int jointIndex) const {
+    assert(frame >= 0 && frame < _frameCount);
+    const JointTracks& tracks = _joints[jointIndex];
+    return AnimPose(sampleVector(tracks.scales, frame), sampleRotation(tracks.rotations, frame),
+                    sampleVector(tracks.translations, frame));
+}
+
+void AnimClipData::evaluate(int prevFrame, int nextFrame, float alpha, AnimPose* posesOut) const {
+    int jointCount = getJointCount();
+    for (int joint = 0; joint < jointCount; joint++) {
+        AnimPose prevPose = getPose(prevFrame, joint);
+        AnimPose nextPose = getPose(nextFrame, joint);
+        ::blend(1, &prevPose, &nextPose, alpha, &posesOut[joint]);
+    }
+}
+
+std::vector<AnimPoseVec> AnimClipData::decompress() const {
+    std::vector<AnimPoseVec> frames(_frameCount);
+    for (int frame = 0; frame < _frameCount; frame++) {
+        frames[frame].reserve(_joints.size());
+        for (int joint = 0; joint < getJointCount(); joint++) {
+            frames[frame].push_back(getPose(frame, joint));
+        }
+    }
+    return frames;
+}
@@ -0,0 +1,92 @@
+//
+//  AnimClipData.h
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AnimClipData_h
+#define hifi_AnimClipData_h
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <QByteArray>
+#include <QString>
+
+#include "AnimPose.h"
+#include "AnimSkeleton.h"
+
+// Immutable, compressed animation frames for one clip, already retargeted onto one skeleton.
+//
+// Every AnimClip that plays the same url on a skeleton with the same signature shares a single instance, so a crowd
+// of avatars holds one copy of each idle/walk/run animation instead of one per avatar.  Each joint keeps separate
+// rotation, translation and scale tracks.  Rotations are quantized to 48 bits (smallest three), and keys that linear
+// interpolation reproduces within tolerance are dropped, so constant tracks collapse to a single key.
+class AnimClipData {
+public:
+    using ConstPointer = std::shared_ptr<const AnimClipData>;
+    using FrameBuilder = std::function<std::vector<AnimPoseVec>()>;
+
+    // Returns the cached data for key, or compresses the result of buildFrames() (_anim[frame][joint]) and caches that.
+    // The cache only holds weak references, clip data is freed when the last clip using it goes away.
+    static ConstPointer get(const QString& key, FrameBuilder buildFrames);
+
+    // The mirrored version of clipData, built on first use and cached alongside it.
+    static ConstPointer getMirrored(const ConstPointer& clipData, const AnimSkeleton& skeleton);
+
+    // Identifies everything about a skeleton that retargeting depends on: joint names, hierarchy and default poses.
+    static QByteArray getSkeletonSignature(const AnimSkeleton& skeleton);
+
+    // Compresses without touching the cache.
+    static ConstPointer create(const QString& key, const std::vector<AnimPoseVec>& frames);
+
+    // Bytes an uncompressed std::vector<AnimPoseVec> of this clip would take.
+    static size_t getUncompressedSize(int frameCount, int jointCount);
+
+    const QString& getKey() const { return _key; }
+    int getFrameCount() const { return _frameCount; }
+    int getJointCount() const { return (int)_joints.size(); }
+    size_t getSize() const;
+
+    AnimPose getPose(int frame, int jointIndex) const;
+
+    // Same result as ::blend() of the uncompressed prevFrame and nextFrame poses, written to posesOut[0..jointCount).
+    void evaluate(int prevFrame, int nextFrame, float alpha, AnimPose* posesOut) const;
+
+    // All frames, uncompressed.
+    std::vector<AnimPoseVec> decompress() const;
+
+    // 48 bit quaternion: the three smallest components in 15 bits each, the index of the largest in the 2 spare bits.
+    struct QuantizedQuat {
+        uint16_t data[3];
+    };
+
+    template <typename T>
+    struct Track {
+        std::vector<uint16_t> frames; // frame of each key, always starts at 0
+        std::vector<T> keys;
+        size_t getSize() const { return frames.capacity() * sizeof(uint16_t) + keys.capacity() * sizeof(T); }
+    };
+
+private:
+    struct JointTracks {
+        Track<QuantizedQuat> rotations;
+        Track<glm::vec3> translations;
+        Track<glm::vec3> scales;
+    };
+
+    AnimClipData(const QString& key) : _key(key) {}
+
+    glm::quat sampleRotation(const Track<QuantizedQuat>& track, int frame) const;
+    glm::vec3 sampleVector(const Track<glm::vec3>& track, int frame) const;
+
+    QString _key;
+    int _frameCount { 0 };
+    std::vector<JointTracks> _joints;
+};
+
+#endif // hifi_AnimClipData_h
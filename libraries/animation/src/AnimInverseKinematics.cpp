@@ -26,6 +26,16 @@
 static const int MAX_TARGET_MARKERS = 30;
 static const float JOINT_CHAIN_INTERP_TIME = 0.25f;
 
+// a chain whose tip is this close to its target doesn't need to be solved again
+static const float IK_POSITION_TOLERANCE = 0.1f; // cm
+static const float IK_ROTATION_TOLERANCE = 0.005f; // radians
+
+// a chain whose error changes less than this between iterations has stalled, e.g. the target is out of reach
+static const float IK_POSITION_STALL_TOLERANCE = 0.01f; // cm
+static const float IK_ROTATION_STALL_TOLERANCE = 0.0005f; // radians
+
+bool AnimInverseKinematics::useIncrementalSolve = true;
+
 static void lookupJointInfo(const AnimInverseKinematics::JointChainInfo& jointChainInfo,
                             int indexA, int indexB,
                             const AnimInverseKinematics::JointInfo** jointInfoA,
@@ -46,6 +56,11 @@ static void lookupJointInfo(const AnimInverseKinematics::JointChainInfo& jointCh
     }
 }
 
+// angle of the rotation that takes a to b
+static float angleBetween(const glm::quat& a, const glm::quat& b) {
+    return 2.0f * acosf(std::min(fabsf(glm::dot(a, b)), 1.0f));
+}
+
 static float easeOutExpo(float t) {
     return 1.0f - powf(2, -10.0f * t);
 }
@@ -227,16 +242,46 @@ void AnimInverseKinematics::solve(const AnimContext& context, const std::vector<
         accumulator.clearAndClean();
     }
 
+    // Chains that are within tolerance of their target, or that stop making progress, are settled: instead of being
+    // solved again they keep voting for the joint rotations they last produced.  Since _relativePoses start from last
+    // frame's solution, chains whose target and parent poses haven't moved start out settled and vote for the poses
+    // they already have.
+    std::vector<ChainError> chainErrors(targets.size());
+    std::vector<bool> settled(targets.size(), false);
+    for (size_t i = 0; i < targets.size(); i++) {
+        chainErrors[i] = computeChainError(targets[i], absolutePoses);
+        if (useIncrementalSolve && chainErrors[i].position < IK_POSITION_TOLERANCE &&
+            chainErrors[i].rotation < IK_ROTATION_TOLERANCE) {
+            settled[i] = true;
+            IKTarget::Type type = targets[i].getType();
+            if (type != IKTarget::Type::Unknown && type != IKTarget::Type::RotationOnly) {
+                holdJointChain(jointChainInfoVec[i]);
+            }
+        }
+    }
+
+    // the last iteration interpolates recently changed joint chains and draws the debug chains, so when the solution
+    // converges early, one more iteration is needed to do those.
+    bool needsLastLoop = context.getEnableDebugDrawIKChains();
+    for (auto& prevJointChainInfo : _prevJointChainInfoVec) {
+        needsLastLoop = needsLastLoop || prevJointChainInfo.timer > 0.0f;
+    }
+
     float maxError = 0.0f;
     int numLoops = 0;
     const int MAX_IK_LOOPS = 16;
+    bool converged = false;
     while (numLoops < MAX_IK_LOOPS) {
         ++numLoops;
 
-        bool debug = context.getEnableDebugDrawIKChains() && numLoops == MAX_IK_LOOPS;
+        bool lastLoop = converged || numLoops == MAX_IK_LOOPS;
+        bool debug = context.getEnableDebugDrawIKChains() && lastLoop;
 
         // solve all targets
         for (size_t i = 0; i < targets.size(); i++) {
+            if (settled[i] && !debug) {
+                continue;
+            }
             switch (targets[i].getType()) {
             case IKTarget::Type::Unknown:
                 break;
@@ -250,7 +295,7 @@ void AnimInverseKinematics::solve(const AnimContext& context, const std::vector<
         }
 
         // on last iteration, interpolate jointChains, if necessary
-        if (numLoops == MAX_IK_LOOPS) {
+        if (lastLoop) {
             for (size_t i = 0; i < _prevJointChainInfoVec.size(); i++) {
                 if (_prevJointChainInfoVec[i].timer > 0.0f) {
                     float alpha = (JOINT_CHAIN_INTERP_TIME - _prevJointChainInfoVec[i].timer) / JOINT_CHAIN_INTERP_TIME;
@@ -325,8 +370,30 @@ void AnimInverseKinematics::solve(const AnimContext& context, const std::vector<
                 }
             }
         }
+
+        if (lastLoop) {
+            break;
+        }
+
+        // update which chains have settled
+        if (useIncrementalSolve) {
+            converged = true;
+            for (size_t i = 0; i < targets.size(); i++) {
+                ChainError error = computeChainError(targets[i], absolutePoses);
+                bool withinTolerance = error.position < IK_POSITION_TOLERANCE && error.rotation < IK_ROTATION_TOLERANCE;
+                bool stalled = fabsf(error.position - chainErrors[i].position) < IK_POSITION_STALL_TOLERANCE &&
+                    fabsf(error.rotation - chainErrors[i].rotation) < IK_ROTATION_STALL_TOLERANCE;
+                settled[i] = withinTolerance || stalled;
+                converged = converged && settled[i];
+                chainErrors[i] = error;
+            }
+            if (converged && !needsLastLoop) {
+                break;
+            }
+        }
     }
     _maxErrorOnLastSolve = maxError;
+    _numLoopsOnLastSolve = numLoops;
 
     // finally set the relative rotation of each tip to agree with absolute target rotation
     for (auto& target: targets) {
@@ -374,8 +441,47 @@ void AnimInverseKinematics::solve(const AnimContext& context, const std::vector<
             }
         }
     }
+
+    for (size_t i = 0; i < targets.size(); i++) {
+        chainErrors[i] = computeChainError(targets[i], absolutePoses);
+    }
+    _chainErrorsOnLastSolve.swap(chainErrors);
+}
+
+AnimInverseKinematics::ChainError AnimInverseKinematics::computeChainError(const IKTarget& target, const AnimPoseVec& absolutePoses) const {
+    ChainError error;
+    error.jointIndex = target.getIndex();
+    switch (target.getType()) {
+    case IKTarget::Type::Unknown:
+    case IKTarget::Type::RotationOnly:
+        // not solved by the ik loop, always settled
+        break;
+    case IKTarget::Type::HmdHead:
+        // the head position is enforced by moving the hips, not by this chain
+        error.rotation = angleBetween(absolutePoses[target.getIndex()].rot(), target.getRotation());
+        break;
+    default:
+        error.position = glm::length(absolutePoses[target.getIndex()].trans() - target.getTranslation());
+        error.rotation = angleBetween(absolutePoses[target.getIndex()].rot(), target.getRotation());
+        break;
+    }
+    return error;
+}
+
+// fill a chain with the current relative poses of its joints, as if it had been solved without changing anything.
+void AnimInverseKinematics::holdJointChain(JointChainInfo& jointChainInfo) const {
+    for (auto& info : jointChainInfo.jointInfoVec) {
+        if (info.jointIndex == _hipsIndex) {
+            break;  // the solvers never write the hips or the joints above them
+        }
+        if (info.jointIndex >= 0) {
+            info.rot = _relativePoses[info.jointIndex].rot();
+            info.trans = _relativePoses[info.jointIndex].trans();
+        }
+    }
 }
 
+
 void AnimInverseKinematics::solveTargetWithCCD(const AnimContext& context, const IKTarget& target, const AnimPoseVec& absolutePoses,
                                                bool debug, JointChainInfo& jointChainInfoOut) const {
     size_t chainDepth = 0;
@@ -61,6 +61,19 @@ public:
 
     float getMaxErrorOnLastSolve() { return _maxErrorOnLastSolve; }
 
+    struct ChainError {
+        int jointIndex { -1 };   // tip of the chain
+        float position { 0.0f }; // cm
+        float rotation { 0.0f }; // radians
+    };
+
+    // iterations the solver needed last frame, and how far each target's tip was from its target afterwards.
+    int getNumLoopsOnLastSolve() const { return _numLoopsOnLastSolve; }
+    const std::vector<ChainError>& getChainErrorsOnLastSolve() const { return _chainErrorsOnLastSolve; }
+
+    // when false, every target is solved for the full MAX_IK_LOOPS iterations, even when they have already converged.
+    static bool useIncrementalSolve;
+
     enum class SolutionSource {
         RelaxToUnderPoses = 0,
         RelaxToLimitCenterPoses,
@@ -84,6 +97,8 @@ protected:
     void solveTargetWithSpline(const AnimContext& context, const IKTarget& target, const AnimPoseVec& absolutePoses,
                                bool debug, JointChainInfo& jointChainInfoOut) const;
     virtual void setSkeletonInternal(AnimSkeleton::ConstPointer skeleton) override;
+    ChainError computeChainError(const IKTarget& target, const AnimPoseVec& absolutePoses) const;
+    void holdJointChain(JointChainInfo& jointChainInfo) const;
     void debugDrawIKChain(const JointChainInfo& jointChainInfo, const AnimContext& context) const;
     void debugDrawRelativePoses(const AnimContext& context) const;
     void debugDrawConstraints(const AnimContext& context) const;
@@ -161,6 +176,8 @@ protected:
     int _rightHandIndex { -1 };
 
     float _maxErrorOnLastSolve { FLT_MAX };
+    int _numLoopsOnLastSolve { 0 };
+    std::vector<ChainError> _chainErrorsOnLastSolve;
     bool _previousEnableDebugIKTargets { false };
     SolutionSource _solutionSource { SolutionSource::RelaxToUnderPoses };
     QString _solutionSourceVar;
@@ -61,6 +61,7 @@ public:
     BoneSet _boneSet;
     float _alpha;
     std::vector<float> _boneSetVec;
+    std::vector<float> _boneSetAlphas; // _boneSetVec * _alpha, for this frame's blend
 
     QString _boneSetVar;
     QString _alphaVar;
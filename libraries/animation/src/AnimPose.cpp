@@ -55,6 +55,13 @@ glm::vec3 AnimPose::xformVectorFast(const glm::vec3& rhs) const {
 }
 
 AnimPose AnimPose::operator*(const AnimPose& rhs) const {
+    // A uniform positive scale on the left commutes with rhs's rotation, so the product is just another
+    // scale/rotation/translation and can be composed directly.  This is the same pose the matrix path below would
+    // decompose to, without the matrix multiply, scale extraction and quat_cast.  Almost every skeleton hits it.
+    if (_scale.x == _scale.y && _scale.x == _scale.z && _scale.x > 0.0f &&
+        rhs._scale.x > 0.0f && rhs._scale.y > 0.0f && rhs._scale.z > 0.0f) {
+        return AnimPose(_scale.x * rhs._scale, glm::normalize(_rot * rhs._rot), _trans + _rot * (_scale.x * rhs._trans));
+    }
     glm::mat4 result;
     glm_mat4u_mul(*this, rhs, result);
     return AnimPose(result);
@@ -11,26 +11,140 @@
 #include "AnimUtil.h"
 #include "GLMHelpers.h"
 
-// TODO: use restrict keyword
-// TODO: excellent candidate for simd vectorization.
+// The kernels below see an array of AnimPose as packed floats: scale (3), rotation (4), translation (3).
+static const int POSE_FLOATS = 10;
+static const int ROT_OFFSET = 3;
+static const int TRANS_OFFSET = 7;
+static_assert(sizeof(AnimPose) == POSE_FLOATS * sizeof(float), "AnimPose must be packed for the blend kernels");
 
-void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
-    for (size_t i = 0; i < numPoses; i++) {
-        const AnimPose& aPose = a[i];
-        const AnimPose& bPose = b[i];
-
-        // adjust signs if necessary
-        const glm::quat& q1 = aPose.rot();
-        glm::quat q2 = bPose.rot();
-        float dot = glm::dot(q1, q2);
-        if (dot < 0.0f) {
-            q2 = -q2;
+// alphaStride is 0 when every pose uses alphas[0], 1 for one alpha per pose
+static void blend_ref(const float* a, const float* b, const float* alphas, int alphaStride, float* result, int numPoses) {
+    for (int i = 0; i < numPoses; i++) {
+        const AnimPose& aPose = reinterpret_cast<const AnimPose*>(a)[i];
+        const AnimPose& bPose = reinterpret_cast<const AnimPose*>(b)[i];
+        AnimPose& resultPose = reinterpret_cast<AnimPose*>(result)[i];
+        float alpha = alphas[i * alphaStride];
+
+        resultPose.scale() = lerp(aPose.scale(), bPose.scale(), alpha);
+        resultPose.rot() = safeLerp(aPose.rot(), bPose.rot(), alpha);
+        resultPose.trans() = lerp(aPose.trans(), bPose.trans(), alpha);
+    }
+}
+
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>
+
+// Four poses at a time.  Rotations are transposed so that each register holds one component of four quaternions,
+// which turns the dot product, sign flip and normalize of safeLerp() into plain vertical math.  Scales and
+// translations are lerped one pose per register.
+static void blend_SSE2(const float* a, const float* b, const float* alphas, int alphaStride, float* result, int numPoses) {
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+
+    int i = 0;
+    for (; i + 4 <= numPoses; i += 4) {
+
+        const float* pa = &a[i * POSE_FLOATS];
+        const float* pb = &b[i * POSE_FLOATS];
+        float* pr = &result[i * POSE_FLOATS];
+
+        __m128 alpha = alphaStride ? _mm_loadu_ps(&alphas[i]) : _mm_set1_ps(alphas[0]);
+        __m128 oneMinusAlpha = _mm_sub_ps(one, alpha);
+
+        __m128 a0 = _mm_loadu_ps(&pa[0 * POSE_FLOATS + ROT_OFFSET]);
+        __m128 a1 = _mm_loadu_ps(&pa[1 * POSE_FLOATS + ROT_OFFSET]);
+        __m128 a2 = _mm_loadu_ps(&pa[2 * POSE_FLOATS + ROT_OFFSET]);
+        __m128 a3 = _mm_loadu_ps(&pa[3 * POSE_FLOATS + ROT_OFFSET]);
+        _MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+
+        __m128 b0 = _mm_loadu_ps(&pb[0 * POSE_FLOATS + ROT_OFFSET]);
+        __m128 b1 = _mm_loadu_ps(&pb[1 * POSE_FLOATS + ROT_OFFSET]);
+        __m128 b2 = _mm_loadu_ps(&pb[2 * POSE_FLOATS + ROT_OFFSET]);
+        __m128 b3 = _mm_loadu_ps(&pb[3 * POSE_FLOATS + ROT_OFFSET]);
+        _MM_TRANSPOSE4_PS(b0, b1, b2, b3);
+
+        // negate b wherever it is more than 90 degrees from a, so we take the short way around
+        __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a0, b0), _mm_mul_ps(a1, b1)),
+                                _mm_add_ps(_mm_mul_ps(a2, b2), _mm_mul_ps(a3, b3)));
+        __m128 flip = _mm_and_ps(_mm_cmplt_ps(dot, zero), signBit);
+        b0 = _mm_xor_ps(b0, flip);
+        b1 = _mm_xor_ps(b1, flip);
+        b2 = _mm_xor_ps(b2, flip);
+        b3 = _mm_xor_ps(b3, flip);
+
+        __m128 r0 = _mm_add_ps(_mm_mul_ps(a0, oneMinusAlpha), _mm_mul_ps(b0, alpha));
+        __m128 r1 = _mm_add_ps(_mm_mul_ps(a1, oneMinusAlpha), _mm_mul_ps(b1, alpha));
+        __m128 r2 = _mm_add_ps(_mm_mul_ps(a2, oneMinusAlpha), _mm_mul_ps(b2, alpha));
+        __m128 r3 = _mm_add_ps(_mm_mul_ps(a3, oneMinusAlpha), _mm_mul_ps(b3, alpha));
+
+        __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(r0, r0), _mm_mul_ps(r1, r1)),
+                                               _mm_add_ps(_mm_mul_ps(r2, r2), _mm_mul_ps(r3, r3))));
+        r0 = _mm_div_ps(r0, length);
+        r1 = _mm_div_ps(r1, length);
+        r2 = _mm_div_ps(r2, length);
+        r3 = _mm_div_ps(r3, length);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+        // The scale is followed by the rotation, and the translation by the next pose (or nothing), so the scale is
+        // lerped as a whole register starting at the pose and the translation as one ending at the pose's last
+        // float.  The extra lane lands on a rotation component, which is stored over afterwards.  Everything this
+        // pose needs from a and b has been loaded by then, so result may be the same array as a or b.
+        float alphaLanes[4];
+        _mm_storeu_ps(alphaLanes, alpha);
+        for (int k = 0; k < 4; k++) {
+            const float* ka = &pa[k * POSE_FLOATS];
+            const float* kb = &pb[k * POSE_FLOATS];
+            float* kr = &pr[k * POSE_FLOATS];
+            __m128 kAlpha = _mm_set1_ps(alphaLanes[k]);
+            __m128 kOneMinusAlpha = _mm_sub_ps(one, kAlpha);
+            __m128 scale = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&ka[0]), kOneMinusAlpha), _mm_mul_ps(_mm_loadu_ps(&kb[0]), kAlpha));
+            __m128 trans = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&ka[TRANS_OFFSET - 1]), kOneMinusAlpha),
+                                      _mm_mul_ps(_mm_loadu_ps(&kb[TRANS_OFFSET - 1]), kAlpha));
+            _mm_storeu_ps(&kr[0], scale);
+            _mm_storeu_ps(&kr[TRANS_OFFSET - 1], trans);
         }
 
-        result[i].scale() = lerp(aPose.scale(), bPose.scale(), alpha);
-        result[i].rot() = safeLerp(aPose.rot(), bPose.rot(), alpha);
-        result[i].trans() = lerp(aPose.trans(), bPose.trans(), alpha);
+        _mm_storeu_ps(&pr[0 * POSE_FLOATS + ROT_OFFSET], r0);
+        _mm_storeu_ps(&pr[1 * POSE_FLOATS + ROT_OFFSET], r1);
+        _mm_storeu_ps(&pr[2 * POSE_FLOATS + ROT_OFFSET], r2);
+        _mm_storeu_ps(&pr[3 * POSE_FLOATS + ROT_OFFSET], r3);
     }
+
+    // remainder
+    blend_ref(&a[i * POSE_FLOATS], &b[i * POSE_FLOATS], &alphas[i * alphaStride], alphaStride, &result[i * POSE_FLOATS], numPoses - i);
+}
+
+//
+// Runtime CPU dispatch
+//
+
+#include "CPUDetect.h"
+
+void blend_AVX2(const float* a, const float* b, const float* alphas, int alphaStride, float* result, int numPoses);
+
+static void blendPoses(const float* a, const float* b, const float* alphas, int alphaStride, float* result, int numPoses) {
+    static auto f = cpuSupportsAVX2() ? blend_AVX2 : blend_SSE2;
+    (*f)(a, b, alphas, alphaStride, result, numPoses);  // dispatch
+}
+
+#else   // portable reference code
+
+static auto& blendPoses = blend_ref;
+
+#endif
+
+void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+    blendPoses((const float*)a, (const float*)b, &alpha, 0, (float*)result, (int)numPoses);
+}
+
+void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, const float* alphas, AnimPose* result) {
+    blendPoses((const float*)a, (const float*)b, alphas, 1, (float*)result, (int)numPoses);
 }
 
 glm::quat averageQuats(size_t numQuats, const glm::quat* quats) {
@@ -385,6 +385,43 @@ float Rig::getIKErrorOnLastSolve() const {
     return result;
 }
 
+int Rig::getIKIterationsOnLastSolve() const {
+    int result = 0;
+
+    if (_animNode) {
+        _animNode->traverse([&](AnimNode::Pointer node) {
+            auto ikNode = std::dynamic_pointer_cast<AnimInverseKinematics>(node);
+            if (ikNode) {
+                result = ikNode->getNumLoopsOnLastSolve();
+            }
+            return true;
+        });
+    }
+    return result;
+}
+
+QVariantMap Rig::getIKChainErrorsOnLastSolve() const {
+    QVariantMap result;
+
+    if (_animNode && _animSkeleton) {
+        _animNode->traverse([&](AnimNode::Pointer node) {
+            auto ikNode = std::dynamic_pointer_cast<AnimInverseKinematics>(node);
+            if (ikNode) {
+                for (auto& chainError : ikNode->getChainErrorsOnLastSolve()) {
+                    if (chainError.jointIndex >= 0) {
+                        QVariantMap errors;
+                        errors["position"] = chainError.position;
+                        errors["rotation"] = chainError.rotation;
+                        result[_animSkeleton->getJointName(chainError.jointIndex)] = errors;
+                    }
+                }
+            }
+            return true;
+        });
+    }
+    return result;
+}
+
 int Rig::getJointParentIndex(int childIndex) const {
     if (_animSkeleton && isIndexValid(childIndex)) {
         return _animSkeleton->getParentIndex(childIndex);
@@ -17,6 +17,7 @@
 #include <QObject>
 #include <QMutex>
 #include <QScriptValue>
+#include <QVariant>
 #include <vector>
 #include <JointData.h>
 #include <QReadWriteLock>
@@ -128,6 +129,8 @@ public:
     float getMaxHipsOffsetLength() const;
 
     float getIKErrorOnLastSolve() const;
+    int getIKIterationsOnLastSolve() const;
+    QVariantMap getIKChainErrorsOnLastSolve() const;
 
     int getJointParentIndex(int childIndex) const;
 
@@ -0,0 +1,142 @@
+//
+//  AnimUtil_avx2.cpp
+//  libraries/animation/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifdef __AVX2__
+
+#include <assert.h>
+#include <immintrin.h>
+
+// packed AnimPose layout, see AnimUtil.cpp
+static const int POSE_FLOATS = 10;
+static const int ROT_OFFSET = 3;
+static const int TRANS_OFFSET = 7;
+
+// two 128-bit loads, pose k in the low lane and pose k + 4 in the high lane
+static inline __m256 loadRotPair(const float* poses, int k) {
+    __m128 lo = _mm_loadu_ps(&poses[k * POSE_FLOATS + ROT_OFFSET]);
+    __m128 hi = _mm_loadu_ps(&poses[(k + 4) * POSE_FLOATS + ROT_OFFSET]);
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+}
+
+static inline void storeRotPair(float* poses, int k, __m256 rot) {
+    _mm_storeu_ps(&poses[k * POSE_FLOATS + ROT_OFFSET], _mm256_castps256_ps128(rot));
+    _mm_storeu_ps(&poses[(k + 4) * POSE_FLOATS + ROT_OFFSET], _mm256_extractf128_ps(rot, 1));
+}
+
+// _MM_TRANSPOSE4_PS within each 128-bit lane
+static inline void transpose4x4x2(__m256& r0, __m256& r1, __m256& r2, __m256& r3) {
+    __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+    __m256 t1 = _mm256_unpacklo_ps(r2, r3);
+    __m256 t2 = _mm256_unpackhi_ps(r0, r1);
+    __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+    r0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+    r1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+    r2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    r3 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+// Eight poses at a time, otherwise the same as blend_SSE2().
+void blend_AVX2(const float* a, const float* b, const float* alphas, int alphaStride, float* result, int numPoses) {
+
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+
+    int i = 0;
+    for (; i + 8 <= numPoses; i += 8) {
+
+        const float* pa = &a[i * POSE_FLOATS];
+        const float* pb = &b[i * POSE_FLOATS];
+        float* pr = &result[i * POSE_FLOATS];
+
+        // lanes are ordered 0, 1, 2, 3 | 4, 5, 6, 7 after the transpose, the same as the alphas
+        __m256 alpha = alphaStride ? _mm256_loadu_ps(&alphas[i]) : _mm256_set1_ps(alphas[0]);
+        __m256 oneMinusAlpha = _mm256_sub_ps(one, alpha);
+
+        __m256 a0 = loadRotPair(pa, 0);
+        __m256 a1 = loadRotPair(pa, 1);
+        __m256 a2 = loadRotPair(pa, 2);
+        __m256 a3 = loadRotPair(pa, 3);
+        transpose4x4x2(a0, a1, a2, a3);
+
+        __m256 b0 = loadRotPair(pb, 0);
+        __m256 b1 = loadRotPair(pb, 1);
+        __m256 b2 = loadRotPair(pb, 2);
+        __m256 b3 = loadRotPair(pb, 3);
+        transpose4x4x2(b0, b1, b2, b3);
+
+        __m256 dot = _mm256_fmadd_ps(a3, b3, _mm256_fmadd_ps(a2, b2, _mm256_fmadd_ps(a1, b1, _mm256_mul_ps(a0, b0))));
+        __m256 flip = _mm256_and_ps(_mm256_cmp_ps(dot, zero, _CMP_LT_OQ), signBit);
+        b0 = _mm256_xor_ps(b0, flip);
+        b1 = _mm256_xor_ps(b1, flip);
+        b2 = _mm256_xor_ps(b2, flip);
+        b3 = _mm256_xor_ps(b3, flip);
+
+        __m256 r0 = _mm256_fmadd_ps(b0, alpha, _mm256_mul_ps(a0, oneMinusAlpha));
+        __m256 r1 = _mm256_fmadd_ps(b1, alpha, _mm256_mul_ps(a1, oneMinusAlpha));
+        __m256 r2 = _mm256_fmadd_ps(b2, alpha, _mm256_mul_ps(a2, oneMinusAlpha));
+        __m256 r3 = _mm256_fmadd_ps(b3, alpha, _mm256_mul_ps(a3, oneMinusAlpha));
+
+        __m256 length = _mm256_sqrt_ps(_mm256_fmadd_ps(r3, r3, _mm256_fmadd_ps(r2, r2, _mm256_fmadd_ps(r1, r1, _mm256_mul_ps(r0, r0)))));
+        r0 = _mm256_div_ps(r0, length);
+        r1 = _mm256_div_ps(r1, length);
+        r2 = _mm256_div_ps(r2, length);
+        r3 = _mm256_div_ps(r3, length);
+        transpose4x4x2(r0, r1, r2, r3);
+
+        // scale and translation, see blend_SSE2()
+        float alphaLanes[8];
+        _mm256_storeu_ps(alphaLanes, alpha);
+        for (int k = 0; k < 8; k++) {
+            const float* ka = &pa[k * POSE_FLOATS];
+            const float* kb = &pb[k * POSE_FLOATS];
+            float* kr = &pr[k * POSE_FLOATS];
+            __m128 kAlpha = _mm_set1_ps(alphaLanes[k]);
+            __m128 kOneMinusAlpha = _mm_sub_ps(_mm256_castps256_ps128(one), kAlpha);
+            __m128 scale = _mm_fmadd_ps(_mm_loadu_ps(&kb[0]), kAlpha, _mm_mul_ps(_mm_loadu_ps(&ka[0]), kOneMinusAlpha));
+            __m128 trans = _mm_fmadd_ps(_mm_loadu_ps(&kb[TRANS_OFFSET - 1]), kAlpha,
+                                        _mm_mul_ps(_mm_loadu_ps(&ka[TRANS_OFFSET - 1]), kOneMinusAlpha));
+            _mm_storeu_ps(&kr[0], scale);
+            _mm_storeu_ps(&kr[TRANS_OFFSET - 1], trans);
+        }
+
+        storeRotPair(pr, 0, r0);
+        storeRotPair(pr, 1, r1);
+        storeRotPair(pr, 2, r2);
+        storeRotPair(pr, 3, r3);
+    }
+
+    // remainder, one pose at a time with 128-bit math
+    for (; i < numPoses; i++) {
+
+        const float* pa = &a[i * POSE_FLOATS];
+        const float* pb = &b[i * POSE_FLOATS];
+        float* pr = &result[i * POSE_FLOATS];
+
+        __m128 alpha = _mm_set1_ps(alphas[i * alphaStride]);
+        __m128 oneMinusAlpha = _mm_sub_ps(_mm_set1_ps(1.0f), alpha);
+
+        __m128 qa = _mm_loadu_ps(&pa[ROT_OFFSET]);
+        __m128 qb = _mm_loadu_ps(&pb[ROT_OFFSET]);
+        __m128 dot = _mm_dp_ps(qa, qb, 0xff);
+        qb = _mm_xor_ps(qb, _mm_and_ps(_mm_cmplt_ps(dot, _mm_setzero_ps()), _mm_set1_ps(-0.0f)));
+        __m128 q = _mm_fmadd_ps(qb, alpha, _mm_mul_ps(qa, oneMinusAlpha));
+        q = _mm_div_ps(q, _mm_sqrt_ps(_mm_dp_ps(q, q, 0xff)));
+
+        __m128 scale = _mm_fmadd_ps(_mm_loadu_ps(&pb[0]), alpha, _mm_mul_ps(_mm_loadu_ps(&pa[0]), oneMinusAlpha));
+        __m128 trans = _mm_fmadd_ps(_mm_loadu_ps(&pb[TRANS_OFFSET - 1]), alpha,
+                                    _mm_mul_ps(_mm_loadu_ps(&pa[TRANS_OFFSET - 1]), oneMinusAlpha));
+        _mm_storeu_ps(&pr[0], scale);
+        _mm_storeu_ps(&pr[TRANS_OFFSET - 1], trans);
+        _mm_storeu_ps(&pr[ROT_OFFSET], q);
+    }
+}
+
+#endif
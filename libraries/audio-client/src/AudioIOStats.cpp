@@ -145,11 +145,15 @@ void AudioStreamStatsInterface::updateStream(const AudioStreamStats& stats) {
     framesAvailableAvg(stats._framesAvailableAverage);
 
     unplayedMsMax(stats._unplayedMs);
+    targetDelayMs(stats._targetDelayMs);
 
     starveCount(stats._starveCount);
     lastStarveDurationCount(stats._consecutiveNotMixedCount);
     dropCount(stats._framesDropped);
     overflowCount(stats._overflowCount);
+    concealedCount(stats._framesConcealed);
+    concealedRateWindow(stats._concealedRate);
+    stretchedRateWindow(stats._stretchedRate);
 
     timegapMsMax(stats._timeGapMax / USECS_PER_MSEC);
     timegapMsAvg(stats._timeGapAverage / USECS_PER_MSEC);
@@ -47,11 +47,15 @@ class AudioStreamStatsInterface : public QObject {
     AUDIO_PROPERTY(int, framesAvailable)
     AUDIO_PROPERTY(int, framesAvailableAvg)
     AUDIO_PROPERTY(float, unplayedMsMax)
+    AUDIO_PROPERTY(int, targetDelayMs)
 
     AUDIO_PROPERTY(int, starveCount)
     AUDIO_PROPERTY(int, lastStarveDurationCount)
     AUDIO_PROPERTY(int, dropCount)
     AUDIO_PROPERTY(int, overflowCount)
+    AUDIO_PROPERTY(int, concealedCount)
+    AUDIO_PROPERTY(float, concealedRateWindow)
+    AUDIO_PROPERTY(float, stretchedRateWindow)
 
     AUDIO_PROPERTY(quint64, timegapMsMax)
     AUDIO_PROPERTY(quint64, timegapMsAvg)
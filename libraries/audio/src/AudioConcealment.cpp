@@ -0,0 +1,170 @@
+//
+//  AudioConcealment.cpp
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioConcealment.h"
+
+#include <algorithm>
+#include <string.h>
+#include <math.h>
+
+#include "AudioConstants.h"
+
+// pitch periods from 400Hz down to 100Hz, matched over the last 10ms received
+static const int MIN_PITCH_LAG = AudioConstants::SAMPLE_RATE / 400;
+static const int MAX_PITCH_LAG = AudioConstants::SAMPLE_RATE / 100;
+static const int HISTORY_FRAMES = 2 * MAX_PITCH_LAG;
+
+// below this there is no clear pitch, repeating the longest period sounds least buzzy
+static const float MIN_PITCH_CORRELATION = 0.3f;
+
+// same fade as the mixer's repeated frames, see calculateRepeatedFrameFadeFactor()
+static const int NO_FADE_FRAMES = AudioConstants::SAMPLE_RATE / 50;     // 20ms
+static const float FADE_SECS = 0.32f;
+static const float MIN_GAIN = 1.0f / 32768.0f;
+static const float FADE_PER_FRAME = expf(logf(MIN_GAIN) / (FADE_SECS * AudioConstants::SAMPLE_RATE));
+
+// cross-fade from the concealed audio into the first frame received after a loss
+static const int OVERLAP_FRAMES = AudioConstants::SAMPLE_RATE / 400;    // 2.5ms
+static const int MAX_CHANNELS = AudioConstants::AMBISONIC;
+
+void AudioConcealment::reset() {
+    std::fill(_history.begin(), _history.end(), 0);
+    _hasHistory = false;
+    _numConcealedFrames = 0;
+}
+
+void AudioConcealment::receivedFrame(int16_t* samples, int numFrames, int numChannels) {
+    if (numChannels != _numChannels) {
+        _numChannels = numChannels;
+        _history.assign(HISTORY_FRAMES * numChannels, 0);
+        _hasHistory = false;
+        _numConcealedFrames = 0;
+    }
+
+    if (_numConcealedFrames > 0 && numChannels <= MAX_CHANNELS) {
+        int16_t concealed[OVERLAP_FRAMES * MAX_CHANNELS];
+        int overlap = std::min(numFrames, OVERLAP_FRAMES);
+        renderPeriod(concealed, overlap, false);
+
+        float step = 1.0f / overlap;
+        for (int i = 0; i < overlap; i++) {
+            float weight = (i + 0.5f) * step;
+            for (int j = 0; j < numChannels; j++) {
+                int k = i * numChannels + j;
+                samples[k] = (int16_t)lrintf(concealed[k] + weight * (samples[k] - concealed[k]));
+            }
+        }
+    }
+    _numConcealedFrames = 0;
+
+    // keep the last HISTORY_FRAMES received
+    if (numFrames >= HISTORY_FRAMES) {
+        memcpy(_history.data(), samples + (numFrames - HISTORY_FRAMES) * numChannels, _history.size() * sizeof(int16_t));
+    } else {
+        int keptSamples = (HISTORY_FRAMES - numFrames) * numChannels;
+        memmove(_history.data(), _history.data() + numFrames * numChannels, keptSamples * sizeof(int16_t));
+        memcpy(_history.data() + keptSamples, samples, numFrames * numChannels * sizeof(int16_t));
+    }
+    _hasHistory = true;
+}
+
+bool AudioConcealment::concealFrame(int16_t* samples, int numFrames, int numChannels) {
+    if (numChannels != _numChannels) {
+        // nothing received in this format yet
+        memset(samples, 0, numFrames * numChannels * sizeof(int16_t));
+        return false;
+    }
+
+    if (_numConcealedFrames == 0) {
+        // a new loss, pick up where the audio received left off
+        findPitchLag();
+        _phase = 0;
+        _gain = 1.0f;
+        _framesConcealed = 0;
+    }
+    ++_numConcealedFrames;
+
+    if (_pitchLag == 0 || _gain < MIN_GAIN) {
+        memset(samples, 0, numFrames * numChannels * sizeof(int16_t));
+        return false;
+    }
+
+    renderPeriod(samples, numFrames, true);
+    return true;
+}
+
+void AudioConcealment::findPitchLag() {
+    _pitchLag = 0;
+    if (!_hasHistory) {
+        return;
+    }
+
+    // match the last MAX_PITCH_LAG frames received against the audio one lag before them, on the sum of all channels
+    float mono[HISTORY_FRAMES];
+    for (int i = 0; i < HISTORY_FRAMES; i++) {
+        float sum = 0.0f;
+        for (int j = 0; j < _numChannels; j++) {
+            sum += (float)_history[i * _numChannels + j];
+        }
+        mono[i] = sum;
+    }
+
+    const float* tail = mono + HISTORY_FRAMES - MAX_PITCH_LAG;
+    float tailEnergy = 0.0f;
+    for (int i = 0; i < MAX_PITCH_LAG; i++) {
+        tailEnergy += tail[i] * tail[i];
+    }
+
+    _pitchLag = MAX_PITCH_LAG;
+    float bestCorrelation = MIN_PITCH_CORRELATION;
+    for (int lag = MIN_PITCH_LAG; lag <= MAX_PITCH_LAG; lag++) {
+        const float* head = tail - lag;
+        float dot = 0.0f;
+        float headEnergy = 0.0f;
+        for (int i = 0; i < MAX_PITCH_LAG; i++) {
+            dot += head[i] * tail[i];
+            headEnergy += head[i] * head[i];
+        }
+        float norm = sqrtf(headEnergy * tailEnergy);
+        if (norm > 0.0f && dot >= bestCorrelation * norm) {
+            bestCorrelation = dot / norm;
+            _pitchLag = lag;
+        }
+    }
+}
+
+void AudioConcealment::renderPeriod(int16_t* samples, int numFrames, bool advance) {
+    if (_pitchLag == 0) {
+        memset(samples, 0, numFrames * _numChannels * sizeof(int16_t));
+        return;
+    }
+
+    const int16_t* period = _history.data() + (HISTORY_FRAMES - _pitchLag) * _numChannels;
+    int phase = _phase;
+    float gain = _gain;
+
+    for (int i = 0; i < numFrames; i++) {
+        if (_framesConcealed + i >= NO_FADE_FRAMES) {
+            gain *= FADE_PER_FRAME;
+        }
+        for (int j = 0; j < _numChannels; j++) {
+            samples[i * _numChannels + j] = (int16_t)lrintf(gain * period[phase * _numChannels + j]);
+        }
+        if (++phase == _pitchLag) {
+            phase = 0;
+        }
+    }
+
+    if (advance) {
+        _phase = phase;
+        _gain = gain;
+        _framesConcealed += numFrames;
+    }
+}
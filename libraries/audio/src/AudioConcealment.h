@@ -0,0 +1,48 @@
+//
+//  AudioConcealment.h
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioConcealment_h
+#define hifi_AudioConcealment_h
+
+#include <stdint.h>
+#include <vector>
+
+// Codec independent packet loss concealment for network rate audio.
+// Lost frames are filled by repeating the last pitch period received, fading out after the first 20ms, and the frame
+// that ends the loss is cross-faded in from the concealed audio so neither edge clicks.
+class AudioConcealment {
+public:
+    // forgets the audio received so far, so a loss right after it conceals with silence
+    void reset();
+
+    // blends a frame received right after a loss into the concealed audio, and keeps it to conceal from later
+    void receivedFrame(int16_t* samples, int numFrames, int numChannels);
+
+    // fills a frame that was lost, returns false (and a silent frame) once the concealment has faded out
+    bool concealFrame(int16_t* samples, int numFrames, int numChannels);
+
+    bool isConcealing() const { return _numConcealedFrames > 0; }
+
+private:
+    void findPitchLag();
+    void renderPeriod(int16_t* samples, int numFrames, bool advance);
+
+    std::vector<int16_t> _history;  // the last frames received, interleaved
+    int _numChannels { 0 };
+    bool _hasHistory { false };
+
+    int _pitchLag { 0 };
+    int _phase { 0 };
+    float _gain { 1.0f };
+    int _framesConcealed { 0 };     // since the loss started, for the fade
+    int _numConcealedFrames { 0 };  // calls to concealFrame() since the loss started
+};
+
+#endif // hifi_AudioConcealment_h
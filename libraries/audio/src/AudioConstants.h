@@ -43,6 +43,13 @@ namespace AudioConstants {
     
     const int MIN_SAMPLE_VALUE = std::numeric_limits<AudioSample>::min();
     const int MAX_SAMPLE_VALUE = std::numeric_limits<AudioSample>::max();
+
+    // flags packed in an InjectCachedSound packet
+    const uint8_t CACHED_SOUND_STOP = 1;
+    const uint8_t CACHED_SOUND_LOOP = 2;
+    const uint8_t CACHED_SOUND_STEREO = 4;
+    const uint8_t CACHED_SOUND_IGNORE_PENUMBRA = 8;
+    const uint8_t CACHED_SOUND_LOOPBACK = 16;
 }
 
 
@@ -15,6 +15,7 @@
 #include <QtCore/QDataStream>
 
 #include <NodeList.h>
+#include <ResourceManager.h>
 #include <udt/PacketHeaders.h>
 #include <SharedUtil.h>
 #include <UUID.h>
@@ -41,6 +42,7 @@ AudioInjectorState& operator|= (AudioInjectorState& lhs, AudioInjectorState rhs)
 AudioInjector::AudioInjector(const Sound& sound, const AudioInjectorOptions& injectorOptions) :
     AudioInjector(sound.getByteArray(), injectorOptions)
 {
+    _soundURL = sound.getURL();
 }
 
 AudioInjector::AudioInjector(const QByteArray& audioData, const AudioInjectorOptions& injectorOptions) :
@@ -62,9 +64,12 @@ void AudioInjector::setOptions(const AudioInjectorOptions& options) {
     // we need to copy it from existing options just in case.
     bool currentlyStereo = _options.stereo;
     bool currentlyAmbisonic = _options.ambisonic;
+    // the mixer cache is chosen when the injector starts, it can't be switched mid-sound
+    bool currentlyCachedOnMixer = _options.cachedOnMixer;
     _options = options;
     _options.stereo = currentlyStereo;
     _options.ambisonic = currentlyAmbisonic;
+    _options.cachedOnMixer = currentlyCachedOnMixer;
 }
 
 void AudioInjector::finishNetworkInjection() {
@@ -85,6 +90,11 @@ void AudioInjector::finishLocalInjection() {
 }
 
 void AudioInjector::finish() {
+    if (isCachedOnMixer() && _hasSentFirstFrame && !stateHas(AudioInjectorState::NetworkInjectionFinished)) {
+        // otherwise the mixer keeps playing a looped sound until our updates time out
+        sendCachedSoundPacket(true);
+    }
+
     _state |= AudioInjectorState::Finished;
 
     emit finished();
@@ -117,6 +127,9 @@ void AudioInjector::restart() {
     }
     _hasSentFirstFrame = false;
 
+    // tells the mixer to seek back to the start if it plays the sound from its cache
+    ++_cachedSoundGeneration;
+
     // check our state to decide if we need extra handling for the restart request
     if (stateHas(AudioInjectorState::Finished)) {
         if (!inject(&AudioInjectorManager::restartFinishedInjector)) {
@@ -191,6 +204,10 @@ const uchar MAX_INJECTOR_VOLUME = packFloatGainToByte(1.0f);
 static const int64_t NEXT_FRAME_DELTA_ERROR_OR_FINISHED = -1;
 static const int64_t NEXT_FRAME_DELTA_IMMEDIATELY = 0;
 
+// how often an injector playing from the mixer's cache checks for option changes, and re-sends them regardless
+static const int64_t CACHED_SOUND_UPDATE_USECS = 5 * AudioConstants::NETWORK_FRAME_USECS;
+static const int64_t CACHED_SOUND_KEEPALIVE_USECS = USECS_PER_SECOND;
+
 qint64 writeStringToStream(const QString& string, QDataStream& stream) {
     QByteArray data = string.toUtf8();
     uint32_t length = data.length();
@@ -212,6 +229,10 @@ int64_t AudioInjector::injectNextFrame() {
         return NEXT_FRAME_DELTA_ERROR_OR_FINISHED;
     }
 
+    if (isCachedOnMixer()) {
+        return injectCachedSoundUpdate();
+    }
+
     // if we haven't setup the packet to send then do so now
     static int loopbackOptionOffset = -1;
     static int positionOptionOffset = -1;
@@ -313,13 +334,7 @@ int64_t AudioInjector::injectNextFrame() {
         totalBytesLeftToCopy = std::min(totalBytesLeftToCopy, _audioData.size() - _currentSendOffset);
     }
 
-    //  Measure the loudness of this frame
-    _loudness = 0.0f;
-    for (int i = 0; i < totalBytesLeftToCopy; i += sizeof(int16_t)) {
-        _loudness += abs(*reinterpret_cast<int16_t*>(_audioData.data() + ((_currentSendOffset + i) % _audioData.size()))) /
-            (AudioConstants::MAX_SAMPLE_VALUE / 2.0f);
-    }
-    _loudness /= (float)(totalBytesLeftToCopy/ sizeof(int16_t));
+    updateLoudness(totalBytesLeftToCopy);
 
     _currentPacket->seek(0);
 
@@ -398,6 +413,117 @@ int64_t AudioInjector::injectNextFrame() {
     return std::max(INT64_C(0), playNextFrameAt - currentTime);
 }
 
+bool AudioInjector::isCachedOnMixer() const {
+    // the mixer has to be able to fetch the sound itself, and only does so from the asset server
+    return _options.cachedOnMixer && _soundURL.isValid() && _soundURL.scheme() == URL_SCHEME_ATP;
+}
+
+void AudioInjector::updateLoudness(int numBytes) {
+    //  Measure the loudness of the next numBytes of audio
+    _loudness = 0.0f;
+    for (int i = 0; i < numBytes; i += sizeof(int16_t)) {
+        _loudness += abs(*reinterpret_cast<int16_t*>(_audioData.data() + ((_currentSendOffset + i) % _audioData.size()))) /
+            (AudioConstants::MAX_SAMPLE_VALUE / 2.0f);
+    }
+    _loudness /= (float)(numBytes / sizeof(int16_t));
+}
+
+int64_t AudioInjector::injectCachedSoundUpdate() {
+    // The mixer renders the sound out of its own cache, all we send is the sound URL and our options whenever they change.
+    // We still walk through the samples in step with the mixer so loudness, restarts and the end of the sound behave as
+    // they do for a streamed injector.
+    if (_audioData.size() == 0) {
+        qCDebug(audio) << "AudioInjector::injectCachedSoundUpdate() called with no samples to inject. Returning.";
+        return NEXT_FRAME_DELTA_ERROR_OR_FINISHED;
+    }
+
+    if (_streamIdentifier.isNull()) {
+        _streamIdentifier = QUuid::createUuid();
+    }
+
+    if (!_frameTimer) {
+        _frameTimer = std::unique_ptr<QElapsedTimer>(new QElapsedTimer);
+    }
+
+    if (!_frameTimer->isValid()) {
+        // we were just started or restarted, the mixer starts playing from the current offset
+        if (_currentSendOffset < 0 || _currentSendOffset >= _audioData.size()) {
+            _currentSendOffset = 0;
+        }
+        _startSendOffset = _currentSendOffset;
+        _frameTimer->restart();
+    }
+
+    int frameBytes = (_options.stereo ? 2 : 1) * AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL;
+    int64_t currentTime = _frameTimer->nsecsElapsed() / 1000;
+    int64_t playedOffset = _startSendOffset + (currentTime / AudioConstants::NETWORK_FRAME_USECS) * frameBytes;
+
+    if (!_options.loop && playedOffset >= _audioData.size()) {
+        // the mixer drops the stream by itself once it has played the last frame
+        finishNetworkInjection();
+        return NEXT_FRAME_DELTA_ERROR_OR_FINISHED;
+    }
+
+    _currentSendOffset = (int)(playedOffset % _audioData.size());
+    updateLoudness(std::min(frameBytes, _audioData.size()));
+
+    bool optionsChanged = _options.position != _sentOptions.position || _options.orientation != _sentOptions.orientation
+        || _options.volume != _sentOptions.volume || _options.loop != _sentOptions.loop
+        || _options.ignorePenumbra != _sentOptions.ignorePenumbra;
+
+    if (!_hasSentFirstFrame || optionsChanged || currentTime - _lastCachedSoundUpdate >= CACHED_SOUND_KEEPALIVE_USECS) {
+        sendCachedSoundPacket(false);
+        _hasSentFirstFrame = true;
+        _lastCachedSoundUpdate = currentTime;
+    }
+
+    return CACHED_SOUND_UPDATE_USECS;
+}
+
+void AudioInjector::sendCachedSoundPacket(bool stop) {
+    auto nodeList = DependencyManager::get<NodeList>();
+    SharedNodePointer audioMixer = nodeList->soloNodeOfType(NodeType::AudioMixer);
+    if (!audioMixer) {
+        return;
+    }
+
+    quint8 flags = 0;
+    if (stop) {
+        flags |= AudioConstants::CACHED_SOUND_STOP;
+    }
+    if (_options.loop) {
+        flags |= AudioConstants::CACHED_SOUND_LOOP;
+    }
+    if (_options.stereo) {
+        flags |= AudioConstants::CACHED_SOUND_STEREO;
+    }
+    if (_options.ignorePenumbra) {
+        flags |= AudioConstants::CACHED_SOUND_IGNORE_PENUMBRA;
+    }
+    if (_localAudioInterface && _localAudioInterface->shouldLoopbackInjectors()) {
+        flags |= AudioConstants::CACHED_SOUND_LOOPBACK;
+    }
+
+    // the mixer seeks to this offset when it starts the sound, or when the generation changes after a restart
+    int bytesPerFrame = (_options.stereo ? 2 : 1) * AudioConstants::SAMPLE_SIZE;
+    quint32 frameOffset = _currentSendOffset / bytesPerFrame;
+
+    // there are only a few of these a second, send them reliably so that the mixer can't miss a start or a stop
+    auto packet = NLPacket::create(PacketType::InjectCachedSound, -1, true);
+    packet->write(_streamIdentifier.toRfc4122());
+    packet->writePrimitive(flags);
+    packet->writePrimitive(_cachedSoundGeneration);
+    packet->writePrimitive(frameOffset);
+    packet->writePrimitive(_options.position);
+    packet->writePrimitive(_options.orientation);
+    packet->writePrimitive(packFloatGainToByte(_options.volume));
+    packet->writeString(_soundURL.toString());
+
+    nodeList->sendPacket(std::move(packet), *audioMixer);
+
+    _sentOptions = _options;
+}
+
 void AudioInjector::stop() {
     // trigger a call on the injector's thread to change state to finished
     QMetaObject::invokeMethod(this, "finish");
@@ -470,3 +596,12 @@ AudioInjectorPointer AudioInjector::playSound(const QByteArray& buffer, const Au
     }
     return injector;
 }
+
+AudioInjectorPointer AudioInjector::playSound(SharedSoundPointer sound, const AudioInjectorOptions options) {
+    AudioInjectorPointer injector = AudioInjectorPointer::create(*sound, options);
+
+    if (!injector->inject(&AudioInjectorManager::threadInjector)) {
+        qWarning() << "AudioInjector::playSound failed to thread injector";
+    }
+    return injector;
+}
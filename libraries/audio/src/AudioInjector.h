@@ -18,6 +18,8 @@
 #include <QtCore/QObject>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QThread>
+#include <QtCore/QUrl>
+#include <QtCore/QUuid>
 
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
@@ -76,6 +78,7 @@ public:
     static void setLocalAudioInterface(AbstractAudioInterface* audioInterface) { _localAudioInterface = audioInterface; }
     static AudioInjectorPointer playSoundAndDelete(const QByteArray& buffer, const AudioInjectorOptions options);
     static AudioInjectorPointer playSound(const QByteArray& buffer, const AudioInjectorOptions options);
+    static AudioInjectorPointer playSound(SharedSoundPointer sound, const AudioInjectorOptions options);
     static AudioInjectorPointer playSound(SharedSoundPointer sound, const float volume,
                                           const float stretchFactor, const glm::vec3 position);
 
@@ -100,6 +103,10 @@ signals:
 
 private:
     int64_t injectNextFrame();
+    int64_t injectCachedSoundUpdate();
+    void sendCachedSoundPacket(bool stop);
+    bool isCachedOnMixer() const;
+    void updateLoudness(int numBytes);
     bool inject(bool(AudioInjectorManager::*injection)(const AudioInjectorPointer&));
     bool injectLocally();
     void deleteLocalBuffer();
@@ -107,6 +114,7 @@ private:
     static AbstractAudioInterface* _localAudioInterface;
 
     QByteArray _audioData;
+    QUrl _soundURL;
     AudioInjectorOptions _options;
     AudioInjectorState _state { AudioInjectorState::NotFinished };
     bool _hasSentFirstFrame { false };
@@ -119,6 +127,13 @@ private:
     std::unique_ptr<QElapsedTimer> _frameTimer { nullptr };
     quint16 _outgoingSequenceNumber { 0 };
 
+    // when the mixer plays our sound from its cache we only send it the options, see injectCachedSoundUpdate()
+    QUuid _streamIdentifier;
+    AudioInjectorOptions _sentOptions;
+    quint16 _cachedSoundGeneration { 0 };
+    int _startSendOffset { 0 };
+    int64_t _lastCachedSoundUpdate { 0 };
+
     // when the injector is local, we need this
     AudioHRTF _localHRTF;
     AudioFOA _localFOA;
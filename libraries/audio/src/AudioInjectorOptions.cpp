@@ -26,7 +26,8 @@ AudioInjectorOptions::AudioInjectorOptions() :
     ambisonic(false),
     ignorePenumbra(false),
     localOnly(false),
-    secondOffset(0.0f)
+    secondOffset(0.0f),
+    cachedOnMixer(false)
 {
 
 }
@@ -40,6 +41,7 @@ QScriptValue injectorOptionsToScriptValue(QScriptEngine* engine, const AudioInje
     obj.setProperty("ignorePenumbra", injectorOptions.ignorePenumbra);
     obj.setProperty("localOnly", injectorOptions.localOnly);
     obj.setProperty("secondOffset", injectorOptions.secondOffset);
+    obj.setProperty("cachedOnMixer", injectorOptions.cachedOnMixer);
     return obj;
 }
 
@@ -87,6 +89,12 @@ void injectorOptionsFromScriptValue(const QScriptValue& object, AudioInjectorOpt
             } else {
                 qCWarning(audio) << "Audio injector options: secondOffset is not a number";
             }
+        } else if (it.name() == "cachedOnMixer") {
+            if (it.value().isBool()) {
+                injectorOptions.cachedOnMixer = it.value().toBool();
+            } else {
+                qCWarning(audio) << "Audio injector options: cachedOnMixer is not a boolean";
+            }
         } else {
             qCWarning(audio) << "Unknown audio injector option:" << it.name();
         }
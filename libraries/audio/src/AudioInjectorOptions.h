@@ -29,6 +29,8 @@ public:
     bool ignorePenumbra;
     bool localOnly;
     float secondOffset;
+    // play a sound from its URL out of the audio mixer's sound cache instead of streaming its samples
+    bool cachedOnMixer;
 };
 
 Q_DECLARE_METATYPE(AudioInjectorOptions);
@@ -0,0 +1,136 @@
+//
+//  AudioJitterEstimator.cpp
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioJitterEstimator.h"
+
+#include <algorithm>
+
+#include "AudioConstants.h"
+
+// the fastest packet of the last 5s is the one that counts as on time
+static const int64_t FASTEST_WINDOW_PACKETS = 5 * 100;
+
+// 1ms bins up to half a second, anything later than that lands in the last bin
+static const int HISTOGRAM_BIN_USECS = 1000;
+static const int NUM_HISTOGRAM_BINS = 500;
+
+// each packet weighs this much less than the next one, so the histogram covers about the last 10s
+static const float HISTOGRAM_FORGET_FACTOR = 0.999f;
+static const float HISTOGRAM_MAX_WEIGHT = 1.0e20f;
+
+static const float TARGET_PERCENTILE = 0.97f;
+
+// late packets less than 100ms apart are one event (a stall, then a burst), when an event follows another
+// within 10s its worst delay is held as the target for 10s
+static const uint64_t LATE_EVENT_GAP_USECS = 100 * 1000;
+static const uint64_t PEAK_RECUR_USECS = 10 * 1000 * 1000;
+static const uint64_t PEAK_HOLD_USECS = 10 * 1000 * 1000;
+
+AudioJitterEstimator::AudioJitterEstimator() :
+    _histogram(NUM_HISTOGRAM_BINS, 0.0f) {}
+
+void AudioJitterEstimator::reset() {
+    _hasSequence = false;
+    _lastSequence = 0;
+    _unwrappedSequence = 0;
+    _fastestPackets.clear();
+    std::fill(_histogram.begin(), _histogram.end(), 0.0f);
+    _histogramWeight = 1.0f;
+    _histogramTotal = 0.0f;
+    _hasLatePacket = false;
+    _lastLateArrivalUsecs = 0;
+    _lateEventUsecs = 0;
+    _peakDelayUsecs = 0;
+    _peakArrivalUsecs = 0;
+    _targetDelayUsecs = 0;
+}
+
+int AudioJitterEstimator::packetArrived(uint16_t sequence, uint64_t arrivalUsecs) {
+    if (!_hasSequence) {
+        _hasSequence = true;
+        _lastSequence = sequence;
+    }
+
+    // late packets are measured too, they are what the buffer has to wait for
+    int16_t sequenceDiff = (int16_t)(sequence - _lastSequence);
+    int64_t packetSequence = _unwrappedSequence + sequenceDiff;
+    if (sequenceDiff > 0) {
+        _lastSequence = sequence;
+        _unwrappedSequence = packetSequence;
+    }
+
+    // when the packet arrived on the sender's clock, give or take the offset between the two clocks
+    int64_t delay = (int64_t)arrivalUsecs - packetSequence * AudioConstants::NETWORK_FRAME_USECS;
+
+    // keep the packets that may still become the fastest in the window, with increasing delays
+    while (!_fastestPackets.empty() && _fastestPackets.back().second >= delay) {
+        _fastestPackets.pop_back();
+    }
+    _fastestPackets.emplace_back(packetSequence, delay);
+    while (_fastestPackets.size() > 1 && _fastestPackets.front().first <= _unwrappedSequence - FASTEST_WINDOW_PACKETS) {
+        _fastestPackets.pop_front();
+    }
+
+    int64_t maxDelayUsecs = (int64_t)NUM_HISTOGRAM_BINS * HISTOGRAM_BIN_USECS;
+    int delayUsecs = (int)std::min(delay - _fastestPackets.front().second, maxDelayUsecs);
+
+    // rather than decay every bin, new packets weigh more and everything is scaled back once in a while
+    _histogramWeight /= HISTOGRAM_FORGET_FACTOR;
+    int bin = std::min(delayUsecs / HISTOGRAM_BIN_USECS, NUM_HISTOGRAM_BINS - 1);
+    _histogram[bin] += _histogramWeight;
+    _histogramTotal += _histogramWeight;
+    if (_histogramWeight > HISTOGRAM_MAX_WEIGHT) {
+        for (auto& count : _histogram) {
+            count /= _histogramWeight;
+        }
+        _histogramTotal /= _histogramWeight;
+        _histogramWeight = 1.0f;
+    }
+
+    updateTargetDelay(delayUsecs, arrivalUsecs);
+
+    return delayUsecs;
+}
+
+void AudioJitterEstimator::updateTargetDelay(int delayUsecs, uint64_t arrivalUsecs) {
+    float percentileCount = TARGET_PERCENTILE * _histogramTotal;
+    float count = 0.0f;
+    int bin = 0;
+    for (; bin < NUM_HISTOGRAM_BINS - 1; bin++) {
+        count += _histogram[bin];
+        if (count >= percentileCount) {
+            break;
+        }
+    }
+    // the upper edge of the bin, so the packets in it are on time
+    int percentileDelayUsecs = (bin + 1) * HISTOGRAM_BIN_USECS;
+
+    if (delayUsecs > percentileDelayUsecs) {
+        bool isHoldingPeak = _peakDelayUsecs > 0 && arrivalUsecs - _peakArrivalUsecs < PEAK_HOLD_USECS;
+        bool isNewEvent = !_hasLatePacket || arrivalUsecs - _lastLateArrivalUsecs > LATE_EVENT_GAP_USECS;
+        if (isNewEvent) {
+            if (_hasLatePacket && arrivalUsecs - _lateEventUsecs < PEAK_RECUR_USECS) {
+                // it happened again, hold on to it
+                _peakDelayUsecs = isHoldingPeak ? std::max(_peakDelayUsecs, delayUsecs) : delayUsecs;
+                _peakArrivalUsecs = arrivalUsecs;
+            }
+            _lateEventUsecs = arrivalUsecs;
+        } else if (isHoldingPeak) {
+            // the rest of a burst of late packets
+            _peakDelayUsecs = std::max(_peakDelayUsecs, delayUsecs);
+            _peakArrivalUsecs = arrivalUsecs;
+        }
+        _hasLatePacket = true;
+        _lastLateArrivalUsecs = arrivalUsecs;
+    }
+
+    bool isHoldingPeak = _peakDelayUsecs > 0 && arrivalUsecs - _peakArrivalUsecs < PEAK_HOLD_USECS;
+    _targetDelayUsecs = isHoldingPeak ? std::max(percentileDelayUsecs, _peakDelayUsecs) : percentileDelayUsecs;
+}
@@ -0,0 +1,58 @@
+//
+//  AudioJitterEstimator.h
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioJitterEstimator_h
+#define hifi_AudioJitterEstimator_h
+
+#include <stdint.h>
+#include <deque>
+#include <vector>
+
+// Estimates how much delay a jitter buffer needs from the arrival times of a stream's packets.
+// Each packet's delay is measured against the fastest packet of the last few seconds, using its sequence number to
+// tell when it was sent. The target is a high percentile of a histogram of those delays that slowly forgets old
+// packets, held up for a while by any packet later than that so a burst of late packets is covered right away.
+class AudioJitterEstimator {
+public:
+    AudioJitterEstimator();
+
+    void reset();
+
+    // takes the arrival time of a packet (on any clock, in usecs) and returns how late it was
+    int packetArrived(uint16_t sequence, uint64_t arrivalUsecs);
+
+    // the delay that plays all but the latest few percent of packets on time
+    int getTargetDelayUsecs() const { return _targetDelayUsecs; }
+
+private:
+    void updateTargetDelay(int delayUsecs, uint64_t arrivalUsecs);
+
+    bool _hasSequence { false };
+    uint16_t _lastSequence { 0 };
+    int64_t _unwrappedSequence { 0 };
+
+    // (unwrapped sequence, delay on the sender's clock) of the packets that may still be the fastest in the window
+    std::deque<std::pair<int64_t, int64_t>> _fastestPackets;
+
+    std::vector<float> _histogram;
+    float _histogramWeight { 1.0f };
+    float _histogramTotal { 0.0f };
+
+    // packets later than the percentile, held up as the target once they recur
+    bool _hasLatePacket { false };
+    uint64_t _lastLateArrivalUsecs { 0 };
+    uint64_t _lateEventUsecs { 0 };
+    int _peakDelayUsecs { 0 };
+    uint64_t _peakArrivalUsecs { 0 };
+
+    int _targetDelayUsecs { 0 };
+};
+
+#endif // hifi_AudioJitterEstimator_h
@@ -7,6 +7,7 @@
 //
 
 #include <assert.h>
+#include <string.h>
 
 #include "AudioDynamics.h"
 #include "AudioLimiter.h"
@@ -42,7 +43,8 @@ public:
 
     int32_t envelope(int32_t attn);
 
-    virtual void process(float* input, int16_t* output, int numFrames) = 0;
+    // returns true if any input sample was non-zero
+    virtual bool process(float* input, int16_t* output, int numFrames) = 0;
 };
 
 LimiterImpl::LimiterImpl(int sampleRate) {
@@ -191,178 +193,333 @@ int32_t LimiterImpl::envelope(int32_t attn) {
 }
 
 //
-// Limiter (mono)
+// Limiter block processing
 //
-template<int N>
-class LimiterMono : public LimiterImpl {
+// The audio is processed in blocks, in separate passes, so that the peak detection, the conversions
+// to and from the log2 domain, and the gain are vectorized around the envelope and the lowpass filter,
+// which are serial.
+//
+static const int LIMITER_BLOCK = 256;
 
-    MinFilter<N> _filter;
-    MonoDelay<N> _delay;
+// compute limiter attenuation in log2 domain
+static void peakAttn_ref(float* peak, int32_t* attn, int32_t threshold, int numFrames) {
 
-public:
-    LimiterMono(int sampleRate) : LimiterImpl(sampleRate) {}
+    for (int n = 0; n < numFrames; n++) {
 
-    void process(float* input, int16_t* output, int numFrames) override;
-};
+        // convert to log2 domain
+        int32_t x = peaklog2(&peak[n]);
+
+        attn[n] = MAX(threshold - x, 0);
+    }
+}
 
-template<int N>
-void LimiterMono<N>::process(float* input, int16_t* output, int numFrames) {
+// convert from log2 domain
+static void attnExp2_ref(int32_t* attn, int numFrames) {
 
     for (int n = 0; n < numFrames; n++) {
+        attn[n] = fixexp2(attn[n]);
+    }
+}
+
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
 
-        // peak detect and convert to log2 domain
-        int32_t peak = peaklog2(&input[n]);
+#include <emmintrin.h>
 
-        // compute limiter attenuation
-        int32_t attn = MAX(_threshold - peak, 0);
+// peak detect across channels, returns true if any input sample was non-zero
+static bool peakDetect_SSE(const float* input, float* peak, int numFrames, int numChannels) {
 
-        // apply envelope
-        attn = envelope(attn);
+    const __m128 FABS_MASK = _mm_castsi128_ps(_mm_set1_epi32(IEEE754_FABS_MASK));
+    const __m128 ZERO = _mm_setzero_ps();
+    __m128 nonzero = _mm_setzero_ps();
 
-        // convert from log2 domain
-        attn = fixexp2(attn);
+    int n = 0;
+    if (numChannels == 1) {
 
-        // lowpass filter
-        attn = _filter.process(attn);
-        float gain = attn * _outGain;
+        for (; n < numFrames - 3; n += 4) {
+            __m128 x0 = _mm_loadu_ps(&input[n]);
+            nonzero = _mm_or_ps(nonzero, _mm_cmpneq_ps(x0, ZERO));
 
-        // delay audio
-        float x = input[n];
-        _delay.process(x);
+            _mm_storeu_ps(&peak[n], _mm_and_ps(x0, FABS_MASK));
+        }
+
+    } else if (numChannels == 2) {
+
+        for (; n < numFrames - 3; n += 4) {
+            __m128 x0 = _mm_loadu_ps(&input[2*n+0]);
+            __m128 x1 = _mm_loadu_ps(&input[2*n+4]);
+            nonzero = _mm_or_ps(nonzero, _mm_cmpneq_ps(x0, ZERO));
+            nonzero = _mm_or_ps(nonzero, _mm_cmpneq_ps(x1, ZERO));
+
+            x0 = _mm_and_ps(x0, FABS_MASK);
+            x1 = _mm_and_ps(x1, FABS_MASK);
+
+            // max of each left/right pair
+            x0 = _mm_max_ps(x0, _mm_shuffle_ps(x0, x0, _MM_SHUFFLE(2,3,0,1)));
+            x1 = _mm_max_ps(x1, _mm_shuffle_ps(x1, x1, _MM_SHUFFLE(2,3,0,1)));
+
+            _mm_storeu_ps(&peak[n], _mm_shuffle_ps(x0, x1, _MM_SHUFFLE(2,0,2,0)));
+        }
+
+    } else if (numChannels == 4) {
+
+        for (; n < numFrames - 3; n += 4) {
+            __m128 x0 = _mm_loadu_ps(&input[4*n+0]);
+            __m128 x1 = _mm_loadu_ps(&input[4*n+4]);
+            __m128 x2 = _mm_loadu_ps(&input[4*n+8]);
+            __m128 x3 = _mm_loadu_ps(&input[4*n+12]);
+            nonzero = _mm_or_ps(nonzero, _mm_cmpneq_ps(x0, ZERO));
+            nonzero = _mm_or_ps(nonzero, _mm_cmpneq_ps(x1, ZERO));
+            nonzero = _mm_or_ps(nonzero, _mm_cmpneq_ps(x2, ZERO));
+            nonzero = _mm_or_ps(nonzero, _mm_cmpneq_ps(x3, ZERO));
+
+            x0 = _mm_and_ps(x0, FABS_MASK);
+            x1 = _mm_and_ps(x1, FABS_MASK);
+            x2 = _mm_and_ps(x2, FABS_MASK);
+            x3 = _mm_and_ps(x3, FABS_MASK);
+
+            // max across each frame, as the columns
+            _MM_TRANSPOSE4_PS(x0, x1, x2, x3);
+            x0 = _mm_max_ps(_mm_max_ps(x0, x1), _mm_max_ps(x2, x3));
+
+            _mm_storeu_ps(&peak[n], x0);
+        }
+    }
+
+    bool hasAudio = _mm_movemask_ps(nonzero) != 0;
+
+    // remaining frames
+    for (; n < numFrames; n++) {
+        float x = 0.0f;
+        for (int c = 0; c < numChannels; c++) {
+            float y = input[numChannels*n+c];
+            hasAudio |= (y != 0.0f);
+            x = MAX(x, fabsf(y));
+        }
+        peak[n] = x;
+    }
+    return hasAudio;
+}
+
+// apply gain and dither, and convert to 16-bit output
+static void applyGain_SSE(const float* input, const float* gain, const float* dither, int16_t* output, 
+                          int numFrames, int numChannels) {
+
+    int n = 0;
+    if (numChannels == 1) {
+
+        for (; n < numFrames - 7; n += 8) {
+            __m128 x0 = _mm_loadu_ps(&input[n+0]);
+            __m128 x1 = _mm_loadu_ps(&input[n+4]);
+
+            x0 = _mm_add_ps(_mm_mul_ps(x0, _mm_loadu_ps(&gain[n+0])), _mm_loadu_ps(&dither[n+0]));
+            x1 = _mm_add_ps(_mm_mul_ps(x1, _mm_loadu_ps(&gain[n+4])), _mm_loadu_ps(&dither[n+4]));
+
+            __m128i y = _mm_packs_epi32(_mm_cvtps_epi32(x0), _mm_cvtps_epi32(x1));
+            _mm_storeu_si128((__m128i*)&output[n], y);
+        }
+
+    } else if (numChannels == 2) {
+
+        for (; n < numFrames - 3; n += 4) {
+            __m128 x0 = _mm_loadu_ps(&input[2*n+0]);
+            __m128 x1 = _mm_loadu_ps(&input[2*n+4]);
+            __m128 g = _mm_loadu_ps(&gain[n]);
+            __m128 d = _mm_loadu_ps(&dither[n]);
+
+            // same gain and dither for both channels
+            x0 = _mm_add_ps(_mm_mul_ps(x0, _mm_unpacklo_ps(g, g)), _mm_unpacklo_ps(d, d));
+            x1 = _mm_add_ps(_mm_mul_ps(x1, _mm_unpackhi_ps(g, g)), _mm_unpackhi_ps(d, d));
 
-        // apply gain
-        x *= gain;
+            __m128i y = _mm_packs_epi32(_mm_cvtps_epi32(x0), _mm_cvtps_epi32(x1));
+            _mm_storeu_si128((__m128i*)&output[2*n], y);
+        }
+
+    } else if (numChannels == 4) {
 
-        // apply dither
-        x += dither();
+        for (; n < numFrames - 1; n += 2) {
+            __m128 x0 = _mm_loadu_ps(&input[4*n+0]);
+            __m128 x1 = _mm_loadu_ps(&input[4*n+4]);
+
+            // same gain and dither for all channels
+            x0 = _mm_add_ps(_mm_mul_ps(x0, _mm_set1_ps(gain[n+0])), _mm_set1_ps(dither[n+0]));
+            x1 = _mm_add_ps(_mm_mul_ps(x1, _mm_set1_ps(gain[n+1])), _mm_set1_ps(dither[n+1]));
+
+            __m128i y = _mm_packs_epi32(_mm_cvtps_epi32(x0), _mm_cvtps_epi32(x1));
+            _mm_storeu_si128((__m128i*)&output[4*n], y);
+        }
+    }
 
-        // store 16-bit output
-        output[n] = (int16_t)floatToInt(x);
+    // remaining frames
+    for (; n < numFrames; n++) {
+        for (int c = 0; c < numChannels; c++) {
+            float x = input[numChannels*n+c];
+            x *= gain[n];
+            x += dither[n];
+            output[numChannels*n+c] = (int16_t)floatToInt(x);
+        }
     }
 }
 
 //
-// Limiter (stereo)
+// Runtime CPU dispatch
 //
-template<int N>
-class LimiterStereo : public LimiterImpl {
 
-    MinFilter<N> _filter;
-    StereoDelay<N> _delay;
+#include "CPUDetect.h"
 
-public:
-    LimiterStereo(int sampleRate) : LimiterImpl(sampleRate) {}
+bool peakDetect_AVX2(const float* input, float* peak, int numFrames, int numChannels);
+void peakAttn_AVX2(float* peak, int32_t* attn, int32_t threshold, int numFrames);
+void attnExp2_AVX2(int32_t* attn, int numFrames);
+void applyGain_AVX2(const float* input, const float* gain, const float* dither, int16_t* output, 
+                    int numFrames, int numChannels);
 
-    // interleaved stereo input/output
-    void process(float* input, int16_t* output, int numFrames) override;
-};
+static bool peakDetect(const float* input, float* peak, int numFrames, int numChannels) {
+
+    static auto f = cpuSupportsAVX2() ? peakDetect_AVX2 : peakDetect_SSE;
+    return (*f)(input, peak, numFrames, numChannels);   // dispatch
+}
 
-template<int N>
-void LimiterStereo<N>::process(float* input, int16_t* output, int numFrames) {
+static void peakAttn(float* peak, int32_t* attn, int32_t threshold, int numFrames) {
 
-    for (int n = 0; n < numFrames; n++) {
+    static auto f = cpuSupportsAVX2() ? peakAttn_AVX2 : peakAttn_ref;
+    (*f)(peak, attn, threshold, numFrames); // dispatch
+}
 
-        // peak detect and convert to log2 domain
-        int32_t peak = peaklog2(&input[2*n+0], &input[2*n+1]);
+static void attnExp2(int32_t* attn, int numFrames) {
 
-        // compute limiter attenuation
-        int32_t attn = MAX(_threshold - peak, 0);
+    static auto f = cpuSupportsAVX2() ? attnExp2_AVX2 : attnExp2_ref;
+    (*f)(attn, numFrames);  // dispatch
+}
 
-        // apply envelope
-        attn = envelope(attn);
+static void applyGain(const float* input, const float* gain, const float* dither, int16_t* output, 
+                      int numFrames, int numChannels) {
 
-        // convert from log2 domain
-        attn = fixexp2(attn);
+    static auto f = cpuSupportsAVX2() ? applyGain_AVX2 : applyGain_SSE;
+    (*f)(input, gain, dither, output, numFrames, numChannels);  // dispatch
+}
 
-        // lowpass filter
-        attn = _filter.process(attn);
-        float gain = attn * _outGain;
+#else   // portable reference code
 
-        // delay audio
-        float x0 = input[2*n+0];
-        float x1 = input[2*n+1];
-        _delay.process(x0, x1);
-
-        // apply gain
-        x0 *= gain;
-        x1 *= gain;
-
-        // apply dither
-        float d = dither();
-        x0 += d;
-        x1 += d;
-
-        // store 16-bit output
-        output[2*n+0] = (int16_t)floatToInt(x0);
-        output[2*n+1] = (int16_t)floatToInt(x1);
+// peak detect across channels, returns true if any input sample was non-zero
+static bool peakDetect(const float* input, float* peak, int numFrames, int numChannels) {
+
+    bool hasAudio = false;
+
+    for (int n = 0; n < numFrames; n++) {
+        float x = 0.0f;
+        for (int c = 0; c < numChannels; c++) {
+            float y = input[numChannels*n+c];
+            hasAudio |= (y != 0.0f);
+            x = MAX(x, fabsf(y));
+        }
+        peak[n] = x;
+    }
+    return hasAudio;
+}
+
+static void peakAttn(float* peak, int32_t* attn, int32_t threshold, int numFrames) {
+    peakAttn_ref(peak, attn, threshold, numFrames);
+}
+
+static void attnExp2(int32_t* attn, int numFrames) {
+    attnExp2_ref(attn, numFrames);
+}
+
+// apply gain and dither, and convert to 16-bit output
+static void applyGain(const float* input, const float* gain, const float* dither, int16_t* output, 
+                      int numFrames, int numChannels) {
+
+    for (int n = 0; n < numFrames; n++) {
+        for (int c = 0; c < numChannels; c++) {
+            float x = input[numChannels*n+c];
+            x *= gain[n];
+            x += dither[n];
+            output[numChannels*n+c] = (int16_t)floatToInt(x);
+        }
     }
 }
 
+#endif
+
 //
-// Limiter (quad)
+// Limiter (mono, stereo or quad)
 //
-template<int N>
-class LimiterQuad : public LimiterImpl {
+template<int N, int NUM_CHANNELS>
+class LimiterT : public LimiterImpl {
 
     MinFilter<N> _filter;
-    QuadDelay<N> _delay;
+
+    // N-1 frames of delayed audio
+    float _delay[(N - 1) * NUM_CHANNELS] = {};
 
 public:
-    LimiterQuad(int sampleRate) : LimiterImpl(sampleRate) {}
+    LimiterT(int sampleRate) : LimiterImpl(sampleRate) {}
 
-    // interleaved quad input/output
-    void process(float* input, int16_t* output, int numFrames) override;
+    // interleaved input/output
+    bool process(float* input, int16_t* output, int numFrames) override;
 };
 
-template<int N>
-void LimiterQuad<N>::process(float* input, int16_t* output, int numFrames) {
+template<int N, int NUM_CHANNELS>
+bool LimiterT<N, NUM_CHANNELS>::process(float* input, int16_t* output, int numFrames) {
 
-    for (int n = 0; n < numFrames; n++) {
+    const int DELAY = N - 1;
+    bool hasAudio = false;
+
+    float peak[LIMITER_BLOCK];
+    int32_t attn[LIMITER_BLOCK];
+    float gain[LIMITER_BLOCK];
+    float dith[LIMITER_BLOCK];
+
+    while (numFrames > 0) {
+
+        int numBlock = MIN(numFrames, LIMITER_BLOCK);
 
-        // peak detect and convert to log2 domain
-        int32_t peak = peaklog2(&input[4*n+0], &input[4*n+1], &input[4*n+2], &input[4*n+3]);
+        // peak detect
+        hasAudio |= peakDetect(input, peak, numBlock, NUM_CHANNELS);
 
         // compute limiter attenuation
-        int32_t attn = MAX(_threshold - peak, 0);
+        peakAttn(peak, attn, _threshold, numBlock);
 
         // apply envelope
-        attn = envelope(attn);
+        for (int n = 0; n < numBlock; n++) {
+            attn[n] = envelope(attn[n]);
+        }
 
         // convert from log2 domain
-        attn = fixexp2(attn);
+        attnExp2(attn, numBlock);
 
         // lowpass filter
-        attn = _filter.process(attn);
-        float gain = attn * _outGain;
+        for (int n = 0; n < numBlock; n++) {
+            gain[n] = _filter.process(attn[n]) * _outGain;
+            dith[n] = dither();
+        }
+
+        // apply gain and dither to the delayed audio
+        int numDelayed = MIN(numBlock, DELAY);
+        applyGain(_delay, gain, dith, output, numDelayed, NUM_CHANNELS);
+        applyGain(input, &gain[numDelayed], &dith[numDelayed], &output[numDelayed * NUM_CHANNELS], 
+                  numBlock - numDelayed, NUM_CHANNELS);
 
         // delay audio
-        float x0 = input[4*n+0];
-        float x1 = input[4*n+1];
-        float x2 = input[4*n+2];
-        float x3 = input[4*n+3];
-        _delay.process(x0, x1, x2, x3);
-
-        // apply gain
-        x0 *= gain;
-        x1 *= gain;
-        x2 *= gain;
-        x3 *= gain;
-
-        // apply dither
-        float d = dither();
-        x0 += d;
-        x1 += d;
-        x2 += d;
-        x3 += d;
-
-        // store 16-bit output
-        output[4*n+0] = (int16_t)floatToInt(x0);
-        output[4*n+1] = (int16_t)floatToInt(x1);
-        output[4*n+2] = (int16_t)floatToInt(x2);
-        output[4*n+3] = (int16_t)floatToInt(x3);
+        if (numBlock < DELAY) {
+            memmove(&_delay[0], &_delay[numBlock * NUM_CHANNELS], (DELAY - numBlock) * NUM_CHANNELS * sizeof(float));
+        }
+        memcpy(&_delay[(DELAY - numDelayed) * NUM_CHANNELS], &input[(numBlock - numDelayed) * NUM_CHANNELS], 
+               numDelayed * NUM_CHANNELS * sizeof(float));
+
+        input += numBlock * NUM_CHANNELS;
+        output += numBlock * NUM_CHANNELS;
+        numFrames -= numBlock;
     }
+    return hasAudio;
 }
 
+template<int N> using LimiterMono = LimiterT<N, 1>;
+template<int N> using LimiterStereo = LimiterT<N, 2>;
+template<int N> using LimiterQuad = LimiterT<N, 4>;
+
 //
 // Public API
 //
@@ -417,8 +574,8 @@ AudioLimiter::~AudioLimiter() {
     delete _impl;
 }
 
-void AudioLimiter::render(float* input, int16_t* output, int numFrames) {
-    _impl->process(input, output, numFrames);
+bool AudioLimiter::render(float* input, int16_t* output, int numFrames) {
+    return _impl->process(input, output, numFrames);
 }
 
 void AudioLimiter::setThreshold(float threshold) {
@@ -18,7 +18,8 @@ public:
     AudioLimiter(int sampleRate, int numChannels);
     ~AudioLimiter();
 
-    void render(float* input, int16_t* output, int numFrames);
+    // returns true if the input had any non-zero samples, the dithered output can't tell silence apart
+    bool render(float* input, int16_t* output, int numFrames);
 
     void setThreshold(float threshold);
     void setRelease(float release);
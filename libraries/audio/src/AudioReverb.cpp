@@ -699,6 +699,242 @@ public:
     }
 };
 
+//
+// Block processing
+//
+// The feedforward sections (the predelay, the early reflections and the output diffusion) are processed
+// a block at a time, using the vectorized kernels below.  The late reverb is a feedback network, and is
+// processed a frame at a time.
+//
+static const int REVERB_BLOCK = 256;
+
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>
+
+// output = gain * input
+static void gainBlock_SSE(const float* input, float* output, float gain, int numFrames) {
+
+    __m128 g = _mm_set1_ps(gain);
+
+    int i = 0;
+    for (; i < numFrames - 3; i += 4) {
+        _mm_storeu_ps(&output[i], _mm_mul_ps(g, _mm_loadu_ps(&input[i])));
+    }
+    for (; i < numFrames; i++) {
+        output[i] = gain * input[i];
+    }
+}
+
+// output = input0 + input1
+static void addBlock_SSE(const float* input0, const float* input1, float* output, int numFrames) {
+
+    int i = 0;
+    for (; i < numFrames - 3; i += 4) {
+        _mm_storeu_ps(&output[i], _mm_add_ps(_mm_loadu_ps(&input0[i]), _mm_loadu_ps(&input1[i])));
+    }
+    for (; i < numFrames; i++) {
+        output[i] = input0[i] + input1[i];
+    }
+}
+
+// output = (input0 + input1 * mix1 + input2 * mix2) * gain
+static void mixBlock_SSE(const float* input0, const float* input1, const float* input2, float* output,
+                         float mix1, float mix2, float gain, int numFrames) {
+
+    __m128 m1 = _mm_set1_ps(mix1);
+    __m128 m2 = _mm_set1_ps(mix2);
+    __m128 g = _mm_set1_ps(gain);
+
+    int i = 0;
+    for (; i < numFrames - 3; i += 4) {
+        __m128 x0 = _mm_add_ps(_mm_loadu_ps(&input0[i]), _mm_mul_ps(_mm_loadu_ps(&input1[i]), m1));
+        x0 = _mm_add_ps(x0, _mm_mul_ps(_mm_loadu_ps(&input2[i]), m2));
+        _mm_storeu_ps(&output[i], _mm_mul_ps(x0, g));
+    }
+    for (; i < numFrames; i++) {
+        output[i] = (input0[i] + input1[i] * mix1 + input2[i] * mix2) * gain;
+    }
+}
+
+// output = dry + (wet - dry) * mix
+static void wetDryBlock_SSE(const float* dry, const float* wet, float* output, float mix, int numFrames) {
+
+    __m128 m = _mm_set1_ps(mix);
+
+    int i = 0;
+    for (; i < numFrames - 3; i += 4) {
+        __m128 x0 = _mm_loadu_ps(&dry[i]);
+        __m128 y0 = _mm_loadu_ps(&wet[i]);
+        _mm_storeu_ps(&output[i], _mm_add_ps(x0, _mm_mul_ps(_mm_sub_ps(y0, x0), m)));
+    }
+    for (; i < numFrames; i++) {
+        output[i] = dry[i] + (wet[i] - dry[i]) * mix;
+    }
+}
+
+// allpass, where the delayed feedback is already in delayed[]
+// NOTE: feedback[] may overlap delayed[], ahead of it
+static void allpassBlock_SSE(const float* delayed, const float* input, float* output, float* feedback,
+                             float coef, int numFrames) {
+
+    __m128 c = _mm_set1_ps(coef);
+
+    int i = 0;
+    for (; i < numFrames - 3; i += 4) {
+        __m128 x0 = _mm_loadu_ps(&input[i]);
+        __m128 y0 = _mm_sub_ps(_mm_loadu_ps(&delayed[i]), _mm_mul_ps(c, x0));  // feedforward path
+        _mm_storeu_ps(&output[i], y0);
+        _mm_storeu_ps(&feedback[i], _mm_add_ps(x0, _mm_mul_ps(c, y0)));       // feedback path
+    }
+    for (; i < numFrames; i++) {
+        output[i] = delayed[i] - coef * input[i];
+        feedback[i] = input[i] + coef * output[i];
+    }
+}
+
+//
+// Runtime CPU dispatch
+//
+
+#include "CPUDetect.h"
+
+void gainBlock_AVX2(const float* input, float* output, float gain, int numFrames);
+void addBlock_AVX2(const float* input0, const float* input1, float* output, int numFrames);
+void mixBlock_AVX2(const float* input0, const float* input1, const float* input2, float* output,
+                   float mix1, float mix2, float gain, int numFrames);
+void wetDryBlock_AVX2(const float* dry, const float* wet, float* output, float mix, int numFrames);
+void allpassBlock_AVX2(const float* delayed, const float* input, float* output, float* feedback,
+                       float coef, int numFrames);
+
+static void gainBlock(const float* input, float* output, float gain, int numFrames) {
+
+    static auto f = cpuSupportsAVX2() ? gainBlock_AVX2 : gainBlock_SSE;
+    (*f)(input, output, gain, numFrames);   // dispatch
+}
+
+static void addBlock(const float* input0, const float* input1, float* output, int numFrames) {
+
+    static auto f = cpuSupportsAVX2() ? addBlock_AVX2 : addBlock_SSE;
+    (*f)(input0, input1, output, numFrames);    // dispatch
+}
+
+static void mixBlock(const float* input0, const float* input1, const float* input2, float* output,
+                     float mix1, float mix2, float gain, int numFrames) {
+
+    static auto f = cpuSupportsAVX2() ? mixBlock_AVX2 : mixBlock_SSE;
+    (*f)(input0, input1, input2, output, mix1, mix2, gain, numFrames);  // dispatch
+}
+
+static void wetDryBlock(const float* dry, const float* wet, float* output, float mix, int numFrames) {
+
+    static auto f = cpuSupportsAVX2() ? wetDryBlock_AVX2 : wetDryBlock_SSE;
+    (*f)(dry, wet, output, mix, numFrames); // dispatch
+}
+
+static void allpassBlock(const float* delayed, const float* input, float* output, float* feedback,
+                         float coef, int numFrames) {
+
+    static auto f = cpuSupportsAVX2() ? allpassBlock_AVX2 : allpassBlock_SSE;
+    (*f)(delayed, input, output, feedback, coef, numFrames);    // dispatch
+}
+
+#else   // portable reference code
+
+// output = gain * input
+static void gainBlock(const float* input, float* output, float gain, int numFrames) {
+    for (int i = 0; i < numFrames; i++) {
+        output[i] = gain * input[i];
+    }
+}
+
+// output = input0 + input1
+static void addBlock(const float* input0, const float* input1, float* output, int numFrames) {
+    for (int i = 0; i < numFrames; i++) {
+        output[i] = input0[i] + input1[i];
+    }
+}
+
+// output = (input0 + input1 * mix1 + input2 * mix2) * gain
+static void mixBlock(const float* input0, const float* input1, const float* input2, float* output,
+                     float mix1, float mix2, float gain, int numFrames) {
+    for (int i = 0; i < numFrames; i++) {
+        output[i] = (input0[i] + input1[i] * mix1 + input2[i] * mix2) * gain;
+    }
+}
+
+// output = dry + (wet - dry) * mix
+static void wetDryBlock(const float* dry, const float* wet, float* output, float mix, int numFrames) {
+    for (int i = 0; i < numFrames; i++) {
+        output[i] = dry[i] + (wet[i] - dry[i]) * mix;
+    }
+}
+
+// allpass, where the delayed feedback is already in delayed[]
+// NOTE: feedback[] may overlap delayed[], ahead of it
+static void allpassBlock(const float* delayed, const float* input, float* output, float* feedback,
+                         float coef, int numFrames) {
+    for (int i = 0; i < numFrames; i++) {
+        output[i] = delayed[i] - coef * input[i];
+        feedback[i] = input[i] + coef * output[i];
+    }
+}
+
+#endif
+
+//
+// Block access to the history in a delay buffer of N frames, where index is the next frame to be written.
+// The block versions of process() match calling process() on every frame, including the frame of latency
+// of the stored output.
+//
+
+// output = gain * x[n - delay], where x[] is the input preceded by the history
+template<int N>
+static void readDelay(const float* buffer, int index, int delay, const float* input, float* output, float gain,
+                      int numFrames) {
+
+    int numHistory = MIN(delay, numFrames);
+
+    // split where the buffer wraps
+    int k = (index - delay) & (N - 1);
+    for (int i = 0; i < numHistory; ) {
+        int n = MIN(numHistory - i, N - k);
+        gainBlock(&buffer[k], &output[i], gain, n);
+        i += n;
+        k = (k + n) & (N - 1);
+    }
+
+    gainBlock(input, &output[numHistory], gain, numFrames - numHistory);
+}
+
+// x[i - delay], where x[] is the input preceded by the history
+template<int N>
+static float tapDelay(const float* buffer, int index, int delay, const float* input, int i) {
+    int k = i - delay;
+    return (k < 0) ? buffer[(index + k) & (N - 1)] : input[k];
+}
+
+// append the input to the history, returns the new index
+template<int N>
+static int writeDelay(float* buffer, int index, const float* input, int numFrames) {
+
+    // only the last N frames are kept
+    int i = MAX(numFrames - N, 0);
+    index = (index + i) & (N - 1);
+
+    // split where the buffer wraps
+    while (i < numFrames) {
+        int n = MIN(numFrames - i, N - index);
+        memcpy(&buffer[index], &input[i], n * sizeof(float));
+        i += n;
+        index = (index + n) & (N - 1);
+    }
+    return index;
+}
+
 template<int N>
 class DelayLine {
 
@@ -727,6 +963,15 @@ public:
         _index = (_index + 1) & (N - 1);
     }
 
+    void process(const float* input, float* output, int numFrames) {
+        output[0] = _output;
+
+        readDelay<N>(_buffer, _index, _delay, input, &output[1], 1.0f, numFrames - 1);
+        _output = tapDelay<N>(_buffer, _index, _delay, input, numFrames - 1);
+
+        _index = writeDelay<N>(_buffer, _index, input, numFrames);
+    }
+
     void reset() {
         memset(_buffer, 0, sizeof(_buffer));
         _output = 0.0f;
@@ -773,6 +1018,30 @@ public:
         _index1 = (_index1 + 1) & (N - 1);
     }
 
+    void process(const float* input, float* output, int numFrames) {
+        float y[REVERB_BLOCK + 1];
+        y[0] = _output;
+
+        for (int i = 0; i < numFrames; ) {
+
+            // the feedback is delayed at least _delay frames, so each run only reads the feedback of earlier runs
+            int n = MIN(numFrames - i, _delay);
+
+            // split where the buffer wraps
+            n = MIN(n, N - _index0);
+            n = MIN(n, N - _index1);
+
+            allpassBlock(&_buffer[_index1], &input[i], &y[i + 1], &_buffer[_index0], _coef, n);
+
+            _index0 = (_index0 + n) & (N - 1);
+            _index1 = (_index1 + n) & (N - 1);
+            i += n;
+        }
+
+        memcpy(output, y, numFrames * sizeof(float));
+        _output = y[numFrames];
+    }
+
     void getOutput(float& output) {
         output = _output;
     }
@@ -1065,6 +1334,19 @@ public:
         _index = (_index + 1) & (N - 1);
     }
 
+    void process(const float* input, float* output0, float* output1, int numFrames) {
+        output0[0] = _output0;
+        output1[0] = _output1;
+
+        readDelay<N>(_buffer, _index, _delay0, input, &output0[1], _gain0, numFrames - 1);
+        readDelay<N>(_buffer, _index, _delay1, input, &output1[1], _gain1, numFrames - 1);
+
+        _output0 = _gain0 * tapDelay<N>(_buffer, _index, _delay0, input, numFrames - 1);
+        _output1 = _gain1 * tapDelay<N>(_buffer, _index, _delay1, input, numFrames - 1);
+
+        _index = writeDelay<N>(_buffer, _index, input, numFrames);
+    }
+
     void reset() {
         memset(_buffer, 0, sizeof(_buffer));
         _output0 = 0.0f;
@@ -1132,6 +1414,22 @@ public:
         _index = (_index + 1) & (N - 1);
     }
 
+    void process(const float* input, float* output0, float* output1, float* output2, int numFrames) {
+        output0[0] = _output0;
+        output1[0] = _output1;
+        output2[0] = _output2;
+
+        readDelay<N>(_buffer, _index, _delay0, input, &output0[1], _gain0, numFrames - 1);
+        readDelay<N>(_buffer, _index, _delay1, input, &output1[1], _gain1, numFrames - 1);
+        readDelay<N>(_buffer, _index, _delay2, input, &output2[1], _gain2, numFrames - 1);
+
+        _output0 = _gain0 * tapDelay<N>(_buffer, _index, _delay0, input, numFrames - 1);
+        _output1 = _gain1 * tapDelay<N>(_buffer, _index, _delay1, input, numFrames - 1);
+        _output2 = _gain2 * tapDelay<N>(_buffer, _index, _delay2, input, numFrames - 1);
+
+        _index = writeDelay<N>(_buffer, _index, input, numFrames);
+    }
+
     void reset() {
         memset(_buffer, 0, sizeof(_buffer));
         _output0 = 0.0f;
@@ -1210,6 +1508,8 @@ class ReverbImpl {
     float _earlyGain = 0.0f;
     float _wetDryMix = 0.0f;
 
+    void processBlock(const float* input0, const float* input1, float* output0, float* output1, int numFrames);
+
 public:
     void setParameters(ReverbParameters *p);
     void process(float** inputs, float** outputs, int numFrames);
@@ -1584,39 +1884,58 @@ void ReverbImpl::setParameters(ReverbParameters *p) {
 
 void ReverbImpl::process(float** inputs, float** outputs, int numFrames) {
 
+    for (int i = 0; i < numFrames; i += REVERB_BLOCK) {
+
+        int n = MIN(numFrames - i, REVERB_BLOCK);
+
+        processBlock(&inputs[0][i], &inputs[1][i], &outputs[0][i], &outputs[1][i], n);
+    }
+}
+
+// NOTE: outputs may be the same as inputs
+void ReverbImpl::processBlock(const float* input0, const float* input1, float* output0, float* output1, int numFrames) {
+
+    float tap0[REVERB_BLOCK], tap1[REVERB_BLOCK], mix0[REVERB_BLOCK], mix1[REVERB_BLOCK], mix2[REVERB_BLOCK];
+
+    // Preprocess
+    for (int i = 0; i < numFrames; i++) {
+        _bw.process(input0[i], input1[i], tap0[i], tap1[i]);
+    }
+
+    float preL[REVERB_BLOCK], preR[REVERB_BLOCK];
+    _dl0.process(tap0, preL, numFrames);
+    _dl1.process(tap1, preR, numFrames);
+
+    // Early Left
+    float early0L[REVERB_BLOCK], early1L[REVERB_BLOCK], early2L[REVERB_BLOCK], earlyOutL[REVERB_BLOCK];
+    _mt0.process(preL, tap0, tap1, mix0, numFrames);
+    addBlock(tap0, tap1, tap0, numFrames);
+    _ap0.process(tap0, mix1, numFrames);
+    _mt1.process(mix1, tap0, tap1, early0L, numFrames);
+    addBlock(tap0, tap1, tap0, numFrames);
+    _ap1.process(tap0, mix2, numFrames);
+    _ap2.process(mix2, tap0, numFrames);
+    _mt2.process(tap0, early1L, early2L, numFrames);
+
+    mixBlock(mix0, mix1, mix2, earlyOutL, _earlyMix1L, _earlyMix2L, _earlyGain, numFrames);
+
+    // Early Right
+    float early0R[REVERB_BLOCK], early1R[REVERB_BLOCK], early2R[REVERB_BLOCK], earlyOutR[REVERB_BLOCK];
+    _mt3.process(preR, tap0, tap1, mix0, numFrames);
+    addBlock(tap0, tap1, tap0, numFrames);
+    _ap3.process(tap0, mix1, numFrames);
+    _mt4.process(mix1, tap0, tap1, early0R, numFrames);
+    addBlock(tap0, tap1, tap0, numFrames);
+    _ap4.process(tap0, mix2, numFrames);
+    _ap5.process(mix2, tap0, numFrames);
+    _mt5.process(tap0, early1R, early2R, numFrames);
+
+    mixBlock(mix0, mix1, mix2, earlyOutR, _earlyMix1R, _earlyMix2R, _earlyGain, numFrames);
+
+    float lateOutL[REVERB_BLOCK], lateOutR[REVERB_BLOCK];
+
     for (int i = 0; i < numFrames; i++) {
-        float x0, x1, y0, y1, y2, y3;
-
-        // Preprocess
-        x0 = inputs[0][i];
-        x1 = inputs[1][i];
-        _bw.process(x0, x1, x0, x1);
-
-        float preL, preR;
-        _dl0.process(x0, preL);
-        _dl1.process(x1, preR);
-
-        // Early Left
-        float early0L, early1L, early2L, earlyOutL;
-        _mt0.process(preL, x0, x1, y0);
-        _ap0.process(x0 + x1, y1);
-        _mt1.process(y1, x0, x1, early0L);
-        _ap1.process(x0 + x1, y2);
-        _ap2.process(y2, x0);
-        _mt2.process(x0, early1L, early2L);
-
-        earlyOutL = (y0 + y1 * _earlyMix1L + y2 * _earlyMix2L) * _earlyGain;
-
-        // Early Right
-        float early0R, early1R, early2R, earlyOutR;
-        _mt3.process(preR, x0, x1, y0);
-        _ap3.process(x0 + x1, y1);
-        _mt4.process(y1, x0, x1, early0R);
-        _ap4.process(x0 + x1, y2);
-        _ap5.process(y2, x0);
-        _mt5.process(x0, early1R, early2R);
-
-        earlyOutR = (y0 + y1 * _earlyMix1R + y2 * _earlyMix2R) * _earlyGain;
+        float x0, y0, y1, y2, y3;
 
         // LFO update
         int32_t lfoSin, lfoCos;
@@ -1626,50 +1945,51 @@ void ReverbImpl::process(float** inputs, float** outputs, int numFrames) {
         float lateOut0;
         _ap6.getOutput(x0);
         _ap7.process(x0, lfoSin, x0);
-        _eq0.process(-early0L + x0, x0);
+        _eq0.process(-early0L[i] + x0, x0);
         _mt6.process(x0, y0, lateOut0);
 
         float lateOut1;
         _ap8.getOutput(x0);
         _ap9.process(x0, lfoCos, x0);
-        _eq1.process(-early0R + x0, x0);
+        _eq1.process(-early0R[i] + x0, x0);
         _mt7.process(x0, y1, lateOut1);
 
         float lateOut2;
         _ap10.getOutput(x0);
-        _ap11.process(-early2L + x0, x0);
+        _ap11.process(-early2L[i] + x0, x0);
         _ap12.process(x0, x0);
-        _ap13.process(-early2L - x0, x0);
-        _mt8.process(-early0L + x0, x0, lateOut2);
+        _ap13.process(-early2L[i] - x0, x0);
+        _mt8.process(-early0L[i] + x0, x0, lateOut2);
         _lp0.process(x0, y2);
 
         float lateOut3;
         _ap14.getOutput(x0);
-        _ap15.process(-early2R + x0, x0);
+        _ap15.process(-early2R[i] + x0, x0);
         _ap16.process(x0, x0);
-        _ap17.process(-early2R - x0, x0);
-        _mt9.process(-early0R + x0, x0, lateOut3);
+        _ap17.process(-early2R[i] - x0, x0);
+        _mt9.process(-early0R[i] + x0, x0, lateOut3);
         _lp1.process(x0, y3);
 
         // Feedback matrix
-        _ap6.process(early1L + y2 - y3, x0);
-        _ap8.process(early1R - y2 - y3, x0);
-        _ap10.process(-early2R + y0 + y1, x0);
-        _ap14.process(-early2L - y0 + y1, x0);
+        _ap6.process(early1L[i] + y2 - y3, x0);
+        _ap8.process(early1R[i] - y2 - y3, x0);
+        _ap10.process(-early2R[i] + y0 + y1, x0);
+        _ap14.process(-early2L[i] - y0 + y1, x0);
+
+        lateOutL[i] = -earlyOutL[i] + lateOut0 + lateOut3;
+        lateOutR[i] = -earlyOutR[i] + lateOut1 + lateOut2;
+    }
 
-        // Output Left
-        _ap18.process(-earlyOutL + lateOut0 + lateOut3, x0);
-        _ap19.process(x0, y0);
+    // Output Left
+    _ap18.process(lateOutL, tap0, numFrames);
+    _ap19.process(tap0, mix0, numFrames);
 
-        // Output Right
-        _ap20.process(-earlyOutR + lateOut1 + lateOut2, x1);
-        _ap21.process(x1, y1);
+    // Output Right
+    _ap20.process(lateOutR, tap1, numFrames);
+    _ap21.process(tap1, mix1, numFrames);
 
-        x0 = inputs[0][i];
-        x1 = inputs[1][i];
-        outputs[0][i] = x0 + (y0 - x0) * _wetDryMix;
-        outputs[1][i] = x1 + (y1 - x1) * _wetDryMix;
-    }
+    wetDryBlock(input0, mix0, output0, _wetDryMix, numFrames);
+    wetDryBlock(input1, mix1, output1, _wetDryMix, numFrames);
 }
 
 // clear internal state, but retain settings
@@ -1725,8 +2045,6 @@ void ReverbImpl::reset() {
 // Public API
 //
 
-static const int REVERB_BLOCK = 256;
-
 AudioReverb::AudioReverb(float sampleRate) {
 
     _impl = new ReverbImpl;
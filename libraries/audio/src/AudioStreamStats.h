@@ -39,6 +39,10 @@ public:
         _consecutiveNotMixedCount(0),
         _overflowCount(0),
         _framesDropped(0),
+        _targetDelayMs(0),
+        _framesConcealed(0),
+        _concealedRate(0.0f),
+        _stretchedRate(0.0f),
         _packetStreamStats(),
         _packetStreamWindowStats()
     {}
@@ -61,6 +65,10 @@ public:
     quint32 _consecutiveNotMixedCount;
     quint32 _overflowCount;
     quint32 _framesDropped;
+    quint16 _targetDelayMs;
+    quint32 _framesConcealed;
+    float _concealedRate;
+    float _stretchedRate;
 
     PacketStreamStats _packetStreamStats;
     PacketStreamStats _packetStreamWindowStats;
@@ -0,0 +1,121 @@
+//
+//  AudioTimeStretch.cpp
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioTimeStretch.h"
+
+#include <string.h>
+#include <math.h>
+
+// lags cover voice pitch from 133Hz to 400Hz, and leave at least 2.5ms of a 10ms frame to cross-fade over
+static const float MIN_LAG_SECS = 0.0025f;
+static const float MAX_LAG_SECS = 0.0075f;
+
+// below this the stretch would be audible as a warble, unless the frame is too quiet to tell
+static const float MIN_CORRELATION = 0.5f;
+static const float QUIET_ENERGY_PER_SAMPLE = 100.0f * 100.0f;   // about -50dBFS
+
+// 10ms at 96KHz
+static const int MAX_FRAMES = 1024;
+
+static int getMinLag(int sampleRate) {
+    return (int)(MIN_LAG_SECS * sampleRate);
+}
+
+int AudioTimeStretch::getMaxLag(int sampleRate) {
+    return (int)(MAX_LAG_SECS * sampleRate);
+}
+
+// returns the lag where the frame best matches itself, or 0 if it matches too poorly to stretch
+static int findLag(const int16_t* input, int numFrames, int numChannels, int sampleRate) {
+    int minLag = getMinLag(sampleRate);
+    int maxLag = AudioTimeStretch::getMaxLag(sampleRate);
+    if (numFrames > MAX_FRAMES || numFrames - maxLag < minLag) {
+        return 0;
+    }
+
+    // match on the sum of all channels
+    float mono[MAX_FRAMES];
+    float energy[MAX_FRAMES + 1];   // running sum of squares, energy[i] covers mono[0..i)
+    energy[0] = 0.0f;
+    for (int i = 0; i < numFrames; i++) {
+        float sum = 0.0f;
+        for (int j = 0; j < numChannels; j++) {
+            sum += (float)input[i * numChannels + j];
+        }
+        mono[i] = sum;
+        energy[i + 1] = energy[i] + sum * sum;
+    }
+
+    float quietEnergy = QUIET_ENERGY_PER_SAMPLE * numChannels * numChannels * numFrames;
+    if (energy[numFrames] < quietEnergy) {
+        // nothing to hear, take the biggest step
+        return maxLag;
+    }
+
+    int bestLag = 0;
+    float bestCorrelation = MIN_CORRELATION;
+    for (int lag = minLag; lag <= maxLag; lag++) {
+        int overlap = numFrames - lag;
+
+        float dot = 0.0f;
+        for (int i = 0; i < overlap; i++) {
+            dot += mono[i] * mono[i + lag];
+        }
+        float headEnergy = energy[overlap];
+        float tailEnergy = energy[numFrames] - energy[lag];
+        float norm = sqrtf(headEnergy * tailEnergy);
+
+        if (norm > 0.0f && dot >= bestCorrelation * norm) {
+            bestCorrelation = dot / norm;
+            bestLag = lag;
+        }
+    }
+    return bestLag;
+}
+
+// cross-fades from one segment into another, the weights sum to one so the result stays in range
+static void crossFade(const int16_t* from, const int16_t* to, int16_t* output, int numFrames, int numChannels) {
+    float step = 1.0f / numFrames;
+    for (int i = 0; i < numFrames; i++) {
+        float weight = (i + 0.5f) * step;
+        for (int j = 0; j < numChannels; j++) {
+            int k = i * numChannels + j;
+            output[k] = (int16_t)lrintf(from[k] + weight * (to[k] - from[k]));
+        }
+    }
+}
+
+int AudioTimeStretch::compress(const int16_t* input, int16_t* output, int numFrames, int numChannels, int sampleRate) {
+    int lag = findLag(input, numFrames, numChannels, sampleRate);
+    if (lag == 0) {
+        memcpy(output, input, numFrames * numChannels * sizeof(int16_t));
+        return numFrames;
+    }
+
+    // fade from the head of the frame into the same stretch one lag later, dropping that lag
+    int overlap = numFrames - lag;
+    crossFade(input, input + lag * numChannels, output, overlap, numChannels);
+    return overlap;
+}
+
+int AudioTimeStretch::expand(const int16_t* input, int16_t* output, int numFrames, int numChannels, int sampleRate) {
+    int lag = findLag(input, numFrames, numChannels, sampleRate);
+    if (lag == 0) {
+        memcpy(output, input, numFrames * numChannels * sizeof(int16_t));
+        return numFrames;
+    }
+
+    // play the first lag, fade from the rest of the frame back into its head, then play the last lag again
+    int overlap = numFrames - lag;
+    memcpy(output, input, lag * numChannels * sizeof(int16_t));
+    crossFade(input + lag * numChannels, input, output + lag * numChannels, overlap, numChannels);
+    memcpy(output + numFrames * numChannels, input + overlap * numChannels, lag * numChannels * sizeof(int16_t));
+    return numFrames + lag;
+}
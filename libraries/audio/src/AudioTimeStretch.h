@@ -0,0 +1,35 @@
+//
+//  AudioTimeStretch.h
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioTimeStretch_h
+#define hifi_AudioTimeStretch_h
+
+#include <stdint.h>
+
+// WSOLA-style time stretching of a single frame, used by the jitter buffer to grow or shrink its delay by a fraction
+// of a frame without touching the pitch.
+// The frame is searched for the lag (within typical voice pitch periods) where it best matches itself, then one lag
+// worth of samples is removed or repeated with a cross-fade over that match.
+// Frames need to hold at least 10ms of interleaved audio.
+namespace AudioTimeStretch {
+
+    // the most frames compress() removes or expand() adds
+    int getMaxLag(int sampleRate);
+
+    // writes the frame less one lag to output (which needs numFrames of room), returns the frames written,
+    // or numFrames with output a plain copy when the frame does not match itself well enough to stretch
+    int compress(const int16_t* input, int16_t* output, int numFrames, int numChannels, int sampleRate);
+
+    // writes the frame plus one lag to output (which needs numFrames + getMaxLag() of room), returns the frames written,
+    // or numFrames with output a plain copy when the frame does not match itself well enough to stretch
+    int expand(const int16_t* input, int16_t* output, int numFrames, int numChannels, int sampleRate);
+}
+
+#endif // hifi_AudioTimeStretch_h
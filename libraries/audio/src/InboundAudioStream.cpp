@@ -11,12 +11,15 @@
 
 #include <glm/glm.hpp>
 
+#include <chrono>
+
 #include <NLPacket.h>
 #include <Node.h>
 #include <NodeList.h>
 
 #include "InboundAudioStream.h"
 #include "AudioLogging.h"
+#include "AudioTimeStretch.h"
 
 const bool InboundAudioStream::DEFAULT_DYNAMIC_JITTER_BUFFER_ENABLED = true;
 const int InboundAudioStream::DEFAULT_STATIC_JITTER_FRAMES = 1;
@@ -27,8 +30,6 @@ const int InboundAudioStream::WINDOW_SECONDS_FOR_DESIRED_REDUCTION = 10;
 const bool InboundAudioStream::USE_STDEV_FOR_JITTER = false;
 const bool InboundAudioStream::REPETITION_WITH_FADE = true;
 
-static const int STARVE_HISTORY_CAPACITY = 50;
-
 // This is called 1x/s, and we want it to log the last 5s
 static const int UNPLAYED_MS_WINDOW_SECS = 5;
 
@@ -46,6 +47,14 @@ static const int STATS_FOR_STATS_PACKET_WINDOW_SECONDS = 30;
 // _currentJitterBufferFrames is updated with the time-weighted avg and the running time-weighted avg is reset.
 static const quint64 FRAMES_AVAILABLE_STAT_WINDOW_USECS = 10 * USECS_PER_SECOND;
 
+// The dynamic jitter buffer aims for the estimated delay plus half a frame, since frames are popped on frame boundaries.
+// Frames are stretched when the playout delay drops below that target, and squeezed once it is a frame over it.
+static const int TARGET_DELAY_PADDING_USECS = AudioConstants::NETWORK_FRAME_USECS / 2;
+static const int TARGET_DELAY_TOLERANCE_USECS = AudioConstants::NETWORK_FRAME_USECS;
+
+// the playout delay follows that of the frames written over about 8 frames
+static const float PLAYOUT_DELAY_FILTER = 1.0f / 8.0f;
+
 // When the audio codec is switched, temporary codec mismatch is expected due to packets in-flight.
 // A SelectedAudioFormat packet is not sent until this threshold is exceeded.
 static const int MAX_MISMATCHED_AUDIO_CODEC_COUNT = 10;
@@ -57,7 +66,8 @@ InboundAudioStream::InboundAudioStream(int numChannels, int numFrames, int numBl
     _staticJitterBufferFrames(std::max(numStaticJitterBlocks, DEFAULT_STATIC_JITTER_FRAMES)),
     _desiredJitterBufferFrames(_dynamicJitterBufferEnabled ? 1 : _staticJitterBufferFrames),
     _incomingSequenceNumberStats(STATS_FOR_STATS_PACKET_WINDOW_SECONDS),
-    _starveHistory(STARVE_HISTORY_CAPACITY),
+    _concealedFrameStats(0, STATS_FOR_STATS_PACKET_WINDOW_SECONDS),
+    _stretchedFrameStats(0, STATS_FOR_STATS_PACKET_WINDOW_SECONDS),
     _unplayedMs(0, UNPLAYED_MS_WINDOW_SECS),
     _timeGapStatsForStatsPacket(0, STATS_FOR_STATS_PACKET_WINDOW_SECONDS) {}
 
@@ -71,6 +81,7 @@ void InboundAudioStream::reset() {
     _lastPopOutput = AudioRingBuffer::ConstIterator();
     _isStarved = true;
     _hasStarted = false;
+    _concealment.reset();
     resetStats();
     // FIXME: calling cleanupCodec() seems to be the cause of the buzzsaw -- we get an assert
     // after this is called in AudioClient.  Ponder and fix...
@@ -87,9 +98,13 @@ void InboundAudioStream::resetStats() {
     _oldFramesDropped = 0;
     _incomingSequenceNumberStats.reset();
     _lastPacketReceivedTime = 0;
-    _timeGapStatsForDesiredCalcOnTooManyStarves.reset();
-    _timeGapStatsForDesiredReduction.reset();
-    _starveHistory.clear();
+    _jitterEstimator.reset();
+    _packetDelayUsecs = 0;
+    _hasPlayoutDelay = false;
+    _framesConcealed = 0;
+    _framesStretched = 0;
+    _concealedFrameStats.reset();
+    _stretchedFrameStats.reset();
     _framesAvailableStat.reset();
     _currentJitterBufferFrames = 0;
     _timeGapStatsForStatsPacket.reset();
@@ -98,6 +113,7 @@ void InboundAudioStream::resetStats() {
 
 void InboundAudioStream::clearBuffer() {
     _ringBuffer.clear();
+    _hasPlayoutDelay = false;
     _framesAvailableStat.reset();
     _currentJitterBufferFrames = 0;
 }
@@ -110,10 +126,10 @@ void InboundAudioStream::setReverb(float reverbTime, float wetLevel) {
 
 void InboundAudioStream::perSecondCallbackForUpdatingStats() {
     _incomingSequenceNumberStats.pushStatsToHistory();
-    _timeGapStatsForDesiredCalcOnTooManyStarves.currentIntervalComplete();
-    _timeGapStatsForDesiredReduction.currentIntervalComplete();
     _timeGapStatsForStatsPacket.currentIntervalComplete();
     _unplayedMs.currentIntervalComplete();
+    _concealedFrameStats.currentIntervalComplete();
+    _stretchedFrameStats.currentIntervalComplete();
 }
 
 int InboundAudioStream::parseData(ReceivedMessage& message) {
@@ -126,6 +142,23 @@ int InboundAudioStream::parseData(ReceivedMessage& message) {
 
     packetReceivedUpdateTimingStats();
 
+    if (arrivalInfo._status != SequenceNumberStats::Unreasonable) {
+        // timed when the packet reached the socket, the mixer only gets to parse packets once per frame
+        auto arrivalTime = message.getFirstPacketReceiveTime().time_since_epoch();
+        quint64 arrivalUsecs = std::chrono::duration_cast<std::chrono::microseconds>(arrivalTime).count();
+        _packetDelayUsecs = _jitterEstimator.packetArrived(sequence, arrivalUsecs);
+
+        int calculatedJitterBufferFrames = std::max((int)ceilf((float)getTargetDelayUsecs()
+                                                               / (float)AudioConstants::NETWORK_FRAME_USECS), 1);
+        if (calculatedJitterBufferFrames != _calculatedJitterBufferFrames) {
+            _calculatedJitterBufferFrames = calculatedJitterBufferFrames;
+            if (_dynamicJitterBufferEnabled) {
+                _desiredJitterBufferFrames = _calculatedJitterBufferFrames;
+                qCInfo(audiostream, "Set desired jitter frames to %d", _desiredJitterBufferFrames);
+            }
+        }
+    }
+
     int networkFrames;
 
     // parse the info after the seq number and before the audio data (the stream properties)
@@ -244,14 +277,14 @@ int InboundAudioStream::parseStreamProperties(PacketType type, const QByteArray&
 
 int InboundAudioStream::lostAudioData(int numPackets) {
     QByteArray decodedBuffer;
+    int numChannels = getNetworkChannels();
 
     while (numPackets--) {
         if (_decoder) {
+            // keep the decoder in step, the concealment itself does not depend on the codec
             _decoder->lostFrame(decodedBuffer);
-        } else {
-            decodedBuffer.resize(AudioConstants::NETWORK_FRAME_BYTES_STEREO);
-            memset(decodedBuffer.data(), 0, decodedBuffer.size());
         }
+        concealLostFrame(decodedBuffer, numChannels);
         _ringBuffer.writeData(decodedBuffer.data(), decodedBuffer.size());
     }
     return 0;
@@ -264,10 +297,90 @@ int InboundAudioStream::parseAudioData(PacketType type, const QByteArray& packet
     } else {
         decodedBuffer = packetAfterStreamProperties;
     }
+
+    int numChannels = getNetworkChannels();
+    updateConcealment(decodedBuffer, numChannels);
+    stretchToTargetDelay(decodedBuffer, numChannels, AudioConstants::SAMPLE_RATE);
+
     auto actualSize = decodedBuffer.size();
     return _ringBuffer.writeData(decodedBuffer.data(), actualSize);
 }
 
+void InboundAudioStream::updateConcealment(QByteArray& decodedBuffer, int numChannels) {
+    int numFrames = decodedBuffer.size() / (numChannels * AudioConstants::SAMPLE_SIZE);
+    _concealment.receivedFrame(reinterpret_cast<int16_t*>(decodedBuffer.data()), numFrames, numChannels);
+    _concealedFrameStats.update(0.0f);
+}
+
+bool InboundAudioStream::concealLostFrame(QByteArray& decodedBuffer, int numChannels) {
+    decodedBuffer.resize(numChannels * AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL);
+    bool isConcealed = _concealment.concealFrame(reinterpret_cast<int16_t*>(decodedBuffer.data()),
+                                                 AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL, numChannels);
+    ++_framesConcealed;
+    _concealedFrameStats.update(1.0f);
+    return isConcealed;
+}
+
+void InboundAudioStream::stretchToTargetDelay(QByteArray& samples, int numChannels, int sampleRate) {
+    if (!_dynamicJitterBufferEnabled || _isStarved) {
+        // while refilling, the buffer is meant to grow
+        return;
+    }
+
+    // this frame plays once everything buffered ahead of it has, count from when the fastest packet would have arrived
+    int bufferedUsecs = (int)((qint64)_ringBuffer.samplesAvailable() * AudioConstants::NETWORK_FRAME_USECS
+                              / _ringBuffer.getNumFrameSamples());
+    float playoutDelayUsecs = (float)(bufferedUsecs + _packetDelayUsecs);
+    if (_hasPlayoutDelay) {
+        _playoutDelayUsecs += PLAYOUT_DELAY_FILTER * (playoutDelayUsecs - _playoutDelayUsecs);
+    } else {
+        _playoutDelayUsecs = playoutDelayUsecs;
+        _hasPlayoutDelay = true;
+    }
+
+    int targetDelayUsecs = getTargetDelayUsecs();
+    bool shouldCompress = _playoutDelayUsecs > targetDelayUsecs + TARGET_DELAY_TOLERANCE_USECS;
+    bool shouldExpand = _playoutDelayUsecs < targetDelayUsecs;
+    if (!shouldCompress && !shouldExpand) {
+        _stretchedFrameStats.update(0.0f);
+        return;
+    }
+
+    int numFrames = samples.size() / (numChannels * AudioConstants::SAMPLE_SIZE);
+    auto input = reinterpret_cast<const int16_t*>(samples.constData());
+    QByteArray stretchedSamples((numFrames + AudioTimeStretch::getMaxLag(sampleRate)) * numChannels * AudioConstants::SAMPLE_SIZE,
+                                Qt::Uninitialized);
+    auto output = reinterpret_cast<int16_t*>(stretchedSamples.data());
+
+    int stretchedFrames = shouldCompress ?
+        AudioTimeStretch::compress(input, output, numFrames, numChannels, sampleRate) :
+        AudioTimeStretch::expand(input, output, numFrames, numChannels, sampleRate);
+
+    if (stretchedFrames == numFrames) {
+        // nothing in this frame to stretch without it being heard, try the next one
+        _stretchedFrameStats.update(0.0f);
+        return;
+    }
+
+    _playoutDelayUsecs += (float)(stretchedFrames - numFrames) * USECS_PER_SECOND / sampleRate;
+    ++_framesStretched;
+    _stretchedFrameStats.update(1.0f);
+
+    stretchedSamples.resize(stretchedFrames * numChannels * AudioConstants::SAMPLE_SIZE);
+    samples = stretchedSamples;
+}
+
+int InboundAudioStream::getTargetDelayUsecs() const {
+    if (!_dynamicJitterBufferEnabled) {
+        return _staticJitterBufferFrames * AudioConstants::NETWORK_FRAME_USECS;
+    }
+    return std::max(_jitterEstimator.getTargetDelayUsecs() + TARGET_DELAY_PADDING_USECS, AudioConstants::NETWORK_FRAME_USECS);
+}
+
+int InboundAudioStream::getNetworkChannels() const {
+    return _ringBuffer.getNumFrameSamples() / AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+}
+
 int InboundAudioStream::writeDroppableSilentFrames(int silentFrames) {
 
     // We can't guarentee that all clients have faded the stream down
@@ -289,6 +402,9 @@ int InboundAudioStream::writeDroppableSilentFrames(int silentFrames) {
         _decoder->lostFrame(decodedBuffer);
     }
 
+    // the sender went quiet, don't conceal a loss from here on with what it said before
+    _concealment.reset();
+
     // calculate how many silent frames we should drop.
     int silentSamples = silentFrames * _numChannels;
     int samplesPerFrame = _ringBuffer.getNumFrameSamples();
@@ -327,6 +443,11 @@ int InboundAudioStream::popSamples(int maxSamples, bool allOrNothing) {
         _consecutiveNotMixedCount++;
         _lastPopSucceeded = false;
     } else {
+        if (samplesAvailable < maxSamples && _concealUnderruns && _hasStarted) {
+            // we ran dry, play concealed audio until the late packets catch up (the jitter buffer then shrinks back)
+            samplesAvailable += concealUnderrun(maxSamples - samplesAvailable);
+        }
+
         if (samplesAvailable >= maxSamples) {
             // we have enough samples to pop, so we're good to pop
             popSamplesNoCheck(maxSamples);
@@ -346,6 +467,21 @@ int InboundAudioStream::popSamples(int maxSamples, bool allOrNothing) {
     return samplesPopped;
 }
 
+int InboundAudioStream::concealUnderrun(int samples) {
+    QByteArray decodedBuffer;
+    int numChannels = getNetworkChannels();
+
+    int samplesWritten = 0;
+    while (samplesWritten < samples) {
+        if (!concealLostFrame(decodedBuffer, numChannels)) {
+            // faded out, the stream is gone or too late to make up for
+            break;
+        }
+        samplesWritten += _ringBuffer.writeData(decodedBuffer.data(), decodedBuffer.size()) / AudioConstants::SAMPLE_SIZE;
+    }
+    return samplesWritten;
+}
+
 int InboundAudioStream::popFrames(int maxFrames, bool allOrNothing) {
     int numFrameSamples = _ringBuffer.getNumFrameSamples();
     int samplesPopped = popSamples(maxFrames * numFrameSamples, allOrNothing);
@@ -385,43 +521,6 @@ void InboundAudioStream::setToStarved() {
     // if we have more than the desired frames when setToStarved() is called, then we'll immediately
     // be considered refilled. in that case, there's no need to set _isStarved to true.
     _isStarved = (_ringBuffer.framesAvailable() < _desiredJitterBufferFrames);
-
-    // record the time of this starve in the starve history
-    quint64 now = usecTimestampNow();
-    _starveHistory.insert(now);
-
-    if (_dynamicJitterBufferEnabled) {
-        // dynamic jitter buffers are enabled. check if this starve put us over the window
-        // starve threshold
-        quint64 windowEnd = now - WINDOW_SECONDS_FOR_DESIRED_CALC_ON_TOO_MANY_STARVES * USECS_PER_SECOND;
-        RingBufferHistory<quint64>::Iterator starvesIterator = _starveHistory.begin();
-        RingBufferHistory<quint64>::Iterator end = _starveHistory.end();
-        int starvesInWindow = 1;
-        do {
-            ++starvesIterator;
-            if (*starvesIterator < windowEnd) {
-                break;
-            }
-            starvesInWindow++;
-        } while (starvesIterator != end);
-
-        // this starve put us over the starve threshold. update _desiredJitterBufferFrames to
-        // value determined by window A.
-        if (starvesInWindow >= WINDOW_STARVE_THRESHOLD) {
-            int calculatedJitterBufferFrames;
-            // we don't know when the next packet will arrive, so it's possible the gap between the last packet and the
-            // next packet will exceed the max time gap in the window.  If the time since the last packet has already exceeded
-            // the window max gap, then we should use that value to calculate desired frames.
-            int framesSinceLastPacket = ceilf((float)(now - _lastPacketReceivedTime)
-                                              / (float)AudioConstants::NETWORK_FRAME_USECS);
-            calculatedJitterBufferFrames = std::max(_calculatedJitterBufferFrames, framesSinceLastPacket);
-            // make sure _desiredJitterBufferFrames does not become lower here
-            if (calculatedJitterBufferFrames >= _desiredJitterBufferFrames) {
-                _desiredJitterBufferFrames = calculatedJitterBufferFrames;
-                qCInfo(audiostream, "Set desired jitter frames to %d (starved)", _desiredJitterBufferFrames);
-            }
-        }
-    }
 }
 
 void InboundAudioStream::setDynamicJitterBufferEnabled(bool enable) {
@@ -445,37 +544,13 @@ void InboundAudioStream::setStaticJitterBufferFrames(int staticJitterBufferFrame
 
 void InboundAudioStream::packetReceivedUpdateTimingStats() {
     
-    // update our timegap stats and desired jitter buffer frames if necessary
+    // update our timegap stats
     // discard the first few packets we receive since they usually have gaps that aren't represensative of normal jitter
     const quint32 NUM_INITIAL_PACKETS_DISCARD = 1000; // 10s
     quint64 now = usecTimestampNow();
     if (_incomingSequenceNumberStats.getReceived() > NUM_INITIAL_PACKETS_DISCARD) {
         quint64 gap = now - _lastPacketReceivedTime;
         _timeGapStatsForStatsPacket.update(gap);
-
-        // update all stats used for desired frames calculations under dynamic jitter buffer mode
-        _timeGapStatsForDesiredCalcOnTooManyStarves.update(gap);
-        _timeGapStatsForDesiredReduction.update(gap);
-
-        if (_timeGapStatsForDesiredCalcOnTooManyStarves.getNewStatsAvailableFlag()) {
-            _calculatedJitterBufferFrames = ceilf((float)_timeGapStatsForDesiredCalcOnTooManyStarves.getWindowMax()
-                                                             / (float) AudioConstants::NETWORK_FRAME_USECS);
-            _timeGapStatsForDesiredCalcOnTooManyStarves.clearNewStatsAvailableFlag();
-        }
-
-        if (_dynamicJitterBufferEnabled) {
-            // if the max gap in window B (_timeGapStatsForDesiredReduction) corresponds to a smaller number of frames than _desiredJitterBufferFrames,
-            // then reduce _desiredJitterBufferFrames to that number of frames.
-            if (_timeGapStatsForDesiredReduction.getNewStatsAvailableFlag() && _timeGapStatsForDesiredReduction.isWindowFilled()) {
-                int calculatedJitterBufferFrames = ceilf((float)_timeGapStatsForDesiredReduction.getWindowMax()
-                                                         / (float)AudioConstants::NETWORK_FRAME_USECS);
-                if (calculatedJitterBufferFrames < _desiredJitterBufferFrames) {
-                    _desiredJitterBufferFrames = calculatedJitterBufferFrames;
-                    qCInfo(audiostream, "Set desired jitter frames to %d (reduced)", _desiredJitterBufferFrames);
-                }
-                _timeGapStatsForDesiredReduction.clearNewStatsAvailableFlag();
-            }
-        }
     }
 
     _lastPacketReceivedTime = now;
@@ -499,6 +574,10 @@ AudioStreamStats InboundAudioStream::getAudioStreamStats() const {
     streamStats._consecutiveNotMixedCount = _consecutiveNotMixedCount;
     streamStats._overflowCount = _ringBuffer.getOverflowCount();
     streamStats._framesDropped = _silentFramesDropped + _oldFramesDropped;    // TODO: add separate stat for old frames dropped
+    streamStats._targetDelayMs = (quint16)(getTargetDelayUsecs() / USECS_PER_MSEC);
+    streamStats._framesConcealed = _framesConcealed;
+    streamStats._concealedRate = (float)_concealedFrameStats.getWindowAverage();
+    streamStats._stretchedRate = (float)_stretchedFrameStats.getWindowAverage();
 
     streamStats._packetStreamStats = _incomingSequenceNumberStats.getStats();
     streamStats._packetStreamWindowStats = _incomingSequenceNumberStats.getStatsForHistoryWindow();
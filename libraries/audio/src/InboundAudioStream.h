@@ -21,6 +21,8 @@
 
 #include <plugins/CodecPlugin.h>
 
+#include "AudioConcealment.h"
+#include "AudioJitterEstimator.h"
 #include "AudioRingBuffer.h"
 #include "MovingMinMaxAvg.h"
 #include "SequenceNumberStats.h"
@@ -69,10 +71,17 @@ public:
     void setDynamicJitterBufferEnabled(bool enable);
     void setStaticJitterBufferFrames(int staticJitterBufferFrames);
 
+    /// when enabled, a stream that runs dry plays concealed audio until its late packets catch up instead of starving.
+    /// Only for streams that are never popped while a packet is being parsed.
+    void setConcealUnderruns(bool concealUnderruns) { _concealUnderruns = concealUnderruns; }
+
     virtual AudioStreamStats getAudioStreamStats() const;
 
     /// returns the desired number of jitter buffer frames under the dyanmic jitter buffers scheme
     int getCalculatedJitterBufferFrames() const { return _calculatedJitterBufferFrames; }
+
+    /// the delay, from the fastest a packet can arrive to when it plays, the dynamic jitter buffer stretches towards
+    int getTargetDelayUsecs() const;
     
     bool dynamicJitterBufferEnabled() const { return _dynamicJitterBufferEnabled; }
     int getStaticJitterBufferFrames() { return _staticJitterBufferFrames; }
@@ -91,6 +100,8 @@ public:
     int getStarveCount() const { return _starveCount; }
     int getSilentFramesDropped() const { return _silentFramesDropped; }
     int getOverflowCount() const { return _ringBuffer.getOverflowCount(); }
+    int getFramesConcealed() const { return _framesConcealed; }
+    int getFramesStretched() const { return _framesStretched; }
 
     int getPacketsReceived() const { return _incomingSequenceNumberStats.getReceived(); }
     
@@ -118,6 +129,9 @@ private:
     void popSamplesNoCheck(int samples);
     void framesAvailableChanged();
 
+    int concealUnderrun(int samples);
+    int getNetworkChannels() const;
+
 protected:
     // disallow copying of InboundAudioStream objects
     InboundAudioStream(const InboundAudioStream&);
@@ -137,6 +151,15 @@ protected:
 
     /// writes silent frames to the buffer that may be dropped to reduce latency caused by the buffer
     virtual int writeDroppableSilentFrames(int silentFrames);
+
+    /// blends a decoded network frame into the concealment of any loss before it, and keeps it to conceal later ones
+    void updateConcealment(QByteArray& decodedBuffer, int numChannels);
+
+    /// fills decodedBuffer with a concealed network frame, returns false once the concealment faded to silence
+    bool concealLostFrame(QByteArray& decodedBuffer, int numChannels);
+
+    /// time-stretches the samples about to be written by a fraction of a frame, if the delay is off target
+    void stretchToTargetDelay(QByteArray& samples, int numChannels, int sampleRate);
     
 protected:
 
@@ -163,11 +186,21 @@ protected:
     SequenceNumberStats _incomingSequenceNumberStats;
 
     quint64 _lastPacketReceivedTime { 0 };
-    MovingMinMaxAvg<quint64> _timeGapStatsForDesiredCalcOnTooManyStarves { 0, WINDOW_SECONDS_FOR_DESIRED_CALC_ON_TOO_MANY_STARVES };
     int _calculatedJitterBufferFrames { 0 };
-    MovingMinMaxAvg<quint64> _timeGapStatsForDesiredReduction { 0, WINDOW_SECONDS_FOR_DESIRED_REDUCTION };
 
-    RingBufferHistory<quint64> _starveHistory;
+    // dynamic jitter buffer
+    AudioJitterEstimator _jitterEstimator;
+    int _packetDelayUsecs { 0 };            // how late the last packet parsed arrived
+    bool _hasPlayoutDelay { false };
+    float _playoutDelayUsecs { 0.0f };      // filtered, from the fastest a packet can arrive to when it plays
+
+    // packet loss concealment
+    AudioConcealment _concealment;
+    bool _concealUnderruns { false };
+    int _framesConcealed { 0 };
+    int _framesStretched { 0 };
+    MovingMinMaxAvg<float> _concealedFrameStats;
+    MovingMinMaxAvg<float> _stretchedFrameStats;
 
     TimeWeightedAvg<int> _framesAvailableStat;
     MovingMinMaxAvg<float> _unplayedMs;
@@ -33,6 +33,7 @@ private:
     AudioStreamStats getAudioStreamStats() const override;
     int parseStreamProperties(PacketType type, const QByteArray& packetAfterSeqNum, int& numAudioSamples) override;
 
+protected:
     const QUuid _streamIdentifier;
     float _radius;
     float _attenuationRatio;
@@ -37,11 +37,10 @@ int MixedProcessedAudioStream::lostAudioData(int numPackets) {
 
     while (numPackets--) {
         if (_decoder) {
+            // keep the decoder in step, the concealment itself does not depend on the codec
             _decoder->lostFrame(decodedBuffer);
-        } else {
-            decodedBuffer.resize(AudioConstants::NETWORK_FRAME_BYTES_STEREO);
-            memset(decodedBuffer.data(), 0, decodedBuffer.size());
         }
+        concealLostFrame(decodedBuffer, AudioConstants::STEREO);
 
         emit addedStereoSamples(decodedBuffer);
 
@@ -61,11 +60,16 @@ int MixedProcessedAudioStream::parseAudioData(PacketType type, const QByteArray&
         decodedBuffer = packetAfterStreamProperties;
     }
 
+    updateConcealment(decodedBuffer, AudioConstants::STEREO);
+
     emit addedStereoSamples(decodedBuffer);
 
     QByteArray outputBuffer;
     emit processSamples(decodedBuffer, outputBuffer);
 
+    // processing expects whole network frames, so stretch what comes out of it at the device rate
+    stretchToTargetDelay(outputBuffer, _outputChannelCount, _outputSampleRate);
+
     _ringBuffer.writeData(outputBuffer.data(), outputBuffer.size());
     qCDebug(audiostream, "Wrote %d samples to buffer (%d available)", outputBuffer.size() / (int)sizeof(int16_t), getSamplesAvailable());
 
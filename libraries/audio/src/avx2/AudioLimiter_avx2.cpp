@@ -0,0 +1,283 @@
+//
+//  AudioLimiter_avx2.cpp
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifdef __AVX2__
+
+#include <stdint.h>
+#include <immintrin.h>
+
+#include "../AudioDynamics.h"
+
+// high 32 bits of the signed 32x32-bit products, as MULHI()
+static inline __m256i mulhi_epi32(__m256i a, __m256i b) {
+
+    __m256i even = _mm256_mul_epi32(a, b);
+    __m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+
+    return _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xaa);
+}
+
+// peak detect across channels, returns true if any input sample was non-zero
+bool peakDetect_AVX2(const float* input, float* peak, int numFrames, int numChannels) {
+
+    const __m256 FABS_MASK = _mm256_castsi256_ps(_mm256_set1_epi32(IEEE754_FABS_MASK));
+    const __m256 ZERO = _mm256_setzero_ps();
+    __m256 nonzero = _mm256_setzero_ps();
+
+    int n = 0;
+    if (numChannels == 1) {
+
+        for (; n < numFrames - 7; n += 8) {
+            __m256 x0 = _mm256_loadu_ps(&input[n]);
+            nonzero = _mm256_or_ps(nonzero, _mm256_cmp_ps(x0, ZERO, _CMP_NEQ_UQ));
+
+            _mm256_storeu_ps(&peak[n], _mm256_and_ps(x0, FABS_MASK));
+        }
+
+    } else if (numChannels == 2) {
+
+        for (; n < numFrames - 7; n += 8) {
+            __m256 x0 = _mm256_loadu_ps(&input[2*n+0]);
+            __m256 x1 = _mm256_loadu_ps(&input[2*n+8]);
+            nonzero = _mm256_or_ps(nonzero, _mm256_cmp_ps(x0, ZERO, _CMP_NEQ_UQ));
+            nonzero = _mm256_or_ps(nonzero, _mm256_cmp_ps(x1, ZERO, _CMP_NEQ_UQ));
+
+            x0 = _mm256_and_ps(x0, FABS_MASK);
+            x1 = _mm256_and_ps(x1, FABS_MASK);
+
+            // max of each left/right pair
+            x0 = _mm256_max_ps(x0, _mm256_permute_ps(x0, _MM_SHUFFLE(2,3,0,1)));
+            x1 = _mm256_max_ps(x1, _mm256_permute_ps(x1, _MM_SHUFFLE(2,3,0,1)));
+
+            // frames 0 1 4 5 2 3 6 7, back into order
+            x0 = _mm256_shuffle_ps(x0, x1, _MM_SHUFFLE(2,0,2,0));
+            x0 = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(x0), _MM_SHUFFLE(3,1,2,0)));
+
+            _mm256_storeu_ps(&peak[n], x0);
+        }
+
+    } else if (numChannels == 4) {
+
+        const __m256i ORDER = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+        for (; n < numFrames - 7; n += 8) {
+            __m256 x0 = _mm256_loadu_ps(&input[4*n+0]);
+            __m256 x1 = _mm256_loadu_ps(&input[4*n+8]);
+            __m256 x2 = _mm256_loadu_ps(&input[4*n+16]);
+            __m256 x3 = _mm256_loadu_ps(&input[4*n+24]);
+            nonzero = _mm256_or_ps(nonzero, _mm256_cmp_ps(x0, ZERO, _CMP_NEQ_UQ));
+            nonzero = _mm256_or_ps(nonzero, _mm256_cmp_ps(x1, ZERO, _CMP_NEQ_UQ));
+            nonzero = _mm256_or_ps(nonzero, _mm256_cmp_ps(x2, ZERO, _CMP_NEQ_UQ));
+            nonzero = _mm256_or_ps(nonzero, _mm256_cmp_ps(x3, ZERO, _CMP_NEQ_UQ));
+
+            x0 = _mm256_and_ps(x0, FABS_MASK);
+            x1 = _mm256_and_ps(x1, FABS_MASK);
+            x2 = _mm256_and_ps(x2, FABS_MASK);
+            x3 = _mm256_and_ps(x3, FABS_MASK);
+
+            // max across each frame, in every lane of its half
+            x0 = _mm256_max_ps(x0, _mm256_permute_ps(x0, _MM_SHUFFLE(2,3,0,1)));
+            x1 = _mm256_max_ps(x1, _mm256_permute_ps(x1, _MM_SHUFFLE(2,3,0,1)));
+            x2 = _mm256_max_ps(x2, _mm256_permute_ps(x2, _MM_SHUFFLE(2,3,0,1)));
+            x3 = _mm256_max_ps(x3, _mm256_permute_ps(x3, _MM_SHUFFLE(2,3,0,1)));
+            x0 = _mm256_max_ps(x0, _mm256_permute_ps(x0, _MM_SHUFFLE(1,0,3,2)));
+            x1 = _mm256_max_ps(x1, _mm256_permute_ps(x1, _MM_SHUFFLE(1,0,3,2)));
+            x2 = _mm256_max_ps(x2, _mm256_permute_ps(x2, _MM_SHUFFLE(1,0,3,2)));
+            x3 = _mm256_max_ps(x3, _mm256_permute_ps(x3, _MM_SHUFFLE(1,0,3,2)));
+
+            // frames 0 2 4 6 1 3 5 7, back into order
+            x0 = _mm256_blend_ps(x0, x1, 0xaa);
+            x2 = _mm256_blend_ps(x2, x3, 0xaa);
+            x0 = _mm256_blend_ps(x0, x2, 0xcc);
+            x0 = _mm256_permutevar8x32_ps(x0, ORDER);
+
+            _mm256_storeu_ps(&peak[n], x0);
+        }
+    }
+
+    bool hasAudio = _mm256_movemask_ps(nonzero) != 0;
+
+    // remaining frames
+    for (; n < numFrames; n++) {
+        float x = 0.0f;
+        for (int c = 0; c < numChannels; c++) {
+            float y = input[numChannels*n+c];
+            hasAudio |= (y != 0.0f);
+            x = MAX(x, fabsf(y));
+        }
+        peak[n] = x;
+    }
+
+    _mm256_zeroupper();
+    return hasAudio;
+}
+
+// compute limiter attenuation in log2 domain, as peaklog2()
+void peakAttn_AVX2(float* peak, int32_t* attn, int32_t threshold, int numFrames) {
+
+    int n = 0;
+    for (; n < numFrames - 7; n += 8) {
+
+        __m256i x = _mm256_castps_si256(_mm256_loadu_ps(&peak[n]));
+
+        // split into e and x - 1.0
+        __m256i e = _mm256_sub_epi32(_mm256_set1_epi32(IEEE754_EXPN_BIAS + LOG2_HEADROOM),
+                                     _mm256_srli_epi32(x, IEEE754_MANT_BITS));
+        x = _mm256_and_si256(_mm256_slli_epi32(x, IEEE754_EXPN_BITS), _mm256_set1_epi32(0x7fffffff));
+
+        __m256i k = _mm256_srli_epi32(x, 31 - LOG2_TABBITS);
+        k = _mm256_add_epi32(k, _mm256_add_epi32(k, k));    // 3 coefficients per row
+
+        // polynomial for log2(1+x) over x=[0,1]
+        __m256i c0 = _mm256_i32gather_epi32(&log2Table[0][0], k, 4);
+        __m256i c1 = _mm256_i32gather_epi32(&log2Table[0][1], k, 4);
+        __m256i c2 = _mm256_i32gather_epi32(&log2Table[0][2], k, 4);
+
+        c1 = _mm256_add_epi32(c1, mulhi_epi32(c0, x));
+        c2 = _mm256_add_epi32(c2, mulhi_epi32(c1, x));
+
+        // reconstruct result in Q26
+        x = _mm256_sub_epi32(_mm256_slli_epi32(e, LOG2_FRACBITS), _mm256_srai_epi32(c2, 3));
+
+        // saturate
+        __m256i saturate = _mm256_cmpgt_epi32(e, _mm256_set1_epi32(31));
+        x = _mm256_blendv_epi8(x, _mm256_set1_epi32(0x7fffffff), saturate);
+
+        x = _mm256_max_epi32(_mm256_sub_epi32(_mm256_set1_epi32(threshold), x), _mm256_setzero_si256());
+
+        _mm256_storeu_si256((__m256i*)&attn[n], x);
+    }
+
+    // remaining frames
+    for (; n < numFrames; n++) {
+        int32_t x = peaklog2(&peak[n]);
+        attn[n] = MAX(threshold - x, 0);
+    }
+
+    _mm256_zeroupper();
+}
+
+// convert from log2 domain, as fixexp2()
+void attnExp2_AVX2(int32_t* attn, int numFrames) {
+
+    int n = 0;
+    for (; n < numFrames - 7; n += 8) {
+
+        __m256i u = _mm256_loadu_si256((__m256i*)&attn[n]);
+
+        // split into e and 1.0 - x
+        __m256i e = _mm256_srli_epi32(u, LOG2_FRACBITS);
+        __m256i x = _mm256_andnot_si256(_mm256_slli_epi32(u, LOG2_INTBITS), _mm256_set1_epi32(0x7fffffff));
+
+        __m256i k = _mm256_srli_epi32(x, 31 - EXP2_TABBITS);
+        k = _mm256_add_epi32(k, _mm256_add_epi32(k, k));    // 3 coefficients per row
+
+        // polynomial for exp2(x)
+        __m256i c0 = _mm256_i32gather_epi32(&exp2Table[0][0], k, 4);
+        __m256i c1 = _mm256_i32gather_epi32(&exp2Table[0][1], k, 4);
+        __m256i c2 = _mm256_i32gather_epi32(&exp2Table[0][2], k, 4);
+
+        c1 = _mm256_add_epi32(c1, mulhi_epi32(c0, x));
+        c2 = _mm256_add_epi32(c2, mulhi_epi32(c1, x));
+
+        // reconstruct result in Q31
+        x = _mm256_srav_epi32(c2, e);
+
+        // x <= 0 returns 0x7fffffff
+        __m256i saturate = _mm256_cmpgt_epi32(_mm256_set1_epi32(1), u);
+        x = _mm256_blendv_epi8(x, _mm256_set1_epi32(0x7fffffff), saturate);
+
+        _mm256_storeu_si256((__m256i*)&attn[n], x);
+    }
+
+    // remaining frames
+    for (; n < numFrames; n++) {
+        attn[n] = fixexp2(attn[n]);
+    }
+
+    _mm256_zeroupper();
+}
+
+// apply gain and dither, and convert to 16-bit output
+void applyGain_AVX2(const float* input, const float* gain, const float* dither, int16_t* output,
+                    int numFrames, int numChannels) {
+
+    int n = 0;
+    if (numChannels == 1) {
+
+        for (; n < numFrames - 7; n += 8) {
+            __m256 x0 = _mm256_loadu_ps(&input[n]);
+
+            x0 = _mm256_add_ps(_mm256_mul_ps(x0, _mm256_loadu_ps(&gain[n])), _mm256_loadu_ps(&dither[n]));
+
+            __m256i y = _mm256_cvtps_epi32(x0);
+            y = _mm256_packs_epi32(y, _mm256_permute2x128_si256(y, y, 0x01));
+            _mm_storeu_si128((__m128i*)&output[n], _mm256_castsi256_si128(y));
+        }
+
+    } else if (numChannels == 2) {
+
+        const __m256i SPREAD = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+
+        for (; n < numFrames - 7; n += 8) {
+            __m256 x0 = _mm256_loadu_ps(&input[2*n+0]);
+            __m256 x1 = _mm256_loadu_ps(&input[2*n+8]);
+            __m256 g0 = _mm256_castps128_ps256(_mm_loadu_ps(&gain[n+0]));
+            __m256 g1 = _mm256_castps128_ps256(_mm_loadu_ps(&gain[n+4]));
+            __m256 d0 = _mm256_castps128_ps256(_mm_loadu_ps(&dither[n+0]));
+            __m256 d1 = _mm256_castps128_ps256(_mm_loadu_ps(&dither[n+4]));
+
+            // same gain and dither for both channels
+            x0 = _mm256_add_ps(_mm256_mul_ps(x0, _mm256_permutevar8x32_ps(g0, SPREAD)), _mm256_permutevar8x32_ps(d0, SPREAD));
+            x1 = _mm256_add_ps(_mm256_mul_ps(x1, _mm256_permutevar8x32_ps(g1, SPREAD)), _mm256_permutevar8x32_ps(d1, SPREAD));
+
+            // packs interleaves the 128-bit lanes
+            __m256i y = _mm256_packs_epi32(_mm256_cvtps_epi32(x0), _mm256_cvtps_epi32(x1));
+            y = _mm256_permute4x64_epi64(y, _MM_SHUFFLE(3,1,2,0));
+            _mm256_storeu_si256((__m256i*)&output[2*n], y);
+        }
+
+    } else if (numChannels == 4) {
+
+        const __m256i SPREAD = _mm256_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1);
+
+        for (; n < numFrames - 3; n += 4) {
+            __m256 x0 = _mm256_loadu_ps(&input[4*n+0]);
+            __m256 x1 = _mm256_loadu_ps(&input[4*n+8]);
+            __m256 g0 = _mm256_castps128_ps256(_mm_castpd_ps(_mm_load_sd((const double*)&gain[n+0])));
+            __m256 g1 = _mm256_castps128_ps256(_mm_castpd_ps(_mm_load_sd((const double*)&gain[n+2])));
+            __m256 d0 = _mm256_castps128_ps256(_mm_castpd_ps(_mm_load_sd((const double*)&dither[n+0])));
+            __m256 d1 = _mm256_castps128_ps256(_mm_castpd_ps(_mm_load_sd((const double*)&dither[n+2])));
+
+            // same gain and dither for all channels
+            x0 = _mm256_add_ps(_mm256_mul_ps(x0, _mm256_permutevar8x32_ps(g0, SPREAD)), _mm256_permutevar8x32_ps(d0, SPREAD));
+            x1 = _mm256_add_ps(_mm256_mul_ps(x1, _mm256_permutevar8x32_ps(g1, SPREAD)), _mm256_permutevar8x32_ps(d1, SPREAD));
+
+            // packs interleaves the 128-bit lanes
+            __m256i y = _mm256_packs_epi32(_mm256_cvtps_epi32(x0), _mm256_cvtps_epi32(x1));
+            y = _mm256_permute4x64_epi64(y, _MM_SHUFFLE(3,1,2,0));
+            _mm256_storeu_si256((__m256i*)&output[4*n], y);
+        }
+    }
+
+    // remaining frames
+    for (; n < numFrames; n++) {
+        for (int c = 0; c < numChannels; c++) {
+            float x = input[numChannels*n+c];
+            x *= gain[n];
+            x += dither[n];
+            output[numChannels*n+c] = (int16_t)floatToInt(x);
+        }
+    }
+
+    _mm256_zeroupper();
+}
+
+#endif
@@ -0,0 +1,106 @@
+//
+//  AudioReverb_avx2.cpp
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifdef __AVX2__
+
+#include <immintrin.h>
+
+// output = gain * input
+void gainBlock_AVX2(const float* input, float* output, float gain, int numFrames) {
+
+    __m256 g = _mm256_set1_ps(gain);
+
+    int i = 0;
+    for (; i < numFrames - 7; i += 8) {
+        _mm256_storeu_ps(&output[i], _mm256_mul_ps(g, _mm256_loadu_ps(&input[i])));
+    }
+    for (; i < numFrames; i++) {
+        output[i] = gain * input[i];
+    }
+
+    _mm256_zeroupper();
+}
+
+// output = input0 + input1
+void addBlock_AVX2(const float* input0, const float* input1, float* output, int numFrames) {
+
+    int i = 0;
+    for (; i < numFrames - 7; i += 8) {
+        _mm256_storeu_ps(&output[i], _mm256_add_ps(_mm256_loadu_ps(&input0[i]), _mm256_loadu_ps(&input1[i])));
+    }
+    for (; i < numFrames; i++) {
+        output[i] = input0[i] + input1[i];
+    }
+
+    _mm256_zeroupper();
+}
+
+// output = (input0 + input1 * mix1 + input2 * mix2) * gain
+void mixBlock_AVX2(const float* input0, const float* input1, const float* input2, float* output,
+                   float mix1, float mix2, float gain, int numFrames) {
+
+    __m256 m1 = _mm256_set1_ps(mix1);
+    __m256 m2 = _mm256_set1_ps(mix2);
+    __m256 g = _mm256_set1_ps(gain);
+
+    int i = 0;
+    for (; i < numFrames - 7; i += 8) {
+        __m256 x0 = _mm256_fmadd_ps(_mm256_loadu_ps(&input1[i]), m1, _mm256_loadu_ps(&input0[i]));
+        x0 = _mm256_fmadd_ps(_mm256_loadu_ps(&input2[i]), m2, x0);
+        _mm256_storeu_ps(&output[i], _mm256_mul_ps(x0, g));
+    }
+    for (; i < numFrames; i++) {
+        output[i] = (input0[i] + input1[i] * mix1 + input2[i] * mix2) * gain;
+    }
+
+    _mm256_zeroupper();
+}
+
+// output = dry + (wet - dry) * mix
+void wetDryBlock_AVX2(const float* dry, const float* wet, float* output, float mix, int numFrames) {
+
+    __m256 m = _mm256_set1_ps(mix);
+
+    int i = 0;
+    for (; i < numFrames - 7; i += 8) {
+        __m256 x0 = _mm256_loadu_ps(&dry[i]);
+        __m256 y0 = _mm256_loadu_ps(&wet[i]);
+        _mm256_storeu_ps(&output[i], _mm256_fmadd_ps(_mm256_sub_ps(y0, x0), m, x0));
+    }
+    for (; i < numFrames; i++) {
+        output[i] = dry[i] + (wet[i] - dry[i]) * mix;
+    }
+
+    _mm256_zeroupper();
+}
+
+// allpass, where the delayed feedback is already in delayed[]
+// NOTE: feedback[] may overlap delayed[], ahead of it
+void allpassBlock_AVX2(const float* delayed, const float* input, float* output, float* feedback,
+                       float coef, int numFrames) {
+
+    __m256 c = _mm256_set1_ps(coef);
+
+    int i = 0;
+    for (; i < numFrames - 7; i += 8) {
+        __m256 x0 = _mm256_loadu_ps(&input[i]);
+        __m256 y0 = _mm256_fnmadd_ps(c, x0, _mm256_loadu_ps(&delayed[i]));    // feedforward path
+        _mm256_storeu_ps(&output[i], y0);
+        _mm256_storeu_ps(&feedback[i], _mm256_fmadd_ps(c, y0, x0));           // feedback path
+    }
+    for (; i < numFrames; i++) {
+        output[i] = delayed[i] - coef * input[i];
+        feedback[i] = input[i] + coef * output[i];
+    }
+
+    _mm256_zeroupper();
+}
+
+#endif
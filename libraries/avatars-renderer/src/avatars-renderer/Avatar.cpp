@@ -337,42 +337,54 @@ void Avatar::updateAvatarEntities() {
 
 void Avatar::simulate(float deltaTime, bool inView) {
     PROFILE_RANGE(simulation, "simulate");
+    PerformanceTimer perfTimer("simulate");
+    simulateJoints(deltaTime, inView);
+    finishSimulate(deltaTime, inView);
+}
+
+void Avatar::simulateJoints(float deltaTime, bool inView) {
+    PROFILE_RANGE(simulation, "updateJoints");
 
     _simulationRate.increment();
     if (inView) {
         _simulationInViewRate.increment();
     }
 
-    PerformanceTimer perfTimer("simulate");
+    if (inView && _hasNewJointData) {
+        _skeletonModel->getRig().copyJointsFromJointData(_jointData);
+        glm::mat4 rootTransform = glm::scale(_skeletonModel->getScale()) * glm::translate(_skeletonModel->getOffset());
+        _skeletonModel->getRig().computeExternalPoses(rootTransform);
+        _jointDataSimulationRate.increment();
+
+        _hasNewJointData = false;
+        _hasSimulatedNewJoints = true;
+    }
+}
+
+void Avatar::finishSimulate(float deltaTime, bool inView) {
     {
-        PROFILE_RANGE(simulation, "updateJoints");
-        if (inView) {
-            Head* head = getHead();
-            if (_hasNewJointData) {
-                _skeletonModel->getRig().copyJointsFromJointData(_jointData);
-                glm::mat4 rootTransform = glm::scale(_skeletonModel->getScale()) * glm::translate(_skeletonModel->getOffset());
-                _skeletonModel->getRig().computeExternalPoses(rootTransform);
-                _jointDataSimulationRate.increment();
-
-                _skeletonModel->simulate(deltaTime, true);
-
-                locationChanged(); // joints changed, so if there are any children, update them.
-                _hasNewJointData = false;
-
-                glm::vec3 headPosition = getPosition();
-                if (!_skeletonModel->getHeadPosition(headPosition)) {
-                    headPosition = getPosition();
-                }
-                head->setPosition(headPosition);
+        PROFILE_RANGE(simulation, "updateModel");
+        if (_hasSimulatedNewJoints) {
+            _hasSimulatedNewJoints = false;
+            _skeletonModel->simulate(deltaTime, true);
+            locationChanged(); // joints changed, so if there are any children, update them.
+
+            glm::vec3 headPosition = getPosition();
+            if (!_skeletonModel->getHeadPosition(headPosition)) {
+                headPosition = getPosition();
             }
-            head->setScale(getModelScale());
-            head->simulate(deltaTime);
-        } else {
+            getHead()->setPosition(headPosition);
+        } else if (!inView) {
             // a non-full update is still required so that the position, rotation, scale and bounds of the skeletonModel are updated.
             _skeletonModel->simulate(deltaTime, false);
         }
         _skeletonModelSimulationRate.increment();
     }
+    if (inView) {
+        Head* head = getHead();
+        head->setScale(getModelScale());
+        head->simulate(deltaTime);
+    }
 
     // update animation for display name fade in/out
     if ( _displayNameTargetAlpha != _displayNameAlpha) {
@@ -550,7 +562,7 @@ void Avatar::removeFromScene(AvatarSharedPointer self, const render::ScenePointe
 
 void Avatar::updateRenderItem(render::Transaction& transaction) {
     if (render::Item::isValidID(_renderItemID)) {
-        transaction.updateItem<render::Payload<AvatarData>>(_renderItemID, [](render::Payload<AvatarData>& p) {});
+        transaction.updateItem(_renderItemID);
     }
 }
 
@@ -86,6 +86,12 @@ public:
     void init();
     void updateAvatarEntities();
     void simulate(float deltaTime, bool inView);
+
+    // simulate() split in two: simulateJoints() only does the rig's pose math and only touches this avatar, so
+    // different avatars may run it concurrently on worker threads. finishSimulate() must follow on the main thread,
+    // it updates the model (geometry, gpu buffers and blendshapes) which is main-thread only.
+    void simulateJoints(float deltaTime, bool inView);
+    void finishSimulate(float deltaTime, bool inView);
     virtual void simulateAttachments(float deltaTime);
 
     virtual void render(RenderArgs* renderArgs);
@@ -347,6 +353,8 @@ protected:
     RateCounter<> _skeletonModelSimulationRate;
     RateCounter<> _jointDataSimulationRate;
 
+    bool _hasSimulatedNewJoints { false }; // set by simulateJoints(), consumed by finishSimulate()
+
 private:
     class AvatarEntityDataHash {
     public:
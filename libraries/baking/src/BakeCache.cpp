@@ -0,0 +1,157 @@
+//
+//  BakeCache.cpp
+//  libraries/baking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BakeCache.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QUuid>
+
+#include "ModelBakingLoggingCategory.h"
+
+using Lock = std::lock_guard<std::mutex>;
+
+static const QString MANIFEST_FILE_NAME = "manifest.json";
+
+BakeCache::BakeCache(const QString& directory) : _directory(directory) {
+    if (!_directory.mkpath(".")) {
+        qCWarning(model_baking) << "Could not create bake cache folder" << directory;
+    }
+}
+
+QByteArray BakeCache::hashContent(const QByteArray& content) {
+    return QCryptographicHash::hash(content, QCryptographicHash::Sha1).toHex();
+}
+
+QString BakeCache::makeKey(const QByteArray& contentHash, const QString& bakerName, int bakerVersion,
+                           const QString& options) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(contentHash);
+    hash.addData(bakerName.toUtf8());
+    hash.addData(QByteArray::number(bakerVersion));
+    hash.addData(options.toUtf8());
+    return hash.result().toHex();
+}
+
+QString BakeCache::getEntryPath(const QString& key) const {
+    // fan out on the first two characters so no single folder ends up with every entry
+    return _directory.absoluteFilePath(key.left(2) + "/" + key);
+}
+
+bool BakeCache::contains(const QString& key) const {
+    return QFileInfo(getEntryPath(key) + "/" + MANIFEST_FILE_NAME).exists();
+}
+
+BakeCache::Claim BakeCache::claim(const QString& key) {
+    Lock lock(_mutex);
+    if (contains(key)) {
+        ++_hits;
+        return Claim::Hit;
+    }
+    if (_pendingKeys.contains(key)) {
+        return Claim::Wait;
+    }
+    _pendingKeys.insert(key);
+    ++_misses;
+    return Claim::Bake;
+}
+
+bool BakeCache::store(const QString& key, const QHash<QString, QStringList>& filesBySubdirectory,
+                      const QJsonObject& manifest) {
+    QString entryPath = getEntryPath(key);
+
+    // write everything to a temporary folder beside the entry and rename it into place once complete, so a bake that
+    // is interrupted part way never leaves an entry that looks valid
+    QString temporaryPath = entryPath + "-" + QUuid::createUuid().toString().mid(1, 8);
+    bool success = QDir().mkpath(temporaryPath);
+
+    for (auto it = filesBySubdirectory.begin(); success && it != filesBySubdirectory.end(); ++it) {
+        QDir subdirectory { temporaryPath + "/" + it.key() };
+        success = subdirectory.mkpath(".");
+        for (const auto& filePath : it.value()) {
+            if (!success) {
+                break;
+            }
+            success = QFile::copy(filePath, subdirectory.absoluteFilePath(QFileInfo(filePath).fileName()));
+        }
+    }
+
+    if (success) {
+        QFile manifestFile { temporaryPath + "/" + MANIFEST_FILE_NAME };
+        success = manifestFile.open(QIODevice::WriteOnly) &&
+            manifestFile.write(QJsonDocument(manifest).toJson(QJsonDocument::Compact)) != -1;
+    }
+
+    {
+        Lock lock(_mutex);
+        if (success && !contains(key)) {
+            QDir(entryPath).removeRecursively();
+            success = QDir().rename(temporaryPath, entryPath);
+        }
+        _pendingKeys.remove(key);
+    }
+    QDir(temporaryPath).removeRecursively();
+
+    if (!success) {
+        qCWarning(model_baking) << "Could not store" << key << "in the bake cache";
+    }
+
+    emit entryFinished(key, success);
+    return success;
+}
+
+void BakeCache::release(const QString& key) {
+    {
+        Lock lock(_mutex);
+        _pendingKeys.remove(key);
+    }
+    emit entryFinished(key, false);
+}
+
+void BakeCache::remove(const QString& key) {
+    Lock lock(_mutex);
+    QDir(getEntryPath(key)).removeRecursively();
+}
+
+QStringList BakeCache::restore(const QString& key, const QString& subdirectory, const QString& destinationDirectory) {
+    QDir source { getEntryPath(key) + "/" + subdirectory };
+    QDir destination { destinationDirectory };
+    if (!destination.mkpath(".")) {
+        return QStringList();
+    }
+
+    QStringList restoredFiles;
+    for (const auto& fileName : source.entryList(QDir::Files)) {
+        QString destinationPath = destination.absoluteFilePath(fileName);
+        QFile::remove(destinationPath);
+        if (!QFile::copy(source.absoluteFilePath(fileName), destinationPath)) {
+            qCWarning(model_baking) << "Could not restore" << fileName << "from the bake cache";
+            return QStringList();
+        }
+        restoredFiles << destinationPath;
+    }
+    return restoredFiles;
+}
+
+bool BakeCache::restoreFile(const QString& key, const QString& subdirectory, const QString& fileName,
+                            const QString& destinationPath) {
+    QFile::remove(destinationPath);
+    return QFile::copy(getEntryPath(key) + "/" + subdirectory + "/" + fileName, destinationPath);
+}
+
+QJsonObject BakeCache::getManifest(const QString& key) const {
+    QFile manifestFile { getEntryPath(key) + "/" + MANIFEST_FILE_NAME };
+    if (!manifestFile.open(QIODevice::ReadOnly)) {
+        return QJsonObject();
+    }
+    return QJsonDocument::fromJson(manifestFile.readAll()).object();
+}
@@ -0,0 +1,85 @@
+//
+//  BakeCache.h
+//  libraries/baking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BakeCache_h
+#define hifi_BakeCache_h
+
+#include <atomic>
+#include <mutex>
+
+#include <QtCore/QDir>
+#include <QtCore/QJsonObject>
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+
+// A content-addressed store of baked output shared by every baker in a bake, and kept between bakes.
+//
+// Entries are keyed by the hash of the source content, the baker that produced them, its version and the options it
+// baked with, so re-baking unchanged content restores the previous output instead of redoing the work.  Bakers claim
+// a key before baking it so that identical content referenced from several places (a texture shared by many models)
+// is only baked once, the other bakers wait for the entry and restore it.
+class BakeCache : public QObject {
+    Q_OBJECT
+
+public:
+    enum class Claim {
+        Hit, // the entry exists, restore it
+        Bake, // the caller bakes and stores (or releases) the entry
+        Wait // another baker is producing the entry, wait for entryFinished
+    };
+
+    BakeCache(const QString& directory);
+
+    static QByteArray hashContent(const QByteArray& content);
+    static QString makeKey(const QByteArray& contentHash, const QString& bakerName, int bakerVersion,
+                           const QString& options = QString());
+
+    bool contains(const QString& key) const;
+    Claim claim(const QString& key);
+
+    // Copies files (absolute paths) into the entry for key, under subdirectory, and ends the claim on it.
+    // The entry only becomes visible once every file has been written.
+    bool store(const QString& key, const QHash<QString, QStringList>& filesBySubdirectory,
+               const QJsonObject& manifest = QJsonObject());
+
+    // Ends the claim on key without storing anything, after a failed bake.
+    void release(const QString& key);
+
+    // Drops an entry that turned out to be stale, e.g. because a file it was baked from has changed.
+    void remove(const QString& key);
+
+    // Copies the files of an entry's subdirectory into destinationDirectory, returns the paths of the copies.
+    QStringList restore(const QString& key, const QString& subdirectory, const QString& destinationDirectory);
+
+    // Copies a single file of an entry to destinationPath.
+    bool restoreFile(const QString& key, const QString& subdirectory, const QString& fileName,
+                     const QString& destinationPath);
+
+    QJsonObject getManifest(const QString& key) const;
+
+    int getHits() const { return _hits.load(); }
+    int getMisses() const { return _misses.load(); }
+
+signals:
+    void entryFinished(QString key, bool stored);
+
+private:
+    QString getEntryPath(const QString& key) const;
+
+    QDir _directory;
+
+    mutable std::mutex _mutex;
+    QSet<QString> _pendingKeys;
+
+    std::atomic<int> _hits { 0 };
+    std::atomic<int> _misses { 0 };
+};
+
+#endif // hifi_BakeCache_h
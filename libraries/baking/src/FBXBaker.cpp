@@ -57,6 +57,10 @@ FBXBaker::FBXBaker(const QUrl& fbxURL, TextureBakerThreadGetter textureThreadGet
 }
 
 FBXBaker::~FBXBaker() {
+    if (_claimedCacheEntry) {
+        _bakeCache->release(_cacheKey);
+    }
+
     if (_tempDir.exists()) {
         if (!_tempDir.remove(_originalFBXFilePath)) {
             qCWarning(model_baking) << "Failed to remove temporary copy of fbx file:" << _originalFBXFilePath;
@@ -107,6 +111,11 @@ void FBXBaker::bake() {
 }
 
 void FBXBaker::bakeSourceCopy() {
+    // an unchanged model that was baked before, or is being baked right now for another entity, isn't baked again
+    if (_bakeCache && checkBakeCache()) {
+        return;
+    }
+
     // load the scene from the FBX file
     importScene();
 
@@ -641,6 +650,10 @@ void FBXBaker::rewriteAndBakeSceneTextures() {
                                     QString textureID { object->properties[0].toByteArray() };
                                     auto textureType = textureTypes[textureID];
 
+                                    if (_bakeCache && textureContent.isNull()) {
+                                        addTextureDependency(urlToTexture);
+                                    }
+
                                     // bake this texture asynchronously
                                     bakeTexture(urlToTexture, textureType, _bakedOutputDir, bakedTextureFileName, textureContent);
                                 }
@@ -669,6 +682,8 @@ void FBXBaker::bakeTexture(const QUrl& textureURL, image::TextureUsage::Type tex
         &TextureBaker::deleteLater
     };
 
+    bakingTexture->setBakeCache(_bakeCache);
+
     // make sure we hear when the baking texture is done or aborted
     connect(bakingTexture.data(), &Baker::finished, this, &FBXBaker::handleBakedTexture);
     connect(bakingTexture.data(), &TextureBaker::aborted, this, &FBXBaker::handleAbortedTexture);
@@ -715,6 +730,10 @@ void FBXBaker::handleBakedTexture() {
                         if (originalTextureFile.open(QIODevice::WriteOnly) && originalTextureFile.write(bakedTexture->getOriginalTexture()) != -1) {
                             qCDebug(model_baking) << "Saved original texture file" << originalTextureFile.fileName()
                                 << "for" << _fbxURL;
+
+                            // the bake cache restores originals into a single folder
+                            _originalTextureFiles << originalTextureFile.fileName();
+                            _isCacheable = _isCacheable && relativeTexturePath.isEmpty();
                         } else {
                             handleError("Could not save original external texture " + originalTextureFile.fileName()
                                         + " for " + _fbxURL.toString());
@@ -821,12 +840,142 @@ void FBXBaker::checkIfTexturesFinished() {
     }
 }
 
+void FBXBaker::setIsFinished(bool isFinished) {
+    if (isFinished) {
+        finishBakeCacheEntry();
+    }
+
+    Baker::setIsFinished(isFinished);
+}
+
 void FBXBaker::setWasAborted(bool wasAborted) {
     if (wasAborted != _wasAborted.load()) {
         Baker::setWasAborted(wasAborted);
 
         if (wasAborted) {
             qCDebug(model_baking) << "Aborted baking" << _fbxURL;
+            finishBakeCacheEntry();
+        }
+    }
+}
+
+static const QString CACHED_BAKED_FOLDER = "baked";
+static const QString CACHED_ORIGINAL_FOLDER = "original";
+static const QString CACHED_BAKED_FBX_KEY = "bakedFBX";
+static const QString CACHED_DEPENDENCIES_KEY = "dependencies";
+
+bool FBXBaker::checkBakeCache() {
+    if (_cacheKey.isEmpty()) {
+        QFile sourceFile { _originalFBXFilePath };
+        if (!sourceFile.open(QIODevice::ReadOnly)) {
+            return false;
         }
+
+        // the cached bake includes the model's textures, so it is only valid for the same texture baking
+        auto options = QString("texture=%1 color=%2 normal=%3 grayscale=%4 cube=%5").arg(TextureBaker::BAKE_VERSION)
+            .arg((int)image::isColorTexturesCompressionEnabled()).arg((int)image::isNormalTexturesCompressionEnabled())
+            .arg((int)image::isGrayscaleTexturesCompressionEnabled()).arg((int)image::isCubeTexturesCompressionEnabled());
+        _cacheKey = BakeCache::makeKey(BakeCache::hashContent(sourceFile.readAll()), "fbx", BAKE_VERSION, options);
+    }
+
+    // listen before claiming, the baker that owns the entry could finish between a Wait and a later connect
+    _isWaitingForCacheEntry = false;
+    disconnect(_cacheConnection);
+    _cacheConnection = connect(_bakeCache.data(), &BakeCache::entryFinished, this, [this](QString key) {
+        if (key == _cacheKey && _isWaitingForCacheEntry) {
+            _isWaitingForCacheEntry = false;
+            disconnect(_cacheConnection);
+            bakeSourceCopy();
+        }
+    });
+
+    auto claim = _bakeCache->claim(_cacheKey);
+    if (claim == BakeCache::Claim::Hit) {
+        if (restoreFromBakeCache()) {
+            disconnect(_cacheConnection);
+            return true;
+        }
+        _bakeCache->remove(_cacheKey);
+        claim = _bakeCache->claim(_cacheKey);
+    }
+
+    if (claim == BakeCache::Claim::Wait) {
+        _isWaitingForCacheEntry = true;
+        return true;
+    }
+
+    disconnect(_cacheConnection);
+    _claimedCacheEntry = true;
+    return false;
+}
+
+bool FBXBaker::restoreFromBakeCache() {
+    auto manifest = _bakeCache->getManifest(_cacheKey);
+
+    // linked textures can change without the FBX changing
+    auto dependencies = manifest[CACHED_DEPENDENCIES_KEY].toObject();
+    for (auto it = dependencies.begin(); it != dependencies.end(); ++it) {
+        QFile textureFile { it.key() };
+        if (!textureFile.open(QIODevice::ReadOnly) ||
+            QString(BakeCache::hashContent(textureFile.readAll())) != it.value().toString()) {
+            qCDebug(model_baking) << "Cached bake of" << _fbxURL << "is stale," << it.key() << "has changed";
+            return false;
+        }
+    }
+
+    auto bakedFBXFileName = manifest[CACHED_BAKED_FBX_KEY].toString();
+    auto bakedFiles = _bakeCache->restore(_cacheKey, CACHED_BAKED_FOLDER, _bakedOutputDir);
+    if (bakedFBXFileName.isEmpty() || bakedFiles.isEmpty()) {
+        return false;
+    }
+    if (!_originalOutputDir.isEmpty()) {
+        _bakeCache->restore(_cacheKey, CACHED_ORIGINAL_FOLDER, _originalOutputDir);
+    }
+
+    _bakedFBXFilePath = _bakedOutputDir + "/" + bakedFBXFileName;
+    _outputFiles.assign(bakedFiles.begin(), bakedFiles.end());
+    _wasRestoredFromCache = true;
+
+    qCDebug(model_baking) << "Restored" << _fbxURL << "from the bake cache";
+    setIsFinished(true);
+    return true;
+}
+
+void FBXBaker::addTextureDependency(const QUrl& textureURL) {
+    if (!textureURL.isLocalFile()) {
+        // there's no cheap way to tell whether a remote texture has changed, so bakes linking one aren't reused
+        _isCacheable = false;
+        return;
+    }
+
+    QFile textureFile { textureURL.toLocalFile() };
+    if (textureFile.open(QIODevice::ReadOnly)) {
+        _textureDependencies[textureURL.toLocalFile()] = QString(BakeCache::hashContent(textureFile.readAll()));
+    } else {
+        _isCacheable = false;
+    }
+}
+
+void FBXBaker::finishBakeCacheEntry() {
+    if (!_claimedCacheEntry) {
+        return;
+    }
+    _claimedCacheEntry = false;
+
+    if (_isCacheable && !hasErrors() && !wasAborted() && !_bakedFBXFilePath.isEmpty()) {
+        QStringList bakedFiles;
+        for (const auto& file : _outputFiles) {
+            bakedFiles << file;
+        }
+
+        QJsonObject manifest;
+        manifest[CACHED_BAKED_FBX_KEY] = QFileInfo(_bakedFBXFilePath).fileName();
+        manifest[CACHED_DEPENDENCIES_KEY] = _textureDependencies;
+        QHash<QString, QStringList> files;
+        files[CACHED_BAKED_FOLDER] = bakedFiles;
+        files[CACHED_ORIGINAL_FOLDER] = _originalTextureFiles;
+        _bakeCache->store(_cacheKey, files, manifest);
+    } else {
+        _bakeCache->release(_cacheKey);
     }
 }
@@ -17,6 +17,7 @@
 #include <QtCore/QUrl>
 #include <QtNetwork/QNetworkReply>
 
+#include "BakeCache.h"
 #include "Baker.h"
 #include "TextureBaker.h"
 
@@ -37,9 +38,17 @@ public:
              const QString& bakedOutputDir, const QString& originalOutputDir = "");
     ~FBXBaker() override;
 
+    // bump whenever a change to model baking makes previously baked output stale
+    static const int BAKE_VERSION = 1;
+
     QUrl getFBXUrl() const { return _fbxURL; }
     QString getBakedFBXFilePath() const { return _bakedFBXFilePath; }
 
+    // bake through cache: unchanged models are restored from previous bakes, textures are shared with other bakers
+    void setBakeCache(const QSharedPointer<BakeCache>& bakeCache) { _bakeCache = bakeCache; }
+    bool wasRestoredFromCache() const { return _wasRestoredFromCache; }
+
+    virtual void setIsFinished(bool isFinished) override;
     virtual void setWasAborted(bool wasAborted) override;
 
 public slots:
@@ -68,6 +77,11 @@ private:
 
     void checkIfTexturesFinished();
 
+    bool checkBakeCache();
+    bool restoreFromBakeCache();
+    void finishBakeCacheEntry();
+    void addTextureDependency(const QUrl& textureURL);
+
     QString createBakedTextureFileName(const QFileInfo& textureFileInfo);
     QUrl getTextureURL(const QFileInfo& textureFileInfo, QString relativeFileName, bool isEmbedded = false);
 
@@ -97,6 +111,18 @@ private:
     TextureBakerThreadGetter _textureThreadGetter;
 
     bool _pendingErrorEmission { false };
+
+    QSharedPointer<BakeCache> _bakeCache;
+    QString _cacheKey;
+    QMetaObject::Connection _cacheConnection;
+    bool _isWaitingForCacheEntry { false }; // another baker owns our entry
+    bool _claimedCacheEntry { false };
+    bool _isCacheable { true };
+    bool _wasRestoredFromCache { false };
+
+    // hashes of the linked (not embedded) textures this bake read, so a cached bake is only reused while they match
+    QJsonObject _textureDependencies;
+    QStringList _originalTextureFiles;
 };
 
 #endif // hifi_FBXBaker_h
@@ -16,6 +16,7 @@
 
 #include <image/Image.h>
 #include <ktx/KTX.h>
+#include <Finally.h>
 #include <NetworkAccessManager.h>
 #include <SharedUtil.h>
 
@@ -120,7 +121,79 @@ void TextureBaker::handleTextureNetworkReply() {
     }
 }
 
+QString TextureBaker::getBakeOptions() const {
+    return QString("type=%1 color=%2 normal=%3 grayscale=%4 cube=%5").arg((int)_textureType)
+        .arg((int)image::isColorTexturesCompressionEnabled()).arg((int)image::isNormalTexturesCompressionEnabled())
+        .arg((int)image::isGrayscaleTexturesCompressionEnabled()).arg((int)image::isCubeTexturesCompressionEnabled());
+}
+
+static const QString CACHED_TEXTURE_FILE_KEY = "file";
+
+bool TextureBaker::restoreFromBakeCache() {
+    auto fileName = _bakeCache->getManifest(_cacheKey)[CACHED_TEXTURE_FILE_KEY].toString();
+    auto filePath = _outputDirectory.absoluteFilePath(_bakedTextureFileName);
+    if (fileName.isEmpty() || !_bakeCache->restoreFile(_cacheKey, QString(), fileName, filePath)) {
+        return false;
+    }
+
+    _outputFiles.push_back(filePath);
+    _wasRestoredFromCache = true;
+
+    qCDebug(model_baking) << "Restored baked texture" << _textureURL << "from the bake cache";
+    setIsFinished(true);
+    return true;
+}
+
 void TextureBaker::processTexture() {
+    if (shouldStop()) {
+        return;
+    }
+
+    bool claimedCacheEntry = false;
+    if (_bakeCache) {
+        if (_cacheKey.isEmpty()) {
+            _cacheKey = BakeCache::makeKey(BakeCache::hashContent(_originalTexture), "texture", BAKE_VERSION,
+                                           getBakeOptions());
+        }
+
+        // the same texture may be being baked for another model, then we use its result (or bake it ourselves if that
+        // fails). Listen before claiming, the other baker could finish between a Wait and a later connect
+        _isWaitingForCacheEntry = false;
+        disconnect(_cacheConnection);
+        _cacheConnection = connect(_bakeCache.data(), &BakeCache::entryFinished, this, [this](QString key) {
+            if (key == _cacheKey && _isWaitingForCacheEntry) {
+                _isWaitingForCacheEntry = false;
+                disconnect(_cacheConnection);
+                processTexture();
+            }
+        });
+
+        auto claim = _bakeCache->claim(_cacheKey);
+        if (claim == BakeCache::Claim::Hit) {
+            if (restoreFromBakeCache()) {
+                disconnect(_cacheConnection);
+                return;
+            }
+            _bakeCache->remove(_cacheKey);
+            claim = _bakeCache->claim(_cacheKey);
+        }
+
+        if (claim == BakeCache::Claim::Wait) {
+            _isWaitingForCacheEntry = true;
+            return;
+        }
+
+        disconnect(_cacheConnection);
+        claimedCacheEntry = (claim == BakeCache::Claim::Bake);
+    }
+
+    bool storedInCache = false;
+    Finally releaseCacheEntry([&] {
+        if (claimedCacheEntry && !storedInCache) {
+            _bakeCache->release(_cacheKey);
+        }
+    });
+
     auto processedTexture = image::processImage(_originalTexture, _textureURL.toString().toStdString(),
                                                 ABSOLUTE_MAX_TEXTURE_NUM_PIXELS, _textureType, _abortProcessing);
 
@@ -157,6 +230,13 @@ void TextureBaker::processTexture() {
         handleError("Could not write baked texture for " + _textureURL.toString());
     } else {
         _outputFiles.push_back(filePath);
+
+        if (claimedCacheEntry) {
+            bakedTextureFile.close();
+            QJsonObject manifest;
+            manifest[CACHED_TEXTURE_FILE_KEY] = _bakedTextureFileName;
+            storedInCache = _bakeCache->store(_cacheKey, { { QString(), { filePath } } }, manifest);
+        }
     }
 
     qCDebug(model_baking) << "Baked texture" << _textureURL;
@@ -13,12 +13,14 @@
 #define hifi_TextureBaker_h
 
 #include <QtCore/QObject>
+#include <QtCore/QSharedPointer>
 #include <QtCore/QUrl>
 #include <QtCore/QRunnable>
 #include <QImageReader>
 
 #include <image/Image.h>
 
+#include "BakeCache.h"
 #include "Baker.h"
 
 extern const QString BAKED_TEXTURE_EXT;
@@ -31,8 +33,15 @@ public:
                  const QDir& outputDirectory, const QString& bakedFilename = QString(),
                  const QByteArray& textureContent = QByteArray());
 
+    // bump whenever a change to texture baking makes previously baked output stale
+    static const int BAKE_VERSION = 1;
+
     static const QStringList getSupportedFormats();
 
+    // bake through cache: identical textures are only baked once and are restored from previous bakes
+    void setBakeCache(const QSharedPointer<BakeCache>& bakeCache) { _bakeCache = bakeCache; }
+    bool wasRestoredFromCache() const { return _wasRestoredFromCache; }
+
     const QByteArray& getOriginalTexture() const { return _originalTexture; }
 
     QUrl getTextureURL() const { return _textureURL; }
@@ -56,6 +65,9 @@ private:
     void loadTexture();
     void handleTextureNetworkReply();
 
+    QString getBakeOptions() const;
+    bool restoreFromBakeCache();
+
     QUrl _textureURL;
     QByteArray _originalTexture;
     image::TextureUsage::Type _textureType;
@@ -64,6 +76,12 @@ private:
     QString _bakedTextureFileName;
 
     std::atomic<bool> _abortProcessing { false };
+
+    QSharedPointer<BakeCache> _bakeCache;
+    QString _cacheKey;
+    QMetaObject::Connection _cacheConnection;
+    bool _isWaitingForCacheEntry { false }; // another baker owns our entry
+    bool _wasRestoredFromCache { false };
 };
 
 #endif // hifi_TextureBaker_h
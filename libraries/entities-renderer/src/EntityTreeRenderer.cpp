@@ -253,7 +253,7 @@ void EntityTreeRenderer::update(bool simulate) {
                 }
                 {
                     PerformanceTimer pt("enqueue");
-                    scene->enqueueTransaction(transaction);
+                    scene->enqueueTransaction(std::move(transaction));
                 }
             }
         }
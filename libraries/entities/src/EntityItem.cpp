@@ -191,7 +191,7 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
     bool successPropertyFlagsFits = false;
     int propertyFlagsOffset = 0;
     int oldPropertyFlagsLength = 0;
-    QByteArray encodedPropertyFlags;
+    uint8_t encodedPropertyFlags[MAX_ENCODED_ENTITY_PROPERTY_FLAGS_SIZE];
     int propertyCount = 0;
 
     successIDFits = packetData->appendRawData(encodedID);
@@ -213,9 +213,8 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
 
     if (successLastSimulatedFits) {
         propertyFlagsOffset = packetData->getUncompressedByteOffset();
-        encodedPropertyFlags = propertyFlags;
-        oldPropertyFlagsLength = encodedPropertyFlags.length();
-        successPropertyFlagsFits = packetData->appendRawData(encodedPropertyFlags);
+        oldPropertyFlagsLength = propertyFlags.encode(encodedPropertyFlags, MAX_ENCODED_ENTITY_PROPERTY_FLAGS_SIZE);
+        successPropertyFlagsFits = packetData->appendRawData(encodedPropertyFlags, oldPropertyFlagsLength);
     }
 
     bool headerFits = successIDFits && successTypeFits && successCreatedFits && successLastEditedFits
@@ -298,10 +297,8 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
 
     if (propertyCount > 0) {
         int endOfEntityItemData = packetData->getUncompressedByteOffset();
-        encodedPropertyFlags = propertyFlags;
-        int newPropertyFlagsLength = encodedPropertyFlags.length();
-        packetData->updatePriorBytes(propertyFlagsOffset,
-                (const unsigned char*)encodedPropertyFlags.constData(), encodedPropertyFlags.length());
+        int newPropertyFlagsLength = propertyFlags.encode(encodedPropertyFlags, MAX_ENCODED_ENTITY_PROPERTY_FLAGS_SIZE);
+        packetData->updatePriorBytes(propertyFlagsOffset, encodedPropertyFlags, newPropertyFlagsLength);
 
         // if the size of the PropertyFlags shrunk, we need to shift everything down to front of packet.
         if (newPropertyFlagsLength < oldPropertyFlagsLength) {
@@ -999,9 +996,9 @@ void EntityItem::simulate(const quint64& now) {
         setLastSimulated(now);
     }
 
-    float timeElapsed = (float)(now - getLastSimulated()) / (float)(USECS_PER_SECOND);
-
     #ifdef WANT_DEBUG
+        float timeElapsed = (float)(now - getLastSimulated()) / (float)(USECS_PER_SECOND);
+
         qCDebug(entities) << "********** EntityItem::simulate()";
         qCDebug(entities) << "    entity ID=" << getEntityItemID();
         qCDebug(entities) << "    simulator ID=" << getSimulatorID();
@@ -1040,7 +1037,23 @@ void EntityItem::simulate(const quint64& now) {
         qCDebug(entities) << "     ********** EntityItem::simulate() .... SETTING _lastSimulated=" << _lastSimulated;
     #endif
 
-    if (!stepKinematicMotion(timeElapsed)) {
+    KinematicState state;
+    getSimulationState(now, state);
+    bool isMoving = computeSimulationStep(state);
+    applySimulationStep(now, isMoving, state);
+}
+
+void EntityItem::getSimulationState(const quint64& now, KinematicState& state) const {
+    quint64 lastSimulated = getLastSimulated();
+    float timeElapsed = (lastSimulated == 0 || now < lastSimulated) ?
+        0.0f : (float)(now - lastSimulated) / (float)(USECS_PER_SECOND);
+    getKinematicState(timeElapsed, state);
+}
+
+void EntityItem::applySimulationStep(const quint64& now, bool isMoving, const KinematicState& state) {
+    if (isMoving) {
+        setLocalTransformAndVelocities(state.transform, state.linearVelocity, state.angularVelocity);
+    } else {
         // this entity is no longer moving
         // flag it to transition from KINEMATIC to STATIC
         markDirtyFlags(Simulation::DIRTY_MOTION_TYPE);
@@ -1050,11 +1063,41 @@ void EntityItem::simulate(const quint64& now) {
 }
 
 bool EntityItem::stepKinematicMotion(float timeElapsed) {
-    // get all the data
-    Transform transform;
-    glm::vec3 linearVelocity;
-    glm::vec3 angularVelocity;
-    getLocalTransformAndVelocities(transform, linearVelocity, angularVelocity);
+    KinematicState state;
+    getKinematicState(timeElapsed, state);
+    if (!computeSimulationStep(state)) {
+        return false;
+    }
+    if (timeElapsed > 0.0f) {
+        setLocalTransformAndVelocities(state.transform, state.linearVelocity, state.angularVelocity);
+    }
+    return true;
+}
+
+static const float MIN_KINEMATIC_LINEAR_ACCELERATION_SQUARED = 1.0e-4f; // 0.01 m/sec^2
+
+void EntityItem::getKinematicState(float timeElapsed, KinematicState& state) const {
+    state.timeElapsed = timeElapsed;
+    getLocalTransformAndVelocities(state.transform, state.linearVelocity, state.angularVelocity);
+    state.damping = getDamping();
+    state.angularDamping = getAngularDamping();
+    state.acceleration = getAcceleration();
+
+    // acceleration is in world-frame, the step needs the parent's transform to bring it into the local frame
+    state.hasParentTransform = false;
+    if (glm::length2(state.linearVelocity) > 0.0f &&
+            glm::length2(state.acceleration) > MIN_KINEMATIC_LINEAR_ACCELERATION_SQUARED) {
+        bool success;
+        state.parentTransform = getParentTransform(success);
+        state.hasParentTransform = success;
+    }
+}
+
+bool EntityItem::computeSimulationStep(KinematicState& state) {
+    float timeElapsed = state.timeElapsed;
+    Transform& transform = state.transform;
+    glm::vec3& linearVelocity = state.linearVelocity;
+    glm::vec3& angularVelocity = state.angularVelocity;
 
     // find out if it is moving
     bool isSpinning = (glm::length2(angularVelocity) > 0.0f);
@@ -1078,7 +1121,7 @@ bool EntityItem::stepKinematicMotion(float timeElapsed) {
     timeElapsed = glm::min(timeElapsed, MAX_TIME_ELAPSED);
 
     if (isSpinning) {
-        float angularDamping = getAngularDamping();
+        float angularDamping = state.angularDamping;
         // angular damping
         if (angularDamping > 0.0f) {
             angularVelocity *= powf(1.0f - angularDamping, timeElapsed);
@@ -1109,21 +1152,18 @@ bool EntityItem::stepKinematicMotion(float timeElapsed) {
         glm::vec3 deltaVelocity = Vectors::ZERO;
 
         // linear damping
-        float damping = getDamping();
+        float damping = state.damping;
         if (damping > 0.0f) {
             deltaVelocity = (powf(1.0f - damping, timeElapsed) - 1.0f) * linearVelocity;
         }
 
-        const float MIN_KINEMATIC_LINEAR_ACCELERATION_SQUARED = 1.0e-4f; // 0.01 m/sec^2
-        vec3 acceleration = getAcceleration();
+        vec3 acceleration = state.acceleration;
         if (glm::length2(acceleration) > MIN_KINEMATIC_LINEAR_ACCELERATION_SQUARED) {
             // yes acceleration
             // acceleration is in world-frame but we need it in local-frame
             glm::vec3 linearAcceleration = acceleration;
-            bool success;
-            Transform parentTransform = getParentTransform(success);
-            if (success) {
-                linearAcceleration = glm::inverse(parentTransform.getRotation()) * linearAcceleration;
+            if (state.hasParentTransform) {
+                linearAcceleration = glm::inverse(state.parentTransform.getRotation()) * linearAcceleration;
             }
             deltaVelocity += linearAcceleration * timeElapsed;
 
@@ -1152,8 +1192,6 @@ bool EntityItem::stepKinematicMotion(float timeElapsed) {
     }
 
     transform.setTranslation(position);
-    setLocalTransformAndVelocities(transform, linearVelocity, angularVelocity);
-
     return true;
 }
 
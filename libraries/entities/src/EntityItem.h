@@ -155,6 +155,27 @@ public:
     void simulate(const quint64& now);
     bool stepKinematicMotion(float timeElapsed); // return 'true' if moving
 
+    // what a kinematic step reads from this entity and its ancestors
+    struct KinematicState {
+        float timeElapsed { 0.0f }; // seconds
+        Transform transform; // local, stepped in place
+        glm::vec3 linearVelocity; // local, stepped in place
+        glm::vec3 angularVelocity; // local, stepped in place
+        glm::vec3 acceleration; // world frame
+        Transform parentTransform; // only looked up when there is acceleration to bring into the local frame
+        bool hasParentTransform { false };
+        float damping { 0.0f };
+        float angularDamping { 0.0f };
+    };
+
+    // simulate() split in three so EntitySimulation can step many entities at once:
+    // getSimulationState() must be called serially, looking up ancestors updates their cached parent pointers,
+    // computeSimulationStep() only does math on the state and may run concurrently with other entities,
+    // applySimulationStep() writes the result back and must be called serially
+    void getSimulationState(const quint64& now, KinematicState& state) const;
+    static bool computeSimulationStep(KinematicState& state); // return 'true' if moving
+    void applySimulationStep(const quint64& now, bool isMoving, const KinematicState& state);
+
     virtual bool needsToCallUpdate() const { return false; }
 
     virtual void debugDump() const;
@@ -491,6 +512,8 @@ protected:
 
     void setSimulated(bool simulated) { _simulated = simulated; }
 
+    void getKinematicState(float timeElapsed, KinematicState& state) const;
+
     const QByteArray getDynamicDataInternal() const;
     void setDynamicDataInternal(QByteArray dynamicData);
 
@@ -1296,9 +1296,9 @@ bool EntityItemProperties::encodeEntityEditPacket(PacketType command, EntityItem
         bool successLastUpdatedFits = packetData->appendRawData(encodedUpdateDelta);
 
         int propertyFlagsOffset = packetData->getUncompressedByteOffset();
-        QByteArray encodedPropertyFlags = propertyFlags;
-        int oldPropertyFlagsLength = encodedPropertyFlags.length();
-        bool successPropertyFlagsFits = packetData->appendRawData(encodedPropertyFlags);
+        uint8_t encodedPropertyFlags[MAX_ENCODED_ENTITY_PROPERTY_FLAGS_SIZE];
+        int oldPropertyFlagsLength = propertyFlags.encode(encodedPropertyFlags, MAX_ENCODED_ENTITY_PROPERTY_FLAGS_SIZE);
+        bool successPropertyFlagsFits = packetData->appendRawData(encodedPropertyFlags, oldPropertyFlagsLength);
         int propertyCount = 0;
 
         bool headerFits = successIDFits && successTypeFits && successLastEditedFits
@@ -1493,10 +1493,8 @@ bool EntityItemProperties::encodeEntityEditPacket(PacketType command, EntityItem
         if (propertyCount > 0) {
             int endOfEntityItemData = packetData->getUncompressedByteOffset();
 
-            encodedPropertyFlags = propertyFlags;
-            int newPropertyFlagsLength = encodedPropertyFlags.length();
-            packetData->updatePriorBytes(propertyFlagsOffset,
-                                         (const unsigned char*)encodedPropertyFlags.constData(), encodedPropertyFlags.length());
+            int newPropertyFlagsLength = propertyFlags.encode(encodedPropertyFlags, MAX_ENCODED_ENTITY_PROPERTY_FLAGS_SIZE);
+            packetData->updatePriorBytes(propertyFlagsOffset, encodedPropertyFlags, newPropertyFlagsLength);
 
             // if the size of the PropertyFlags shrunk, we need to shift everything down to front of packet.
             if (newPropertyFlagsLength < oldPropertyFlagsLength) {
@@ -1642,32 +1640,30 @@ bool EntityItemProperties::decodeEntityEditPacket(const unsigned char* data, int
     valid = true;
 
     // Entity Type...
-    QByteArray encodedType((const char*)dataAt, (bytesToRead - processedBytes));
-    ByteCountCoded<quint32> typeCoder = encodedType;
+    ByteCountCoded<quint32> typeCoder;
+    int encodedTypeSize = (int)typeCoder.decode((const char*)dataAt, bytesToRead - processedBytes);
     quint32 entityTypeCode = typeCoder;
     properties.setType((EntityTypes::EntityType)entityTypeCode);
-    encodedType = typeCoder; // determine true bytesToRead
-    dataAt += encodedType.size();
-    processedBytes += encodedType.size();
+    dataAt += encodedTypeSize;
+    processedBytes += encodedTypeSize;
 
     // Update Delta - when was this item updated relative to last edit... this really should be 0
     // TODO: Should we get rid of this in this in edit packets, since this has to always be 0?
     // TODO: do properties need to handle lastupdated???
 
     // last updated is stored as ByteCountCoded delta from lastEdited
-    QByteArray encodedUpdateDelta((const char*)dataAt, (bytesToRead - processedBytes));
-    ByteCountCoded<quint64> updateDeltaCoder = encodedUpdateDelta;
-    encodedUpdateDelta = updateDeltaCoder; // determine true bytesToRead
-    dataAt += encodedUpdateDelta.size();
-    processedBytes += encodedUpdateDelta.size();
+    ByteCountCoded<quint64> updateDeltaCoder;
+    int encodedUpdateDeltaSize = (int)updateDeltaCoder.decode((const char*)dataAt, bytesToRead - processedBytes);
+    dataAt += encodedUpdateDeltaSize;
+    processedBytes += encodedUpdateDeltaSize;
 
     // TODO: Do we need this lastUpdated?? We don't seem to use it.
     //quint64 updateDelta = updateDeltaCoder;
     //quint64 lastUpdated = lastEdited + updateDelta; // don't adjust for clock skew since we already did that for lastEdited
 
     // Property Flags...
-    QByteArray encodedPropertyFlags((const char*)dataAt, (bytesToRead - processedBytes));
-    EntityPropertyFlags propertyFlags = encodedPropertyFlags;
+    EntityPropertyFlags propertyFlags;
+    propertyFlags.decode(dataAt, bytesToRead - processedBytes);
     dataAt += propertyFlags.getEncodedLength();
     processedBytes += propertyFlags.getEncodedLength();
 
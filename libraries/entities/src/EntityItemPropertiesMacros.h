@@ -42,7 +42,7 @@
             dataAt += bytes;                                                       \
             bytesRead += bytes;                                                    \
             if (overwriteLocalData) {                                              \
-                S(fromBuffer);                                                     \
+                S(std::move(fromBuffer));                                          \
             }                                                                      \
             somethingChanged = true;                                               \
         }
@@ -67,7 +67,7 @@
             int bytes = OctreePacketData::unpackDataFromBytes(dataAt, fromBuffer); \
             dataAt += bytes;                                                       \
             processedBytes += bytes;                                               \
-            properties.O(fromBuffer);                                              \
+            properties.O(std::move(fromBuffer));                                   \
         }
 
 #define SET_ENTITY_PROPERTY_FROM_PROPERTIES(P,M)    \
@@ -408,6 +408,7 @@ inline xColor xColor_convertFromScriptValue(const QScriptValue& v, bool& isValid
     public: \
         const T& get##N() const { return _##n; } \
         void set##N(const T& value) { _##n = value; _##n##Changed = true; } \
+        void set##N(T&& value) { _##n = std::move(value); _##n##Changed = true; } \
     DEFINE_CORE(N, n, T, V)
 
 #define DEFINE_PROPERTY_REF_WITH_SETTER(P, N, n, T, V)        \
@@ -267,8 +267,13 @@ enum EntityPropertyList {
     // WARNING!!! DO NOT ADD PROPS_xxx here unless you really really meant to.... Add them UP above
 };
 
+// every entity property is known at compile time, so the flags can use fixed, allocation-free storage
+template<> struct PropertyFlagsStorage<EntityPropertyList> : FixedPropertyFlagsStorage<PROP_AFTER_LAST_ITEM> {};
+
 typedef PropertyFlags<EntityPropertyList> EntityPropertyFlags;
 
+const int MAX_ENCODED_ENTITY_PROPERTY_FLAGS_SIZE = PropertyFlagsStorage<EntityPropertyList>::MAX_ENCODED_SIZE;
+
 // this is set at the top of EntityItemProperties.cpp to PROP_AFTER_LAST_ITEM - 1.  PROP_AFTER_LAST_ITEM is always
 // one greater than the last item property due to the enum's auto-incrementing.
 extern EntityPropertyList PROP_LAST_ITEM;
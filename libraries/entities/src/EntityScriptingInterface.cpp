@@ -597,9 +597,7 @@ QVector<QUuid> EntityScriptingInterface::findEntities(const glm::vec3& center, f
     QVector<QUuid> result;
     if (_entityTree) {
         QVector<EntityItemPointer> entities;
-        _entityTree->withReadLock([&] {
-            _entityTree->findEntities(center, radius, entities);
-        });
+        _entityTree->getSpatialIndex().findEntities(center, radius, entities);
 
         foreach (EntityItemPointer entity, entities) {
             result << entity->getEntityItemID();
@@ -614,10 +612,8 @@ QVector<QUuid> EntityScriptingInterface::findEntitiesInBox(const glm::vec3& corn
     QVector<QUuid> result;
     if (_entityTree) {
         QVector<EntityItemPointer> entities;
-        _entityTree->withReadLock([&] {
-            AABox box(corner, dimensions);
-            _entityTree->findEntities(box, entities);
-        });
+        AABox box(corner, dimensions);
+        _entityTree->getSpatialIndex().findEntities(box, entities);
 
         foreach (EntityItemPointer entity, entities) {
             result << entity->getEntityItemID();
@@ -657,9 +653,7 @@ QVector<QUuid> EntityScriptingInterface::findEntitiesInFrustum(QVariantMap frust
 
         if (_entityTree) {
             QVector<EntityItemPointer> entities;
-            _entityTree->withReadLock([&] {
-                _entityTree->findEntities(viewFrustum, entities);
-            });
+            _entityTree->getSpatialIndex().findEntities(viewFrustum, entities);
 
             foreach(EntityItemPointer entity, entities) {
                 result << entity->getEntityItemID();
@@ -676,9 +670,7 @@ QVector<QUuid> EntityScriptingInterface::findEntitiesByType(const QString entity
     QVector<QUuid> result;
     if (_entityTree) {
         QVector<EntityItemPointer> entities;
-        _entityTree->withReadLock([&] {
-            _entityTree->findEntities(center, radius, entities);
-        });
+        _entityTree->getSpatialIndex().findEntities(center, radius, entities);
 
         foreach(EntityItemPointer entity, entities) {
             if (entity->getType() == type) {
@@ -724,10 +716,11 @@ RayToEntityIntersectionResult EntityScriptingInterface::findRayIntersectionWorke
     if (_entityTree) {
         OctreeElementPointer element;
         EntityItemPointer intersectedEntity = NULL;
-        result.intersects = _entityTree->findRayIntersection(ray.origin, ray.direction,
+        // the spatial index never waits on the tree lock, so the answer is always accurate regardless of lockType
+        result.intersects = _entityTree->getSpatialIndex().findRayIntersection(ray.origin, ray.direction,
             entityIdsToInclude, entityIdsToDiscard, visibleOnly, collidableOnly, precisionPicking,
-            element, result.distance, result.face, result.surfaceNormal,
-            (void**)&intersectedEntity, lockType, &result.accurate);
+            element, result.distance, result.face, result.surfaceNormal, (void**)&intersectedEntity);
+        result.accurate = true;
         if (result.intersects && intersectedEntity) {
             result.entityID = intersectedEntity->getEntityItemID();
             result.intersection = ray.origin + (ray.direction * result.distance);
@@ -10,6 +10,7 @@
 //
 
 #include <AACube.h>
+#include <TBBHelpers.h>
 
 #include "EntitySimulation.h"
 #include "EntitiesLogging.h"
@@ -257,10 +258,22 @@ void EntitySimulation::clearEntities() {
     _entitiesToDelete.clear();
 }
 
+// below this many entities the cost of dispatching to worker threads exceeds the work itself
+const size_t MIN_PARALLEL_KINEMATIC_ENTITIES = 64;
+const size_t KINEMATIC_STEP_GRAIN_SIZE = 32;
+
 void EntitySimulation::moveSimpleKinematics(const quint64& now) {
-    SetOfEntities::iterator itemItr = _simpleKinematicEntities.begin();
-    while (itemItr != _simpleKinematicEntities.end()) {
-        EntityItemPointer entity = *itemItr;
+    PerformanceTimer perfTimer("moveSimpleKinematics");
+    quint64 startTime = usecTimestampNow();
+
+    // gather the batch into a flat buffer so the per-entity work can be spread across worker threads.
+    // Looking up ancestors updates their cached parent pointers and AACubes, so this pass is serial.
+    size_t numEntities = (size_t)_simpleKinematicEntities.size();
+    _kinematicSteps.resize(numEntities);
+    size_t index = 0;
+    foreach (const EntityItemPointer& entity, _simpleKinematicEntities) {
+        KinematicStep& step = _kinematicSteps[index++];
+        step.entity = entity;
 
         // The entity-server doesn't know where avatars are, so don't attempt to do simple extrapolation for
         // children of avatars.  See related code in EntityMotionState::remoteSimulationOutOfSync.
@@ -268,15 +281,47 @@ void EntitySimulation::moveSimpleKinematics(const quint64& now) {
         entity->getMaximumAACube(ancestryIsKnown);
         bool hasAvatarAncestor = entity->hasAncestorOfType(NestableType::Avatar);
 
-        if (entity->isMovingRelativeToParent() && !entity->getPhysicsInfo() && ancestryIsKnown && !hasAvatarAncestor) {
-            entity->simulate(now);
-            _entitiesToSort.insert(entity);
-            ++itemItr;
+        step.isSimpleKinematic = entity->isMovingRelativeToParent() && !entity->getPhysicsInfo() &&
+            ancestryIsKnown && !hasAvatarAncestor;
+        if (step.isSimpleKinematic) {
+            entity->getSimulationState(now, step.state);
+        }
+    }
+
+    // compute new transforms: each step is pure math on its own gathered state and touches no entity
+    auto computeStep = [](KinematicStep& step) {
+        if (step.isSimpleKinematic) {
+            step.isMoving = EntityItem::computeSimulationStep(step.state);
+        }
+    };
+    if (numEntities < MIN_PARALLEL_KINEMATIC_ENTITIES) {
+        for (auto& step : _kinematicSteps) {
+            computeStep(step);
+        }
+    } else {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, numEntities, KINEMATIC_STEP_GRAIN_SIZE),
+            [&](const tbb::blocked_range<size_t>& range) {
+                for (size_t i = range.begin(); i != range.end(); ++i) {
+                    computeStep(_kinematicSteps[i]);
+                }
+            });
+    }
+
+    // apply serially: setting the transform notifies children and the moved entities get sorted
+    // into the tree with a single MovingEntitiesOperator pass in sortEntitiesThatMoved()
+    for (auto& step : _kinematicSteps) {
+        if (step.isSimpleKinematic) {
+            step.entity->applySimulationStep(now, step.isMoving, step.state);
+            _entitiesToSort.insert(step.entity);
         } else {
             // the entity is no longer non-physical-kinematic
-            itemItr = _simpleKinematicEntities.erase(itemItr);
+            _simpleKinematicEntities.remove(step.entity);
         }
+        step.entity.reset();
     }
+
+    _totalKinematicSteps += numEntities;
+    _totalKinematicStepTime += usecTimestampNow() - startTime;
 }
 
 void EntitySimulation::addDynamic(EntityDynamicPointer dynamic) {
@@ -78,6 +78,13 @@ public:
 
     EntityTreePointer getEntityTree() { return _entityTree; }
 
+    // throughput of moveSimpleKinematics(), for stats
+    quint64 getTotalKinematicSteps() const { return _totalKinematicSteps; }
+    float getKinematicStepsPerMsec() const {
+        return _totalKinematicStepTime == 0 ? 0.0f :
+            (float)_totalKinematicSteps * (float)USECS_PER_MSEC / (float)_totalKinematicStepTime;
+    }
+
     virtual void takeEntitiesToDelete(VectorOfEntities& entitiesToDelete);
 
     /// \param entity pointer to EntityItem that needs to be put on the entitiesToDelete list and removed from others.
@@ -113,6 +120,17 @@ protected:
 private:
     void moveSimpleKinematics();
 
+    // gathered serially by moveSimpleKinematics(), stepped in parallel, then applied serially
+    struct KinematicStep {
+        EntityItemPointer entity;
+        EntityItem::KinematicState state;
+        bool isSimpleKinematic { false };
+        bool isMoving { false };
+    };
+    std::vector<KinematicStep> _kinematicSteps; // reused between frames to avoid reallocating the batch
+    quint64 _totalKinematicSteps { 0 };
+    quint64 _totalKinematicStepTime { 0 }; // usecs
+
     // back pointer to EntityTree structure
     EntityTreePointer _entityTree;
 
@@ -0,0 +1,246 @@
+//
+//  EntitySpatialIndex.cpp
+//  libraries/entities/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntitySpatialIndex.h"
+
+#include <algorithm>
+#include <cfloat>
+
+#include <OctreeConstants.h>
+
+#include "EntityTreeElement.h"
+
+namespace {
+    int levelForScale(float scale) {
+        // element scales are exact powers of two, so this is exact
+        return (int)roundf(log2f((float)TREE_SCALE / scale));
+    }
+
+    int indexForCoordinate(float coordinate, float scale) {
+        return (int)roundf((coordinate + (float)HALF_TREE_SCALE) / scale);
+    }
+}
+
+AACube EntitySpatialIndex::cubeForCell(int level, const CellKey& key) {
+    // matches OctreeElement::calculateAACube() exactly, both only multiply by powers of two
+    float scale = (float)TREE_SCALE / powf(2.0f, (float)level);
+    glm::vec3 corner = glm::vec3((float)key.x, (float)key.y, (float)key.z) * scale - (float)HALF_TREE_SCALE;
+    return AACube(corner, scale);
+}
+
+EntitySpatialIndex::CellKey EntitySpatialIndex::childKey(const CellKey& key, int childIndex) {
+    return { (key.x << 1) | ((childIndex >> 2) & 1), (key.y << 1) | ((childIndex >> 1) & 1), (key.z << 1) | (childIndex & 1) };
+}
+
+void EntitySpatialIndex::adjustSubtreeCounts(const Location& location, int delta) {
+    CellKey key = location.key;
+    for (int level = location.level; level >= 0; --level) {
+        Level& cells = _levels[level];
+        Cell& cell = cells[key];
+        cell.subtreeCount += delta;
+        if (cell.subtreeCount <= 0) {
+            assert(cell.entities.isEmpty());
+            cells.remove(key);
+        }
+        key = parentKey(key);
+    }
+}
+
+void EntitySpatialIndex::insert(const EntityItemPointer& entity, const EntityTreeElementPointer& element) {
+    const AACube& cube = element->getAACube();
+    float scale = cube.getScale();
+    const glm::vec3& corner = cube.getCorner();
+    Location location { levelForScale(scale), { indexForCoordinate(corner.x, scale),
+        indexForCoordinate(corner.y, scale), indexForCoordinate(corner.z, scale) } };
+    EntityItemID entityID = entity->getEntityItemID();
+
+    withWriteLock([&] {
+        if (_locations.contains(entityID)) {
+            // elements always remove before they add, but never leave a stale cell behind
+            remove(entity);
+        }
+        if ((int)_levels.size() <= location.level) {
+            _levels.resize(location.level + 1);
+        }
+        Cell& cell = _levels[location.level][location.key];
+        cell.entities.push_back(entity);
+        cell.element = element;
+        _locations.insert(entityID, location);
+        adjustSubtreeCounts(location, 1);
+    });
+}
+
+void EntitySpatialIndex::remove(const EntityItemPointer& entity) {
+    withWriteLock([&] {
+        auto locationItr = _locations.find(entity->getEntityItemID());
+        if (locationItr == _locations.end()) {
+            return;
+        }
+        Location location = locationItr.value();
+        _locations.erase(locationItr);
+
+        Level& cells = _levels[location.level];
+        auto cellItr = cells.find(location.key);
+        if (cellItr != cells.end() && cellItr->entities.removeOne(entity)) {
+            adjustSubtreeCounts(location, -1);
+        }
+    });
+}
+
+void EntitySpatialIndex::clear() {
+    withWriteLock([&] {
+        _levels.clear();
+        _locations.clear();
+    });
+}
+
+int EntitySpatialIndex::getEntityCount() const {
+    return resultWithReadLock<int>([&] {
+        return _locations.size();
+    });
+}
+
+template <typename CellTest, typename EntityTest>
+void EntitySpatialIndex::findEntities(CellTest cellTest, EntityTest entityTest,
+                                      QVector<EntityItemPointer>& foundEntities) const {
+    withReadLock([&] {
+        if (_levels.empty()) {
+            return;
+        }
+        // same pruning as the recurseTreeWithOperation() based queries: if a cell's cube fails the test then nothing
+        // below it is considered, otherwise its entities are tested and its occupied children are visited
+        std::vector<Location> cellsToVisit;
+        cellsToVisit.push_back({ 0, { 0, 0, 0 } });
+        while (!cellsToVisit.empty()) {
+            Location location = cellsToVisit.back();
+            cellsToVisit.pop_back();
+
+            const Level& cells = _levels[location.level];
+            auto cellItr = cells.find(location.key);
+            if (cellItr == cells.end() || !cellTest(cubeForCell(location.level, location.key))) {
+                continue;
+            }
+            for (const auto& entity : cellItr->entities) {
+                if (entityTest(entity)) {
+                    foundEntities.push_back(entity);
+                }
+            }
+            int childLevel = location.level + 1;
+            if (cellItr->subtreeCount > cellItr->entities.size() && childLevel < (int)_levels.size()) {
+                for (int childIndex = 0; childIndex < NUMBER_OF_CHILDREN; childIndex++) {
+                    cellsToVisit.push_back({ childLevel, childKey(location.key, childIndex) });
+                }
+            }
+        }
+    });
+}
+
+void EntitySpatialIndex::findEntities(const glm::vec3& center, float radius, QVector<EntityItemPointer>& foundEntities) const {
+    findEntities([&](const AACube& cube) {
+        glm::vec3 penetration;
+        return cube.findSpherePenetration(center, radius, penetration);
+    }, [&](const EntityItemPointer& entity) {
+        return EntityTreeElement::entityTouchesSphere(entity, center, radius);
+    }, foundEntities);
+}
+
+void EntitySpatialIndex::findEntities(const AACube& cube, QVector<EntityItemPointer>& foundEntities) const {
+    findEntities([&](const AACube& cellCube) {
+        return cellCube.touches(cube);
+    }, [&](const EntityItemPointer& entity) {
+        return EntityTreeElement::entityTouchesCube(entity, cube);
+    }, foundEntities);
+}
+
+void EntitySpatialIndex::findEntities(const AABox& box, QVector<EntityItemPointer>& foundEntities) const {
+    findEntities([&](const AACube& cellCube) {
+        return cellCube.touches(box);
+    }, [&](const EntityItemPointer& entity) {
+        return EntityTreeElement::entityTouchesBox(entity, box);
+    }, foundEntities);
+}
+
+void EntitySpatialIndex::findEntities(const ViewFrustum& frustum, QVector<EntityItemPointer>& foundEntities) const {
+    findEntities([&](const AACube& cellCube) {
+        return frustum.calculateCubeKeyholeIntersection(cellCube) != ViewFrustum::OUTSIDE;
+    }, [&](const EntityItemPointer& entity) {
+        return EntityTreeElement::entityTouchesFrustum(entity, frustum);
+    }, foundEntities);
+}
+
+bool EntitySpatialIndex::findRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
+                                             const QVector<EntityItemID>& entityIdsToInclude,
+                                             const QVector<EntityItemID>& entityIdsToDiscard,
+                                             bool visibleOnly, bool collidableOnly, bool precisionPicking,
+                                             OctreeElementPointer& element, float& distance, BoxFace& face,
+                                             glm::vec3& surfaceNormal, void** intersectedObject) const {
+    struct Candidate {
+        float distance;
+        EntityTreeElementPointer element;
+    };
+    std::vector<Candidate> candidates;
+
+    // only gather the cells the ray passes through while locked, the entity tests take element locks of their own
+    withReadLock([&] {
+        if (_levels.empty()) {
+            return;
+        }
+        std::vector<Location> cellsToVisit;
+        cellsToVisit.push_back({ 0, { 0, 0, 0 } });
+        while (!cellsToVisit.empty()) {
+            Location location = cellsToVisit.back();
+            cellsToVisit.pop_back();
+
+            const Level& cells = _levels[location.level];
+            auto cellItr = cells.find(location.key);
+            if (cellItr == cells.end()) {
+                continue;
+            }
+            AACube cube = cubeForCell(location.level, location.key);
+            float distanceToCube;
+            BoxFace cubeFace;
+            glm::vec3 cubeNormal;
+            if (!cube.findRayIntersection(origin, direction, distanceToCube, cubeFace, cubeNormal)) {
+                continue;
+            }
+            if (!cellItr->entities.isEmpty()) {
+                EntityTreeElementPointer cellElement = cellItr->element.lock();
+                if (cellElement) {
+                    candidates.push_back({ cube.contains(origin) ? 0.0f : distanceToCube, cellElement });
+                }
+            }
+            int childLevel = location.level + 1;
+            if (cellItr->subtreeCount > cellItr->entities.size() && childLevel < (int)_levels.size()) {
+                for (int childIndex = 0; childIndex < NUMBER_OF_CHILDREN; childIndex++) {
+                    cellsToVisit.push_back({ childLevel, childKey(location.key, childIndex) });
+                }
+            }
+        }
+    });
+
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return a.distance < b.distance;
+    });
+
+    bool found = false;
+    distance = FLT_MAX;
+    for (auto& candidate : candidates) {
+        // nothing in this cell, or any cell after it, can be closer than what we already hit
+        if (candidate.distance >= distance) {
+            break;
+        }
+        bool keepSearching = true;
+        if (candidate.element->findRayIntersection(origin, direction, keepSearching, element, distance, face, surfaceNormal,
+                entityIdsToInclude, entityIdsToDiscard, visibleOnly, collidableOnly, intersectedObject, precisionPicking)) {
+            found = true;
+        }
+    }
+    return found;
+}
@@ -0,0 +1,96 @@
+//
+//  EntitySpatialIndex.h
+//  libraries/entities/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntitySpatialIndex_h
+#define hifi_EntitySpatialIndex_h
+
+#include <vector>
+
+#include <QHash>
+#include <QVector>
+
+#include <AABox.h>
+#include <AACube.h>
+#include <BoxBase.h>
+#include <OctreeElement.h>
+#include <ViewFrustum.h>
+#include <shared/ReadWriteLockable.h>
+
+#include "EntityItemID.h"
+#include "EntityTypes.h"
+
+class EntityTreeElement;
+using EntityTreeElementPointer = std::shared_ptr<EntityTreeElement>;
+using EntityTreeElementWeakPointer = std::weak_ptr<EntityTreeElement>;
+
+/// A read-optimized shadow of the occupied part of an EntityTree. Every element that holds entities (and every ancestor of
+/// one) has a cell here, hashed by its depth and integer position, so queries can walk straight from occupied cell to
+/// occupied cell without touching the octree or its lock. Cells mirror elements exactly and queries apply the same
+/// element and entity tests as the EntityTree::findEntities() operations, so both paths find the same entities. The index
+/// is maintained by EntityTreeElement as entities are added to and removed from elements, which covers adds, deletes and
+/// every relocation of a moving entity.
+class EntitySpatialIndex : public ReadWriteLockable {
+public:
+    void insert(const EntityItemPointer& entity, const EntityTreeElementPointer& element);
+    void remove(const EntityItemPointer& entity);
+    void clear();
+
+    int getEntityCount() const;
+
+    void findEntities(const glm::vec3& center, float radius, QVector<EntityItemPointer>& foundEntities) const;
+    void findEntities(const AACube& cube, QVector<EntityItemPointer>& foundEntities) const;
+    void findEntities(const AABox& box, QVector<EntityItemPointer>& foundEntities) const;
+    void findEntities(const ViewFrustum& frustum, QVector<EntityItemPointer>& foundEntities) const;
+
+    /// Same contract as EntityTree::findRayIntersection(), but cells are visited nearest first so that anything behind
+    /// the closest hit so far is skipped.
+    bool findRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
+                             const QVector<EntityItemID>& entityIdsToInclude, const QVector<EntityItemID>& entityIdsToDiscard,
+                             bool visibleOnly, bool collidableOnly, bool precisionPicking,
+                             OctreeElementPointer& element, float& distance, BoxFace& face, glm::vec3& surfaceNormal,
+                             void** intersectedObject) const;
+
+private:
+    struct CellKey {
+        int x;
+        int y;
+        int z;
+        bool operator==(const CellKey& other) const { return x == other.x && y == other.y && z == other.z; }
+    };
+    friend uint qHash(const CellKey& key, uint seed) {
+        return qHash(((quint64)(quint32)key.x << 42) ^ ((quint64)(quint32)key.y << 21) ^ (quint64)(quint32)key.z, seed);
+    }
+
+    struct Cell {
+        int subtreeCount { 0 }; // entities in this cell and all cells below it
+        QVector<EntityItemPointer> entities;
+        EntityTreeElementWeakPointer element;
+    };
+    using Level = QHash<CellKey, Cell>;
+
+    struct Location {
+        int level;
+        CellKey key;
+    };
+
+    static AACube cubeForCell(int level, const CellKey& key);
+    static CellKey parentKey(const CellKey& key) { return { key.x >> 1, key.y >> 1, key.z >> 1 }; }
+    static CellKey childKey(const CellKey& key, int childIndex);
+
+    void adjustSubtreeCounts(const Location& location, int delta);
+
+    template <typename CellTest, typename EntityTest>
+    void findEntities(CellTest cellTest, EntityTest entityTest, QVector<EntityItemPointer>& foundEntities) const;
+
+    std::vector<Level> _levels;
+    QHash<EntityItemID, Location> _locations;
+};
+
+#endif // hifi_EntitySpatialIndex_h
@@ -100,6 +100,7 @@ void EntityTree::eraseAllOctreeElements(bool createNewRoot) {
         }
     });
     localMap.clear();
+    _spatialIndex.clear();
     Octree::eraseAllOctreeElements(createNewRoot);
 
     resetClientEditStats();
@@ -243,7 +244,7 @@ void EntityTree::postAddEntity(EntityItemPointer entity) {
     fixupNeedsParentFixups();
 }
 
-bool EntityTree::updateEntity(const EntityItemID& entityID, const EntityItemProperties& properties, const SharedNodePointer& senderNode) {
+bool EntityTree::updateEntity(const EntityItemID& entityID, const EntityItemProperties& origProperties, const SharedNodePointer& senderNode) {
     EntityItemPointer entity;
     {
         QReadLocker locker(&_entityMapLock);
@@ -252,18 +253,17 @@ bool EntityTree::updateEntity(const EntityItemID& entityID, const EntityItemProp
     if (!entity) {
         return false;
     }
+    EntityItemProperties properties = origProperties;
     return updateEntity(entity, properties, senderNode);
 }
 
-bool EntityTree::updateEntity(EntityItemPointer entity, const EntityItemProperties& origProperties,
+bool EntityTree::updateEntity(EntityItemPointer entity, EntityItemProperties& properties,
         const SharedNodePointer& senderNode) {
     EntityTreeElementPointer containingElement = entity->getElement();
     if (!containingElement) {
         return false;
     }
 
-    EntityItemProperties properties = origProperties;
-
     bool allowLockChange;
     QUuid senderID;
     if (senderNode.isNull()) {
@@ -23,6 +23,7 @@ using EntityTreePointer = std::shared_ptr<EntityTree>;
 
 #include "AddEntityOperator.h"
 #include "EntityTreeElement.h"
+#include "EntitySpatialIndex.h"
 #include "DeleteEntityOperator.h"
 #include "MovingEntitiesOperator.h"
 
@@ -170,6 +171,10 @@ public:
     /// \parameter foundEntities[out] vector of EntityItemPointer
     void findEntities(RecurseOctreeOperation& scanOperator, QVector<EntityItemPointer>& foundEntities);
 
+    /// the same sphere, cube, box, frustum and ray queries as above, answered without the tree lock
+    const EntitySpatialIndex& getSpatialIndex() const { return _spatialIndex; }
+    EntitySpatialIndex& getSpatialIndex() { return _spatialIndex; }
+
     void addNewlyCreatedHook(NewlyCreatedEntityHook* hook);
     void removeNewlyCreatedHook(NewlyCreatedEntityHook* hook);
 
@@ -285,7 +290,8 @@ signals:
 protected:
 
     void processRemovedEntities(const DeleteEntityOperator& theOperator);
-    bool updateEntity(EntityItemPointer entity, const EntityItemProperties& properties,
+    // NOTE: properties may be adjusted in place (e.g. disallowed simulation changes are squashed)
+    bool updateEntity(EntityItemPointer entity, EntityItemProperties& properties,
             const SharedNodePointer& senderNode = SharedNodePointer(nullptr));
     static bool findNearPointOperation(const OctreeElementPointer& element, void* extraData);
     static bool findInSphereOperation(const OctreeElementPointer& element, void* extraData);
@@ -321,6 +327,8 @@ protected:
     mutable QReadWriteLock _entityMapLock;
     QHash<EntityItemID, EntityItemPointer> _entityMap;
 
+    EntitySpatialIndex _spatialIndex; // kept current by EntityTreeElement
+
     EntitySimulationPointer _simulation;
 
     bool _wantEditLogging = false;
@@ -200,6 +200,12 @@ public:
     /// \param entities[out] vector of non-const EntityItemPointer
     void getEntities(const ViewFrustum& frustum, QVector<EntityItemPointer>& foundEntities);
 
+    /// the per-entity tests used by getEntities(), shared with EntitySpatialIndex so both find the same entities
+    static bool entityTouchesSphere(const EntityItemPointer& entity, const glm::vec3& position, float radius);
+    static bool entityTouchesCube(const EntityItemPointer& entity, const AACube& cube);
+    static bool entityTouchesBox(const EntityItemPointer& entity, const AABox& box);
+    static bool entityTouchesFrustum(const EntityItemPointer& entity, const ViewFrustum& frustum);
+
     /// finds all entities that match filter
     /// \param filter function that adds matching entities to foundEntities
     /// \param entities[out] vector of non-const EntityItemPointer
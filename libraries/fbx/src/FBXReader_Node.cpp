@@ -11,9 +11,15 @@
 
 #include "FBXReader.h"
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <limits>
+#include <vector>
+
 #include <QtCore/QBuffer>
 #include <QtCore/QDataStream>
+#include <QtCore/QFile>
 #include <QtCore/QIODevice>
 #include <QtCore/QStringList>
 #include <QtCore/QTextStream>
@@ -21,183 +27,150 @@
 #include <QtCore/QtEndian>
 #include <QtCore/QFileInfo>
 
+#include <zlib.h>
+
+#include <Finally.h>
+#include <TBBHelpers.h>
 #include <shared/NsightHelpers.h>
 #include "ModelFormatLogging.h"
 
-template<class T>
-int streamSize() {
-    return sizeof(T);
+namespace {
+
+// An array property's values, copied or inflated once the whole node tree has been read so that the arrays of a large
+// file are decoded in parallel, straight into the vectors the tree holds.
+struct PendingArray {
+    const char* source;
+    quint32 sourceLength;
+    bool compressed;
+    char* destination;
+    quint32 destinationLength;
+    int elementSize;
+};
+
+// Parses a binary FBX file in place.  Callers map the file into memory (or hand over a buffer they already have)
+// instead of streaming it through a QDataStream, so nothing but the node tree itself is allocated, and compressed
+// arrays are inflated directly into their final storage rather than through a copy of the compressed data and a
+// qUncompress() result.
+class FBXBinaryParser {
+public:
+    FBXBinaryParser(const char* data, qint64 size) : _data(data), _size(size) {}
+
+    FBXNode parse();
+
+private:
+    const char* take(qint64 length);
+
+    template <typename T>
+    T read();
+
+    template <typename T>
+    QVariant readArray();
+
+    QVariant parseProperty();
+    FBXNode parseNode();
+    void decodeArrays();
+
+    const char* _data;
+    qint64 _size;
+    qint64 _position { 0 };
+    bool _has64BitPositions { false };
+    std::vector<PendingArray> _pendingArrays;
+};
+
+const char* FBXBinaryParser::take(qint64 length) {
+    if (length < 0 || length > _size - _position) {
+        throw QString("corrupt fbx file");
+    }
+    const char* bytes = _data + _position;
+    _position += length;
+    return bytes;
 }
 
-template<bool>
-int streamSize() {
-    return 1;
+template <typename T>
+T FBXBinaryParser::read() {
+    T value;
+    memcpy(&value, take(sizeof(T)), sizeof(T));
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    std::reverse(reinterpret_cast<char*>(&value), reinterpret_cast<char*>(&value) + sizeof(T));
+#endif
+    return value;
 }
 
-template<class T>
-QVariant readBinaryArray(QDataStream& in, int& position) {
-    quint32 arrayLength;
-    quint32 encoding;
-    quint32 compressedLength;
-
-    in >> arrayLength;
-    in >> encoding;
-    in >> compressedLength;
-    position += sizeof(quint32) * 3;
-
-    QVector<T> values;
-    if ((int)QSysInfo::ByteOrder == (int)in.byteOrder()) {
-        values.resize(arrayLength);
-        QByteArray arrayData;
-        if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
-            // preface encoded data with uncompressed length
-            QByteArray compressed(sizeof(quint32) + compressedLength, 0);
-            *((quint32*)compressed.data()) = qToBigEndian<quint32>(arrayLength * sizeof(T));
-            in.readRawData(compressed.data() + sizeof(quint32), compressedLength);
-            position += compressedLength;
-            arrayData = qUncompress(compressed);
-            if (arrayData.isEmpty() ||
-                (unsigned int)arrayData.size() != (sizeof(T) * arrayLength)) { // answers empty byte array if corrupt
-                throw QString("corrupt fbx file");
-            }
-        } else {
-            arrayData.resize(sizeof(T) * arrayLength);
-            position += sizeof(T) * arrayLength;
-            in.readRawData(arrayData.data(), arrayData.size());
-        }
+template <typename T>
+QVariant FBXBinaryParser::readArray() {
+    quint32 arrayLength = read<quint32>();
+    quint32 encoding = read<quint32>();
+    quint32 compressedLength = read<quint32>();
 
-        if (arrayData.size() > 0) {
-            memcpy(&values[0], arrayData.constData(), arrayData.size());
-        }
-    } else {
-        values.reserve(arrayLength);
-        if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
-            // preface encoded data with uncompressed length
-            QByteArray compressed(sizeof(quint32) + compressedLength, 0);
-            *((quint32*)compressed.data()) = qToBigEndian<quint32>(arrayLength * sizeof(T));
-            in.readRawData(compressed.data() + sizeof(quint32), compressedLength);
-            position += compressedLength;
-            QByteArray uncompressed = qUncompress(compressed);
-            if (uncompressed.isEmpty()) { // answers empty byte array if corrupt
-                throw QString("corrupt fbx file");
-            }
-            QDataStream uncompressedIn(uncompressed);
-            uncompressedIn.setByteOrder(QDataStream::LittleEndian);
-            uncompressedIn.setVersion(QDataStream::Qt_4_5); // for single/double precision switch
-            for (quint32 i = 0; i < arrayLength; i++) {
-                T value;
-                uncompressedIn >> value;
-                values.append(value);
-            }
-        } else {
-            for (quint32 i = 0; i < arrayLength; i++) {
-                T value;
-                in >> value;
-                position += streamSize<T>();
-                values.append(value);
-            }
-        }
+    const quint64 MAX_ARRAY_BYTES = std::numeric_limits<int>::max();
+    quint64 arrayBytes = (quint64)arrayLength * sizeof(T);
+    if (arrayBytes > MAX_ARRAY_BYTES) {
+        throw QString("corrupt fbx file");
+    }
+    bool compressed = (encoding == FBX_PROPERTY_COMPRESSED_FLAG);
+    quint32 sourceLength = compressed ? compressedLength : (quint32)arrayBytes;
+    const char* source = take(sourceLength);
+
+    // The vector's buffer is filled in by decodeArrays(), after the property has been handed to the node.  The QVariant
+    // shares that buffer and nothing detaches it before parsing is done, so the pointer stays valid.
+    QVector<T> values(arrayLength);
+    if (arrayLength > 0) {
+        _pendingArrays.push_back({ source, sourceLength, compressed, reinterpret_cast<char*>(values.data()),
+                                   (quint32)arrayBytes, (int)sizeof(T) });
     }
     return QVariant::fromValue(values);
 }
 
-QVariant parseBinaryFBXProperty(QDataStream& in, int& position) {
-    char ch;
-    in.device()->getChar(&ch);
-    position++;
+QVariant FBXBinaryParser::parseProperty() {
+    char ch = *take(1);
     switch (ch) {
-        case 'Y': {
-            qint16 value;
-            in >> value;
-            position += sizeof(qint16);
-            return QVariant::fromValue(value);
-        }
-        case 'C': {
-            bool value;
-            in >> value;
-            position++;
-            return QVariant::fromValue(value);
-        }
-        case 'I': {
-            qint32 value;
-            in >> value;
-            position += sizeof(qint32);
-            return QVariant::fromValue(value);
-        }
-        case 'F': {
-            float value;
-            in >> value;
-            position += sizeof(float);
-            return QVariant::fromValue(value);
-        }
-        case 'D': {
-            double value;
-            in >> value;
-            position += sizeof(double);
-            return QVariant::fromValue(value);
-        }
-        case 'L': {
-            qint64 value;
-            in >> value;
-            position += sizeof(qint64);
-            return QVariant::fromValue(value);
-        }
-        case 'f': {
-            return readBinaryArray<float>(in, position);
-        }
-        case 'd': {
-            return readBinaryArray<double>(in, position);
-        }
-        case 'l': {
-            return readBinaryArray<qint64>(in, position);
-        }
-        case 'i': {
-            return readBinaryArray<qint32>(in, position);
-        }
-        case 'b': {
-            return readBinaryArray<bool>(in, position);
-        }
+        case 'Y':
+            return QVariant::fromValue(read<qint16>());
+        case 'C':
+            return QVariant::fromValue(read<quint8>() != 0);
+        case 'I':
+            return QVariant::fromValue(read<qint32>());
+        case 'F':
+            return QVariant::fromValue(read<float>());
+        case 'D':
+            return QVariant::fromValue(read<double>());
+        case 'L':
+            return QVariant::fromValue(read<qint64>());
+        case 'f':
+            return readArray<float>();
+        case 'd':
+            return readArray<double>();
+        case 'l':
+            return readArray<qint64>();
+        case 'i':
+            return readArray<qint32>();
+        case 'b':
+            return readArray<bool>();
         case 'S':
         case 'R': {
-            quint32 length;
-            in >> length;
-            position += sizeof(quint32) + length;
-            return QVariant::fromValue(in.device()->read(length));
+            quint32 length = read<quint32>();
+            return QVariant::fromValue(QByteArray(take(length), length));
         }
         default:
             throw QString("Unknown property type: ") + ch;
     }
 }
 
-FBXNode parseBinaryFBXNode(QDataStream& in, int& position, bool has64BitPositions = false) {
+FBXNode FBXBinaryParser::parseNode() {
     qint64 endOffset;
     quint64 propertyCount;
-    quint64 propertyListLength;
-    quint8 nameLength;
 
     // FBX 2016 and beyond uses 64bit positions in the node headers, pre-2016 used 32bit values
-    // our code generally doesn't care about the size that much, so we will use 64bit values
-    // from here on out, but if the file is an older format we read the stream into temp 32bit 
-    // values and then assign to our actual 64bit values.
-    if (has64BitPositions) {
-        in >> endOffset;
-        in >> propertyCount;
-        in >> propertyListLength;
-        position += sizeof(quint64) * 3;
+    if (_has64BitPositions) {
+        endOffset = read<qint64>();
+        propertyCount = read<quint64>();
+        read<quint64>(); // property list length
     } else {
-        qint32 tempEndOffset;
-        quint32 tempPropertyCount;
-        quint32 tempPropertyListLength;
-        in >> tempEndOffset;
-        in >> tempPropertyCount;
-        in >> tempPropertyListLength;
-        position += sizeof(quint32) * 3;
-        endOffset = tempEndOffset;
-        propertyCount = tempPropertyCount;
-        propertyListLength = tempPropertyListLength;
-    }
-    in >> nameLength;
-    position += sizeof(quint8);
+        endOffset = read<qint32>();
+        propertyCount = read<quint32>();
+        read<quint32>(); // property list length
+    }
+    quint8 nameLength = read<quint8>();
 
     FBXNode node;
     const int MIN_VALID_OFFSET = 40;
@@ -205,15 +178,17 @@ FBXNode parseBinaryFBXNode(QDataStream& in, int& position, bool has64BitPosition
         // use a null name to indicate a null node
         return node;
     }
-    node.name = in.device()->read(nameLength);
-    position += nameLength;
+    if (endOffset > _size) {
+        throw QString("corrupt fbx file");
+    }
+    node.name = QByteArray(take(nameLength), nameLength);
 
-    for (quint32 i = 0; i < propertyCount; i++) {
-        node.properties.append(parseBinaryFBXProperty(in, position));
+    for (quint64 i = 0; i < propertyCount; i++) {
+        node.properties.append(parseProperty());
     }
 
-    while (endOffset > position) {
-        FBXNode child = parseBinaryFBXNode(in, position, has64BitPositions);
+    while (endOffset > _position) {
+        FBXNode child = parseNode();
         if (child.name.isNull()) {
             return node;
 
@@ -225,6 +200,67 @@ FBXNode parseBinaryFBXNode(QDataStream& in, int& position, bool has64BitPosition
     return node;
 }
 
+void FBXBinaryParser::decodeArrays() {
+    std::atomic<bool> corrupt { false };
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, _pendingArrays.size()), [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i < range.end(); i++) {
+            const PendingArray& array = _pendingArrays[i];
+            if (array.compressed) {
+                uLongf length = array.destinationLength;
+                if (uncompress(reinterpret_cast<Bytef*>(array.destination), &length,
+                               reinterpret_cast<const Bytef*>(array.source), array.sourceLength) != Z_OK ||
+                    length != array.destinationLength) {
+                    corrupt = true;
+                    continue;
+                }
+            } else {
+                memcpy(array.destination, array.source, array.destinationLength);
+            }
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+            for (char* value = array.destination; value < array.destination + array.destinationLength;
+                 value += array.elementSize) {
+                std::reverse(value, value + array.elementSize);
+            }
+#endif
+        }
+    });
+    if (corrupt) {
+        throw QString("corrupt fbx file");
+    }
+}
+
+FBXNode FBXBinaryParser::parse() {
+    // see http://code.blender.org/index.php/2013/08/fbx-binary-file-format-specification/ for an explanation
+    // of the FBX binary format
+
+    // The first 27 bytes contain the header.
+    //   Bytes 0 - 20: Kaydara FBX Binary  \x00(file - magic, with 2 spaces at the end, then a NULL terminator).
+    //   Bytes 21 - 22: [0x1A, 0x00](unknown but all observed files show these bytes).
+    //   Bytes 23 - 26 : unsigned int, the version number. 7300 for version 7.3 for example.
+    take(FBX_HEADER_BYTES_BEFORE_VERSION);
+    quint32 fileVersion = read<quint32>();
+    qCDebug(modelformat) << "fileVersion:" << fileVersion;
+    _has64BitPositions = (fileVersion >= FBX_VERSION_2016);
+
+    // parse the top-level node
+    const qint64 nodeHeaderSize = _has64BitPositions ? (3 * sizeof(quint64) + 1) : (3 * sizeof(quint32) + 1);
+    FBXNode top;
+    while (_size - _position >= nodeHeaderSize) {
+        FBXNode next = parseNode();
+        if (next.name.isNull()) {
+            break;
+
+        } else {
+            top.children.append(next);
+        }
+    }
+
+    decodeArrays();
+    return top;
+}
+
+}
+
 class Tokenizer {
 public:
 
@@ -366,38 +402,32 @@ FBXNode FBXReader::parseFBX(QIODevice* device) {
         }
         return top;
     }
-    QDataStream in(device);
-    in.setByteOrder(QDataStream::LittleEndian);
-    in.setVersion(QDataStream::Qt_4_5); // for single/double precision switch
-
-    // see http://code.blender.org/index.php/2013/08/fbx-binary-file-format-specification/ for an explanation
-    // of the FBX binary format
-
-    // The first 27 bytes contain the header.
-    //   Bytes 0 - 20: Kaydara FBX Binary  \x00(file - magic, with 2 spaces at the end, then a NULL terminator).
-    //   Bytes 21 - 22: [0x1A, 0x00](unknown but all observed files show these bytes).
-    //   Bytes 23 - 26 : unsigned int, the version number. 7300 for version 7.3 for example.
-    in.skipRawData(FBX_HEADER_BYTES_BEFORE_VERSION);
-    int position = FBX_HEADER_BYTES_BEFORE_VERSION;
-    quint32 fileVersion;
-    in >> fileVersion;
-    position += sizeof(fileVersion);
-    qCDebug(modelformat) << "fileVersion:" << fileVersion;
-    bool has64BitPositions = (fileVersion >= FBX_VERSION_2016);
-
-    // parse the top-level node
-    FBXNode top;
-    while (device->bytesAvailable()) {
-        FBXNode next = parseBinaryFBXNode(in, position, has64BitPositions);
-        if (next.name.isNull()) {
-            return top;
 
-        } else {
-            top.children.append(next);
-        }
+    // parse binary files in place: map files into memory rather than reading them, and use a buffer's data directly
+    const char* data = nullptr;
+    qint64 size = 0;
+    uchar* mappedData = nullptr;
+    QByteArray contents;
+    QFile* file = qobject_cast<QFile*>(device);
+    QBuffer* buffer = qobject_cast<QBuffer*>(device);
+    if (file && (mappedData = file->map(file->pos(), file->size() - file->pos()))) {
+        data = reinterpret_cast<const char*>(mappedData);
+        size = file->size() - file->pos();
+    } else if (buffer) {
+        data = buffer->data().constData() + buffer->pos();
+        size = buffer->size() - buffer->pos();
+    } else {
+        contents = device->readAll();
+        data = contents.constData();
+        size = contents.size();
     }
+    Finally unmap([&] {
+        if (mappedData) {
+            file->unmap(mappedData);
+        }
+    });
 
-    return top;
+    return FBXBinaryParser(data, size).parse();
 }
 
 
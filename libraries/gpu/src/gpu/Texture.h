@@ -310,8 +310,11 @@ public:
 
     class KtxStorage : public Storage {
     public:
-        KtxStorage(const std::string& filename);
-        KtxStorage(const cache::FilePointer& file);
+        // file, if given, is an existing mapping of the ktx and saves mapping it again to read the descriptor
+        KtxStorage(const std::string& filename, const std::shared_ptr<storage::FileStorage>& file = nullptr);
+        KtxStorage(const cache::FilePointer& cacheEntry, const std::shared_ptr<storage::FileStorage>& file = nullptr);
+
+        // Returns a view into the mapped ktx file rather than a copy, and starts paging in the next mip up.
         PixelsPointer getMipFace(uint16 level, uint8 face = 0) const override;
         Size getMipFaceSize(uint16 level, uint8 face = 0) const override;
         bool isMipAvailable(uint16 level, uint8 face = 0) const override;
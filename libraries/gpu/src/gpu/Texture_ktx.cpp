@@ -154,14 +154,17 @@ struct IrradianceKTXPayload {
 };
 const std::string IrradianceKTXPayload::KEY{ "hifi.irradianceSH" };
 
-KtxStorage::KtxStorage(const cache::FilePointer& cacheEntry) : KtxStorage(cacheEntry->getFilepath())  {
+KtxStorage::KtxStorage(const cache::FilePointer& cacheEntry, const std::shared_ptr<storage::FileStorage>& file) :
+    KtxStorage(cacheEntry->getFilepath(), file) {
     _cacheEntry = cacheEntry;
 }
 
-KtxStorage::KtxStorage(const std::string& filename) : _filename(filename) {
+KtxStorage::KtxStorage(const std::string& filename, const std::shared_ptr<storage::FileStorage>& file) : _filename(filename) {
     {
         // We are doing a lot of work here just to get descriptor data
-        ktx::StoragePointer storage{ new storage::FileStorage(_filename.c_str()) };
+        std::shared_ptr<storage::FileStorage> storage = file ? file : std::make_shared<storage::FileStorage>(_filename.c_str());
+        // mips are served straight out of this mapping for as long as anyone holds a view of it
+        _cacheFile = storage;
         auto ktxPointer = ktx::KTX::create(storage);
         _ktxDescriptor.reset(new ktx::KTXDescriptor(ktxPointer->toDescriptor()));
         if (_ktxDescriptor->images.size() < _ktxDescriptor->header.numberOfMipmapLevels) {
@@ -221,7 +224,17 @@ PixelsPointer KtxStorage::getMipFace(uint16 level, uint8 face) const {
         if (file) {
             auto storageView = file->createView(faceSize, faceOffset);
             if (storageView) {
-                return storageView->toMemoryStorage();
+                // Mips are requested from the buffering thread, so fault this one in now rather than during the
+                // upload, and read ahead the next mip up since that is the one the texture will ask for next.
+                file->prefetch(faceOffset, faceSize, true);
+                if (level > _minMipLevelAvailable) {
+                    auto nextOffset = _ktxDescriptor->getMipFaceTexelsOffset(level - 1, face);
+                    auto nextSize = _ktxDescriptor->getMipFaceTexelsSize(level - 1, face);
+                    file->prefetch(nextOffset, nextSize);
+                }
+                // The view keeps the mapping alive, and assignMipData only ever writes mips below the ones
+                // available, so handing out the mapped bytes directly is safe.
+                return storageView;
             } else {
                 qWarning() << "Failed to get a valid storageView for faceSize=" << faceSize << "  faceOffset=" << faceOffset << "out of valid file " << QString::fromStdString(_filename);
             }
@@ -516,28 +529,33 @@ TexturePointer Texture::build(const ktx::KTXDescriptor& descriptor) {
 }
 
 TexturePointer Texture::unserialize(const cache::FilePointer& cacheEntry) {
-    std::unique_ptr<ktx::KTX> ktxPointer = ktx::KTX::create(std::make_shared<storage::FileStorage>(cacheEntry->getFilepath().c_str()));
+    auto file = std::make_shared<storage::FileStorage>(cacheEntry->getFilepath().c_str());
+    std::unique_ptr<ktx::KTX> ktxPointer = ktx::KTX::create(file);
     if (!ktxPointer) {
         return nullptr;
     }
 
     auto texture = build(ktxPointer->toDescriptor());
     if (texture) {
-        texture->setKtxBacking(cacheEntry);
+        // KTX::create has already validated the file, so back the texture with the same mapping
+        auto newBacking = std::unique_ptr<Storage>(new KtxStorage(cacheEntry, file));
+        texture->setStorage(newBacking);
     }
 
     return texture;
 }
 
 TexturePointer Texture::unserialize(const std::string& ktxfile) {
-    std::unique_ptr<ktx::KTX> ktxPointer = ktx::KTX::create(std::make_shared<storage::FileStorage>(ktxfile.c_str()));
+    auto file = std::make_shared<storage::FileStorage>(ktxfile.c_str());
+    std::unique_ptr<ktx::KTX> ktxPointer = ktx::KTX::create(file);
     if (!ktxPointer) {
         return nullptr;
     }
 
     auto texture = build(ktxPointer->toDescriptor());
     if (texture) {
-        texture->setKtxBacking(ktxfile);
+        auto newBacking = std::unique_ptr<Storage>(new KtxStorage(ktxfile, file));
+        texture->setStorage(newBacking);
     }
 
     return texture;
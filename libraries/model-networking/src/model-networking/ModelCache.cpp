@@ -10,7 +10,6 @@
 //
 
 #include "ModelCache.h"
-#include <Finally.h>
 #include <FSTReader.h>
 #include "FBXReader.h"
 #include "OBJReader.h"
@@ -18,13 +17,12 @@
 #include <gpu/Batch.h>
 #include <gpu/Stream.h>
 
-#include <QThreadPool>
+#include <LoaderScheduler.h>
 
 #include <Gzip.h>
 
 #include "ModelNetworkingLogging.h"
 #include <Trace.h>
-#include <StatTracker.h>
 
 Q_LOGGING_CATEGORY(trace_resource_parse_geometry, "trace.resource.parse.geometry")
 
@@ -131,16 +129,14 @@ void GeometryMappingResource::onGeometryMappingLoaded(bool success) {
     finishedLoading(success);
 }
 
-class GeometryReader : public QRunnable {
+// Parses downloaded geometry on a LoaderScheduler thread.
+class GeometryReader {
 public:
     GeometryReader(QWeakPointer<Resource>& resource, const QUrl& url, const QVariantHash& mapping,
                    const QByteArray& data, bool combineParts) :
-        _resource(resource), _url(url), _mapping(mapping), _data(data), _combineParts(combineParts) {
+        _resource(resource), _url(url), _mapping(mapping), _data(data), _combineParts(combineParts) {}
 
-        DependencyManager::get<StatTracker>()->incrementStat("PendingProcessing");
-    }
-
-    virtual void run() override;
+    void run();
 
 private:
     QWeakPointer<Resource> _resource;
@@ -151,17 +147,7 @@ private:
 };
 
 void GeometryReader::run() {
-    DependencyManager::get<StatTracker>()->decrementStat("PendingProcessing");
-    CounterStat counter("Processing");
     PROFILE_RANGE_EX(resource_parse_geometry, "GeometryReader::run", 0xFF00FF00, 0, { { "url", _url.toString() } });
-    auto originalPriority = QThread::currentThread()->priority();
-    if (originalPriority == QThread::InheritPriority) {
-        originalPriority = QThread::NormalPriority;
-    }
-    QThread::currentThread()->setPriority(QThread::LowPriority);
-    Finally setPriorityBackToNormal([originalPriority]() {
-        QThread::currentThread()->setPriority(originalPriority);
-    });
 
     if (!_resource.data()) {
         qCWarning(modelnetworking) << "Abandoning load of" << _url << "; resource was deleted";
@@ -245,7 +231,10 @@ void GeometryDefinitionResource::downloadFinished(const QByteArray& data) {
         _url = _effectiveBaseURL;
         _textureBaseUrl = _effectiveBaseURL;
     }
-    QThreadPool::globalInstance()->start(new GeometryReader(_self, _effectiveBaseURL, _mapping, data, _combineParts));
+    auto reader = std::make_shared<GeometryReader>(_self, _effectiveBaseURL, _mapping, data, _combineParts);
+    DependencyManager::get<LoaderScheduler>()->queueJob(LoaderScheduler::JobType::Geometry, _self, [reader] {
+        reader->run();
+    });
 }
 
 void GeometryDefinitionResource::setGeometryDefinition(FBXGeometry::Pointer fbxGeometry) {
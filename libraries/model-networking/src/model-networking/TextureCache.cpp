@@ -13,12 +13,8 @@
 
 #include <mutex>
 
-#include <QtConcurrent/QtConcurrentRun>
-
 #include <QCryptographicHash>
 #include <QImageReader>
-#include <QRunnable>
-#include <QThreadPool>
 #include <QNetworkReply>
 #include <QPainter>
 #include <QUrlQuery>
@@ -38,13 +34,12 @@
 #include <NumericalConstants.h>
 #include <shared/NsightHelpers.h>
 
-#include <Finally.h>
+#include <LoaderScheduler.h>
 #include <Profile.h>
 
 #include "NetworkLogging.h"
 #include "ModelNetworkingLogging.h"
 #include <Trace.h>
-#include <StatTracker.h>
 
 Q_LOGGING_CATEGORY(trace_resource_parse_image, "trace.resource.parse.image")
 Q_LOGGING_CATEGORY(trace_resource_parse_image_raw, "trace.resource.parse.image.raw")
@@ -342,11 +337,12 @@ gpu::TexturePointer NetworkTexture::getFallbackTexture() const {
     return getFallbackTextureForType(_type);
 }
 
-class ImageReader : public QRunnable {
+// Decodes a downloaded image on a LoaderScheduler thread.
+class ImageReader {
 public:
     ImageReader(const QWeakPointer<Resource>& resource, const QUrl& url,
                 const QByteArray& data, int maxNumPixels);
-    void run() override final;
+    void run();
     void read();
 
 private:
@@ -597,18 +593,8 @@ void NetworkTexture::ktxMipRequestFinished() {
             auto data = _ktxMipRequest->getData();
             auto mipLevel = _ktxMipLevelRangeInFlight.first;
             auto texture = _textureSource->getGPUTexture();
-            DependencyManager::get<StatTracker>()->incrementStat("PendingProcessing");
-            QtConcurrent::run(QThreadPool::globalInstance(), [self, data, mipLevel, url, texture] {
+            DependencyManager::get<LoaderScheduler>()->queueJob(LoaderScheduler::JobType::KTX, self, [self, data, mipLevel, url, texture] {
                 PROFILE_RANGE_EX(resource_parse_image, "NetworkTexture - Processing Mip Data", 0xffff0000, 0, { { "url", url.toString() } });
-                DependencyManager::get<StatTracker>()->decrementStat("PendingProcessing");
-                CounterStat counter("Processing");
-
-                auto originalPriority = QThread::currentThread()->priority();
-                if (originalPriority == QThread::InheritPriority) {
-                    originalPriority = QThread::NormalPriority;
-                }
-                QThread::currentThread()->setPriority(QThread::LowPriority);
-                Finally restorePriority([originalPriority] { QThread::currentThread()->setPriority(originalPriority); });
 
                 auto resource = self.lock();
                 if (!resource) {
@@ -665,18 +651,8 @@ void NetworkTexture::handleFinishedInitialLoad() {
 
     auto self = _self;
     auto url = _url;
-    DependencyManager::get<StatTracker>()->incrementStat("PendingProcessing");
-    QtConcurrent::run(QThreadPool::globalInstance(), [self, ktxHeaderData, ktxHighMipData, url] {
+    DependencyManager::get<LoaderScheduler>()->queueJob(LoaderScheduler::JobType::KTX, self, [self, ktxHeaderData, ktxHighMipData, url] {
         PROFILE_RANGE_EX(resource_parse_image, "NetworkTexture - Processing Initial Data", 0xffff0000, 0, { { "url", url.toString() } });
-        DependencyManager::get<StatTracker>()->decrementStat("PendingProcessing");
-        CounterStat counter("Processing");
-
-        auto originalPriority = QThread::currentThread()->priority();
-        if (originalPriority == QThread::InheritPriority) {
-            originalPriority = QThread::NormalPriority;
-        }
-        QThread::currentThread()->setPriority(QThread::LowPriority);
-        Finally restorePriority([originalPriority] { QThread::currentThread()->setPriority(originalPriority); });
 
         auto resource = self.lock();
         if (!resource) {
@@ -827,7 +803,10 @@ void NetworkTexture::loadContent(const QByteArray& content) {
         return;
     }
 
-    QThreadPool::globalInstance()->start(new ImageReader(_self, _url, content, _maxNumPixels));
+    auto reader = std::make_shared<ImageReader>(_self, _url, content, _maxNumPixels);
+    DependencyManager::get<LoaderScheduler>()->queueJob(LoaderScheduler::JobType::Image, _self, [reader] {
+        reader->run();
+    });
 }
 
 void NetworkTexture::refresh() {
@@ -858,7 +837,6 @@ ImageReader::ImageReader(const QWeakPointer<Resource>& resource, const QUrl& url
     _content(data),
     _maxNumPixels(maxNumPixels)
 {
-    DependencyManager::get<StatTracker>()->incrementStat("PendingProcessing");
     listSupportedImageFormats();
 
 #if DEBUG_DUMP_TEXTURE_LOADS
@@ -891,16 +869,6 @@ void ImageReader::listSupportedImageFormats() {
 
 void ImageReader::run() {
     PROFILE_RANGE_EX(resource_parse_image, __FUNCTION__, 0xffff0000, 0, { { "url", _url.toString() } });
-    DependencyManager::get<StatTracker>()->decrementStat("PendingProcessing");
-    CounterStat counter("Processing");
-
-    auto originalPriority = QThread::currentThread()->priority();
-    if (originalPriority == QThread::InheritPriority) {
-        originalPriority = QThread::NormalPriority;
-    }
-    QThread::currentThread()->setPriority(QThread::LowPriority);
-    Finally restorePriority([originalPriority] { QThread::currentThread()->setPriority(originalPriority); });
-
     read();
 }
 
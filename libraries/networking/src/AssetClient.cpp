@@ -257,7 +257,7 @@ MessageID AssetClient::getAsset(const QString& hash, DataOffset start, DataOffse
         }
     }
 
-    callback(false, AssetServerError::NoError, QByteArray());
+    callback(false, AssetServerError::NoError, QSharedPointer<ReceivedMessage>());
     return INVALID_MESSAGE_ID;
 }
 
@@ -377,9 +377,9 @@ void AssetClient::handleAssetGetReply(QSharedPointer<ReceivedMessage> message, S
         disconnect(message.data(), nullptr, this, nullptr);
 
         if (length != message->getBytesLeftToRead()) {
-            callbacks.completeCallback(false, error, QByteArray());
+            callbacks.completeCallback(false, error, QSharedPointer<ReceivedMessage>());
         } else {
-            callbacks.completeCallback(true, error, message->readAll());
+            callbacks.completeCallback(true, error, message);
         }
 
 
@@ -448,9 +448,9 @@ void AssetClient::handleCompleteCallback(const QWeakPointer<Node>& node, Message
     }
 
     if (message->failed() || length != message->getBytesLeftToRead()) {
-        callbacks.completeCallback(false, AssetServerError::NoError, QByteArray());
+        callbacks.completeCallback(false, AssetServerError::NoError, QSharedPointer<ReceivedMessage>());
     } else {
-        callbacks.completeCallback(true, AssetServerError::NoError, message->readAll());
+        callbacks.completeCallback(true, AssetServerError::NoError, message);
     }
 
     // We should never get to this point without the associated senderNode and messageID
@@ -797,7 +797,7 @@ void AssetClient::forceFailureOfPendingRequests(SharedNodePointer node) {
                     disconnect(message.data(), nullptr, this, nullptr);
                 }
 
-                value.second.completeCallback(false, AssetServerError::NoError, QByteArray());
+                value.second.completeCallback(false, AssetServerError::NoError, QSharedPointer<ReceivedMessage>());
             }
             messageMapIt->second.clear();
         }
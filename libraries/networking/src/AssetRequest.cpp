@@ -13,6 +13,7 @@
 
 #include <algorithm>
 
+#include <QtCore/QCryptographicHash>
 #include <QtCore/QThread>
 
 #include <StatTracker.h>
@@ -80,7 +81,7 @@ void AssetRequest::start() {
     auto hash = _hash;
 
     _assetRequestID = assetClient->getAsset(_hash, _byteRange.fromInclusive, _byteRange.toExclusive,
-        [this, that, hash](bool responseReceived, AssetServerError serverError, const QByteArray& data) {
+        [this, that, hash](bool responseReceived, AssetServerError serverError, QSharedPointer<ReceivedMessage> message) {
 
         if (!that) {
             qCWarning(asset_client) << "Got reply for dead asset request " << hash << "- error code" << _error;
@@ -104,12 +105,24 @@ void AssetRequest::start() {
                     break;
             }
         } else {
-            if (!_byteRange.isSet() && hashData(data).toHex() != _hash) {
-                // the hash of the received data does not match what we expect, so we return an error
-                _error = HashVerificationFailed;
+            if (!_byteRange.isSet()) {
+                // hash the asset straight from the packets it arrived in, it is only copied once it checks out
+                auto dataPosition = message->getPosition();
+                QCryptographicHash hasher { QCryptographicHash::Sha256 };
+                for (const auto& view : message->readViews(message->getBytesLeftToRead())) {
+                    hasher.addData(view);
+                }
+                message->seek(dataPosition);
+
+                if (hasher.result().toHex() != _hash) {
+                    // the hash of the received data does not match what we expect, so we return an error
+                    _error = HashVerificationFailed;
+                }
             }
 
             if (_error == NoError) {
+                // the one copy, into a buffer of exactly the asset's size
+                auto data = message->readAll();
                 _data = data;
                 _totalReceived += data.size();
                 emit progress(_totalReceived, data.size());
@@ -0,0 +1,257 @@
+//
+//  LoaderScheduler.cpp
+//  libraries/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LoaderScheduler.h"
+
+#include <algorithm>
+
+#include <QtCore/QRunnable>
+#include <QtCore/QThread>
+
+#include <Finally.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <StatTracker.h>
+
+#include "ResourceCache.h"
+
+using Lock = std::unique_lock<std::mutex>;
+
+// queued jobs' priorities are refreshed about once a frame
+static const int PRIORITY_REFRESH_INTERVAL_MSECS = 16;
+
+class LoaderJobRunner : public QRunnable {
+public:
+    LoaderJobRunner(LoaderScheduler* scheduler, LoaderScheduler::JobType type, LoaderScheduler::QueuedJob&& job) :
+        _scheduler(scheduler), _type(type), _job(std::move(job)) {}
+
+    void run() override {
+        auto originalPriority = QThread::currentThread()->priority();
+        if (originalPriority == QThread::InheritPriority) {
+            originalPriority = QThread::NormalPriority;
+        }
+        QThread::currentThread()->setPriority(QThread::LowPriority);
+        Finally restorePriority([originalPriority] { QThread::currentThread()->setPriority(originalPriority); });
+
+        _scheduler->runJob(_type, _job);
+    }
+
+private:
+    LoaderScheduler* _scheduler;
+    LoaderScheduler::JobType _type;
+    LoaderScheduler::QueuedJob _job;
+};
+
+LoaderScheduler::LoaderScheduler() {
+    int threads = std::max(QThread::idealThreadCount(), 1);
+    _threadPool.setMaxThreadCount(threads);
+
+    // geometry parsing is the slowest job and the one most likely to be for something off in the distance, so don't let
+    // it take every thread
+    _queues[(int)JobType::Geometry].limit = std::max(threads / 2, 1);
+    _queues[(int)JobType::Image].limit = threads;
+    _queues[(int)JobType::KTX].limit = threads;
+
+    _priorityRefreshTimer.setInterval(PRIORITY_REFRESH_INTERVAL_MSECS);
+    QObject::connect(&_priorityRefreshTimer, &QTimer::timeout, [this] { refreshPriorities(); });
+}
+
+LoaderScheduler::~LoaderScheduler() {
+    {
+        Lock lock(_mutex);
+        auto statTracker = DependencyManager::get<StatTracker>();
+        for (auto& queue : _queues) {
+            if (statTracker) {
+                statTracker->updateStat("PendingProcessing", -(int64_t)queue.jobs.size());
+            }
+            queue.cancelled += queue.jobs.size();
+            queue.jobs.clear();
+        }
+    }
+    _threadPool.waitForDone();
+}
+
+void LoaderScheduler::queueJob(JobType type, const QWeakPointer<Resource>& resource, Job job) {
+    Q_ASSERT(QThread::currentThread() == _priorityRefreshTimer.thread());
+
+    float priority = 0.0f;
+    {
+        auto strongResource = resource.lock();
+        if (!strongResource) {
+            return;
+        }
+        priority = strongResource->getLoadPriority();
+    }
+
+    DependencyManager::get<StatTracker>()->incrementStat("PendingProcessing");
+
+    {
+        Lock lock(_mutex);
+        auto& queue = _queues[(int)type];
+        queue.jobs.push_back({ resource, priority, _nextSequence++, usecTimestampNow(), std::move(job) });
+        std::push_heap(queue.jobs.begin(), queue.jobs.end(), isLowerPriority);
+        dispatch();
+    }
+
+    if (!_priorityRefreshTimer.isActive()) {
+        _priorityRefreshTimer.start();
+    }
+}
+
+void LoaderScheduler::setConcurrencyLimit(JobType type, int limit) {
+    Lock lock(_mutex);
+    _queues[(int)type].limit = std::max(limit, 1);
+    dispatch();
+}
+
+int LoaderScheduler::getConcurrencyLimit(JobType type) const {
+    Lock lock(_mutex);
+    return _queues[(int)type].limit;
+}
+
+QVariantMap LoaderScheduler::getStats() const {
+    Lock lock(_mutex);
+    QVariantMap result;
+    for (int i = 0; i < (int)JobType::NumJobTypes; i++) {
+        const auto& queue = _queues[i];
+        QVariantMap stats;
+        stats["queued"] = (int)queue.jobs.size();
+        stats["running"] = queue.running;
+        stats["limit"] = queue.limit;
+        stats["completed"] = (double)queue.completed;
+        stats["cancelled"] = (double)queue.cancelled;
+
+        QVariantList queueWaitTimes;
+        QVariantList runTimes;
+        for (int bucket = 0; bucket < NUM_HISTOGRAM_BUCKETS; bucket++) {
+            queueWaitTimes.append((double)queue.queueWaitTimes[bucket]);
+            runTimes.append((double)queue.runTimes[bucket]);
+        }
+        stats["queueWaitMsecs"] = queueWaitTimes;
+        stats["runMsecs"] = runTimes;
+
+        result[getJobTypeName((JobType)i)] = stats;
+    }
+    return result;
+}
+
+int LoaderScheduler::getHistogramBucket(quint64 usecs) {
+    quint64 msecs = usecs / USECS_PER_MSEC;
+    int bucket = 0;
+    while (bucket < NUM_HISTOGRAM_BUCKETS - 1 && msecs >= (1ULL << bucket)) {
+        bucket++;
+    }
+    return bucket;
+}
+
+QString LoaderScheduler::getJobTypeName(JobType type) {
+    switch (type) {
+        case JobType::Geometry:
+            return "geometry";
+        case JobType::Image:
+            return "image";
+        case JobType::KTX:
+            return "ktx";
+        default:
+            return "unknown";
+    }
+}
+
+bool LoaderScheduler::isLowerPriority(const QueuedJob& a, const QueuedJob& b) {
+    // jobs of equal priority run in the order they were queued
+    return a.priority < b.priority || (a.priority == b.priority && a.sequence > b.sequence);
+}
+
+void LoaderScheduler::refreshPriorities() {
+    // Resource::getLoadPriority isn't thread safe, it prunes owners that have gone away
+    Q_ASSERT(QThread::currentThread() == _priorityRefreshTimer.thread());
+
+    auto statTracker = DependencyManager::get<StatTracker>();
+    bool isIdle = true;
+
+    Lock lock(_mutex);
+    for (auto& queue : _queues) {
+        auto end = std::remove_if(queue.jobs.begin(), queue.jobs.end(), [&](QueuedJob& job) {
+            auto resource = job.resource.lock();
+            if (!resource) {
+                return true;
+            }
+            job.priority = resource->getLoadPriority();
+            return false;
+        });
+        size_t cancelled = queue.jobs.end() - end;
+        if (cancelled > 0) {
+            // nothing references these resources anymore, drop their jobs and the data they hold
+            queue.jobs.erase(end, queue.jobs.end());
+            queue.cancelled += cancelled;
+            statTracker->updateStat("PendingProcessing", -(int64_t)cancelled);
+        }
+        std::make_heap(queue.jobs.begin(), queue.jobs.end(), isLowerPriority);
+        isIdle = isIdle && queue.jobs.empty();
+    }
+
+    if (isIdle) {
+        _priorityRefreshTimer.stop();
+    }
+}
+
+void LoaderScheduler::dispatch() {
+    while (_running < _threadPool.maxThreadCount()) {
+        // the highest priority job of any type that is under its limit
+        int nextType = -1;
+        for (int i = 0; i < (int)JobType::NumJobTypes; i++) {
+            const auto& queue = _queues[i];
+            if (!queue.jobs.empty() && queue.running < queue.limit &&
+                (nextType == -1 || isLowerPriority(_queues[nextType].jobs.front(), queue.jobs.front()))) {
+                nextType = i;
+            }
+        }
+        if (nextType == -1) {
+            break;
+        }
+
+        auto& queue = _queues[nextType];
+        std::pop_heap(queue.jobs.begin(), queue.jobs.end(), isLowerPriority);
+        QueuedJob job = std::move(queue.jobs.back());
+        queue.jobs.pop_back();
+        queue.running++;
+        _running++;
+        _threadPool.start(new LoaderJobRunner(this, (JobType)nextType, std::move(job)));
+    }
+}
+
+void LoaderScheduler::runJob(JobType type, QueuedJob& job) {
+    auto statTracker = DependencyManager::get<StatTracker>();
+    statTracker->decrementStat("PendingProcessing");
+
+    quint64 start = usecTimestampNow();
+    bool cancelled = job.resource.isNull();
+    if (!cancelled) {
+        CounterStat counter("Processing");
+        job.job();
+    }
+    quint64 end = usecTimestampNow();
+
+    // release whatever the job captured before waiting on the lock
+    job.job = Job();
+
+    Lock lock(_mutex);
+    auto& queue = _queues[(int)type];
+    queue.running--;
+    _running--;
+    if (cancelled) {
+        queue.cancelled++;
+    } else {
+        queue.completed++;
+        queue.queueWaitTimes[getHistogramBucket(start - job.queuedTime)]++;
+        queue.runTimes[getHistogramBucket(end - start)]++;
+    }
+    dispatch();
+}
@@ -0,0 +1,107 @@
+//
+//  LoaderScheduler.h
+//  libraries/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LoaderScheduler_h
+#define hifi_LoaderScheduler_h
+
+#include <array>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QThreadPool>
+#include <QtCore/QTimer>
+#include <QtCore/QVariantMap>
+#include <QtCore/QWeakPointer>
+
+#include <DependencyManager.h>
+
+class Resource;
+
+// Runs the CPU heavy part of loading resources (parsing geometry, decoding images and KTX data) on its own threads.
+//
+// Jobs wait in one queue per job type and start in order of their resource's load priority, so textures in front of
+// the user don't sit behind a large off-screen model.  Each job type has its own concurrency limit.  A job whose
+// resource is no longer referenced by the time it would start is dropped.  Resources are main thread objects, so jobs
+// are queued and their priorities refreshed on the thread that created the scheduler, never on a loader thread.
+class LoaderScheduler : public Dependency {
+    SINGLETON_DEPENDENCY
+
+public:
+    enum class JobType {
+        Geometry = 0,
+        Image,
+        KTX,
+        NumJobTypes
+    };
+
+    using Job = std::function<void()>;
+
+    ~LoaderScheduler();
+
+    void queueJob(JobType type, const QWeakPointer<Resource>& resource, Job job);
+
+    void setConcurrencyLimit(JobType type, int limit);
+    int getConcurrencyLimit(JobType type) const;
+
+    // For each job type: how many jobs are queued, running, completed and cancelled, and histograms of the time jobs
+    // spent queued and running.
+    QVariantMap getStats() const;
+
+    // histogram buckets are powers of two milliseconds: under 1ms, under 2ms ... under 1024ms, then everything slower
+    static const int NUM_HISTOGRAM_BUCKETS = 12;
+    static int getHistogramBucket(quint64 usecs);
+    static QString getJobTypeName(JobType type);
+
+private:
+    LoaderScheduler();
+
+    struct QueuedJob {
+        QWeakPointer<Resource> resource;
+        float priority;
+        uint64_t sequence;
+        quint64 queuedTime;
+        Job job;
+    };
+
+    using Histogram = std::array<uint64_t, NUM_HISTOGRAM_BUCKETS>;
+
+    struct JobQueue {
+        std::vector<QueuedJob> jobs; // a heap, highest priority first
+        int limit { 1 };
+        int running { 0 };
+        uint64_t completed { 0 };
+        uint64_t cancelled { 0 };
+        Histogram queueWaitTimes {};
+        Histogram runTimes {};
+    };
+
+    friend class LoaderJobRunner;
+
+    static bool isLowerPriority(const QueuedJob& a, const QueuedJob& b);
+
+    // on the scheduler's thread, while jobs are queued
+    void refreshPriorities();
+
+    // called with _mutex held
+    void dispatch();
+
+    // called on a loader thread
+    void runJob(JobType type, QueuedJob& job);
+
+    mutable std::mutex _mutex;
+    QThreadPool _threadPool;
+    std::array<JobQueue, (int)JobType::NumJobTypes> _queues;
+    int _running { 0 };
+    uint64_t _nextSequence { 0 };
+    QTimer _priorityRefreshTimer; // only started and stopped on the scheduler's thread
+};
+
+#endif // hifi_LoaderScheduler_h
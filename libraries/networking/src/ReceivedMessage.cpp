@@ -12,6 +12,8 @@
 
 #include "ReceivedMessage.h"
 
+#include <algorithm>
+
 #include "QSharedPointer"
 
 int receivedMessageMetaTypeId = qRegisterMetaType<ReceivedMessage*>("ReceivedMessage*");
@@ -21,39 +23,86 @@ static const int HEAD_DATA_SIZE = 512;
 
 ReceivedMessage::ReceivedMessage(const NLPacketList& packetList)
     : _data(packetList.getMessage()),
-      _headData(_data.mid(0, HEAD_DATA_SIZE)),
       _numPackets(packetList.getNumPackets()),
       _sourceID(packetList.getSourceID()),
+      _firstPacketReceiveTime(p_high_resolution_clock::now()),
       _packetType(packetList.getType()),
       _packetVersion(packetList.getVersion()),
       _senderSockAddr(packetList.getSenderSockAddr())
 {
+    appendSegment(_data.constData(), _data.size());
+    _headData = _data.mid(0, HEAD_DATA_SIZE);
+    _isFlattened = true;
 }
 
 ReceivedMessage::ReceivedMessage(NLPacket& packet)
     : _data(packet.readAll()),
-      _headData(_data.mid(0, HEAD_DATA_SIZE)),
       _numPackets(1),
       _sourceID(packet.getSourceID()),
+      _firstPacketReceiveTime(packet.getReceiveTime()),
       _packetType(packet.getType()),
       _packetVersion(packet.getVersion()),
       _senderSockAddr(packet.getSenderSockAddr()),
       _isComplete(packet.getPacketPosition() == NLPacket::ONLY)
 {
+    appendSegment(_data.constData(), _data.size());
+    _headData = _data.mid(0, HEAD_DATA_SIZE);
+    _isFlattened = true;
+
+    if (_firstPacketReceiveTime == p_high_resolution_clock::time_point()) {
+        // not from a socket
+        _firstPacketReceiveTime = p_high_resolution_clock::now();
+    }
+}
+
+ReceivedMessage::ReceivedMessage(std::unique_ptr<NLPacket> packet)
+    : _numPackets(1),
+      _sourceID(packet->getSourceID()),
+      _firstPacketReceiveTime(packet->getReceiveTime()),
+      _packetType(packet->getType()),
+      _packetVersion(packet->getVersion()),
+      _senderSockAddr(packet->getSenderSockAddr()),
+      _isComplete(packet->getPacketPosition() == NLPacket::ONLY)
+{
+    const char* payload = packet->getPayload() + packet->pos();
+    qint64 payloadSize = packet->bytesLeftToRead();
+
+    appendSegment(payload, payloadSize);
+    _headData = QByteArray(payload, std::min(payloadSize, (qint64)HEAD_DATA_SIZE));
+    _packets.push_back(std::move(packet));
+
+    if (_firstPacketReceiveTime == p_high_resolution_clock::time_point()) {
+        // not from a socket
+        _firstPacketReceiveTime = p_high_resolution_clock::now();
+    }
 }
 
 ReceivedMessage::ReceivedMessage(QByteArray byteArray, PacketType packetType, PacketVersion packetVersion,
                 const HifiSockAddr& senderSockAddr, QUuid sourceID) :
     _data(byteArray),
-    _headData(_data.mid(0, HEAD_DATA_SIZE)),
     _numPackets(1),
     _sourceID(sourceID),
+    _firstPacketReceiveTime(p_high_resolution_clock::now()),
     _packetType(packetType),
     _packetVersion(packetVersion),
     _senderSockAddr(senderSockAddr),
     _isComplete(true)
 {
+    appendSegment(_data.constData(), _data.size());
+    _headData = _data.mid(0, HEAD_DATA_SIZE);
+    _isFlattened = true;
+}
 
+QByteArray ReceivedMessage::getMessage() {
+    flatten();
+    return _data;
+}
+
+const char* ReceivedMessage::getRawMessage() {
+    if (_segments.size() > 1) {
+        flatten();
+    }
+    return _segments.empty() ? _data.constData() : _segments.front().data;
 }
 
 void ReceivedMessage::setFailed() {
@@ -62,7 +111,7 @@ void ReceivedMessage::setFailed() {
     emit completed();
 }
 
-void ReceivedMessage::appendPacket(NLPacket& packet) {
+void ReceivedMessage::appendPacket(std::unique_ptr<NLPacket> packet) {
     Q_ASSERT_X(!_isComplete, "ReceivedMessage::appendPacket", 
                "We should not be appending to a complete message");
 
@@ -71,27 +120,30 @@ void ReceivedMessage::appendPacket(NLPacket& packet) {
 
     ++_numPackets;
 
-    _data.append(packet.getPayload(), packet.getPayloadSize());
+    // keep the packet, its payload is the next segment of the message
+    appendSegment(packet->getPayload(), packet->getPayloadSize());
+    _isFlattened = _isFlattened && packet->getPayloadSize() == 0;
+    bool isLastPacket = packet->getPacketPosition() == NLPacket::PacketPosition::LAST;
+    _packets.push_back(std::move(packet));
 
     if (_numPackets % EMIT_PROGRESS_EVERY_X_PACKETS == 0) {
         emit progress(getSize());
     }
 
-    if (packet.getPacketPosition() == NLPacket::PacketPosition::LAST) {
+    if (isLastPacket) {
         _isComplete = true;
         emit completed();
     }
 }
 
 qint64 ReceivedMessage::peek(char* data, qint64 size) {
-    memcpy(data, _data.constData() + _position, size);
-    return size;
+    return copy(_position, data, size);
 }
 
 qint64 ReceivedMessage::read(char* data, qint64 size) {
-    memcpy(data, _data.constData() + _position, size);
-    _position += size;
-    return size;
+    auto copied = copy(_position, data, size);
+    _position += copied;
+    return copied;
 }
 
 qint64 ReceivedMessage::readHead(char* data, qint64 size) {
@@ -101,12 +153,23 @@ qint64 ReceivedMessage::readHead(char* data, qint64 size) {
 }
 
 QByteArray ReceivedMessage::peek(qint64 size) {
-    return _data.mid(_position, size);
+    if (size < 0 || size > getBytesLeftToRead()) {
+        size = getBytesLeftToRead();
+    }
+
+    if (_isFlattened) {
+        // stored contiguously, share it rather than copy it where possible
+        return _data.mid(_position, size);
+    }
+
+    QByteArray data(size, Qt::Uninitialized);
+    copy(_position, data.data(), size);
+    return data;
 }
 
 QByteArray ReceivedMessage::read(qint64 size) {
-    auto data = _data.mid(_position, size);
-    _position += size;
+    auto data = peek(size);
+    _position += data.size();
     return data;
 }
 
@@ -124,18 +187,117 @@ QString ReceivedMessage::readString() {
     uint32_t size;
     readPrimitive(&size);
     //Q_ASSERT(size <= _size - _position);
-    auto string = QString::fromUtf8(_data.constData() + _position, size);
-    _position += size;
-    return string;
+    if (!isContiguous(_position, size)) {
+        // decode a copy rather than flatten the whole message for one string
+        return QString::fromUtf8(read(size));
+    }
+    return QString::fromUtf8(readWithoutCopy(size));
 }
 
 QByteArray ReceivedMessage::readWithoutCopy(qint64 size) {
-    QByteArray data { QByteArray::fromRawData(_data.constData() + _position, size) };
+    if (!isContiguous(_position, size)) {
+        flatten();
+    }
+
+    const char* data = _data.constData();
+    if (!_segments.empty()) {
+        const auto& segment = _segments[segmentAt(_position)];
+        data = segment.data + (_position - segment.offset);
+    }
+
+    QByteArray byteArray { QByteArray::fromRawData(data, size) };
     _position += size;
-    return data;
+    return byteArray;
+}
+
+std::vector<QByteArray> ReceivedMessage::readViews(qint64 size) {
+    std::vector<QByteArray> views;
+    if (_segments.empty()) {
+        return views;
+    }
+
+    size = std::min(size, getBytesLeftToRead());
+
+    for (size_t i = segmentAt(_position); i < _segments.size() && size > 0; ++i) {
+        const auto& segment = _segments[i];
+        qint64 offset = _position - segment.offset;
+        qint64 length = std::min(segment.size - offset, size);
+
+        views.push_back(QByteArray::fromRawData(segment.data + offset, length));
+        _position += length;
+        size -= length;
+    }
+
+    return views;
 }
 
 void ReceivedMessage::onComplete() {
     _isComplete = true;
     emit completed();
 }
+
+void ReceivedMessage::appendSegment(const char* data, qint64 size) {
+    if (size <= 0) {
+        return;
+    }
+
+    _segments.push_back({ data, size, _size.load() });
+    _size += size;
+}
+
+void ReceivedMessage::flatten() {
+    if (_isFlattened) {
+        // already contiguous in _data
+        return;
+    }
+
+    // one copy into a buffer of exactly the right size
+    QByteArray data(_size, Qt::Uninitialized);
+    copy(0, data.data(), _size);
+
+    // what was read without copying points into the packets and any earlier copy, they go with the message
+    if (!_data.isEmpty()) {
+        _staleData.push_back(_data);
+    }
+
+    _data = data;
+    _segments.clear();
+    if (!_data.isEmpty()) {
+        _segments.push_back({ _data.constData(), _data.size(), 0 });
+    }
+    _isFlattened = true;
+}
+
+bool ReceivedMessage::isContiguous(qint64 position, qint64 size) const {
+    if (_segments.size() <= 1) {
+        return true;
+    }
+    const auto& segment = _segments[segmentAt(position)];
+    return position + size <= segment.offset + segment.size;
+}
+
+size_t ReceivedMessage::segmentAt(qint64 position) const {
+    // the last segment that starts at or before position
+    auto it = std::upper_bound(_segments.begin(), _segments.end(), position, [](qint64 position, const Segment& segment) {
+        return position < segment.offset;
+    });
+    return it == _segments.begin() ? 0 : (it - _segments.begin()) - 1;
+}
+
+qint64 ReceivedMessage::copy(qint64 position, char* data, qint64 size) const {
+    qint64 copied = 0;
+
+    for (size_t i = segmentAt(position); i < _segments.size() && copied < size; ++i) {
+        const auto& segment = _segments[i];
+        qint64 offset = position + copied - segment.offset;
+        qint64 length = std::min(segment.size - offset, size - copied);
+        if (length <= 0) {
+            break;
+        }
+
+        memcpy(data + copied, segment.data + offset, length);
+        copied += length;
+    }
+
+    return copied;
+}
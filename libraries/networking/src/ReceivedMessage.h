@@ -16,26 +16,35 @@
 #include <QObject>
 
 #include <atomic>
+#include <memory>
+#include <vector>
 
 #include "NLPacketList.h"
 
+// A message is kept as it arrived, a chain of packet payloads (segments), so reassembling a large reliable message
+// never copies or reallocates. Reads work across segments; the message is only flattened into one exactly sized buffer
+// if a consumer asks for it whole (getMessage, getRawMessage, or a readWithoutCopy that spans segments).
+// Flattening keeps the packets, so views handed out before it stay valid for the life of the message.
+// While a message is incomplete, only the thread appending to it may read past the head (see readHead).
 class ReceivedMessage : public QObject {
     Q_OBJECT
 public:
     ReceivedMessage(const NLPacketList& packetList);
     ReceivedMessage(NLPacket& packet);
+    // takes the packet, so the payload isn't copied
+    ReceivedMessage(std::unique_ptr<NLPacket> packet);
     ReceivedMessage(QByteArray byteArray, PacketType packetType, PacketVersion packetVersion,
                     const HifiSockAddr& senderSockAddr, QUuid sourceID = QUuid());
 
-    QByteArray getMessage() const { return _data; }
-    const char* getRawMessage() const { return _data.constData(); }
+    QByteArray getMessage();
+    const char* getRawMessage();
 
     PacketType getType() const { return _packetType; }
     PacketVersion getVersion() const { return _packetVersion; }
 
     void setFailed();
 
-    void appendPacket(NLPacket& packet);
+    void appendPacket(std::unique_ptr<NLPacket> packet);
 
     bool failed() const { return _failed; }
     bool isComplete() const { return _isComplete; }
@@ -48,9 +57,12 @@ public:
     // Get the number of packets that were used to send this message
     qint64 getNumPackets() const { return _numPackets; }
 
-    qint64 getSize() const { return _data.size(); }
+    qint64 getSize() const { return _size; }
 
-    qint64 getBytesLeftToRead() const { return _data.size() -  _position; }
+    // when the socket received the first packet of this message, for messages handled some time after that
+    p_high_resolution_clock::time_point getFirstPacketReceiveTime() const { return _firstPacketReceiveTime; }
+
+    qint64 getBytesLeftToRead() const { return _size -  _position; }
 
     void seek(qint64 position) { _position = position; }
 
@@ -74,6 +86,13 @@ public:
     // exceed that of the ReceivedMessage.
     QByteArray readWithoutCopy(qint64 size);
 
+    // Reads the next size bytes as views of the segments they span, without copying or flattening. For streaming
+    // a large message to a file or a hash. Like readWithoutCopy the views must not outlive the ReceivedMessage.
+    std::vector<QByteArray> readViews(qint64 size);
+
+    // Number of separately stored segments, 1 once flattened
+    size_t getNumSegments() const { return _segments.size(); }
+
     template<typename T> qint64 peekPrimitive(T* data);
     template<typename T> qint64 readPrimitive(T* data);
 
@@ -87,13 +106,32 @@ private slots:
     void onComplete();
 
 private:
-    QByteArray _data;
+    struct Segment {
+        const char* data;
+        qint64 size;
+        qint64 offset; // of the first byte, in the message
+    };
+
+    void appendSegment(const char* data, qint64 size);
+    void flatten();
+    bool isContiguous(qint64 position, qint64 size) const;
+    size_t segmentAt(qint64 position) const;
+    qint64 copy(qint64 position, char* data, qint64 size) const;
+
+    QByteArray _data; // storage for a message built from bytes, or once flattened
+    std::vector<QByteArray> _staleData; // earlier flattened copies, for a message appended to after flattening
+    std::vector<std::unique_ptr<NLPacket>> _packets; // storage for a message built from received packets
+    bool _isFlattened { false }; // all of the message is in _data
+    std::vector<Segment> _segments;
+    std::atomic<qint64> _size { 0 };
+
     QByteArray _headData;
 
     std::atomic<qint64> _position { 0 };
     std::atomic<qint64> _numPackets { 0 };
 
     QUuid _sourceID;
+    p_high_resolution_clock::time_point _firstPacketReceiveTime;
     PacketType _packetType;
     PacketVersion _packetVersion;
     HifiSockAddr _senderSockAddr;
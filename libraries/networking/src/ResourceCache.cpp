@@ -18,6 +18,7 @@
 #include <QThread>
 #include <QTimer>
 
+#include <NumericalConstants.h>
 #include <SharedUtil.h>
 #include <shared/QtHelpers.h>
 #include <Trace.h>
@@ -37,27 +38,34 @@ void ResourceCacheSharedItems::appendActiveRequest(QWeakPointer<Resource> resour
     _loadingRequests.append(resource);
 }
 
+// priorities of queued requests are refreshed a batch at a time, about once a frame
+static const quint64 PRIORITY_REFRESH_INTERVAL_USECS = 16 * USECS_PER_MSEC;
+static const int PRIORITY_REFRESH_BATCH_SIZE = 256;
+
 void ResourceCacheSharedItems::appendPendingRequest(QWeakPointer<Resource> resource) {
+    auto request = resource.lock();
+    if (!request) {
+        return;
+    }
+    float priority = request->getLoadPriority();
+    bool isFile = request->getURL().scheme() == URL_SCHEME_FILE;
+
     Lock lock(_mutex);
-    _pendingRequests.append(resource);
+    if (isFile) {
+        _pendingFileRequests.push(resource, priority);
+    } else {
+        _pendingNetworkRequests.push(resource, priority);
+    }
 }
 
 QList<QSharedPointer<Resource>> ResourceCacheSharedItems::getPendingRequests() {
-    QList<QSharedPointer<Resource>> result;
     Lock lock(_mutex);
-
-    foreach(QSharedPointer<Resource> resource, _pendingRequests) {
-        if (resource) {
-            result.append(resource);
-        }
-    }
-
-    return result;
+    return _pendingFileRequests.getResources() + _pendingNetworkRequests.getResources();
 }
 
 uint32_t ResourceCacheSharedItems::getPendingRequestsCount() const {
     Lock lock(_mutex);
-    return _pendingRequests.size();
+    return _pendingFileRequests.size() + _pendingNetworkRequests.size();
 }
 
 QList<QSharedPointer<Resource>> ResourceCacheSharedItems::getLoadingRequests() {
@@ -96,39 +104,20 @@ void ResourceCacheSharedItems::removeRequest(QWeakPointer<Resource> resource) {
 }
 
 QSharedPointer<Resource> ResourceCacheSharedItems::getHighestPendingRequest() {
-    // look for the highest priority pending request
-    int highestIndex = -1;
-    float highestPriority = -FLT_MAX;
-    QSharedPointer<Resource> highestResource;
     Lock lock(_mutex);
 
-    bool currentHighestIsFile = false;
-
-    for (int i = 0; i < _pendingRequests.size();) {
-        // Clear any freed resources
-        auto resource = _pendingRequests.at(i).lock();
-        if (!resource) {
-            _pendingRequests.removeAt(i);
-            continue;
-        }
-
-        // Check load priority
-        float priority = resource->getLoadPriority();
-        bool isFile = resource->getURL().scheme() == URL_SCHEME_FILE;
-        if (priority >= highestPriority && (isFile || !currentHighestIsFile)) {
-            highestPriority = priority;
-            highestIndex = i;
-            highestResource = resource;
-            currentHighestIsFile = isFile;
-        }
-        i++;
+    quint64 now = usecTimestampNow();
+    if (now - _lastPriorityRefresh > PRIORITY_REFRESH_INTERVAL_USECS) {
+        _pendingFileRequests.refreshPriorities(PRIORITY_REFRESH_BATCH_SIZE);
+        _pendingNetworkRequests.refreshPriorities(PRIORITY_REFRESH_BATCH_SIZE);
+        _lastPriorityRefresh = now;
     }
 
-    if (highestIndex >= 0) {
-        _pendingRequests.takeAt(highestIndex);
+    auto resource = _pendingFileRequests.pop();
+    if (!resource) {
+        resource = _pendingNetworkRequests.pop();
     }
-
-    return highestResource;
+    return resource;
 }
 
 ScriptableResource::ScriptableResource(const QUrl& url) :
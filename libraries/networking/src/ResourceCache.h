@@ -33,6 +33,7 @@
 #include <DependencyManager.h>
 
 #include "ResourceManager.h"
+#include "ResourceRequestQueue.h"
 
 Q_DECLARE_METATYPE(size_t)
 
@@ -79,7 +80,12 @@ private:
     ResourceCacheSharedItems() = default;
 
     mutable Mutex _mutex;
-    QList<QWeakPointer<Resource>> _pendingRequests;
+
+    // local files always load before anything from the network, so they get a queue of their own
+    ResourceRequestQueue _pendingFileRequests;
+    ResourceRequestQueue _pendingNetworkRequests;
+    quint64 _lastPriorityRefresh { 0 };
+
     QList<QWeakPointer<Resource>> _loadingRequests;
 };
 
@@ -0,0 +1,155 @@
+//
+//  ResourceRequestQueue.cpp
+//  libraries/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ResourceRequestQueue.h"
+
+#include "ResourceCache.h"
+
+void ResourceRequestQueue::push(const QWeakPointer<Resource>& resource, float priority) {
+    Resource* key = resource.data();
+    if (!key) {
+        return;
+    }
+
+    auto itr = _indices.find(key);
+    if (itr != _indices.end()) {
+        // also replaces the weak pointer, in case a freed resource's address has been reused
+        size_t index = itr.value();
+        _heap[index].resource = resource;
+        _heap[index].priority = priority;
+        _heap[index].sequence = _nextSequence++;
+        update(index);
+        return;
+    }
+
+    size_t index = _heap.size();
+    _heap.push_back(Entry { key, resource, priority, _nextSequence++ });
+    _indices.insert(key, index);
+    siftUp(index);
+}
+
+QSharedPointer<Resource> ResourceRequestQueue::pop() {
+    while (!_heap.empty()) {
+        auto resource = _heap.front().resource.lock();
+        if (!resource) {
+            // clear freed resources
+            removeAt(0);
+            continue;
+        }
+
+        // the cached priority may be stale, make sure this really is the highest before handing it out
+        float priority = resource->getLoadPriority();
+        if (priority != _heap.front().priority) {
+            _heap.front().priority = priority;
+            siftDown(0);
+            if (_heap.front().key != resource.data()) {
+                continue;
+            }
+        }
+
+        removeAt(0);
+        return resource;
+    }
+    return QSharedPointer<Resource>();
+}
+
+void ResourceRequestQueue::refreshPriorities(int count) {
+    for (int i = 0; i < count && !_heap.empty(); i++) {
+        if (_refreshIndex >= _heap.size()) {
+            _refreshIndex = 0;
+        }
+
+        // entries that move in the heap can be refreshed twice or skipped in one pass, that's fine for a cache
+        size_t index = _refreshIndex++;
+        auto resource = _heap[index].resource.lock();
+        if (!resource) {
+            removeAt(index);
+            continue;
+        }
+        float priority = resource->getLoadPriority();
+        if (priority != _heap[index].priority) {
+            _heap[index].priority = priority;
+            update(index);
+        }
+    }
+}
+
+QList<QSharedPointer<Resource>> ResourceRequestQueue::getResources() const {
+    QList<QSharedPointer<Resource>> result;
+    for (const auto& entry : _heap) {
+        auto resource = entry.resource.lock();
+        if (resource) {
+            result.append(resource);
+        }
+    }
+    return result;
+}
+
+bool ResourceRequestQueue::isHigher(const Entry& a, const Entry& b) const {
+    return a.priority > b.priority || (a.priority == b.priority && a.sequence > b.sequence);
+}
+
+void ResourceRequestQueue::set(size_t index, Entry&& entry) {
+    _indices[entry.key] = index;
+    _heap[index] = std::move(entry);
+}
+
+void ResourceRequestQueue::siftUp(size_t index) {
+    Entry entry = std::move(_heap[index]);
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (!isHigher(entry, _heap[parent])) {
+            break;
+        }
+        set(index, std::move(_heap[parent]));
+        index = parent;
+    }
+    set(index, std::move(entry));
+}
+
+void ResourceRequestQueue::siftDown(size_t index) {
+    Entry entry = std::move(_heap[index]);
+    size_t size = _heap.size();
+    while (true) {
+        size_t child = 2 * index + 1;
+        if (child >= size) {
+            break;
+        }
+        if (child + 1 < size && isHigher(_heap[child + 1], _heap[child])) {
+            child++;
+        }
+        if (!isHigher(_heap[child], entry)) {
+            break;
+        }
+        set(index, std::move(_heap[child]));
+        index = child;
+    }
+    set(index, std::move(entry));
+}
+
+void ResourceRequestQueue::update(size_t index) {
+    if (index > 0 && isHigher(_heap[index], _heap[(index - 1) / 2])) {
+        siftUp(index);
+    } else {
+        siftDown(index);
+    }
+}
+
+void ResourceRequestQueue::removeAt(size_t index) {
+    _indices.remove(_heap[index].key);
+    size_t last = _heap.size() - 1;
+    if (index != last) {
+        set(index, std::move(_heap[last]));
+        _heap.pop_back();
+        update(index);
+    } else {
+        _heap.pop_back();
+    }
+}
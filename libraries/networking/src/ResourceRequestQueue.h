@@ -0,0 +1,63 @@
+//
+//  ResourceRequestQueue.h
+//  libraries/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ResourceRequestQueue_h
+#define hifi_ResourceRequestQueue_h
+
+#include <stdint.h>
+#include <vector>
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QWeakPointer>
+
+class Resource;
+
+// Pending resource requests in a max-heap ordered by load priority.  Each resource's position in the heap is indexed, so
+// queuing a request again or changing its priority doesn't need a scan.  Priorities are cached: the top request is
+// re-checked before it is handed out, the rest only when refreshPriorities() gets to them.
+// Not thread safe, ResourceCacheSharedItems guards it with its mutex.
+class ResourceRequestQueue {
+public:
+    // Adds the request, or updates its priority if it is already queued.
+    void push(const QWeakPointer<Resource>& resource, float priority);
+
+    // Removes and returns the highest priority request that hasn't been freed, or null if there is none.
+    QSharedPointer<Resource> pop();
+
+    // Re-reads the load priority of up to count queued requests, carrying on from where the last call stopped.
+    void refreshPriorities(int count);
+
+    int size() const { return (int)_heap.size(); }
+    QList<QSharedPointer<Resource>> getResources() const;
+
+private:
+    struct Entry {
+        Resource* key; // QWeakPointer::data() is null once the resource is freed
+        QWeakPointer<Resource> resource;
+        float priority;
+        uint64_t sequence; // the most recently queued request wins ties
+    };
+
+    bool isHigher(const Entry& a, const Entry& b) const;
+    void set(size_t index, Entry&& entry);
+    void siftUp(size_t index);
+    void siftDown(size_t index);
+    void update(size_t index);
+    void removeAt(size_t index);
+
+    std::vector<Entry> _heap;
+    QHash<Resource*, size_t> _indices;
+    uint64_t _nextSequence { 0 };
+    size_t _refreshIndex { 0 };
+};
+
+#endif // hifi_ResourceRequestQueue_h
@@ -8,8 +8,18 @@
 
 #include "ResourceScriptingInterface.h"
 
+#include "LoaderScheduler.h"
 #include "ResourceManager.h"
 
 void ResourceScriptingInterface::overrideUrlPrefix(const QString& prefix, const QString& replacement) {
     DependencyManager::get<ResourceManager>()->setUrlPrefixOverride(prefix, replacement);
 }
+
+QVariantMap ResourceScriptingInterface::getLoaderStats() {
+    // only processes that decode resources (interface) run a LoaderScheduler, assignment client scripts see no stats
+    auto loaderScheduler = DependencyManager::get<LoaderScheduler>();
+    if (!loaderScheduler) {
+        return QVariantMap();
+    }
+    return loaderScheduler->getStats();
+}
@@ -14,6 +14,7 @@
 #define hifi_networking_ResourceScriptingInterface_h
 
 #include <QtCore/QObject>
+#include <QtCore/QVariantMap>
 
 #include <DependencyManager.h>
 
@@ -25,6 +26,10 @@ public:
     Q_INVOKABLE void restoreUrlPrefix(const QString& prefix) {
         overrideUrlPrefix(prefix, "");
     }
+
+    // Queue lengths, concurrency and timing histograms of the geometry, image and KTX loader jobs.
+    // Empty in processes without a LoaderScheduler, such as assignment clients.
+    Q_INVOKABLE QVariantMap getLoaderStats();
 };
 
 
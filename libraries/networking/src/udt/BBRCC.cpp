@@ -0,0 +1,364 @@
+//
+//  BBRCC.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BBRCC.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include <QtCore/QtGlobal>
+
+using namespace udt;
+using namespace std::chrono;
+
+static const double USECS_PER_SECOND = 1000000.0;
+
+// 2 / ln(2), the smallest gain that doubles the delivery rate every round trip during startup
+static const double HIGH_GAIN = 2.885;
+static const double DRAIN_GAIN = 1.0 / HIGH_GAIN;
+static const double PROBE_BANDWIDTH_WINDOW_GAIN = 2.0;
+
+// probe for more bandwidth for a round trip, drain whatever queue that built for a round trip, then cruise
+static const double PACING_GAIN_CYCLE[] = { 1.25, 0.75, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0 };
+static const int PACING_GAIN_CYCLE_LENGTH = sizeof(PACING_GAIN_CYCLE) / sizeof(PACING_GAIN_CYCLE[0]);
+
+static const int BANDWIDTH_FILTER_ROUNDS = 10;
+static const int64_t MIN_RTT_FILTER_USECS = 10 * 1000 * 1000;
+static const int64_t PROBE_RTT_USECS = 200 * 1000;
+
+// the pipe is full once three round trips in startup fail to grow the bandwidth estimate by a quarter
+static const double FULL_BANDWIDTH_GROWTH = 1.25;
+static const int FULL_BANDWIDTH_ROUNDS = 3;
+
+static const int INITIAL_CW_PACKETS = 10;
+static const int MIN_CW_PACKETS = 4;
+static const int CW_QUANTA_PACKETS = 3; // allowance for ACKs that are delayed or arrive in bursts
+
+BBRCC::BBRCC() :
+    _pacingGain(HIGH_GAIN),
+    _congestionWindowGain(HIGH_GAIN)
+{
+    _mss = udt::MAX_PACKET_SIZE_WITH_UDP_HEADER;
+    _congestionWindowSize = INITIAL_CW_PACKETS;
+
+    setAckInterval(1); // every ACK is a delivery rate and RTT sample
+
+    auto now = p_high_resolution_clock::now();
+    _deliveredTime = now;
+    _firstSentTime = now;
+    _minRTTTime = now;
+    _cycleStartTime = now;
+
+    // start from the initial window paced over the default RTT
+    _packetSendPeriod = std::numeric_limits<double>::max();
+    updatePacketSendPeriod();
+}
+
+bool BBRCC::onACK(SequenceNumber ack, p_high_resolution_clock::time_point receiveTime) {
+    if (ack <= _lastACK) {
+        return false;
+    }
+
+    int numAcked = seqlen(_lastACK + 1, ack);
+    _lastACK = ack;
+
+    _delivered += numAcked;
+    _deliveredTime = receiveTime;
+    _isRoundStart = false;
+
+    auto it = _sentPackets.find(ack);
+    if (it != _sentPackets.end()) {
+        const auto& packet = it->second;
+
+        // a round trip ends when a packet sent after the previous round ended is ACKed
+        if (packet.delivered >= _nextRoundDelivered) {
+            _nextRoundDelivered = _delivered;
+            ++_roundCount;
+            _isRoundStart = true;
+        }
+
+        // retransmitted packets are ambiguous, they don't make for RTT or rate samples
+        if (!packet.retransmitted) {
+            int rtt = std::max(1, (int)duration_cast<microseconds>(receiveTime - packet.sentTime).count());
+            updateMinRTT(rtt, receiveTime);
+
+            // the delivery rate over the longer of the send and ACK intervals, so that neither
+            // a burst of sends nor a compressed burst of ACKs can over-estimate it
+            auto sendElapsed = duration_cast<microseconds>(packet.sentTime - packet.firstSentTime).count();
+            auto ackElapsed = duration_cast<microseconds>(_deliveredTime - packet.deliveredTime).count();
+            auto interval = std::max(sendElapsed, ackElapsed);
+
+            _firstSentTime = packet.sentTime;
+
+            if (interval > 0 && interval >= _minRTT) {
+                updateBandwidth((double)(_delivered - packet.delivered) * USECS_PER_SECOND / interval);
+            }
+        }
+    }
+
+    // everything up to this ACK has been delivered
+    _sentPackets.erase(_sentPackets.begin(), _sentPackets.upper_bound(ack));
+
+    int inFlight = packetsInFlight();
+
+    if (_inRecovery && _delivered >= _recoveryEndDelivered) {
+        // a round trip has passed since the loss, restore the window the model asks for
+        _inRecovery = false;
+        _congestionWindowSize = std::max(_congestionWindowSize, _priorCongestionWindowSize);
+    }
+
+    checkFullPipe();
+    checkDrain(inFlight, receiveTime);
+    if (_mode == Mode::ProbeBandwidth) {
+        advanceCycle(inFlight, receiveTime);
+    }
+    checkProbeRTT(inFlight, receiveTime);
+
+    updatePacketSendPeriod();
+    updateCongestionWindow(numAcked, inFlight);
+
+    // losses are handled through NAKs, never a fast re-transmit
+    return false;
+}
+
+void BBRCC::onLoss(SequenceNumber rangeStart, SequenceNumber rangeEnd) {
+    _hadLossThisCycle = true;
+
+    if (!_inRecovery) {
+        // for the next round trip only send as packets leave the network (packet conservation),
+        // the bandwidth model itself doesn't react to loss
+        int inFlight = packetsInFlight();
+
+        _inRecovery = true;
+        _recoveryEndDelivered = _delivered + inFlight;
+        _priorCongestionWindowSize = _congestionWindowSize;
+        _congestionWindowSize = std::max(inFlight, MIN_CW_PACKETS);
+    }
+}
+
+void BBRCC::onTimeout() {
+    // nothing has been ACKed for a full timeout, restart from a minimal window but keep the model
+    if (!_inRecovery) {
+        _priorCongestionWindowSize = _congestionWindowSize;
+    }
+    _inRecovery = true;
+    _recoveryEndDelivered = _delivered + packetsInFlight();
+    _congestionWindowSize = MIN_CW_PACKETS;
+}
+
+void BBRCC::onPacketSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) {
+    if (seqNum <= _lastACK) {
+        return;
+    }
+
+    auto it = _sentPackets.find(seqNum);
+    if (it != _sentPackets.end()) {
+        it->second.retransmitted = true;
+        return;
+    }
+
+    if (_sentPackets.empty()) {
+        // nothing in flight, so the next rate sample starts now rather than at the last ACK
+        _firstSentTime = timePoint;
+        _deliveredTime = timePoint;
+    }
+
+    _sentPackets[seqNum] = { timePoint, _deliveredTime, _firstSentTime, _delivered, false };
+}
+
+void BBRCC::updateBandwidth(double rate) {
+    // sliding window max over the last BANDWIDTH_FILTER_ROUNDS round trips
+    while (!_bandwidthSamples.empty() && _bandwidthSamples.back().second <= rate) {
+        _bandwidthSamples.pop_back();
+    }
+    _bandwidthSamples.push_back({ _roundCount, rate });
+
+    while (_bandwidthSamples.front().first + BANDWIDTH_FILTER_ROUNDS <= _roundCount) {
+        _bandwidthSamples.pop_front();
+    }
+
+    _bottleneckBandwidth = _bandwidthSamples.front().second;
+}
+
+void BBRCC::updateMinRTT(int rtt, p_high_resolution_clock::time_point now) {
+    _isMinRTTExpired = duration_cast<microseconds>(now - _minRTTTime).count() > MIN_RTT_FILTER_USECS;
+
+    if (_minRTT < 0 || rtt <= _minRTT || _isMinRTTExpired) {
+        _minRTT = rtt;
+        _minRTTTime = now;
+    }
+}
+
+void BBRCC::checkFullPipe() {
+    if (_isPipeFull || !_isRoundStart) {
+        return;
+    }
+
+    if (_bottleneckBandwidth >= _fullBandwidth * FULL_BANDWIDTH_GROWTH) {
+        // still growing
+        _fullBandwidth = _bottleneckBandwidth;
+        _fullBandwidthRounds = 0;
+    } else if (++_fullBandwidthRounds >= FULL_BANDWIDTH_ROUNDS) {
+        _isPipeFull = true;
+    }
+}
+
+void BBRCC::checkDrain(int inFlight, p_high_resolution_clock::time_point now) {
+    if (_mode == Mode::Startup && _isPipeFull) {
+        _mode = Mode::Drain;
+        _pacingGain = DRAIN_GAIN;
+        _congestionWindowGain = HIGH_GAIN;
+    }
+
+    if (_mode == Mode::Drain && inFlight <= bdpPackets(1.0)) {
+        enterProbeBandwidth(now);
+    }
+}
+
+void BBRCC::enterProbeBandwidth(p_high_resolution_clock::time_point now) {
+    _mode = Mode::ProbeBandwidth;
+    _congestionWindowGain = PROBE_BANDWIDTH_WINDOW_GAIN;
+
+    // start at a random cruising phase, so that flows sharing a bottleneck don't probe in lock step
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::uniform_int_distribution<> distribution(2, PACING_GAIN_CYCLE_LENGTH - 1);
+
+    _cycleIndex = distribution(generator);
+    _pacingGain = PACING_GAIN_CYCLE[_cycleIndex];
+    _cycleStartTime = now;
+    _hadLossThisCycle = false;
+}
+
+void BBRCC::advanceCycle(int inFlight, p_high_resolution_clock::time_point now) {
+    bool isFullLength = duration_cast<microseconds>(now - _cycleStartTime).count() > minRTT();
+
+    bool shouldAdvance = isFullLength;
+    if (_pacingGain > 1.0) {
+        // keep probing until the extra data is actually in flight, or it caused loss
+        shouldAdvance = isFullLength && (_hadLossThisCycle || inFlight >= bdpPackets(_pacingGain));
+    } else if (_pacingGain < 1.0) {
+        // stop draining early once the queue is gone
+        shouldAdvance = isFullLength || inFlight <= bdpPackets(1.0);
+    }
+
+    if (shouldAdvance) {
+        _cycleIndex = (_cycleIndex + 1) % PACING_GAIN_CYCLE_LENGTH;
+        _pacingGain = PACING_GAIN_CYCLE[_cycleIndex];
+        _cycleStartTime = now;
+        _hadLossThisCycle = false;
+    }
+}
+
+void BBRCC::checkProbeRTT(int inFlight, p_high_resolution_clock::time_point now) {
+    if (_mode != Mode::ProbeRTT && _isMinRTTExpired) {
+        // the min RTT hasn't been seen in a while, drain the queue to re-measure it
+        _mode = Mode::ProbeRTT;
+        _pacingGain = 1.0;
+        _congestionWindowGain = 1.0;
+        _priorCongestionWindowSize = std::max(_priorCongestionWindowSize, _congestionWindowSize);
+        _hasProbeRTTDoneTime = false;
+    }
+
+    if (_mode != Mode::ProbeRTT) {
+        return;
+    }
+
+    if (!_hasProbeRTTDoneTime) {
+        if (inFlight <= MIN_CW_PACKETS) {
+            // hold the small window for PROBE_RTT_USECS and at least a round trip
+            _probeRTTDoneTime = now + microseconds(PROBE_RTT_USECS);
+            _hasProbeRTTDoneTime = true;
+            _probeRTTRoundDone = false;
+            _nextRoundDelivered = _delivered;
+        }
+    } else {
+        if (_isRoundStart) {
+            _probeRTTRoundDone = true;
+        }
+
+        if (_probeRTTRoundDone && now >= _probeRTTDoneTime) {
+            _minRTTTime = now;
+            _isMinRTTExpired = false;
+            _congestionWindowSize = std::max(_congestionWindowSize, _priorCongestionWindowSize);
+
+            if (_isPipeFull) {
+                enterProbeBandwidth(now);
+            } else {
+                _mode = Mode::Startup;
+                _pacingGain = HIGH_GAIN;
+                _congestionWindowGain = HIGH_GAIN;
+            }
+        }
+    }
+}
+
+void BBRCC::updateCongestionWindow(int numAcked, int inFlight) {
+    if (_mode == Mode::ProbeRTT) {
+        _congestionWindowSize = std::min(_congestionWindowSize, MIN_CW_PACKETS);
+    } else if (_inRecovery) {
+        // packet conservation, one packet out for every packet ACKed
+        _congestionWindowSize = std::max(_congestionWindowSize, inFlight + numAcked);
+    } else {
+        int targetWindowSize = bdpPackets(_congestionWindowGain) + CW_QUANTA_PACKETS;
+
+        if (_isPipeFull) {
+            _congestionWindowSize = std::min(_congestionWindowSize + numAcked, targetWindowSize);
+        } else if (_congestionWindowSize < targetWindowSize || _delivered < INITIAL_CW_PACKETS) {
+            // grow with every ACK while searching for the bandwidth
+            _congestionWindowSize += numAcked;
+        }
+    }
+
+    if (_congestionWindowSize < MIN_CW_PACKETS) {
+        _congestionWindowSize = MIN_CW_PACKETS;
+    } else if (_congestionWindowSize > udt::MAX_PACKETS_IN_FLIGHT) {
+        _congestionWindowSize = udt::MAX_PACKETS_IN_FLIGHT;
+    }
+}
+
+void BBRCC::updatePacketSendPeriod() {
+    double packetsPerSecond;
+    if (_bottleneckBandwidth > 0.0) {
+        packetsPerSecond = _pacingGain * _bottleneckBandwidth;
+    } else {
+        // no delivery rate yet, pace the initial window over the RTT
+        packetsPerSecond = HIGH_GAIN * INITIAL_CW_PACKETS * USECS_PER_SECOND / minRTT();
+    }
+
+    double packetSendPeriod = USECS_PER_SECOND / packetsPerSecond;
+
+    // until the pipe is full, never slow down on a low sample
+    if (_isPipeFull || packetSendPeriod < _packetSendPeriod) {
+        setPacketSendPeriod(packetSendPeriod);
+    }
+}
+
+int BBRCC::packetsInFlight() const {
+    return std::max(0, seqoff(_lastACK, _sendCurrSeqNum));
+}
+
+int BBRCC::bdpPackets(double gain) const {
+    if (_bottleneckBandwidth <= 0.0) {
+        return INITIAL_CW_PACKETS;
+    }
+    return (int)ceil(gain * _bottleneckBandwidth * minRTT() / USECS_PER_SECOND);
+}
+
+int BBRCC::minRTT() const {
+    if (_minRTT > 0) {
+        return _minRTT;
+    } else if (_rtt > 0) {
+        return _rtt;
+    } else {
+        return DEFAULT_SYN_INTERVAL * 10;
+    }
+}
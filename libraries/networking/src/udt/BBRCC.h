@@ -0,0 +1,120 @@
+//
+//  BBRCC.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_BBRCC_h
+#define hifi_BBRCC_h
+
+#include <deque>
+#include <map>
+
+#include "CongestionControl.h"
+#include "Constants.h"
+
+namespace udt {
+
+// Model based congestion control, after BBR (https://queue.acm.org/detail.cfm?id=3022184)
+// Rather than reacting to loss (DefaultCC) or to queueing delay alone (TCPVegasCC), this keeps an estimate of the
+// bottleneck bandwidth (windowed max of delivery rate samples) and of the propagation delay (windowed min RTT),
+// paces at that bandwidth and keeps about one bandwidth-delay product in flight, cycling the pacing gain to probe for more.
+class BBRCC : public CongestionControl {
+public:
+    BBRCC();
+
+    virtual bool onACK(SequenceNumber ackNum, p_high_resolution_clock::time_point receiveTime) override;
+    virtual void onLoss(SequenceNumber rangeStart, SequenceNumber rangeEnd) override;
+    virtual void onTimeout() override;
+
+    // the model doesn't need the ACK2 RTT or probe pairs, but losses should be reported as soon as they're seen
+    virtual bool shouldNAK() override { return true; }
+    virtual bool shouldACK2() override { return false; }
+    virtual bool shouldProbe() override { return false; }
+
+    virtual void onPacketSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) override;
+
+protected:
+    virtual void setInitialSendSequenceNumber(SequenceNumber seqNum) override { _lastACK = seqNum - 1; }
+
+private:
+    enum class Mode {
+        Startup, // exponential search for the bottleneck bandwidth
+        Drain, // drain the queue startup built
+        ProbeBandwidth, // cruise at the estimated bandwidth, cycling the pacing gain
+        ProbeRTT // briefly drop the window to re-measure the propagation delay
+    };
+
+    // delivery state when a packet was sent, for a delivery rate sample when it is ACKed
+    struct SentPacket {
+        p_high_resolution_clock::time_point sentTime;
+        p_high_resolution_clock::time_point deliveredTime;
+        p_high_resolution_clock::time_point firstSentTime;
+        int64_t delivered;
+        bool retransmitted;
+    };
+
+    void updateBandwidth(double rate);
+    void updateMinRTT(int rtt, p_high_resolution_clock::time_point now);
+    void checkFullPipe();
+    void checkDrain(int inFlight, p_high_resolution_clock::time_point now);
+    void advanceCycle(int inFlight, p_high_resolution_clock::time_point now);
+    void checkProbeRTT(int inFlight, p_high_resolution_clock::time_point now);
+    void enterProbeBandwidth(p_high_resolution_clock::time_point now);
+    void updateCongestionWindow(int numAcked, int inFlight);
+    void updatePacketSendPeriod();
+
+    int packetsInFlight() const;
+    int bdpPackets(double gain) const;
+    int minRTT() const;
+
+    using SentPacketList = std::map<SequenceNumber, SentPacket>;
+    SentPacketList _sentPackets;
+
+    Mode _mode { Mode::Startup };
+    double _pacingGain;
+    double _congestionWindowGain;
+
+    SequenceNumber _lastACK; // last ACKed sequence number
+
+    int64_t _delivered { 0 }; // packets delivered so far
+    p_high_resolution_clock::time_point _deliveredTime; // when _delivered was last updated
+    p_high_resolution_clock::time_point _firstSentTime; // send time of the packet that started the current sample
+
+    int64_t _nextRoundDelivered { 0 }; // _delivered at which the current round trip ends
+    int64_t _roundCount { 0 };
+    bool _isRoundStart { false };
+
+    std::deque<std::pair<int64_t, double>> _bandwidthSamples; // (round, packets per second), decreasing max filter
+    double _bottleneckBandwidth { 0.0 }; // estimated bottleneck bandwidth, packets per second
+
+    int _minRTT { -1 }; // estimated propagation delay, microseconds
+    p_high_resolution_clock::time_point _minRTTTime;
+    bool _isMinRTTExpired { false };
+
+    bool _isPipeFull { false };
+    double _fullBandwidth { 0.0 };
+    int _fullBandwidthRounds { 0 };
+
+    int _cycleIndex { 0 };
+    p_high_resolution_clock::time_point _cycleStartTime;
+
+    bool _probeRTTRoundDone { false };
+    p_high_resolution_clock::time_point _probeRTTDoneTime;
+    bool _hasProbeRTTDoneTime { false };
+
+    bool _inRecovery { false }; // packet conservation for a round trip after loss
+    int64_t _recoveryEndDelivered { 0 };
+    int _priorCongestionWindowSize { 0 };
+    bool _hadLossThisCycle { false };
+};
+
+}
+
+#endif // hifi_BBRCC_h
@@ -94,6 +94,7 @@ BasePacket& BasePacket::operator=(const BasePacket& other) {
     _payloadSize = other._payloadSize;
     
     _senderSockAddr = other._senderSockAddr;
+    _receiveTime = other._receiveTime;
     
     if (other.isOpen() && !isOpen()) {
         open(other.openMode());
@@ -118,6 +119,7 @@ BasePacket& BasePacket::operator=(BasePacket&& other) {
     _payloadSize = other._payloadSize;
     
     _senderSockAddr = std::move(other._senderSockAddr);
+    _receiveTime = other._receiveTime;
     
     if (other.isOpen() && !isOpen()) {
         open(other.openMode());
@@ -16,6 +16,8 @@
 #include <memory>
 #include <vector>
 
+#include <QtCore/QString>
+
 #include <PortableHighResolutionClock.h>
 
 #include "LossList.h"
@@ -98,6 +100,9 @@ public:
     static int synInterval() { return DEFAULT_SYN_INTERVAL; }
     
     virtual std::unique_ptr<CongestionControl> create() = 0;
+
+    // factory for one of the built-in controllers ("default", "vegas" or "bbr"), nullptr for an unknown name
+    static std::unique_ptr<CongestionControlVirtualFactory> forName(const QString& name);
 };
 
 template <class T> class CongestionControlFactory: public CongestionControlVirtualFactory {
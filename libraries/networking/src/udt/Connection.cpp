@@ -340,11 +340,8 @@ void Connection::sendACK(bool wasCausedBySyncTimeout) {
     // have the socket send off our packet
     _parentSocket->writeBasePacket(*_ackPacket, _destination);
     
-    Q_ASSERT_X(_sentACKs.empty() || _sentACKs.back().first + 1 == _currentACKSubSequenceNumber,
-               "Connection::sendACK", "Adding an invalid ACK to _sentACKs");
-    
-    // write this ACK to the map of sent ACKs
-    _sentACKs.push_back({ _currentACKSubSequenceNumber, { nextACKNumber, p_high_resolution_clock::now() }});
+    // write this ACK to the window of sent ACKs, the oldest drop out if ACK2s stop coming back
+    _sentACKs.insert(_currentACKSubSequenceNumber, { nextACKNumber, p_high_resolution_clock::now() });
     
     // reset the number of data packets received since last ACK
     _packetsSinceACK = 0;
@@ -458,6 +455,14 @@ bool Connection::processReceivedSequenceNumber(SequenceNumber sequenceNumber, in
         return false;
     }
     
+    if (seqoff(_lastReceivedSequenceNumber, sequenceNumber) > MAX_PACKETS_IN_FLIGHT) {
+        // further ahead than the flow window we advertise lets an honest sender get, the gap would all go into
+        // the loss list
+        qCDebug(networking) << "Dropping packet" << (uint32_t)sequenceNumber << "too far ahead of the last received"
+            << (uint32_t)_lastReceivedSequenceNumber;
+        return false;
+    }
+
     _isReceivingData = true;
     
     // mark our last receive time as now (to push the potential expiry farther)
@@ -732,37 +737,31 @@ void Connection::processACK2(ControlPacketPointer controlPacket) {
     SequenceNumber subSequenceNumber;
     controlPacket->readPrimitive(&subSequenceNumber);
 
-    // check if we had that subsequence number in our map
-    auto it = std::find_if_not(_sentACKs.begin(), _sentACKs.end(), [&subSequenceNumber](const ACKListPair& pair){
-        return pair.first < subSequenceNumber;
-    });
+    // check if we had that subsequence number in our window
+    auto sentACK = _sentACKs.find(subSequenceNumber);
     
-    if (it != _sentACKs.end()) {
-        if (it->first == subSequenceNumber){
-            // update the RTT using the ACK window
-            
-            // calculate the RTT (time now - time ACK sent)
-            auto now = p_high_resolution_clock::now();
-            int rtt = duration_cast<microseconds>(now - it->second.second).count();
-            
-            updateRTT(rtt);
-            // write this RTT to stats
-            _stats.recordRTT(rtt);
-            
-            // set the RTT for congestion control
-            _congestionControl->setRTT(_rtt);
-            
-            // update the last ACKed ACK
-            if (it->second.first > _lastReceivedAcknowledgedACK) {
-                _lastReceivedAcknowledgedACK = it->second.first;
-            }
-        } else if (it->first < subSequenceNumber) {
-            Q_UNREACHABLE();
+    if (sentACK) {
+        // update the RTT using the ACK window
+        
+        // calculate the RTT (time now - time ACK sent)
+        auto now = p_high_resolution_clock::now();
+        int rtt = duration_cast<microseconds>(now - sentACK->second).count();
+        
+        updateRTT(rtt);
+        // write this RTT to stats
+        _stats.recordRTT(rtt);
+        
+        // set the RTT for congestion control
+        _congestionControl->setRTT(_rtt);
+        
+        // update the last ACKed ACK
+        if (sentACK->first > _lastReceivedAcknowledgedACK) {
+            _lastReceivedAcknowledgedACK = sentACK->first;
         }
     }
     
     // erase this sub-sequence number and anything below it now that we've gotten our timing information
-    _sentACKs.erase(_sentACKs.begin(), it);
+    _sentACKs.eraseUpTo(subSequenceNumber);
     
     _stats.record(ConnectionStats::Stats::ReceivedACK2);
 }
@@ -953,29 +952,42 @@ void PendingReceivedMessage::enqueuePacket(std::unique_ptr<Packet> packet) {
                "PendingReceivedMessage::enqueuePacket",
                "called with a packet that is not part of a message");
     
+    // Place it by part number, packets that arrive out of order leave gaps for the ones before them
+    auto messagePartNumber = packet->getMessagePartNumber();
+    if (messagePartNumber < _nextPartNumber) {
+        qCDebug(networking) << "PendingReceivedMessage::enqueuePacket: This is a duplicate packet";
+        return;
+    }
+
+    // the sender can't get further ahead of the part we are missing than its flow window,
+    // anything past that is bogus and would have us allocate a gap of up to 4 billion parts
+    auto index = messagePartNumber - _nextPartNumber;
+    if (index >= (decltype(index))MAX_PACKETS_IN_FLIGHT) {
+        qCDebug(networking) << "PendingReceivedMessage::enqueuePacket: Dropping part" << messagePartNumber
+            << "that is too far ahead of part" << _nextPartNumber;
+        return;
+    }
+
     if (packet->getPacketPosition() == Packet::PacketPosition::LAST ||
         packet->getPacketPosition() == Packet::PacketPosition::ONLY) {
         _hasLastPacket = true;
-        _numPackets = packet->getMessagePartNumber() + 1;
+        _numPackets = messagePartNumber + 1;
     }
 
-    // Insert into the packets list in sorted order. Because we generally expect to receive packets in order, begin
-    // searching from the end of the list.
-    auto messagePartNumber = packet->getMessagePartNumber();
-    auto it = std::find_if(_packets.rbegin(), _packets.rend(),
-        [&](const std::unique_ptr<Packet>& value) { return messagePartNumber >= value->getMessagePartNumber(); });
+    if (index >= _packets.size()) {
+        _packets.resize(index + 1);
+    }
 
-    if (it != _packets.rend() && ((*it)->getMessagePartNumber() == messagePartNumber)) {
+    if (_packets[index]) {
         qCDebug(networking) << "PendingReceivedMessage::enqueuePacket: This is a duplicate packet";
         return;
     }
     
-    _packets.insert(it.base(), std::move(packet));
+    _packets[index] = std::move(packet);
 }
 
 bool PendingReceivedMessage::hasAvailablePackets() const {
-    return _packets.size() > 0
-        && _nextPartNumber == _packets.front()->getMessagePartNumber();
+    return _packets.size() > 0 && _packets.front();
 }
 
 std::unique_ptr<Packet> PendingReceivedMessage::removeNextPacket() {
@@ -12,7 +12,7 @@
 #ifndef hifi_Connection_h
 #define hifi_Connection_h
 
-#include <list>
+#include <deque>
 #include <memory>
 
 #include <QtCore/QObject>
@@ -24,6 +24,7 @@
 #include "LossList.h"
 #include "PacketTimeWindow.h"
 #include "SendQueue.h"
+#include "SequenceRingBuffer.h"
 #include "../HifiSockAddr.h"
 
 namespace udt {
@@ -37,11 +38,12 @@ class Socket;
 class PendingReceivedMessage {
 public:
     void enqueuePacket(std::unique_ptr<Packet> packet);
-    bool isComplete() const { return _hasLastPacket && _numPackets == _packets.size(); }
+    bool isComplete() const { return _hasLastPacket && _nextPartNumber == _numPackets; }
     bool hasAvailablePackets() const;
     std::unique_ptr<Packet> removeNextPacket();
     
-    std::list<std::unique_ptr<Packet>> _packets;
+    // indexed by message part number, starting from _nextPartNumber; parts that haven't arrived yet are null
+    std::deque<std::unique_ptr<Packet>> _packets;
 
 private:
     bool _hasLastPacket { false };
@@ -53,8 +55,7 @@ class Connection : public QObject {
     Q_OBJECT
 public:
     using SequenceNumberTimePair = std::pair<SequenceNumber, p_high_resolution_clock::time_point>;
-    using ACKListPair = std::pair<SequenceNumber, SequenceNumberTimePair>;
-    using SentACKList = std::list<ACKListPair>;
+    using SentACKList = SequenceRingBuffer<SequenceNumberTimePair>;
     using ControlPacketPointer = std::unique_ptr<ControlPacket>;
     
     Connection(Socket* parentSocket, HifiSockAddr destination, std::unique_ptr<CongestionControl> congestionControl);
@@ -161,7 +162,7 @@ private:
     int _bandwidth { 1 }; // Exponential moving average for estimated bandwidth, in packets per second
     int _deliveryRate { 16 }; // Exponential moving average for receiver's receive rate, in packets per second
     
-    SentACKList _sentACKs; // Map of ACK sub-sequence numbers to ACKed sequence number and sent time
+    SentACKList _sentACKs { MAX_SENT_ACKS }; // ACKed sequence number and sent time, by ACK sub-sequence number
     
     Socket* _parentSocket { nullptr };
     HifiSockAddr _destination;
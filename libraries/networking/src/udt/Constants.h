@@ -22,6 +22,7 @@ namespace udt {
     static const int MAX_PACKET_SIZE_WITH_UDP_HEADER = 1492;
     static const int MAX_PACKET_SIZE = MAX_PACKET_SIZE_WITH_UDP_HEADER - UDP_IPV4_HEADER_SIZE;
     static const int MAX_PACKETS_IN_FLIGHT = 25600;
+    static const int MAX_SENT_ACKS = 1024; // ACKs kept waiting for an ACK2, for RTT samples
     static const int CONNECTION_RECEIVE_BUFFER_SIZE_PACKETS = 8192;
     static const int CONNECTION_SEND_BUFFER_SIZE_PACKETS = 8192;
     static const int UDP_SEND_BUFFER_SIZE_BYTES = 1048576;
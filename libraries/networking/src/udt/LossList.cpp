@@ -11,154 +11,142 @@
 
 #include "LossList.h"
 
+#include <algorithm>
+#include <bitset>
+
 #include "ControlPacket.h"
 
 using namespace udt;
 using namespace std;
 
+static const int MIN_CAPACITY_WORDS = 4;
+static const uint64_t ALL_BITS = ~uint64_t(0);
+
+// bits first through last (inclusive) of a word
+static uint64_t maskForBits(int first, int last) {
+    uint64_t upTo = (last == 63) ? ALL_BITS : (uint64_t(1) << (last + 1)) - 1;
+    return upTo & ~((uint64_t(1) << first) - 1);
+}
+
+static int countBits(uint64_t word) {
+    return (int)bitset<64>(word).count();
+}
+
+static int lowestBit(uint64_t word) {
+    int bit = 0;
+    while (!(word & 1)) {
+        word >>= 1;
+        ++bit;
+    }
+    return bit;
+}
+
+static int highestBit(uint64_t word) {
+    int bit = 63;
+    while (!(word >> bit)) {
+        --bit;
+    }
+    return bit;
+}
+
+void LossList::clear() {
+    fill(_words.begin(), _words.end(), 0);
+    _head = 0;
+    _numWords = 0;
+    _length = 0;
+}
+
 void LossList::append(SequenceNumber seq) {
-    Q_ASSERT_X(_lossList.empty() || (_lossList.back().second < seq), "LossList::append(SequenceNumber)",
+    Q_ASSERT_X(isEmpty() || (getLastSequenceNumber() < seq), "LossList::append(SequenceNumber)",
                "SequenceNumber appended is not greater than the last SequenceNumber in the list");
     
-    if (getLength() > 0 && _lossList.back().second + 1 == seq) {
-        ++_lossList.back().second;
-    } else {
-        _lossList.push_back(make_pair(seq, seq));
-    }
-    _length += 1;
+    set(seq, seq);
 }
 
 void LossList::append(SequenceNumber start, SequenceNumber end) {
-    Q_ASSERT_X(_lossList.empty() || (_lossList.back().second < start),
+    Q_ASSERT_X(isEmpty() || (getLastSequenceNumber() < start),
                "LossList::append(SequenceNumber, SequenceNumber)",
                "SequenceNumber range appended is not greater than the last SequenceNumber in the list");
     Q_ASSERT_X(start <= end,
                "LossList::append(SequenceNumber, SequenceNumber)", "Range start greater than range end");
 
-    if (getLength() > 0 && _lossList.back().second + 1 == start) {
-        _lossList.back().second = end;
-    } else {
-        _lossList.push_back(make_pair(start, end));
-    }
-    _length += seqlen(start, end);
+    set(start, end);
 }
 
 void LossList::insert(SequenceNumber start, SequenceNumber end) {
     Q_ASSERT_X(start <= end,
                "LossList::insert(SequenceNumber, SequenceNumber)", "Range start greater than range end");
     
-    auto it = find_if_not(_lossList.begin(), _lossList.end(), [&start](pair<SequenceNumber, SequenceNumber> pair){
-        return pair.second < start;
-    });
-    
-    if (it == _lossList.end() || end < it->first) {
-        // No overlap, simply insert
-        _length += seqlen(start, end);
-        _lossList.insert(it, make_pair(start, end));
-    } else {
-        // If it starts before segment, extend segment
-        if (start < it->first) {
-            _length += seqlen(start, it->first - 1);
-            it->first = start;
-        }
-        
-        // If it ends after segment, extend segment
-        if (end > it->second) {
-            _length += seqlen(it->second + 1, end);
-            it->second = end;
-        }
-        
-        auto it2 = it;
-        ++it2;
-        // For all ranges touching the current range
-        while (it2 != _lossList.end() && it->second >= it2->first - 1) {
-            // extend current range if necessary
-            if (it->second < it2->second) {
-                _length += seqlen(it->second + 1, it2->second);
-                it->second = it2->second;
-            }
-            
-            // Remove overlapping range
-            _length -= seqlen(it2->first, it2->second);
-            it2 = _lossList.erase(it2);
-        }
+    set(start, end);
+}
+
+void LossList::insertWithin(SequenceNumber start, SequenceNumber end, SequenceNumber first, SequenceNumber last) {
+    // the peer's ranges aren't trusted to be in order or inside the window, and set() grows the ring to cover them
+    if (end < start || end < first || last < start) {
+        return;
     }
+
+    set(start < first ? first : start, last < end ? last : end);
 }
 
 bool LossList::remove(SequenceNumber seq) {
-    auto it = find_if(_lossList.begin(), _lossList.end(), [&seq](pair<SequenceNumber, SequenceNumber> pair) {
-        return pair.first <= seq && seq <= pair.second;
-    });
-    
-    if (it != end(_lossList)) {
-        if (it->first == it->second) {
-            _lossList.erase(it);
-        } else if (seq == it->first) {
-            ++it->first;
-        } else if (seq == it->second) {
-            --it->second;
-        } else {
-            auto temp = it->second;
-            it->second = seq - 1;
-            _lossList.insert(++it, make_pair(seq + 1, temp));
-        }
-        _length -= 1;
-        
-        // this sequence number was found in the loss list, return true
-        return true;
-    } else {
+    if (isEmpty()) {
+        return false;
+    }
+
+    int offset = seqoff(_base, seq);
+    if (offset < 0 || offset >= _numWords * BITS_PER_WORD) {
         // this sequence number was not found in the loss list, return false
         return false;
     }
+
+    auto& word = wordAt(offset / BITS_PER_WORD);
+    Word bit = Word(1) << (offset % BITS_PER_WORD);
+    if (!(word & bit)) {
+        return false;
+    }
+
+    word &= ~bit;
+    _length -= 1;
+    trim();
+
+    // this sequence number was found in the loss list, return true
+    return true;
 }
 
 void LossList::remove(SequenceNumber start, SequenceNumber end) {
     Q_ASSERT_X(start <= end,
                "LossList::remove(SequenceNumber, SequenceNumber)", "Range start greater than range end");
-    // Find the first segment sharing sequence numbers
-    auto it = find_if(_lossList.begin(), _lossList.end(), [&start, &end](pair<SequenceNumber, SequenceNumber> pair) {
-        return (pair.first <= start && start <= pair.second) || (start <= pair.first && pair.first <= end);
-    });
-    
-    // If we found one
-    if (it != _lossList.end()) {
-        
-        // While the end of the current segment is contained, either shorten it (first one only - sometimes)
-        // or remove it altogether since it is fully contained it the range
-        while (it != _lossList.end() && end >= it->second) {
-            if (start <= it->first) {
-                // Segment is contained, update new length and erase it.
-                _length -= seqlen(it->first, it->second);
-                it = _lossList.erase(it);
-            } else {
-                // Beginning of segment not contained, modify end of segment.
-                // Will only occur sometimes one the first loop
-                _length -= seqlen(start, it->second);
-                it->second = start - 1;
-                ++it;
-            }
-        }
-        
-        // There might be more to remove
-        if (it != _lossList.end() && it->first <= end) {
-            if (start <= it->first) {
-                // Truncate beginning of segment
-                _length -= seqlen(it->first, end);
-                it->first = end + 1;
-            } else {
-                // Cut it in half if the range we are removing is contained within one segment
-                _length -= seqlen(start, end);
-                auto temp = it->second;
-                it->second = start - 1;
-                _lossList.insert(++it, make_pair(end + 1, temp));
-            }
-        }
+
+    if (isEmpty() || end < start) {
+        return;
+    }
+
+    // only the part of the range that overlaps the words in use can have anything to remove
+    int first = max(seqoff(_base, start), 0);
+    int last = min(seqoff(_base, end), _numWords * BITS_PER_WORD - 1);
+
+    for (int index = first / BITS_PER_WORD; index <= last / BITS_PER_WORD && first <= last; ++index) {
+        int firstBit = (index == first / BITS_PER_WORD) ? first % BITS_PER_WORD : 0;
+        int lastBit = (index == last / BITS_PER_WORD) ? last % BITS_PER_WORD : BITS_PER_WORD - 1;
+
+        auto& word = wordAt(index);
+        auto mask = maskForBits(firstBit, lastBit);
+        _length -= countBits(word & mask);
+        word &= ~mask;
     }
+
+    trim();
 }
 
 SequenceNumber LossList::getFirstSequenceNumber() const {
     Q_ASSERT_X(getLength() > 0, "LossList::getFirstSequenceNumber()", "Trying to get first element of an empty list");
-    return _lossList.front().first;
+    return _base + lowestBit(wordAt(0));
+}
+
+SequenceNumber LossList::getLastSequenceNumber() const {
+    Q_ASSERT_X(getLength() > 0, "LossList::getLastSequenceNumber()", "Trying to get last element of an empty list");
+    return _base + (_numWords - 1) * BITS_PER_WORD + highestBit(wordAt(_numWords - 1));
 }
 
 SequenceNumber LossList::popFirstSequenceNumber() {
@@ -169,16 +157,114 @@ SequenceNumber LossList::popFirstSequenceNumber() {
 
 void LossList::write(ControlPacket& packet, int maxPairs) {
     int writtenPairs = 0;
-    
-    for (const auto& pair : _lossList) {
-        packet.writePrimitive(pair.first);
-        packet.writePrimitive(pair.second);
-        
+    int rangeStart = -1;
+
+    auto writeRange = [&](int first, int last) {
+        packet.writePrimitive(_base + first);
+        packet.writePrimitive(_base + last);
         ++writtenPairs;
-        
-        // check if we've written the maximum number we were told to write
-        if (maxPairs != -1 && writtenPairs >= maxPairs) {
-            break;
+    };
+    
+    for (int index = 0; index < _numWords; ++index) {
+        auto word = wordAt(index);
+
+        // whole words inside or outside of a range don't need looking at bit by bit
+        if ((rangeStart == -1 && word == 0) || (rangeStart != -1 && word == ALL_BITS)) {
+            continue;
         }
+
+        for (int bit = 0; bit < BITS_PER_WORD; ++bit) {
+            int offset = index * BITS_PER_WORD + bit;
+            bool isMissing = (word >> bit) & 1;
+
+            if (isMissing && rangeStart == -1) {
+                rangeStart = offset;
+            } else if (!isMissing && rangeStart != -1) {
+                writeRange(rangeStart, offset - 1);
+                rangeStart = -1;
+
+                // check if we've written the maximum number we were told to write
+                if (maxPairs != -1 && writtenPairs >= maxPairs) {
+                    return;
+                }
+            }
+        }
+    }
+
+    if (rangeStart != -1) {
+        writeRange(rangeStart, _numWords * BITS_PER_WORD - 1);
+    }
+}
+
+void LossList::set(SequenceNumber start, SequenceNumber end) {
+    if (end < start) {
+        return;
+    }
+
+    if (isEmpty()) {
+        // start over from the word holding start
+        _head = 0;
+        _base = SequenceNumber((SequenceNumber::Type)start & ~(BITS_PER_WORD - 1));
+    }
+
+    int first = seqoff(_base, start);
+    if (first < 0) {
+        // grow the ring backwards to take in words before the first one
+        int wordsBefore = (-first + BITS_PER_WORD - 1) / BITS_PER_WORD;
+        reserve(_numWords + wordsBefore);
+
+        _head = (_head - wordsBefore) & (_words.size() - 1);
+        _base -= wordsBefore * BITS_PER_WORD;
+        _numWords += wordsBefore;
+        first += wordsBefore * BITS_PER_WORD;
+    }
+
+    int last = seqoff(_base, end);
+    int wordsNeeded = last / BITS_PER_WORD + 1;
+    if (wordsNeeded > _numWords) {
+        reserve(wordsNeeded);
+        _numWords = wordsNeeded;
+    }
+
+    for (int index = first / BITS_PER_WORD; index <= last / BITS_PER_WORD; ++index) {
+        int firstBit = (index == first / BITS_PER_WORD) ? first % BITS_PER_WORD : 0;
+        int lastBit = (index == last / BITS_PER_WORD) ? last % BITS_PER_WORD : BITS_PER_WORD - 1;
+
+        auto& word = wordAt(index);
+        auto mask = maskForBits(firstBit, lastBit);
+        _length += countBits(mask & ~word);
+        word |= mask;
+    }
+}
+
+void LossList::reserve(int numWords) {
+    if (numWords <= (int)_words.size()) {
+        return;
+    }
+
+    size_t capacity = max<size_t>(_words.size(), MIN_CAPACITY_WORDS);
+    while ((int)capacity < numWords) {
+        capacity *= 2;
+    }
+
+    // lay the words in use out from the start of the new ring
+    vector<Word> words(capacity, 0);
+    for (int index = 0; index < _numWords; ++index) {
+        words[index] = wordAt(index);
+    }
+
+    _words.swap(words);
+    _head = 0;
+}
+
+void LossList::trim() {
+    while (_numWords > 0 && wordAt(0) == 0) {
+        _head = (_head + 1) & (_words.size() - 1);
+        _base += BITS_PER_WORD;
+        --_numWords;
+    }
+
+    while (_numWords > 0 && wordAt(_numWords - 1) == 0) {
+        --_numWords;
     }
 }
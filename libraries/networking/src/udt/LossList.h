@@ -12,26 +12,34 @@
 #ifndef hifi_LossList_h
 #define hifi_LossList_h
 
-#include <list>
+#include <cstdint>
+#include <vector>
 
 #include "SequenceNumber.h"
 
 namespace udt {
 
 class ControlPacket;
-    
+
+// Missing sequence numbers, one bit each in a ring of words starting at the first of them.
+// The ring grows to the span between the first and last missing sequence numbers, so adding or removing a range costs
+// a word per 64 sequence numbers and never walks other ranges. Ranges from the peer go through insertWithin, so
+// that span stays within the flow window.
 class LossList {
 public:
     LossList() {}
     
-    void clear() { _length = 0; _lossList.clear(); }
+    void clear();
     
-    // must always add at the end - faster than insert
+    // must always add at the end
     void append(SequenceNumber seq);
     void append(SequenceNumber start, SequenceNumber end);
     
-    // inserts anywhere - MUCH slower
+    // inserts anywhere, as fast as append
     void insert(SequenceNumber start, SequenceNumber end);
+
+    // inserts only the part of the range from first to last, for ranges reported by the peer
+    void insertWithin(SequenceNumber start, SequenceNumber end, SequenceNumber first, SequenceNumber last);
     
     bool remove(SequenceNumber seq);
     void remove(SequenceNumber start, SequenceNumber end);
@@ -40,11 +48,28 @@ public:
     bool isEmpty() const { return _length == 0; }
     SequenceNumber getFirstSequenceNumber() const;
     SequenceNumber popFirstSequenceNumber();
+
+    int getCapacity() const { return (int)_words.size() * BITS_PER_WORD; } // sequence numbers the ring can hold
     
     void write(ControlPacket& packet, int maxPairs = -1);
     
 private:
-    std::list<std::pair<SequenceNumber, SequenceNumber>> _lossList;
+    using Word = uint64_t;
+    static const int BITS_PER_WORD = 64;
+
+    SequenceNumber getLastSequenceNumber() const;
+
+    void set(SequenceNumber start, SequenceNumber end);
+    void reserve(int numWords);
+    void trim();
+
+    Word& wordAt(int index) { return _words[(_head + index) & (_words.size() - 1)]; }
+    const Word& wordAt(int index) const { return _words[(_head + index) & (_words.size() - 1)]; }
+
+    std::vector<Word> _words; // capacity is a power of two, words outside the ones in use are always zero
+    size_t _head { 0 }; // the word holding _base
+    int _numWords { 0 }; // words in use from _head, the first and the last always have a bit set
+    SequenceNumber _base; // sequence number of the first bit of the word at _head, a multiple of BITS_PER_WORD
     int _length { 0 };
 };
     
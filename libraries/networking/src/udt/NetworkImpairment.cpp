@@ -0,0 +1,273 @@
+//
+//  NetworkImpairment.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "NetworkImpairment.h"
+
+#include <algorithm>
+
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+
+#include "../NetworkLogging.h"
+
+using namespace udt;
+using namespace std::chrono;
+
+static const int64_t USECS_PER_MSEC = 1000;
+static const int64_t USECS_PER_SECOND = 1000 * 1000;
+static const int BITS_PER_BYTE = 8;
+
+// the least a reordered datagram is held back behind the ones after it, when there's no jitter to go by
+static const int MIN_REORDER_HOLD_MSECS = 5;
+
+bool ImpairmentParameters::isImpaired() const {
+    return loss > 0.0 || delay > 0 || jitter > 0 || reorder > 0.0 || duplicate > 0.0 || bandwidth > 0;
+}
+
+ImpairmentParameters ImpairmentParameters::fromJson(const QJsonObject& object, const ImpairmentParameters& defaults) {
+    ImpairmentParameters parameters = defaults;
+
+    parameters.loss = object.value("loss").toDouble(parameters.loss);
+    parameters.lossBurst = std::max(1.0, object.value("lossBurst").toDouble(parameters.lossBurst));
+    parameters.delay = object.value("delay").toInt(parameters.delay);
+    parameters.jitter = object.value("jitter").toInt(parameters.jitter);
+    parameters.reorder = object.value("reorder").toDouble(parameters.reorder);
+    parameters.duplicate = object.value("duplicate").toDouble(parameters.duplicate);
+    parameters.bandwidth = object.value("bandwidth").toInt(parameters.bandwidth);
+    parameters.queue = std::max(1, object.value("queue").toInt(parameters.queue));
+
+    return parameters;
+}
+
+QJsonObject ImpairmentParameters::toJson() const {
+    return {
+        { "loss", loss },
+        { "lossBurst", lossBurst },
+        { "delay", delay },
+        { "jitter", jitter },
+        { "reorder", reorder },
+        { "duplicate", duplicate },
+        { "bandwidth", bandwidth },
+        { "queue", queue }
+    };
+}
+
+ImpairmentProfile ImpairmentProfile::fromJson(const QJsonObject& object) {
+    ImpairmentProfile profile;
+    profile.name = object.value("name").toString();
+    profile.repeat = object.value("repeat").toBool();
+
+    auto readStage = [](const QJsonObject& stageObject) {
+        ImpairmentStage stage;
+        stage.duration = stageObject.value("duration").toInt();
+
+        auto both = ImpairmentParameters::fromJson(stageObject);
+        stage.send = ImpairmentParameters::fromJson(stageObject.value("send").toObject(), both);
+        stage.receive = ImpairmentParameters::fromJson(stageObject.value("receive").toObject(), both);
+
+        return stage;
+    };
+
+    if (object.contains("stages")) {
+        for (const auto& stageValue : object.value("stages").toArray()) {
+            profile.stages.push_back(readStage(stageValue.toObject()));
+        }
+    } else {
+        // a profile without stages is a single, constant stage
+        profile.stages.push_back(readStage(object));
+    }
+
+    return profile;
+}
+
+ImpairmentProfile ImpairmentProfile::fromFile(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(networking) << "Could not open impairment profile" << path << "-" << file.errorString();
+        return ImpairmentProfile();
+    }
+
+    QJsonParseError error;
+    auto document = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError || !document.isObject()) {
+        qCWarning(networking) << "Could not parse impairment profile" << path << "-" << error.errorString();
+        return ImpairmentProfile();
+    }
+
+    auto profile = fromJson(document.object());
+    if (profile.name.isEmpty()) {
+        profile.name = QFileInfo(path).baseName();
+    }
+    return profile;
+}
+
+NetworkImpairment::NetworkImpairment(const ImpairmentProfile& profile, Direction direction, ReleaseOperator releaseOperator,
+                                     QObject* parent) :
+    QObject(parent),
+    _profile(profile),
+    _direction(direction),
+    _startTime(Clock::now()),
+    _releaseOperator(releaseOperator)
+{
+    Q_ASSERT_X(_profile.isValid(), "NetworkImpairment::NetworkImpairment", "Impairment profile must have a stage");
+
+    _linkFreeTime = _startTime;
+    _lastReleaseTime = _startTime;
+
+    // only runs while there are datagrams waiting
+    _timer.setTimerType(Qt::PreciseTimer);
+    _timer.setInterval(1);
+    connect(&_timer, &QTimer::timeout, this, &NetworkImpairment::release);
+}
+
+void NetworkImpairment::push(const char* data, qint64 size, const HifiSockAddr& sockAddr) {
+    auto now = Clock::now();
+    bool wasEmpty = false;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        const auto& parameters = currentParameters(now);
+        ++_stats.datagrams;
+
+        if (shouldDrop(parameters)) {
+            ++_stats.lost;
+            return;
+        }
+
+        auto sendTime = now;
+        if (parameters.bandwidth > 0) {
+            while (!_departures.empty() && _departures.front() <= now) {
+                _departures.pop_front();
+            }
+
+            if ((int)_departures.size() >= parameters.queue) {
+                ++_stats.overflowed;
+                return;
+            }
+
+            // serialize behind whatever is still queued at the cap
+            auto serialization = microseconds(size * BITS_PER_BYTE * USECS_PER_SECOND / parameters.bandwidth);
+            _linkFreeTime = std::max(now, _linkFreeTime) + serialization;
+            _departures.push_back(_linkFreeTime);
+            sendTime = _linkFreeTime;
+        }
+
+        auto releaseTime = sendTime + milliseconds(parameters.delay);
+        if (parameters.jitter > 0) {
+            releaseTime += microseconds((int64_t)((random() * 2.0 - 1.0) * parameters.jitter * USECS_PER_MSEC));
+        }
+
+        if (parameters.reorder > 0.0 && random() < parameters.reorder) {
+            // hold this one back without holding back the ones that follow it
+            int64_t holdUsecs = std::max(parameters.jitter, MIN_REORDER_HOLD_MSECS) * USECS_PER_MSEC;
+            releaseTime = std::max(releaseTime, _lastReleaseTime) + microseconds((int64_t)(random() * holdUsecs) + 1);
+            ++_stats.reordered;
+        } else {
+            // jitter alone doesn't reorder, like a real queue
+            releaseTime = std::max(releaseTime, _lastReleaseTime);
+            _lastReleaseTime = releaseTime;
+        }
+
+        wasEmpty = _pending.empty();
+
+        Datagram datagram { QByteArray(data, size), sockAddr };
+        if (parameters.duplicate > 0.0 && random() < parameters.duplicate) {
+            _pending.insert({ releaseTime, datagram });
+            ++_stats.duplicated;
+        }
+        _pending.insert({ releaseTime, std::move(datagram) });
+    }
+
+    if (wasEmpty) {
+        // push may be called from any thread, the timer has to be started from ours
+        QMetaObject::invokeMethod(this, "startReleasing", Qt::QueuedConnection);
+    }
+}
+
+NetworkImpairment::Stats NetworkImpairment::getStats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+void NetworkImpairment::release() {
+    std::vector<Datagram> due;
+    bool isEmpty = false;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto end = _pending.upper_bound(Clock::now());
+        for (auto it = _pending.begin(); it != end; ++it) {
+            due.push_back(std::move(it->second));
+        }
+        _pending.erase(_pending.begin(), end);
+
+        isEmpty = _pending.empty();
+    }
+
+    for (const auto& datagram : due) {
+        _releaseOperator(datagram.data, datagram.sockAddr);
+    }
+
+    if (isEmpty) {
+        // a push that raced this has queued a restart
+        _timer.stop();
+    }
+}
+
+const ImpairmentParameters& NetworkImpairment::currentParameters(Clock::time_point now) const {
+    int64_t elapsed = duration_cast<milliseconds>(now - _startTime).count();
+
+    if (_profile.repeat) {
+        int64_t totalDuration = 0;
+        for (const auto& stage : _profile.stages) {
+            totalDuration += stage.duration;
+        }
+        if (totalDuration > 0) {
+            elapsed %= totalDuration;
+        }
+    }
+
+    const ImpairmentStage* current = &_profile.stages.back();
+    for (const auto& stage : _profile.stages) {
+        if (elapsed < stage.duration) {
+            current = &stage;
+            break;
+        }
+        elapsed -= stage.duration;
+    }
+
+    return _direction == Send ? current->send : current->receive;
+}
+
+bool NetworkImpairment::shouldDrop(const ImpairmentParameters& parameters) {
+    if (parameters.loss <= 0.0) {
+        _isInLossBurst = false;
+        return false;
+    }
+
+    // two state (Gilbert) loss model, every datagram in the bad state is lost. Leaving it with
+    // probability 1 / lossBurst and entering it as below keeps the overall loss rate at parameters.loss
+    double exitProbability = 1.0 / parameters.lossBurst;
+
+    if (_isInLossBurst) {
+        _isInLossBurst = random() >= exitProbability;
+    } else if (parameters.loss >= 1.0) {
+        _isInLossBurst = true;
+    } else {
+        double enterProbability = parameters.loss * exitProbability / (1.0 - parameters.loss);
+        _isInLossBurst = random() < enterProbability;
+    }
+
+    return _isInLossBurst;
+}
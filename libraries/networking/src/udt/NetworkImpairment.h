@@ -0,0 +1,140 @@
+//
+//  NetworkImpairment.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_NetworkImpairment_h
+#define hifi_NetworkImpairment_h
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+
+#include <PortableHighResolutionClock.h>
+
+#include "../HifiSockAddr.h"
+
+namespace udt {
+
+struct ImpairmentParameters {
+    double loss { 0.0 }; // probability a datagram is dropped
+    double lossBurst { 1.0 }; // mean length of a run of drops, in datagrams
+    int delay { 0 }; // one way, milliseconds
+    int jitter { 0 }; // delay varies by up to +/- this, milliseconds
+    double reorder { 0.0 }; // probability a datagram is held back behind the ones sent after it
+    double duplicate { 0.0 }; // probability a datagram is delivered twice
+    int bandwidth { 0 }; // bits per second, 0 for no cap
+    int queue { 100 }; // datagrams buffered behind the bandwidth cap before they are tail dropped
+
+    bool isImpaired() const;
+
+    // reads the keys present in object over a copy of defaults
+    static ImpairmentParameters fromJson(const QJsonObject& object, const ImpairmentParameters& defaults = {});
+    QJsonObject toJson() const;
+};
+
+struct ImpairmentStage {
+    int duration { 0 }; // milliseconds
+    ImpairmentParameters send;
+    ImpairmentParameters receive;
+};
+
+// A scripted sequence of link conditions, for example:
+// { "name": "handover", "repeat": true, "stages": [
+//     { "duration": 10000, "delay": 40, "jitter": 5, "loss": 0.005 },
+//     { "duration": 1500, "loss": 0.4, "lossBurst": 8, "receive": { "loss": 0.1 } } ] }
+// Keys at the top of a stage apply in both directions, a "send" or "receive" object overrides them for one direction.
+// Once the last stage has run the profile starts over if it repeats, otherwise the last stage holds.
+struct ImpairmentProfile {
+    QString name;
+    bool repeat { false };
+    std::vector<ImpairmentStage> stages;
+
+    bool isValid() const { return !stages.empty(); }
+
+    static ImpairmentProfile fromJson(const QJsonObject& object);
+    // returns an invalid profile if the file can't be read or parsed
+    static ImpairmentProfile fromFile(const QString& path);
+};
+
+// Holds datagrams crossing between a udt::Socket and its QUdpSocket and releases them (or not) according to
+// the current stage of an ImpairmentProfile. Each direction of a socket has its own.
+class NetworkImpairment : public QObject {
+    Q_OBJECT
+public:
+    enum Direction {
+        Send,
+        Receive
+    };
+
+    struct Stats {
+        int datagrams { 0 };
+        int lost { 0 };
+        int overflowed { 0 }; // tail dropped behind the bandwidth cap
+        int duplicated { 0 };
+        int reordered { 0 };
+    };
+
+    using ReleaseOperator = std::function<void(const QByteArray&, const HifiSockAddr&)>;
+
+    // releaseOperator is called on the thread that owns this object
+    NetworkImpairment(const ImpairmentProfile& profile, Direction direction, ReleaseOperator releaseOperator,
+                      QObject* parent = nullptr);
+
+    // Thread safe, the data is copied
+    void push(const char* data, qint64 size, const HifiSockAddr& sockAddr);
+
+    Stats getStats() const;
+
+private slots:
+    void startReleasing() { _timer.start(); }
+    void release();
+
+private:
+    using Clock = p_high_resolution_clock;
+
+    struct Datagram {
+        QByteArray data;
+        HifiSockAddr sockAddr;
+    };
+
+    const ImpairmentParameters& currentParameters(Clock::time_point now) const;
+    bool shouldDrop(const ImpairmentParameters& parameters);
+    double random() { return _distribution(_generator); }
+
+    const ImpairmentProfile _profile;
+    const Direction _direction;
+    const Clock::time_point _startTime;
+    ReleaseOperator _releaseOperator;
+
+    mutable std::mutex _mutex;
+    std::multimap<Clock::time_point, Datagram> _pending; // by release time, in push order for equal times
+    std::deque<Clock::time_point> _departures; // when datagrams behind the bandwidth cap finish sending
+    Clock::time_point _linkFreeTime;
+    Clock::time_point _lastReleaseTime; // keeps jittered datagrams in order unless they are reordered on purpose
+    bool _isInLossBurst { false };
+    Stats _stats;
+
+    std::mt19937 _generator { std::random_device()() };
+    std::uniform_real_distribution<double> _distribution { 0.0, 1.0 };
+
+    QTimer _timer { this };
+};
+
+}
+
+#endif // hifi_NetworkImpairment_h
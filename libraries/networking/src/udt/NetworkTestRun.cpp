@@ -0,0 +1,77 @@
+//
+//  NetworkTestRun.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "NetworkTestRun.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QTimer>
+
+using namespace udt;
+
+static const int MSECS_PER_SECOND = 1000;
+
+const QCommandLineOption NetworkTestRun::IMPAIRMENT_PROFILE {
+    "impairment-profile",
+    "JSON profile of the loss, delay, jitter, reordering and bandwidth to emulate (examples in tools/udt-test/profiles)",
+    "path"
+};
+const QCommandLineOption NetworkTestRun::DURATION {
+    "duration", "seconds to run before exiting (default is to run until interrupted)", "seconds"
+};
+const QCommandLineOption NetworkTestRun::REPORT {
+    "report", "write a JSON report of the run on exit", "path"
+};
+
+void NetworkTestRun::addOptions(QCommandLineParser& parser) {
+    parser.addOptions({ IMPAIRMENT_PROFILE, DURATION, REPORT });
+}
+
+bool NetworkTestRun::start(const QCommandLineParser& parser, ReportBuilder buildReport) {
+    _runTimer.start();
+
+    if (parser.isSet(IMPAIRMENT_PROFILE)) {
+        _impairmentProfile = ImpairmentProfile::fromFile(parser.value(IMPAIRMENT_PROFILE));
+
+        if (!_impairmentProfile.isValid()) {
+            qCritical() << "Could not load an impairment profile from" << parser.value(IMPAIRMENT_PROFILE);
+            return false;
+        }
+    }
+
+    auto application = QCoreApplication::instance();
+
+    if (parser.isSet(REPORT)) {
+        _reportPath = parser.value(REPORT);
+        _buildReport = buildReport;
+        connect(application, &QCoreApplication::aboutToQuit, this, &NetworkTestRun::writeReport);
+    }
+
+    if (parser.isSet(DURATION)) {
+        QTimer::singleShot(parser.value(DURATION).toInt() * MSECS_PER_SECOND, application, &QCoreApplication::quit);
+    }
+
+    return true;
+}
+
+double NetworkTestRun::getElapsedSeconds() const {
+    return std::max((qint64)1, _runTimer.elapsed()) / (double)MSECS_PER_SECOND;
+}
+
+void NetworkTestRun::writeReport() {
+    QFile file(_reportPath);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(_buildReport()).toJson());
+        qDebug() << "Wrote report to" << _reportPath;
+    } else {
+        qCritical() << "Could not write report to" << _reportPath << "-" << file.errorString();
+    }
+}
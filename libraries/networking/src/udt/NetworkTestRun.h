@@ -0,0 +1,92 @@
+//
+//  NetworkTestRun.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_NetworkTestRun_h
+#define hifi_NetworkTestRun_h
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonObject>
+
+#include "NetworkImpairment.h"
+
+namespace udt {
+
+// What the network test tools (udt-test, load-generator) have in common: the network to emulate, how long to run
+// and a JSON report of the run written on exit.
+class NetworkTestRun : public QObject {
+    Q_OBJECT
+public:
+    static const QCommandLineOption IMPAIRMENT_PROFILE;
+    static const QCommandLineOption DURATION;
+    static const QCommandLineOption REPORT;
+
+    using ReportBuilder = std::function<QJsonObject()>;
+
+    NetworkTestRun(QObject* parent = nullptr) : QObject(parent) {}
+
+    static void addOptions(QCommandLineParser& parser);
+
+    // Loads the impairment profile, quits the application once the duration is up and writes the report it builds
+    // as the application quits. Returns false, having logged why, if the impairment profile can't be loaded.
+    bool start(const QCommandLineParser& parser, ReportBuilder buildReport);
+
+    const ImpairmentProfile& getImpairmentProfile() const { return _impairmentProfile; }
+    bool isReporting() const { return !_reportPath.isEmpty(); }
+    double getElapsedSeconds() const; // since start, at least a millisecond
+
+    // mean, percentiles and max of a set of samples, each multiplied by scale (to report microseconds in ms, say)
+    template <typename T>
+    static QJsonObject summarize(std::vector<T> samples, double scale = 1.0);
+
+private:
+    void writeReport();
+
+    ImpairmentProfile _impairmentProfile;
+    QString _reportPath; // where to write the report, if anywhere
+    ReportBuilder _buildReport;
+    QElapsedTimer _runTimer;
+};
+
+template <typename T>
+QJsonObject NetworkTestRun::summarize(std::vector<T> samples, double scale) {
+    if (samples.empty()) {
+        return QJsonObject();
+    }
+
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&](double fraction) {
+        return samples[(size_t)(fraction * (samples.size() - 1))] * scale;
+    };
+
+    double total = 0.0;
+    for (auto sample : samples) {
+        total += sample;
+    }
+
+    return {
+        { "mean", total / samples.size() * scale },
+        { "p50", percentile(0.5) },
+        { "p90", percentile(0.9) },
+        { "p99", percentile(0.99) },
+        { "max", samples.back() * scale }
+    };
+}
+
+}
+
+#endif // hifi_NetworkTestRun_h
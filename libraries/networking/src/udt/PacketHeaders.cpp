@@ -67,8 +67,11 @@ PacketVersion versionForPacketType(PacketType packetType) {
         case PacketType::InjectAudio:
         case PacketType::MicrophoneAudioNoEcho:
         case PacketType::MicrophoneAudioWithEcho:
-        case PacketType::AudioStreamStats:
             return static_cast<PacketVersion>(AudioVersion::HighDynamicRangeVolume);
+        case PacketType::AudioStreamStats:
+            return static_cast<PacketVersion>(AudioVersion::AdaptiveJitterBufferStats);
+        case PacketType::InjectCachedSound:
+            return static_cast<PacketVersion>(AudioVersion::CachedSoundInjection);
         default:
             return 17;
     }
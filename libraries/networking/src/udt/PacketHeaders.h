@@ -123,6 +123,8 @@ public:
         ReplicatedBulkAvatarData,
         OctreeFileReplacementFromUrl,
         ChallengeOwnership,
+        InjectCachedSound,
+        TraceDumpRequest,
         NUM_PACKET_TYPE
     };
 
@@ -147,6 +149,7 @@ public:
             << PacketTypeEnum::Value::EntityEditNack
             << PacketTypeEnum::Value::DomainListRequest
             << PacketTypeEnum::Value::StopNode
+            << PacketTypeEnum::Value::TraceDumpRequest
             << PacketTypeEnum::Value::DomainDisconnectRequest
             << PacketTypeEnum::Value::UsernameFromIDRequest
             << PacketTypeEnum::Value::NodeKickRequest
@@ -171,7 +174,8 @@ public:
             << PacketTypeEnum::Value::OctreeFileReplacement << PacketTypeEnum::Value::ReplicatedMicrophoneAudioNoEcho
             << PacketTypeEnum::Value::ReplicatedMicrophoneAudioWithEcho << PacketTypeEnum::Value::ReplicatedInjectAudio
             << PacketTypeEnum::Value::ReplicatedSilentAudioFrame << PacketTypeEnum::Value::ReplicatedAvatarIdentity
-            << PacketTypeEnum::Value::ReplicatedKillAvatar << PacketTypeEnum::Value::ReplicatedBulkAvatarData;
+            << PacketTypeEnum::Value::ReplicatedKillAvatar << PacketTypeEnum::Value::ReplicatedBulkAvatarData
+            << PacketTypeEnum::Value::TraceDumpRequest;
         return NON_SOURCED_PACKETS;
     }
 };
@@ -341,6 +345,8 @@ enum class AudioVersion : PacketVersion {
     SpaceBubbleChanges,
     HasPersonalMute,
     HighDynamicRangeVolume,
+    CachedSoundInjection,
+    AdaptiveJitterBufferStats,
 };
 
 enum class MessageDataVersion : PacketVersion {
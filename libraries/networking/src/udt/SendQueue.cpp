@@ -154,9 +154,7 @@ void SendQueue::ack(SequenceNumber ack) {
     {
         // remove any ACKed packets from the map of sent packets
         QWriteLocker locker(&_sentLock);
-        for (auto seq = SequenceNumber { (uint32_t) _lastACKSequenceNumber }; seq <= ack; ++seq) {
-            _sentPackets.erase(seq);
-        }
+        _sentPackets.eraseUpTo(ack);
     }
     
     {   // remove any sequence numbers equal to or lower than this ACK in the loss list
@@ -179,7 +177,8 @@ void SendQueue::nak(SequenceNumber start, SequenceNumber end) {
     
     {
         std::lock_guard<std::mutex> nakLocker(_naksLock);
-        _naks.insert(start, end);
+        // only what was sent and not yet ACKed can be lost
+        _naks.insertWithin(start, end, SequenceNumber(_lastACKSequenceNumber) + 1, getCurrentSequenceNumber());
     }
     
     // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for losses to re-send
@@ -189,7 +188,7 @@ void SendQueue::nak(SequenceNumber start, SequenceNumber end) {
 void SendQueue::fastRetransmit(udt::SequenceNumber ack) {
     {
         std::lock_guard<std::mutex> nakLocker(_naksLock);
-        _naks.insert(ack, ack);
+        _naks.insertWithin(ack, ack, SequenceNumber(_lastACKSequenceNumber) + 1, getCurrentSequenceNumber());
     }
 
     // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for losses to re-send
@@ -204,16 +203,15 @@ void SendQueue::overrideNAKListFromPacket(ControlPacket& packet) {
         std::lock_guard<std::mutex> nakLocker(_naksLock);
         _naks.clear();
         
+        SequenceNumber windowStart = SequenceNumber(_lastACKSequenceNumber) + 1;
+        SequenceNumber windowEnd = getCurrentSequenceNumber();
+
         SequenceNumber first, second;
         while (packet.bytesLeftToRead() >= (qint64)(2 * sizeof(SequenceNumber))) {
             packet.readPrimitive(&first);
             packet.readPrimitive(&second);
-            
-            if (first == second) {
-                _naks.append(first);
-            } else {
-                _naks.append(first, second);
-            }
+
+            _naks.insertWithin(first, second, windowStart, windowEnd);
         }
     }
     
@@ -269,11 +267,10 @@ bool SendQueue::sendNewPacketAndAddToSentList(std::unique_ptr<Packet> newPacket,
     {
         // Insert the packet we have just sent in the sent list
         QWriteLocker locker(&_sentLock);
-        auto& entry = _sentPackets[newPacket->getSequenceNumber()];
-        entry.first = 0; // No resend
-        entry.second.swap(newPacket);
+        Q_ASSERT_X(!_sentPackets.find(sequenceNumber), "SendQueue::sendNewPacketAndAddToSentList()",
+                   "Overriden packet in sent list");
+        _sentPackets.insert(sequenceNumber, { 0, std::move(newPacket) }); // No resend
     }
-    Q_ASSERT_X(!newPacket, "SendQueue::sendNewPacketAndAddToSentList()", "Overriden packet in sent list");
 
     if (bytesWritten < 0) {
         // this is a short-circuit loss - we failed to put this packet on the wire
@@ -470,19 +467,17 @@ bool SendQueue::maybeResendPacket() {
             QReadLocker sentLocker(&_sentLock);
             
             // see if we can find the packet to re-send
-            auto it = _sentPackets.find(resendNumber);
+            auto entry = _sentPackets.find(resendNumber);
 
-            if (it != _sentPackets.end()) {
+            if (entry) {
 
-                auto& entry = it->second;
                 // we found the packet - grab it
-                auto& resendPacket = *(entry.second);
-                ++entry.first; // Add 1 resend
+                auto& resendPacket = *(entry->second);
+                ++entry->first; // Add 1 resend
 
-                Packet::ObfuscationLevel level = (Packet::ObfuscationLevel)(entry.first < 2 ? 0 : (entry.first - 2) % 4);
+                Packet::ObfuscationLevel level = (Packet::ObfuscationLevel)(entry->first < 2 ? 0 : (entry->first - 2) % 4);
 
                 auto wireSize = resendPacket.getWireSize();
-                auto sequenceNumber = it->first;
 
                 if (level != Packet::NoObfuscation) {
 #ifdef UDT_CONNECTION_DEBUG
@@ -518,7 +513,7 @@ bool SendQueue::maybeResendPacket() {
                     sentLocker.unlock();
                 }
                 
-                emit packetRetransmitted(wireSize, sequenceNumber, p_high_resolution_clock::now());
+                emit packetRetransmitted(wireSize, resendNumber, p_high_resolution_clock::now());
                 
                 // Signal that we did resend a packet
                 return true;
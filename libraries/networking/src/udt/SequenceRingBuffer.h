@@ -0,0 +1,184 @@
+//
+//  SequenceRingBuffer.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_SequenceRingBuffer_h
+#define hifi_SequenceRingBuffer_h
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <QtCore/QtGlobal>
+
+#include "SequenceNumber.h"
+
+namespace udt {
+
+// Values keyed by consecutive sequence numbers, in a ring of slots indexed by offset from the oldest one.
+// Lookup is O(1) and insertion is O(1) amortized, the ring doubles when the span of sequence numbers outgrows it.
+// With a maxSize the ring stops growing there and the oldest values are dropped to make room instead.
+template <typename T>
+class SequenceRingBuffer {
+public:
+    explicit SequenceRingBuffer(int maxSize = 0) : _maxSize(maxSize) {}
+
+    bool isEmpty() const { return _size == 0; }
+    int size() const { return _size; }
+
+    // seq must not be older than the oldest value kept, a value already there is replaced
+    void insert(SequenceNumber seq, T value);
+
+    // nullptr if there is no value for seq
+    T* find(SequenceNumber seq);
+
+    // drops the values for every sequence number up to and including seq
+    void eraseUpTo(SequenceNumber seq);
+
+    void clear();
+
+private:
+    struct Slot {
+        T value;
+        bool occupied { false };
+    };
+
+    Slot& slotAt(int offset) { return _slots[(_head + offset) & (_slots.size() - 1)]; }
+    void eraseFront(int count);
+    void reserve(int span);
+
+    std::vector<Slot> _slots; // capacity is a power of two
+    size_t _head { 0 }; // the slot for _base
+    int _span { 0 }; // slots in use from _head, up to the newest value
+    int _size { 0 }; // values kept
+    SequenceNumber _base; // sequence number of the slot at _head
+    int _maxSize;
+};
+
+template <typename T>
+void SequenceRingBuffer<T>::insert(SequenceNumber seq, T value) {
+    if (_span == 0) {
+        _head = 0;
+        _base = seq;
+    }
+
+    int offset = seqoff(_base, seq);
+    Q_ASSERT_X(offset >= 0, "SequenceRingBuffer::insert", "Inserting a sequence number older than the oldest one kept");
+    if (offset < 0) {
+        return;
+    }
+
+    if (_maxSize > 0 && offset >= _maxSize) {
+        // make room by dropping the oldest
+        eraseFront(offset - _maxSize + 1);
+        if (_span == 0) {
+            _head = 0;
+            _base = seq;
+        }
+        offset = seqoff(_base, seq);
+    }
+
+    if (offset >= _span) {
+        reserve(offset + 1);
+        _span = offset + 1;
+    }
+
+    auto& slot = slotAt(offset);
+    if (!slot.occupied) {
+        slot.occupied = true;
+        ++_size;
+    }
+    slot.value = std::move(value);
+}
+
+template <typename T>
+T* SequenceRingBuffer<T>::find(SequenceNumber seq) {
+    if (_span == 0) {
+        return nullptr;
+    }
+
+    int offset = seqoff(_base, seq);
+    if (offset < 0 || offset >= _span) {
+        return nullptr;
+    }
+
+    auto& slot = slotAt(offset);
+    return slot.occupied ? &slot.value : nullptr;
+}
+
+template <typename T>
+void SequenceRingBuffer<T>::eraseUpTo(SequenceNumber seq) {
+    if (_span == 0) {
+        return;
+    }
+
+    eraseFront(seqoff(_base, seq) + 1);
+}
+
+template <typename T>
+void SequenceRingBuffer<T>::eraseFront(int count) {
+    if (count <= 0) {
+        return;
+    }
+
+    if (count >= _span) {
+        clear();
+        return;
+    }
+
+    for (int offset = 0; offset < count; ++offset) {
+        auto& slot = slotAt(offset);
+        if (slot.occupied) {
+            slot = Slot();
+            --_size;
+        }
+    }
+
+    _head = (_head + count) & (_slots.size() - 1);
+    _base = _base + count;
+    _span -= count;
+}
+
+template <typename T>
+void SequenceRingBuffer<T>::clear() {
+    for (int offset = 0; offset < _span; ++offset) {
+        slotAt(offset) = Slot();
+    }
+    _head = 0;
+    _span = 0;
+    _size = 0;
+}
+
+template <typename T>
+void SequenceRingBuffer<T>::reserve(int span) {
+    if (span <= (int)_slots.size()) {
+        return;
+    }
+
+    const size_t MIN_CAPACITY = 16;
+    size_t capacity = std::max(_slots.size(), MIN_CAPACITY);
+    while ((int)capacity < span) {
+        capacity *= 2;
+    }
+
+    // lay the slots in use out from the start of the new ring
+    std::vector<Slot> slots(capacity);
+    for (int offset = 0; offset < _span; ++offset) {
+        slots[offset] = std::move(slotAt(offset));
+    }
+
+    _slots.swap(slots);
+    _head = 0;
+}
+
+}
+
+#endif // hifi_SequenceRingBuffer_h
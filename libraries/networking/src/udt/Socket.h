@@ -25,6 +25,7 @@
 #include "../HifiSockAddr.h"
 #include "TCPVegasCC.h"
 #include "Connection.h"
+#include "NetworkImpairment.h"
 
 //#define UDT_CONNECTION_DEBUG
 
@@ -83,6 +84,11 @@ public:
     void setCongestionControlFactory(std::unique_ptr<CongestionControlVirtualFactory> ccFactory);
     void setConnectionMaxBandwidth(int maxBandwidth);
 
+    // Emulates a poor network between this socket and the OS socket, for testing and benchmarking.
+    // Set it before the socket sends anything, send queues write from their own threads.
+    void setImpairmentProfile(const ImpairmentProfile& profile);
+    NetworkImpairment::Stats getImpairmentStats(NetworkImpairment::Direction direction) const;
+
     void messageReceived(std::unique_ptr<Packet> packet);
     void messageFailed(Connection* connection, Packet::MessageNumber messageNumber);
     
@@ -110,6 +116,9 @@ private slots:
 private:
     void setSystemBufferSizes();
     Connection* findOrCreateConnection(const HifiSockAddr& sockAddr);
+    qint64 writeDatagramToSocket(const QByteArray& datagram, const HifiSockAddr& sockAddr);
+    void processDatagram(std::unique_ptr<char[]> buffer, int size, const HifiSockAddr& senderSockAddr,
+                         p_high_resolution_clock::time_point receiveTime);
     bool socketMatchesNodeOrDomain(const HifiSockAddr& sockAddr);
    
     // privatized methods used by UDTTest - they are private since they must be called on the Socket thread
@@ -143,6 +152,9 @@ private:
 
     std::unique_ptr<CongestionControlVirtualFactory> _ccFactory { new CongestionControlFactory<TCPVegasCC>() };
 
+    std::unique_ptr<NetworkImpairment> _sendImpairment;
+    std::unique_ptr<NetworkImpairment> _receiveImpairment;
+
     bool _shouldChangeSocketOptions { true };
 
     int _lastPacketSizeRead { 0 };
@@ -749,8 +749,9 @@ int OctreePacketData::unpackDataFromBytes(const unsigned char* dataBytes, QByteA
     uint16_t length;
     memcpy(&length, dataBytes, sizeof(length));
     dataBytes += sizeof(length);
-    QByteArray value((const char*)dataBytes, length);
-    result = value;
+    // reuses the storage of result when it isn't shared
+    result.resize(length);
+    memcpy(result.data(), dataBytes, length);
     return sizeof(length) + length;
 }
 
@@ -10,12 +10,29 @@
 //
 #pragma once
 
+#include <stdint.h>
+#include <string.h>
+
+#include <QtCore/QByteArray>
+
 #include "Plugin.h"
 
 class Encoder {
 public:
     virtual ~Encoder() { }
     virtual void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) = 0;
+
+    // encodes numSamples samples straight into a caller owned buffer of maxEncodedSize bytes, returns the encoded size
+    // the default goes through encode() above, encoders that can write in place should override it
+    virtual int encodeInto(const int16_t* decodedSamples, int numSamples, char* encodedBuffer, int maxEncodedSize) {
+        QByteArray decodedBuffer = QByteArray::fromRawData(reinterpret_cast<const char*>(decodedSamples),
+                                                           numSamples * (int)sizeof(int16_t));
+        QByteArray encoded;
+        encode(decodedBuffer, encoded);
+        int encodedSize = encoded.size() < maxEncodedSize ? encoded.size() : maxEncodedSize;
+        memcpy(encodedBuffer, encoded.constData(), encodedSize);
+        return encodedSize;
+    }
 };
 
 class Decoder {
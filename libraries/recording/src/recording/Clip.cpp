@@ -8,6 +8,8 @@
 
 #include "Clip.h"
 
+#include <vector>
+
 #include "Frame.h"
 #include "Logging.h"
 
@@ -92,6 +94,18 @@ bool writeFrame(QIODevice& output, const Frame& frame, bool compressed = true) {
 
 const QString Clip::FRAME_TYPE_MAP = QStringLiteral("frameTypes");
 const QString Clip::FRAME_COMREPSSION_FLAG = QStringLiteral("compressed");
+const QString Clip::FILE_VERSION = QStringLiteral("version");
+const QString Clip::FRAME_COUNT = QStringLiteral("frameCount");
+const QString Clip::BLOCK_COUNT = QStringLiteral("blockCount");
+
+// Frames are packed into blocks of about this many bytes before compression.  Large enough for zlib to find the
+// redundancy between consecutive frames, small enough that a seek only has to inflate a little data.
+static const int BLOCK_SIZE = 64 * 1024;
+
+template <typename T>
+void appendIndexValue(QByteArray& index, const T& value) {
+    index.append((const char*)&value, sizeof(T));
+}
 
 bool Clip::write(QIODevice& output) {
     auto frameTypes = Frame::getFrameTypes();
@@ -100,20 +114,68 @@ bool Clip::write(QIODevice& output) {
         frameTypeObj[frameTypeName] = frameTypes[frameTypeName];
     }
 
+    // Pack the frames into blocks and build the frame index, see PointerClip for the layout
+    QByteArray frameIndex;
+    QByteArray blockIndex;
+    std::vector<QByteArray> blocks;
+    QByteArray block;
+    quint64 blockOffset = 0;
+    uint32_t frameCount = 0;
+    auto finishBlock = [&] {
+        if (block.isEmpty()) {
+            return;
+        }
+        QByteArray compressedBlock = qCompress(block);
+        appendIndexValue<quint64>(blockIndex, blockOffset);
+        appendIndexValue<uint32_t>(blockIndex, compressedBlock.size());
+        appendIndexValue<uint32_t>(blockIndex, block.size());
+        blockOffset += compressedBlock.size();
+        blocks.push_back(compressedBlock);
+        block.clear();
+    };
+
+    seek(0);
+
+    for (auto frame = nextFrame(); frame; frame = nextFrame()) {
+        if (frame->type == Frame::TYPE_INVALID) {
+            qWarning() << "Attempting to write invalid frame";
+            continue;
+        }
+        if (frame->data.size() > std::numeric_limits<FrameSize>::max()) {
+            qWarning() << "Frame of " << frame->data.size() << " bytes is too large to write";
+            return false;
+        }
+        if (!block.isEmpty() && block.size() + frame->data.size() > BLOCK_SIZE) {
+            finishBlock();
+        }
+        appendIndexValue<FrameType>(frameIndex, frame->type);
+        appendIndexValue<FrameSize>(frameIndex, frame->data.size());
+        appendIndexValue<Frame::Time>(frameIndex, frame->timeOffset);
+        appendIndexValue<uint32_t>(frameIndex, (uint32_t)blocks.size());
+        appendIndexValue<uint32_t>(frameIndex, block.size());
+        block.append(frame->data);
+        ++frameCount;
+    }
+    finishBlock();
+
     QJsonObject rootObject;
     rootObject.insert(FRAME_TYPE_MAP, frameTypeObj);
     // Always mark new files as compressed
     rootObject.insert(FRAME_COMREPSSION_FLAG, true);
+    rootObject.insert(FILE_VERSION, PointerClip::BLOCK_COMPRESSED_VERSION);
+    rootObject.insert(FRAME_COUNT, (double)frameCount);
+    rootObject.insert(BLOCK_COUNT, (double)blocks.size());
     QByteArray headerFrameData = QJsonDocument(rootObject).toBinaryData();
     // Never compress the header frame
     if (!writeFrame(output, Frame({ Frame::TYPE_HEADER, 0, headerFrameData }), false)) {
         return false;
     }
 
-    seek(0);
-
-    for (auto frame = nextFrame(); frame; frame = nextFrame()) {
-        if (!writeFrame(output, *frame)) {
+    if (output.write(frameIndex) != frameIndex.size() || output.write(blockIndex) != blockIndex.size()) {
+        return false;
+    }
+    for (const auto& compressedBlock : blocks) {
+        if (output.write(compressedBlock) != compressedBlock.size()) {
             return false;
         }
     }
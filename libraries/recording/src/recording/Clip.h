@@ -56,6 +56,9 @@ public:
     
     static const QString FRAME_TYPE_MAP;
     static const QString FRAME_COMREPSSION_FLAG;
+    static const QString FILE_VERSION;
+    static const QString FRAME_COUNT;
+    static const QString BLOCK_COUNT;
 
 protected:
     friend class WrapperClip;
@@ -45,38 +45,90 @@ FrameTranslationMap parseTranslationMap(const QJsonDocument& doc) {
 }
 
 
-PointerFrameHeaderList parseFrameHeaders(uchar* const start, const size_t& size) {
+// Reads the frame header at current and moves current past the frame, returns false if there isn't a whole frame left
+bool readFrameHeader(uchar*& current, uchar* const start, uchar* const end, PointerFrameHeader& header) {
+    if (end - current < PointerClip::MINIMUM_FRAME_SIZE) {
+        return false;
+    }
+    memcpy(&(header.type), current, sizeof(FrameType));
+    current += sizeof(FrameType);
+    memcpy(&(header.timeOffset), current, sizeof(Frame::Time));
+    current += sizeof(Frame::Time);
+    memcpy(&(header.size), current, sizeof(FrameSize));
+    current += sizeof(FrameSize);
+    header.fileOffset = current - start;
+    if (end - current < header.size) {
+        current = end;
+        return false;
+    }
+    current += header.size;
+    return true;
+}
+
+PointerFrameHeaderList parseFrameHeaders(uchar* const start, uchar* current, uchar* const end) {
     PointerFrameHeaderList results;
-    auto current = start;
-    auto end = current + size;
     // Read all the frame headers
-    // FIXME move to Frame::readHeader?
-    while (end - current >= PointerClip::MINIMUM_FRAME_SIZE) {
-        PointerFrameHeader header;
-        memcpy(&(header.type), current, sizeof(FrameType));
-        current += sizeof(FrameType);
-        memcpy(&(header.timeOffset), current, sizeof(Frame::Time));
-        current += sizeof(Frame::Time);
-        memcpy(&(header.size), current, sizeof(FrameSize));
-        current += sizeof(FrameSize);
-        header.fileOffset = current - start;
-        if (end - current < header.size) {
-            current = end;
-            break;
-        }
-        current += header.size;
+    PointerFrameHeader header;
+    while (readFrameHeader(current, start, end, header)) {
         results.push_back(header);
     }
     qDebug(recordingLog) << "Parsed source data into " << results.size() << " frames";
-//    int i = 0;
-//    for (const auto& frameHeader : results) {
-//        qDebug(recordingLog) << "Frame " << i++ << " time " << frameHeader.timeOffset << " Type " << frameHeader.type;
-//    }
     return results;
 }
 
+template <typename T>
+T readIndexValue(uchar*& current) {
+    T result;
+    memcpy(&result, current, sizeof(T));
+    current += sizeof(T);
+    return result;
+}
+
+// Reads the frame and block index of a block compressed file, without touching any of the frame data
+bool parseIndexedFrameHeaders(uchar* const start, uchar* current, uchar* const end, size_t frameCount, size_t blockCount,
+                               PointerFrameHeaderList& frames, std::vector<PointerBlockHeader>& blocks) {
+    size_t available = end - current;
+    if (frameCount > available / PointerClip::INDEXED_FRAME_SIZE || blockCount > available / PointerClip::INDEXED_BLOCK_SIZE ||
+        frameCount * PointerClip::INDEXED_FRAME_SIZE + blockCount * PointerClip::INDEXED_BLOCK_SIZE > available) {
+        return false;
+    }
+
+    frames.resize(frameCount);
+    for (auto& header : frames) {
+        header.type = readIndexValue<FrameType>(current);
+        header.size = readIndexValue<FrameSize>(current);
+        header.timeOffset = readIndexValue<Frame::Time>(current);
+        header.block = readIndexValue<uint32_t>(current);
+        header.fileOffset = readIndexValue<uint32_t>(current);
+    }
+
+    // block offsets are relative to the end of the index
+    blocks.resize(blockCount);
+    uchar* blockData = current + blockCount * PointerClip::INDEXED_BLOCK_SIZE;
+    for (auto& block : blocks) {
+        block.fileOffset = readIndexValue<quint64>(current);
+        block.size = readIndexValue<uint32_t>(current);
+        block.uncompressedSize = readIndexValue<uint32_t>(current);
+        if (block.fileOffset > (quint64)(end - blockData) || block.size > (quint64)(end - blockData) - block.fileOffset) {
+            return false;
+        }
+        block.fileOffset += blockData - start;
+    }
+
+    for (const auto& header : frames) {
+        if (header.size && (header.block >= blockCount || header.fileOffset + header.size > blocks[header.block].uncompressedSize)) {
+            return false;
+        }
+    }
+    qDebug(recordingLog) << "Read index of " << frames.size() << " frames in " << blocks.size() << " blocks";
+    return true;
+}
+
 void PointerClip::reset() {
     _frames.clear();
+    _blocks.clear();
+    _decodedBlock.clear();
+    _decodedBlockIndex = INVALID_BLOCK;
     _data = nullptr;
     _size = 0;
     _header = QJsonDocument();
@@ -88,18 +140,17 @@ void PointerClip::init(uchar* data, size_t size) {
     _data = data;
     _size = size;
 
-    auto parsedFrameHeaders = parseFrameHeaders(data, size);
-    // Verify that at least one frame exists and that the first frame is a header
-    if (0 == parsedFrameHeaders.size()) {
-        qWarning() << "No frames found, invalid file";
-        reset();
-        return;
-    }
+    uchar* current = data;
+    uchar* const end = data + size;
 
     // Grab the file header
     {
-        auto fileHeaderFrameHeader = *parsedFrameHeaders.begin();
-        parsedFrameHeaders.pop_front();
+        PointerFrameHeader fileHeaderFrameHeader;
+        if (!readFrameHeader(current, data, end, fileHeaderFrameHeader)) {
+            qWarning() << "No frames found, invalid file";
+            reset();
+            return;
+        }
         if (fileHeaderFrameHeader.type != Frame::TYPE_HEADER) {
             qWarning() << "Missing header frame, invalid file";
             reset();
@@ -115,6 +166,20 @@ void PointerClip::init(uchar* data, size_t size) {
         _compressed = _header.object()[FRAME_COMREPSSION_FLAG].toBool();
     }
 
+    // Read the frame headers, either from the index or by walking every frame in the file
+    PointerFrameHeaderList parsedFrameHeaders;
+    if (_header.object()[FILE_VERSION].toInt(1) >= BLOCK_COMPRESSED_VERSION) {
+        size_t frameCount = (size_t)_header.object()[FRAME_COUNT].toDouble();
+        size_t blockCount = (size_t)_header.object()[BLOCK_COUNT].toDouble();
+        if (!parseIndexedFrameHeaders(data, current, end, frameCount, blockCount, parsedFrameHeaders, _blocks)) {
+            qWarning() << "Corrupt frame index, invalid file";
+            reset();
+            return;
+        }
+    } else {
+        parsedFrameHeaders = parseFrameHeaders(data, current, end);
+    }
+
     // Find the type enum translation map and fix up the frame headers
     {
         FrameTranslationMap translationMap = parseTranslationMap(_header);
@@ -137,6 +202,24 @@ void PointerClip::init(uchar* data, size_t size) {
 
 }
 
+// Internal only function, needs no locking
+const QByteArray& PointerClip::decodeBlock(uint32_t blockIndex) const {
+    if (blockIndex != _decodedBlockIndex) {
+        const auto& block = _blocks[blockIndex];
+        if (_compressed) {
+            _decodedBlock = qUncompress(_data + block.fileOffset, (int)block.size);
+        } else {
+            _decodedBlock = QByteArray::fromRawData(reinterpret_cast<char*>(_data) + block.fileOffset, (int)block.size);
+        }
+        if ((uint32_t)_decodedBlock.size() != block.uncompressedSize) {
+            qCWarning(recordingLog) << "Unable to decode block " << blockIndex << ", corrupt file";
+            _decodedBlock.clear();
+        }
+        _decodedBlockIndex = blockIndex;
+    }
+    return _decodedBlock;
+}
+
 // Internal only function, needs no locking
 FrameConstPointer PointerClip::readFrame(size_t frameIndex) const {
     FramePointer result;
@@ -146,9 +229,16 @@ FrameConstPointer PointerClip::readFrame(size_t frameIndex) const {
         result->type = header.type;
         result->timeOffset = header.timeOffset;
         if (header.size) {
-            result->data.insert(0, reinterpret_cast<char*>(_data)+header.fileOffset, header.size);
-            if (_compressed) {
-                result->data = qUncompress(result->data);
+            if (!_blocks.empty()) {
+                const QByteArray& block = decodeBlock(header.block);
+                if (header.fileOffset + header.size <= (quint64)block.size()) {
+                    result->data = QByteArray(block.constData() + header.fileOffset, header.size);
+                }
+            } else {
+                result->data.insert(0, reinterpret_cast<char*>(_data)+header.fileOffset, header.size);
+                if (_compressed) {
+                    result->data = qUncompress(result->data);
+                }
             }
         }
     }
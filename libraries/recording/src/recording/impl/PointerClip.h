@@ -13,7 +13,9 @@
 #include "ArrayClip.h"
 
 #include <mutex>
+#include <vector>
 
+#include <QtCore/QByteArray>
 #include <QtCore/QJsonDocument>
 
 #include "../Frame.h"
@@ -24,10 +26,17 @@ struct PointerFrameHeader : public FrameHeader {
     FrameType type;
     Frame::Time timeOffset;
     uint16_t size;
-    quint64 fileOffset;
+    quint64 fileOffset; // from the start of the data, or of the uncompressed block in block compressed clips
+    uint32_t block { 0 };
 };
 
-using PointerFrameHeaderList = std::list<PointerFrameHeader>;
+using PointerFrameHeaderList = std::vector<PointerFrameHeader>;
+
+struct PointerBlockHeader {
+    quint64 fileOffset;
+    uint32_t size;
+    uint32_t uncompressedSize;
+};
 
 class PointerClip : public ArrayClip<PointerFrameHeader> {
 public:
@@ -44,13 +53,28 @@ public:
 
     // FIXME move to frame?
     static const qint64 MINIMUM_FRAME_SIZE = sizeof(FrameType) + sizeof(Frame::Time) + sizeof(FrameSize);
+
+    // Version 1 files are a sequence of individually compressed frames, version 2 files follow the header frame with
+    // an index of all the frames and blocks, then frame data packed into separately compressed blocks.
+    static const int BLOCK_COMPRESSED_VERSION = 2;
+    static const size_t INDEXED_FRAME_SIZE = sizeof(FrameType) + sizeof(FrameSize) + sizeof(Frame::Time) + 2 * sizeof(uint32_t);
+    static const size_t INDEXED_BLOCK_SIZE = sizeof(quint64) + 2 * sizeof(uint32_t);
+
 protected:
     void reset() override;
     virtual FrameConstPointer readFrame(size_t index) const override;
+    const QByteArray& decodeBlock(uint32_t blockIndex) const;
+
     QJsonDocument _header;
     uchar* _data { nullptr };
     size_t _size { 0 };
     bool _compressed { true };
+
+    // only the most recently used block is kept uncompressed, playback moves through the blocks in order
+    static const uint32_t INVALID_BLOCK = 0xFFFFFFFF;
+    std::vector<PointerBlockHeader> _blocks;
+    mutable QByteArray _decodedBlock;
+    mutable uint32_t _decodedBlockIndex { INVALID_BLOCK };
 };
 
 }
@@ -206,7 +206,7 @@ void CauterizedModel::updateRenderItems() {
             render::Transaction transaction;
             QList<render::ItemID> keys = self->getRenderItems().keys();
             foreach (auto itemID, keys) {
-                transaction.updateItem<CauterizedMeshPartPayload>(itemID, [modelTransform, deleteGeometryCounter](CauterizedMeshPartPayload& data) {
+                transaction.updateItemConcurrently<CauterizedMeshPartPayload>(itemID, [modelTransform, deleteGeometryCounter](CauterizedMeshPartPayload& data) {
                     ModelPointer model = data._model.lock();
                     if (model && model->isLoaded()) {
                         // Ensure the model geometry was not reset between frames
@@ -232,7 +232,7 @@ void CauterizedModel::updateRenderItems() {
                 });
             }
 
-            scene->enqueueTransaction(transaction);
+            scene->enqueueTransaction(std::move(transaction));
         });
     } else {
         Model::updateRenderItems();
@@ -73,9 +73,9 @@ void Item::PayloadInterface::addStatusGetters(const Status::Getters& getters) {
     }
 }
 
-void Item::update(const UpdateFunctorPointer& updateFunctor) {
+void Item::update(const UpdateFunctorInterface* updateFunctor) {
     if (updateFunctor) {
-        _payload->update(updateFunctor);
+        _payload->update(*updateFunctor);
     }
     _key = _payload->getKey();
 }
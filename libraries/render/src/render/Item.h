@@ -34,6 +34,7 @@ typedef int32_t Index;
 const Index INVALID_INDEX{ -1 };
 
 class Context;
+class TransactionArena;
 
 // Key is the KEY to filter Items and create specialized lists
 class ItemKey {
@@ -300,11 +301,12 @@ public:
     typedef std::shared_ptr<Status> StatusPointer;
 
     // Update Functor
+    // Type erased update of a payload, constructed in place in the arena of the Transaction carrying it
     class UpdateFunctorInterface {
     public:
         virtual ~UpdateFunctorInterface() {}
+        virtual UpdateFunctorInterface* clone(TransactionArena& arena) const = 0;
     };
-    typedef std::shared_ptr<UpdateFunctorInterface> UpdateFunctorPointer;
 
     // Payload is whatever is in this Item and implement the Payload Interface
     class PayloadInterface {
@@ -329,7 +331,7 @@ public:
         StatusPointer _status;
 
         friend class Item;
-        virtual void update(const UpdateFunctorPointer& functor) = 0;
+        virtual void update(const UpdateFunctorInterface& functor) = 0;
     };
     typedef std::shared_ptr<PayloadInterface> PayloadPointer;
 
@@ -342,7 +344,7 @@ public:
     // Main scene / item managment interface reset/update/kill
     void resetPayload(const PayloadPointer& payload);
     void resetCell(ItemCell cell = INVALID_CELL, bool _small = false) { _cell = cell; _key.setSmaller(_small); }
-    void update(const UpdateFunctorPointer& updateFunctor); // communicate update to payload
+    void update(const UpdateFunctorInterface* updateFunctor); // communicate update to payload
     void kill() { _payload.reset(); resetCell(); _key._flags.reset(); } // forget the payload, key, cell
 
     // Check heuristic key
@@ -390,16 +392,10 @@ protected:
 
 
 typedef Item::UpdateFunctorInterface UpdateFunctorInterface;
-typedef Item::UpdateFunctorPointer UpdateFunctorPointer;
-typedef std::vector<UpdateFunctorPointer> UpdateFunctors;
 
 template <class T> class UpdateFunctor : public Item::UpdateFunctorInterface {
 public:
-    typedef std::function<void(T&)> Func;
-    Func _func;
-
-    UpdateFunctor(Func func): _func(func) {}
-    ~UpdateFunctor() {}
+    virtual void apply(T& data) const = 0;
 };
 
 
@@ -452,8 +448,8 @@ protected:
     DataPointer _data;
 
     // Update mechanics
-    virtual void update(const UpdateFunctorPointer& functor) override {
-        std::static_pointer_cast<Updater>(functor)->_func((*_data));
+    virtual void update(const UpdateFunctorInterface& functor) override {
+        static_cast<const Updater&>(functor).apply(*_data);
     }
     friend class Item;
 };
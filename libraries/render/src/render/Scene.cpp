@@ -10,13 +10,75 @@
 //
 #include "Scene.h"
 
+#include <algorithm>
 #include <numeric>
+
+#include <tbb/parallel_for.h>
+
 #include <gpu/Batch.h>
 #include "Logging.h"
 #include "TransitionStage.h"
 
 using namespace render;
 
+// below this many concurrent updates in a frame it isn't worth waking the worker threads
+static const size_t MIN_PARALLEL_UPDATES = 64;
+
+Transaction::~Transaction() {
+    clear();
+}
+
+Transaction::Transaction(const Transaction& other) {
+    merge(other);
+}
+
+Transaction& Transaction::operator=(const Transaction& other) {
+    if (this != &other) {
+        clear();
+        merge(other);
+    }
+    return *this;
+}
+
+Transaction::Transaction(Transaction&& other) :
+    _resetItems(std::move(other._resetItems)),
+    _removedItems(std::move(other._removedItems)),
+    _updatedItems(std::move(other._updatedItems)),
+    _addedTransitions(std::move(other._addedTransitions)),
+    _queriedTransitions(std::move(other._queriedTransitions)),
+    _reAppliedTransitions(std::move(other._reAppliedTransitions)),
+    _resetSelections(std::move(other._resetSelections)),
+    _arena(std::move(other._arena))
+{
+    // the functors now belong to us, make sure other doesn't destroy them
+    other._updatedItems.clear();
+}
+
+Transaction& Transaction::operator=(Transaction&& other) {
+    if (this != &other) {
+        clear();
+        merge(std::move(other));
+    }
+    return *this;
+}
+
+void Transaction::clear() {
+    for (auto& update : _updatedItems) {
+        auto functor = std::get<1>(update);
+        if (functor) {
+            functor->~UpdateFunctorInterface();
+        }
+    }
+    _resetItems.clear();
+    _removedItems.clear();
+    _updatedItems.clear();
+    _addedTransitions.clear();
+    _queriedTransitions.clear();
+    _reAppliedTransitions.clear();
+    _resetSelections.clear();
+    _arena.clear();
+}
+
 void Transaction::resetItem(ItemID id, const PayloadPointer& payload) {
     if (payload) {
         _resetItems.emplace_back(Reset{ id, payload });
@@ -46,18 +108,43 @@ void Transaction::queryTransitionOnItem(ItemID id, TransitionQueryFunc func) {
     _queriedTransitions.emplace_back(TransitionQuery{ id, func });
 }
 
-void Transaction::updateItem(ItemID id, const UpdateFunctorPointer& functor) {
-    _updatedItems.emplace_back(Update{ id, functor });
-}
-
 void Transaction::resetSelection(const Selection& selection) {
     _resetSelections.emplace_back(selection);
 }
 
+template <class T>
+static void moveAppend(std::vector<T>& destination, std::vector<T>& source) {
+    if (destination.empty()) {
+        std::swap(destination, source);
+    } else {
+        destination.insert(destination.end(), std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()));
+    }
+    source.clear();
+}
+
+void Transaction::merge(Transaction&& transaction) {
+    if (&transaction == this) {
+        return;
+    }
+    moveAppend(_resetItems, transaction._resetItems);
+    moveAppend(_removedItems, transaction._removedItems);
+    // the functors stay where they are, we just take over the blocks they live in
+    moveAppend(_updatedItems, transaction._updatedItems);
+    _arena.splice(transaction._arena);
+    moveAppend(_resetSelections, transaction._resetSelections);
+    moveAppend(_addedTransitions, transaction._addedTransitions);
+    moveAppend(_queriedTransitions, transaction._queriedTransitions);
+    moveAppend(_reAppliedTransitions, transaction._reAppliedTransitions);
+}
+
 void Transaction::merge(const Transaction& transaction) {
     _resetItems.insert(_resetItems.end(), transaction._resetItems.begin(), transaction._resetItems.end());
     _removedItems.insert(_removedItems.end(), transaction._removedItems.begin(), transaction._removedItems.end());
-    _updatedItems.insert(_updatedItems.end(), transaction._updatedItems.begin(), transaction._updatedItems.end());
+    _updatedItems.reserve(_updatedItems.size() + transaction._updatedItems.size());
+    for (auto& update : transaction._updatedItems) {
+        auto functor = std::get<1>(update);
+        _updatedItems.emplace_back(Update{ std::get<0>(update), functor ? functor->clone(_arena) : nullptr, std::get<2>(update) });
+    }
     _resetSelections.insert(_resetSelections.end(), transaction._resetSelections.begin(), transaction._resetSelections.end());
     _addedTransitions.insert(_addedTransitions.end(), transaction._addedTransitions.begin(), transaction._addedTransitions.end());
     _queriedTransitions.insert(_queriedTransitions.end(), transaction._queriedTransitions.begin(), transaction._queriedTransitions.end());
@@ -91,10 +178,15 @@ void Scene::enqueueTransaction(const Transaction& transaction) {
     _transactionQueueMutex.unlock();
 }
 
+void Scene::enqueueTransaction(Transaction&& transaction) {
+    _transactionQueueMutex.lock();
+    _transactionQueue.push(std::move(transaction));
+    _transactionQueueMutex.unlock();
+}
+
 void consolidateTransaction(TransactionQueue& queue, Transaction& singleBatch) {
     while (!queue.empty()) {
-        const auto& transaction = queue.front();
-        singleBatch.merge(transaction);
+        singleBatch.merge(std::move(queue.front()));
         queue.pop();
     };
 }
@@ -110,7 +202,7 @@ uint32_t Scene::enqueueFrame() {
     uint32_t frameNumber = 0;
     {
         std::unique_lock<std::mutex> lock(_transactionFramesMutex);
-        _transactionFrames.push_back(consolidatedTransaction);
+        _transactionFrames.push_back(std::move(consolidatedTransaction));
         _transactionFrameNumber++;
         frameNumber = _transactionFrameNumber;
     }
@@ -126,8 +218,7 @@ void Scene::processTransactionQueue() {
     {
         // capture the queued frames and clear the queue
         std::unique_lock<std::mutex> lock(_transactionFramesMutex);
-        queuedFrames = _transactionFrames;
-        _transactionFrames.clear();
+        queuedFrames.swap(_transactionFrames);
     }
 
     // go through the queue of frames and process them
@@ -224,11 +315,73 @@ void Scene::removeItems(const Transaction::Removes& transactions) {
 }
 
 void Scene::updateItems(const Transaction::Updates& transactions) {
+    // Concurrent updates can run in parallel as long as each item's updates stay on one thread and in order, and no
+    // serial update of the same item has to be ordered with them.  Those items are grouped into runs here.
+    _hasSerialUpdate.resize(_items.size(), false);
+    for (auto& update : transactions) {
+        auto updateID = std::get<0>(update);
+        if (updateID != Item::INVALID_ITEM_ID && !std::get<2>(update)) {
+            _hasSerialUpdate[updateID] = true;
+        }
+    }
+
+    for (auto& update : transactions) {
+        auto updateID = std::get<0>(update);
+        if (updateID != Item::INVALID_ITEM_ID && std::get<2>(update) && !_hasSerialUpdate[updateID]) {
+            _concurrentUpdates.emplace_back(updateID, std::get<1>(update));
+        }
+    }
+
+    if (!_concurrentUpdates.empty()) {
+        // stable, so each item's updates keep the order they were queued in
+        std::stable_sort(_concurrentUpdates.begin(), _concurrentUpdates.end(),
+            [](const std::pair<ItemID, UpdateFunctorInterface*>& a, const std::pair<ItemID, UpdateFunctorInterface*>& b) {
+                return a.first < b.first;
+            });
+        for (size_t i = 0; i < _concurrentUpdates.size();) {
+            ItemID id = _concurrentUpdates[i].first;
+            size_t end = i + 1;
+            while (end < _concurrentUpdates.size() && _concurrentUpdates[end].first == id) {
+                ++end;
+            }
+            const auto& item = _items[id];
+            _concurrentUpdateRuns.push_back({ id, i, end, item.getKey(), item.getCell() });
+            i = end;
+        }
+
+        auto applyRun = [this](const ConcurrentUpdateRun& run) {
+            auto& item = _items[run.id];
+            for (size_t i = run.begin; i < run.end; ++i) {
+                item.update(_concurrentUpdates[i].second);
+            }
+        };
+        if (_concurrentUpdates.size() < MIN_PARALLEL_UPDATES) {
+            for (auto& run : _concurrentUpdateRuns) {
+                applyRun(run);
+            }
+        } else {
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, _concurrentUpdateRuns.size()), [&](const tbb::blocked_range<size_t>& range) {
+                for (size_t i = range.begin(); i != range.end(); ++i) {
+                    applyRun(_concurrentUpdateRuns[i]);
+                }
+            });
+        }
+
+        // the spatial tree isn't thread safe, so the items are moved in it afterwards
+        for (auto& run : _concurrentUpdateRuns) {
+            updateItemContainer(run.id, run.oldKey, run.oldCell);
+        }
+    }
+
+    // everything else, in the order it was queued
     for (auto& update : transactions) {
         auto updateID = std::get<0>(update);
         if (updateID == Item::INVALID_ITEM_ID) {
             continue;
         }
+        if (std::get<2>(update) && !_hasSerialUpdate[updateID]) {
+            continue;
+        }
 
         // Access the true item
         auto& item = _items[updateID];
@@ -237,26 +390,41 @@ void Scene::updateItems(const Transaction::Updates& transactions) {
 
         // Update the item
         item.update(std::get<1>(update));
-        auto newKey = item.getKey();
 
-        // Update the item's container
-        if (oldKey.isSpatial() == newKey.isSpatial()) {
-            if (newKey.isSpatial()) {
-                auto newCell = _masterSpatialTree.resetItem(oldCell, oldKey, item.getBound(), updateID, newKey);
-                item.resetCell(newCell, newKey.isSmall());
-            }
-        } else {
-            if (newKey.isSpatial()) {
-                _masterNonspatialSet.erase(updateID);
+        updateItemContainer(updateID, oldKey, oldCell);
+    }
 
-                auto newCell = _masterSpatialTree.resetItem(oldCell, oldKey, item.getBound(), updateID, newKey);
-                item.resetCell(newCell, newKey.isSmall());
-            } else {
-                _masterSpatialTree.removeItem(oldCell, oldKey, updateID);
-                item.resetCell();
+    for (auto& update : transactions) {
+        auto updateID = std::get<0>(update);
+        if (updateID != Item::INVALID_ITEM_ID) {
+            _hasSerialUpdate[updateID] = false;
+        }
+    }
+    _concurrentUpdates.clear();
+    _concurrentUpdateRuns.clear();
+}
 
-                _masterNonspatialSet.insert(updateID);
-            }
+void Scene::updateItemContainer(ItemID updateID, const ItemKey& oldKey, const ItemCell& oldCell) {
+    auto& item = _items[updateID];
+    auto newKey = item.getKey();
+
+    // Update the item's container
+    if (oldKey.isSpatial() == newKey.isSpatial()) {
+        if (newKey.isSpatial()) {
+            auto newCell = _masterSpatialTree.resetItem(oldCell, oldKey, item.getBound(), updateID, newKey);
+            item.resetCell(newCell, newKey.isSmall());
+        }
+    } else {
+        if (newKey.isSpatial()) {
+            _masterNonspatialSet.erase(updateID);
+
+            auto newCell = _masterSpatialTree.resetItem(oldCell, oldKey, item.getBound(), updateID, newKey);
+            item.resetCell(newCell, newKey.isSmall());
+        } else {
+            _masterSpatialTree.removeItem(oldCell, oldKey, updateID);
+            item.resetCell();
+
+            _masterNonspatialSet.insert(updateID);
         }
     }
 }
@@ -17,6 +17,7 @@
 #include "Stage.h"
 #include "Selection.h"
 #include "Transition.h"
+#include "TransactionArena.h"
 
 namespace render {
 
@@ -32,6 +33,8 @@ class Scene;
 // THe Transaction is then queued on the Scene so all the pending transactions can be consolidated and processed at the time
 // of updating the scene before it s rendered.
 // 
+// Update functors are stored in place in the transaction's arena rather than in individually allocated std::functions,
+// and moving or merging a transaction hands its arena over without copying them.
 class Transaction {
     friend class Scene;
 public:
@@ -39,7 +42,12 @@ public:
     typedef std::function<void(ItemID, const Transition*)> TransitionQueryFunc;
 
     Transaction() {}
-    ~Transaction() {}
+    ~Transaction();
+
+    Transaction(const Transaction& other);
+    Transaction& operator=(const Transaction& other);
+    Transaction(Transaction&& other);
+    Transaction& operator=(Transaction&& other);
 
     // Item transactions
     void resetItem(ItemID id, const PayloadPointer& payload);
@@ -51,26 +59,54 @@ public:
     void reApplyTransitionToItem(ItemID id);
     void queryTransitionOnItem(ItemID id, TransitionQueryFunc func);
 
-    template <class T> void updateItem(ItemID id, std::function<void(T&)> func) {
-        updateItem(id, std::make_shared<UpdateFunctor<T>>(func));
+    // func is called with the item's payload data on the render thread when the transaction is processed
+    template <class T, class F> void updateItem(ItemID id, F&& func) {
+        _updatedItems.emplace_back(Update{ id, createUpdateFunctor<T>(std::forward<F>(func)), false });
+    }
+
+    // Same as updateItem, for updates that touch nothing but their own item's payload data.
+    // Those are applied in parallel with the concurrent updates of other items.
+    template <class T, class F> void updateItemConcurrently(ItemID id, F&& func) {
+        _updatedItems.emplace_back(Update{ id, createUpdateFunctor<T>(std::forward<F>(func)), true });
     }
 
-    void updateItem(ItemID id, const UpdateFunctorPointer& functor);
-    void updateItem(ItemID id) { updateItem(id, nullptr); }
+    // Only refresh the item's key and bound
+    void updateItem(ItemID id) { _updatedItems.emplace_back(Update{ id, nullptr, false }); }
 
     // Selection transactions
     void resetSelection(const Selection& selection);
 
     void merge(const Transaction& transaction);
+    void merge(Transaction&& transaction);
 
     // Checkers if there is work to do when processing the transaction
     bool touchTransactions() const { return !_resetSelections.empty(); }
 
 protected:
 
+    template <class T, class F> class UpdateLambda : public UpdateFunctor<T> {
+    public:
+        UpdateLambda(const F& func) : _func(func) {}
+        UpdateLambda(F&& func) : _func(std::move(func)) {}
+        void apply(T& data) const override { _func(data); }
+        UpdateFunctorInterface* clone(TransactionArena& arena) const override {
+            return new (arena.allocate(sizeof(UpdateLambda), alignof(UpdateLambda))) UpdateLambda(_func);
+        }
+    private:
+        mutable F _func;
+    };
+
+    template <class T, class F> UpdateFunctorInterface* createUpdateFunctor(F&& func) {
+        using Lambda = UpdateLambda<T, typename std::decay<F>::type>;
+        return new (_arena.allocate(sizeof(Lambda), alignof(Lambda))) Lambda(std::forward<F>(func));
+    }
+
+    // Destroys the update functors and empties every list
+    void clear();
+
     using Reset = std::tuple<ItemID, PayloadPointer>;
     using Remove = ItemID;
-    using Update = std::tuple<ItemID, UpdateFunctorPointer>;
+    using Update = std::tuple<ItemID, UpdateFunctorInterface*, bool>; // id, functor (owned by _arena), concurrent
     using TransitionAdd = std::tuple<ItemID, Transition::Type, ItemID>;
     using TransitionQuery = std::tuple<ItemID, TransitionQueryFunc>;
     using TransitionReApply = ItemID;
@@ -91,6 +127,8 @@ protected:
     TransitionQueries _queriedTransitions;
     TransitionReApplies _reAppliedTransitions;
     SelectionResets _resetSelections;
+
+    TransactionArena _arena;
 };
 typedef std::queue<Transaction> TransactionQueue;
 
@@ -116,6 +154,7 @@ public:
 
     // Enqueue transaction to the scene
     void enqueueTransaction(const Transaction& transaction);
+    void enqueueTransaction(Transaction&& transaction);
 
     // Enqueue end of frame transactions boundary
     uint32_t enqueueFrame();
@@ -184,12 +223,25 @@ protected:
     void resetItems(const Transaction::Resets& transactions);
     void removeItems(const Transaction::Removes& transactions);
     void updateItems(const Transaction::Updates& transactions);
+    void updateItemContainer(ItemID id, const ItemKey& oldKey, const ItemCell& oldCell);
     void transitionItems(const Transaction::TransitionAdds& transactions);
     void reApplyTransitions(const Transaction::TransitionReApplies& transactions);
     void queryTransitionItems(const Transaction::TransitionQueries& transactions);
 
     void collectSubItems(ItemID parentId, ItemIDs& subItems) const;
 
+    // Scratch space for updateItems, kept around so applying updates doesn't allocate
+    struct ConcurrentUpdateRun {
+        ItemID id;
+        size_t begin;
+        size_t end;
+        ItemKey oldKey;
+        ItemCell oldCell;
+    };
+    std::vector<bool> _hasSerialUpdate;
+    std::vector<std::pair<ItemID, UpdateFunctorInterface*>> _concurrentUpdates;
+    std::vector<ConcurrentUpdateRun> _concurrentUpdateRuns;
+
     // The Selection map
     mutable std::mutex _selectionsMutex; // mutable so it can be used in the thread safe getSelection const method
     SelectionMap _selections;
@@ -0,0 +1,121 @@
+//
+//  TransactionArena.cpp
+//  render/src/render
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TransactionArena.h"
+
+#include <mutex>
+
+using namespace render;
+
+namespace {
+    // a few MB of blocks is plenty for thousands of updates per frame, anything past that is freed
+    const size_t MAX_POOLED_BLOCKS = 256;
+
+    struct BlockPool {
+        ~BlockPool() {
+            for (auto block : blocks) {
+                delete[] block;
+            }
+        }
+        std::mutex mutex;
+        std::vector<uint8_t*> blocks;
+    } pool;
+
+    uint8_t* acquireBlock() {
+        {
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            if (!pool.blocks.empty()) {
+                uint8_t* block = pool.blocks.back();
+                pool.blocks.pop_back();
+                return block;
+            }
+        }
+        return new uint8_t[TransactionArena::BLOCK_SIZE];
+    }
+
+    void releaseBlock(uint8_t* block) {
+        {
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            if (pool.blocks.size() < MAX_POOLED_BLOCKS) {
+                pool.blocks.push_back(block);
+                return;
+            }
+        }
+        delete[] block;
+    }
+}
+
+TransactionArena::TransactionArena(TransactionArena&& other) :
+    _blocks(std::move(other._blocks)),
+    _cursor(other._cursor),
+    _end(other._end)
+{
+    other._blocks.clear();
+    other._cursor = nullptr;
+    other._end = nullptr;
+}
+
+TransactionArena& TransactionArena::operator=(TransactionArena&& other) {
+    if (this != &other) {
+        clear();
+        std::swap(_blocks, other._blocks);
+        std::swap(_cursor, other._cursor);
+        std::swap(_end, other._end);
+    }
+    return *this;
+}
+
+void* TransactionArena::allocate(size_t size, size_t alignment) {
+    uintptr_t aligned = ((uintptr_t)_cursor + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    if (!_cursor || aligned + size > (uintptr_t)_end) {
+        if (size + alignment > BLOCK_SIZE) {
+            // too big for a pooled block, give it a block of its own and keep bumping through the current one
+            Block block { new uint8_t[size + alignment], size + alignment };
+            _blocks.push_back(block);
+            aligned = ((uintptr_t)block.data + alignment - 1) & ~(uintptr_t)(alignment - 1);
+            return (void*)aligned;
+        }
+        Block block { acquireBlock(), BLOCK_SIZE };
+        _blocks.push_back(block);
+        _cursor = block.data;
+        _end = block.data + BLOCK_SIZE;
+        aligned = ((uintptr_t)_cursor + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    }
+    _cursor = (uint8_t*)(aligned + size);
+    return (void*)aligned;
+}
+
+void TransactionArena::splice(TransactionArena& other) {
+    if (other._blocks.empty()) {
+        return;
+    }
+    // keep allocating from our own current block, other's partially used one is simply left as is
+    _blocks.insert(_blocks.end(), other._blocks.begin(), other._blocks.end());
+    if (!_cursor) {
+        _cursor = other._cursor;
+        _end = other._end;
+    }
+    other._blocks.clear();
+    other._cursor = nullptr;
+    other._end = nullptr;
+}
+
+void TransactionArena::clear() {
+    for (auto& block : _blocks) {
+        if (block.size == BLOCK_SIZE) {
+            releaseBlock(block.data);
+        } else {
+            delete[] block.data;
+        }
+    }
+    _blocks.clear();
+    _cursor = nullptr;
+    _end = nullptr;
+}
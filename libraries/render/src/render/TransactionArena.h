@@ -0,0 +1,59 @@
+//
+//  TransactionArena.h
+//  render/src/render
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_render_TransactionArena_h
+#define hifi_render_TransactionArena_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace render {
+
+// Bump allocator backing the update functors of a Transaction.
+// Memory comes in fixed size blocks from a process wide pool and goes back to it when the arena is cleared, so once the
+// pool has warmed up building and applying transactions doesn't touch the heap.  Blocks never move, which lets merged
+// transactions take over each other's blocks without moving what was constructed in them.
+class TransactionArena {
+public:
+    static const size_t BLOCK_SIZE = 16 * 1024;
+
+    TransactionArena() {}
+    ~TransactionArena() { clear(); }
+
+    TransactionArena(TransactionArena&& other);
+    TransactionArena& operator=(TransactionArena&& other);
+    TransactionArena(const TransactionArena& other) = delete;
+    TransactionArena& operator=(const TransactionArena& other) = delete;
+
+    void* allocate(size_t size, size_t alignment);
+
+    // Takes ownership of all of other's blocks, leaving it empty
+    void splice(TransactionArena& other);
+
+    // Returns every block to the pool, anything constructed in them must have been destroyed already
+    void clear();
+
+    bool empty() const { return _blocks.empty(); }
+
+private:
+    struct Block {
+        uint8_t* data;
+        size_t size;
+    };
+
+    std::vector<Block> _blocks;
+    uint8_t* _cursor { nullptr };
+    uint8_t* _end { nullptr };
+};
+
+}
+
+#endif // hifi_render_TransactionArena_h
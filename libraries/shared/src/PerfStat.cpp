@@ -11,10 +11,12 @@
 
 #include <cstdio>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <QDebug>
-#include <QThread>
+#include <QHash>
 
 #include "PerfStat.h"
 
@@ -80,27 +82,84 @@ void PerformanceTimerRecord::tallyResult(const quint64& now) {
 // ----------------------------------------------------------------------------
 
 std::atomic<bool> PerformanceTimer::_isActive(false);
-QHash<QThread*, QString> PerformanceTimer::_fullNames;
+std::mutex PerformanceTimer::_mutex;
 QMap<QString, PerformanceTimerRecord> PerformanceTimer::_records;
 
+// the names of the timers running on this thread, outermost first
+static thread_local QString threadFullName;
+
+// Timers accumulate into the records of their own thread, which tallyAllTimerRecords merges into _records, so timing
+// on worker threads doesn't contend for one lock. A thread's lock is only ever contended while that merge runs.
+struct ThreadTimerRecords {
+    struct Pending {
+        quint64 elapsedUsec { 0 };
+        quint64 count { 0 };
+    };
+
+    std::mutex mutex;
+    QHash<QString, Pending> pending;
+};
+
+static std::mutex threadRecordsMutex;
+static std::vector<std::shared_ptr<ThreadTimerRecords>> threadRecords; // outlive their threads until the next merge
+
+static ThreadTimerRecords& getThreadTimerRecords() {
+    thread_local std::shared_ptr<ThreadTimerRecords> records = [] {
+        auto records = std::make_shared<ThreadTimerRecords>();
+        std::lock_guard<std::mutex> lock(threadRecordsMutex);
+        threadRecords.push_back(records);
+        return records;
+    }();
+    return *records;
+}
+
+static void accumulateOnThread(const QString& fullName, quint64 elapsedUsec) {
+    ThreadTimerRecords& records = getThreadTimerRecords();
+    std::lock_guard<std::mutex> lock(records.mutex);
+    ThreadTimerRecords::Pending& pending = records.pending[fullName];
+    pending.elapsedUsec += elapsedUsec;
+    ++pending.count;
+}
+
+// moves what each thread has accumulated into records, or drops it if records is null
+static void mergeThreadRecords(QMap<QString, PerformanceTimerRecord>* records) {
+    std::lock_guard<std::mutex> lock(threadRecordsMutex);
+    auto itr = threadRecords.begin();
+    while (itr != threadRecords.end()) {
+        bool hasThreadExited = itr->use_count() == 1;
+        {
+            std::lock_guard<std::mutex> threadLock((*itr)->mutex);
+            if (records) {
+                for (auto pending = (*itr)->pending.cbegin(); pending != (*itr)->pending.cend(); ++pending) {
+                    (*records)[pending.key()].accumulateResults(pending.value().elapsedUsec, pending.value().count);
+                }
+            }
+            (*itr)->pending.clear();
+        }
+        if (hasThreadExited) {
+            itr = threadRecords.erase(itr);
+        } else {
+            ++itr;
+        }
+    }
+}
 
 PerformanceTimer::PerformanceTimer(const QString& name) {
     if (_isActive) {
         _name = name;
-        QString& fullName = _fullNames[QThread::currentThread()];
-        fullName.append("/");
-        fullName.append(_name);
+        threadFullName.append("/");
+        threadFullName.append(_name);
         _start = usecTimestampNow();
     }
 }
 
 PerformanceTimer::~PerformanceTimer() {
-    if (_isActive && _start != 0) {
-        quint64 elapsedUsec = (usecTimestampNow() - _start);
-        QString& fullName = _fullNames[QThread::currentThread()];
-        PerformanceTimerRecord& namedRecord = _records[fullName];
-        namedRecord.accumulateResult(elapsedUsec);
-        fullName.resize(fullName.size() - (_name.size() + 1));
+    if (_start != 0) {
+        if (_isActive) {
+            accumulateOnThread(threadFullName, usecTimestampNow() - _start);
+        }
+        // even if timing was turned off since, so the names on this thread stay balanced
+        threadFullName.resize(threadFullName.size() - (_name.size() + 1));
     }
 }
 
@@ -111,13 +170,12 @@ bool PerformanceTimer::isActive() {
 
 // static
 QString PerformanceTimer::getContextName() {
-    return _fullNames[QThread::currentThread()];
+    return threadFullName;
 }
 
 // static
 void PerformanceTimer::addTimerRecord(const QString& fullName, quint64 elapsedUsec) {
-    PerformanceTimerRecord& namedRecord = _records[fullName];
-    namedRecord.accumulateResult(elapsedUsec);
+    accumulateOnThread(fullName, elapsedUsec);
 }
 
 // static
@@ -125,7 +183,8 @@ void PerformanceTimer::setActive(bool active) {
     if (active != _isActive) {
         _isActive.store(active);
         if (!active) {
-            _fullNames.clear();
+            std::lock_guard<std::mutex> lock(_mutex);
+            mergeThreadRecords(nullptr);
             _records.clear();
         }
 
@@ -135,6 +194,8 @@ void PerformanceTimer::setActive(bool active) {
 
 // static
 void PerformanceTimer::tallyAllTimerRecords() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    mergeThreadRecords(&_records);
     QMap<QString, PerformanceTimerRecord>::iterator recordsItr = _records.begin();
     QMap<QString, PerformanceTimerRecord>::const_iterator recordsEnd = _records.end();
     quint64 now = usecTimestampNow();
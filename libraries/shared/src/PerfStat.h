@@ -21,6 +21,7 @@
 
 #include <atomic>
 #include <cstring>
+#include <mutex>
 #include <string>
 #include <map>
 
@@ -58,6 +59,7 @@ public:
     PerformanceTimerRecord() : _runningTotal(0), _lastTotal(0), _numAccumulations(0), _numTallies(0), _expiry(0) {}
 
     void accumulateResult(const quint64& elapsed) { _runningTotal += elapsed; ++_numAccumulations; }
+    void accumulateResults(const quint64& elapsed, quint64 count) { _runningTotal += elapsed; _numAccumulations += count; }
     void tallyResult(const quint64& now);
     bool isStale(const quint64& now) const { return now > _expiry; }
     quint64 getAverage() const { return (_numTallies == 0) ? 0 : _runningTotal / _numTallies; }
@@ -93,7 +95,7 @@ private:
     quint64 _start = 0;
     QString _name;
     static std::atomic<bool> _isActive;
-    static QHash<QThread*, QString> _fullNames;
+    static std::mutex _mutex; // guards _records, which timers on any thread are merged into when tallied
     static QMap<QString, PerformanceTimerRecord> _records;
 };
 
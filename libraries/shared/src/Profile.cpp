@@ -33,45 +33,53 @@ Q_LOGGING_CATEGORY(trace_simulation_physics_detail, "trace.simulation.physics.de
 #define NSIGHT_TRACING
 #endif
 
-static bool tracingEnabled() {
-    return DependencyManager::isSet<tracing::Tracer>() && DependencyManager::get<tracing::Tracer>()->isEnabled();
-}
+void Duration::begin(tracing::NameID name, uint32_t argbColor, uint64_t payload, const QVariantMap& baseArgs) {
+    static const tracing::NameID PAYLOAD_NAME = tracing::internStaticName("nv_payload");
+    _name = name;
 
-Duration::Duration(const QLoggingCategory& category, const QString& name, uint32_t argbColor, uint64_t payload, const QVariantMap& baseArgs) : _name(name), _category(category) {
-    if (tracingEnabled() && category.isDebugEnabled()) {
+    // Ranges with args of their own only make it into a tracing session, so the flight recorder
+    // records them without the args
+    auto tracer = baseArgs.empty() ? nullptr : DependencyManager::get<tracing::Tracer>();
+    if (tracer && tracer->isEnabled()) {
+        _hasArgs = true;
         QVariantMap args = baseArgs;
         args["nv_payload"] = QVariant::fromValue(payload);
-        tracing::traceEvent(_category, _name, tracing::DurationBegin, "", args);
+        tracer->traceEvent(_category, tracing::nameForID(_name), tracing::DurationBegin, "", args);
+    } else {
+        tracing::record(tracing::categoryID(_category), _name, tracing::DurationBegin, tracing::TraceRecord::UIntArg, payload, PAYLOAD_NAME);
+    }
 
 #if defined(NSIGHT_TRACING)
-        nvtxEventAttributes_t eventAttrib { 0 };
-        eventAttrib.version = NVTX_VERSION;
-        eventAttrib.size = NVTX_EVENT_ATTRIB_STRUCT_SIZE;
-        eventAttrib.colorType = NVTX_COLOR_ARGB;
-        eventAttrib.color = argbColor;
-        eventAttrib.messageType = NVTX_MESSAGE_TYPE_ASCII;
-        eventAttrib.message.ascii = name.toUtf8().data();
-        eventAttrib.payload.llValue = payload;
-        eventAttrib.payloadType = NVTX_PAYLOAD_TYPE_UNSIGNED_INT64;
+    QByteArray message = tracing::nameForID(_name).toUtf8();
+    nvtxEventAttributes_t eventAttrib { 0 };
+    eventAttrib.version = NVTX_VERSION;
+    eventAttrib.size = NVTX_EVENT_ATTRIB_STRUCT_SIZE;
+    eventAttrib.colorType = NVTX_COLOR_ARGB;
+    eventAttrib.color = argbColor;
+    eventAttrib.messageType = NVTX_MESSAGE_TYPE_ASCII;
+    eventAttrib.message.ascii = message.data();
+    eventAttrib.payload.llValue = payload;
+    eventAttrib.payloadType = NVTX_PAYLOAD_TYPE_UNSIGNED_INT64;
 
-        nvtxRangePushEx(&eventAttrib);
+    nvtxRangePushEx(&eventAttrib);
 #endif
-    }
 }
 
-Duration::~Duration() {
-    if (tracingEnabled() && _category.isDebugEnabled()) {
-        tracing::traceEvent(_category, _name, tracing::DurationEnd);
+void Duration::end() {
+    if (_hasArgs) {
+        tracing::traceEvent(_category, tracing::nameForID(_name), tracing::DurationEnd);
+    } else {
+        tracing::record(tracing::categoryID(_category), _name, tracing::DurationEnd);
+    }
 #ifdef NSIGHT_TRACING
-        nvtxRangePop();
+    nvtxRangePop();
 #endif
-    }
 }
 
 // FIXME
 uint64_t Duration::beginRange(const QLoggingCategory& category, const char* name, uint32_t argbColor) {
 #ifdef NSIGHT_TRACING
-    if (tracingEnabled() && category.isDebugEnabled()) {
+    if (tracing::recording() && category.isDebugEnabled()) {
         nvtxEventAttributes_t eventAttrib = { 0 };
         eventAttrib.version = NVTX_VERSION;
         eventAttrib.size = NVTX_EVENT_ATTRIB_STRUCT_SIZE;
@@ -88,7 +96,7 @@ uint64_t Duration::beginRange(const QLoggingCategory& category, const char* name
 // FIXME
 void Duration::endRange(const QLoggingCategory& category, uint64_t rangeId) {
 #ifdef NSIGHT_TRACING
-    if (tracingEnabled() && category.isDebugEnabled()) {
+    if (tracing::recording() && category.isDebugEnabled()) {
         nvtxRangeEnd(rangeId);
     }
 #endif
@@ -35,15 +35,34 @@ Q_DECLARE_LOGGING_CATEGORY(trace_simulation_physics_detail)
 
 class Duration {
 public:
-    Duration(const QLoggingCategory& category, const QString& name, uint32_t argbColor = 0xff0000ff, uint64_t payload = 0, const QVariantMap& args = QVariantMap());
-    ~Duration();
+    // Names that live for the life of the process (string literals, __FUNCTION__) are interned by address
+    template <size_t N>
+    Duration(const QLoggingCategory& category, const char (&name)[N], uint32_t argbColor = 0xff0000ff, uint64_t payload = 0, const QVariantMap& args = QVariantMap()) : _category(category) {
+        if (tracing::recording() && category.isDebugEnabled()) {
+            begin(tracing::internStaticName(name), argbColor, payload, args);
+        }
+    }
+    Duration(const QLoggingCategory& category, const QString& name, uint32_t argbColor = 0xff0000ff, uint64_t payload = 0, const QVariantMap& args = QVariantMap()) : _category(category) {
+        if (tracing::recording() && category.isDebugEnabled()) {
+            begin(tracing::internName(name), argbColor, payload, args);
+        }
+    }
+    ~Duration() {
+        if (_name != tracing::INVALID_NAME_ID) {
+            end();
+        }
+    }
 
     static uint64_t beginRange(const QLoggingCategory& category, const char* name, uint32_t argbColor);
     static void endRange(const QLoggingCategory& category, uint64_t rangeId);
 
 private:
-    QString _name;
+    void begin(tracing::NameID name, uint32_t argbColor, uint64_t payload, const QVariantMap& args);
+    void end();
+
     const QLoggingCategory& _category;
+    tracing::NameID _name { tracing::INVALID_NAME_ID };
+    bool _hasArgs { false };
 };
 
 
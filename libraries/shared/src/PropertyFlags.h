@@ -21,6 +21,7 @@
 
 #include <algorithm>
 #include <climits>
+#include <cstring>
 
 #include <QBitArray>
 #include <QByteArray>
@@ -28,9 +29,129 @@
 #include "ByteCountCoding.h"
 #include "SharedLogging.h"
 
+const int BITS_PER_BYTE = 8;
+
+/// Fixed size stand-in for QBitArray, used as the PropertyFlags storage for enums whose largest flag is known at
+/// compile time. The bits live in an array of words inside the object so copies and set operations never allocate.
+/// Only the part of the QBitArray interface that PropertyFlags needs is provided, with the same semantics.
+template<int NumBits> class FixedBitArray {
+public:
+    static const int BITS_PER_WORD = 64;
+    static const int NUM_WORDS = (NumBits + BITS_PER_WORD - 1) / BITS_PER_WORD;
+
+    int size() const { return _size; }
+    void clear() { resize(0); }
+    void resize(int size);
+
+    bool testBit(int i) const { return (_words[i / BITS_PER_WORD] & bitMask(i)) != 0; }
+    void setBit(int i, bool value);
+    bool at(int i) const { return testBit(i); }
+    bool operator[](int i) const { return testBit(i); }
+
+    bool operator==(const FixedBitArray& other) const;
+    bool operator!=(const FixedBitArray& other) const { return !(*this == other); }
+
+    FixedBitArray& operator|=(const FixedBitArray& other);
+    FixedBitArray& operator&=(const FixedBitArray& other);
+    FixedBitArray& operator^=(const FixedBitArray& other);
+    FixedBitArray operator~() const;
+
+private:
+    static uint64_t bitMask(int i) { return (uint64_t)1 << (i % BITS_PER_WORD); }
+    void clearBitsFrom(int first);
+
+    uint64_t _words[NUM_WORDS] { };
+    int _size { 0 };
+};
+
+template<int NumBits> inline void FixedBitArray<NumBits>::resize(int size) {
+    size = std::max(0, std::min(size, NumBits));
+    if (size < _size) {
+        clearBitsFrom(size);
+    }
+    _size = size;
+}
+
+template<int NumBits> inline void FixedBitArray<NumBits>::setBit(int i, bool value) {
+    if (value) {
+        _words[i / BITS_PER_WORD] |= bitMask(i);
+    } else {
+        _words[i / BITS_PER_WORD] &= ~bitMask(i);
+    }
+}
+
+template<int NumBits> inline void FixedBitArray<NumBits>::clearBitsFrom(int first) {
+    int word = first / BITS_PER_WORD;
+    if (word < NUM_WORDS) {
+        int bit = first % BITS_PER_WORD;
+        if (bit > 0) {
+            _words[word] &= ((uint64_t)1 << bit) - 1;
+            ++word;
+        }
+        for (; word < NUM_WORDS; ++word) {
+            _words[word] = 0;
+        }
+    }
+}
+
+template<int NumBits> inline bool FixedBitArray<NumBits>::operator==(const FixedBitArray& other) const {
+    // bits past _size are always kept clear, so whole words can be compared
+    return _size == other._size && memcmp(_words, other._words, sizeof(_words)) == 0;
+}
+
+template<int NumBits> inline FixedBitArray<NumBits>& FixedBitArray<NumBits>::operator|=(const FixedBitArray& other) {
+    for (int i = 0; i < NUM_WORDS; ++i) {
+        _words[i] |= other._words[i];
+    }
+    _size = std::max(_size, other._size);
+    return *this;
+}
+
+template<int NumBits> inline FixedBitArray<NumBits>& FixedBitArray<NumBits>::operator&=(const FixedBitArray& other) {
+    for (int i = 0; i < NUM_WORDS; ++i) {
+        _words[i] &= other._words[i];
+    }
+    _size = std::max(_size, other._size);
+    return *this;
+}
+
+template<int NumBits> inline FixedBitArray<NumBits>& FixedBitArray<NumBits>::operator^=(const FixedBitArray& other) {
+    for (int i = 0; i < NUM_WORDS; ++i) {
+        _words[i] ^= other._words[i];
+    }
+    _size = std::max(_size, other._size);
+    return *this;
+}
+
+template<int NumBits> inline FixedBitArray<NumBits> FixedBitArray<NumBits>::operator~() const {
+    FixedBitArray result(*this);
+    for (int i = 0; i < NUM_WORDS; ++i) {
+        result._words[i] = ~_words[i];
+    }
+    result.clearBitsFrom(_size);
+    return result;
+}
+
+/// By default PropertyFlags<Enum> keeps its bits in a QBitArray that grows as flags are set. Enums with a known
+/// maximum can specialize this to use fixed, allocation-free storage:
+///
+///     template<> struct PropertyFlagsStorage<MyPropertyList> : FixedPropertyFlagsStorage<MY_PROP_COUNT> {};
+///
+template<typename Enum> struct PropertyFlagsStorage {
+    using type = QBitArray;
+    static const int MAX_FLAGS = INT_MAX;
+};
+
+template<int NumFlags> struct FixedPropertyFlagsStorage {
+    using type = FixedBitArray<NumFlags>;
+    static const int MAX_FLAGS = NumFlags;
+    static const int MAX_ENCODED_SIZE = ((NumFlags - 1) / (BITS_PER_BYTE - 1)) + 1;
+};
+
 template<typename Enum>class PropertyFlags {
 public:
     typedef Enum enum_type;
+    typedef typename PropertyFlagsStorage<Enum>::type storage_type;
     inline PropertyFlags() : 
             _maxFlag(INT_MIN), _minFlag(INT_MAX), _trailingFlipped(false), _encodedLength(0) { };
 
@@ -53,6 +174,9 @@ public:
     void setHasProperty(Enum flag, bool value = true);
     bool getHasProperty(Enum flag) const;
     QByteArray encode();
+    int getEncodedSize() const { return _maxFlag < _minFlag ? 1 : (_maxFlag / (BITS_PER_BYTE - 1)) + 1; }
+    /// encodes into a caller supplied buffer without allocating, returns the bytes written or 0 if it doesn't fit
+    int encode(uint8_t* buffer, int bufferSize);
     size_t decode(const uint8_t* data, size_t length);
     size_t decode(const QByteArray& fromEncoded);
 
@@ -111,7 +235,7 @@ public:
 private:
     void shrinkIfNeeded();
 
-    QBitArray _flags;
+    storage_type _flags;
     int _maxFlag;
     int _minFlag;
     bool _trailingFlipped; /// are the trailing properties flipping in their state (e.g. assumed true, instead of false)
@@ -128,6 +252,10 @@ template<typename Enum> PropertyFlags<Enum>& operator<<(PropertyFlags<Enum>& out
 
 
 template<typename Enum> inline void PropertyFlags<Enum>::setHasProperty(Enum flag, bool value) {
+    if ((int)flag >= PropertyFlagsStorage<Enum>::MAX_FLAGS) {
+        return; // fixed storage can't hold flags past the end of the enum, e.g. from a newer protocol version
+    }
+
     // keep track of our min flag
     if (flag < _minFlag) {
         if (value) {
@@ -156,44 +284,38 @@ template<typename Enum> inline bool PropertyFlags<Enum>::getHasProperty(Enum fla
     return _flags.testBit(flag);
 }
 
-const int BITS_PER_BYTE = 8;
-
 template<typename Enum> inline QByteArray PropertyFlags<Enum>::encode() {
-    QByteArray output;
-    
-    if (_maxFlag < _minFlag) {
-        output.fill(0, 1);
-        return output; // no flags... nothing to encode
-    }
+    QByteArray output(getEncodedSize(), 0);
+    encode(reinterpret_cast<uint8_t*>(output.data()), output.size());
+    return output;
+}
 
-    // we should size the array to the correct size.
-    int lengthInBytes = (_maxFlag / (BITS_PER_BYTE - 1)) + 1;
+template<typename Enum> inline int PropertyFlags<Enum>::encode(uint8_t* buffer, int bufferSize) {
+    int lengthInBytes = getEncodedSize();
+    if (bufferSize < lengthInBytes) {
+        return 0;
+    }
+    memset(buffer, 0, lengthInBytes);
 
-    output.fill(0, lengthInBytes);
+    if (_maxFlag < _minFlag) {
+        return 1; // no flags... nothing to encode
+    }
 
-    // next pack the number of header bits in, the first N-1 to be set to 1, the last to be set to 0
-    for(int i = 0; i < lengthInBytes; i++) {
-        int outputIndex = i;
-        int bitValue = (i < (lengthInBytes - 1)  ? 1 : 0);
-        char original = output.at(outputIndex / BITS_PER_BYTE);
-        int shiftBy = BITS_PER_BYTE - ((outputIndex % BITS_PER_BYTE) + 1);
-        char thisBit = ( bitValue << shiftBy);
-        output[i / BITS_PER_BYTE] = (original | thisBit);
+    // first pack the number of header bits in, the first N-1 to be set to 1, the last to be set to 0
+    for (int i = 0; i < lengthInBytes - 1; i++) {
+        buffer[i / BITS_PER_BYTE] |= (uint8_t)(0x80 >> (i % BITS_PER_BYTE));
     }
 
     // finally pack the the actual bits from the bit array
-    for(int i = lengthInBytes; i < (lengthInBytes + _maxFlag + 1); i++) {
-        int flagIndex = i - lengthInBytes;
-        int outputIndex = i;
-        int bitValue = ( _flags[flagIndex]  ? 1 : 0);
-        char original = output.at(outputIndex / BITS_PER_BYTE);
-        int shiftBy = BITS_PER_BYTE - ((outputIndex % BITS_PER_BYTE) + 1);
-        char thisBit = ( bitValue << shiftBy);
-        output[i / BITS_PER_BYTE] = (original | thisBit);
+    for (int flagIndex = 0; flagIndex <= _maxFlag; flagIndex++) {
+        if (_flags.testBit(flagIndex)) {
+            int outputIndex = lengthInBytes + flagIndex;
+            buffer[outputIndex / BITS_PER_BYTE] |= (uint8_t)(0x80 >> (outputIndex % BITS_PER_BYTE));
+        }
     }
-    
+
     _encodedLength = lengthInBytes;
-    return output;
+    return lengthInBytes;
 }
 
 template<typename Enum> 
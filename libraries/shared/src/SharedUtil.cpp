@@ -44,7 +44,12 @@ extern "C" FILE * __cdecl __iob_func(void) {
 #include <CoreFoundation/CoreFoundation.h>
 #endif
 
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
 #include <QtCore/QDebug>
+#include <QtCore/QFile>
 #include <QDateTime>
 #include <QElapsedTimer>
 #include <QTimer>
@@ -888,6 +893,25 @@ bool getMemoryInfo(MemoryInfo& info) {
     return false;
 }
 
+uint64_t getProcessResidentBytes() {
+#ifdef Q_OS_LINUX
+    // the second field is the resident set, in pages
+    QFile statm("/proc/self/statm");
+    if (statm.open(QIODevice::ReadOnly)) {
+        QList<QByteArray> fields = statm.readAll().split(' ');
+        if (fields.size() > 1) {
+            return fields[1].toULongLong() * (uint64_t)sysconf(_SC_PAGESIZE);
+        }
+    }
+#endif
+
+    MemoryInfo info;
+    if (getMemoryInfo(info)) {
+        return info.processUsedMemoryBytes;
+    }
+    return 0;
+}
+
 // Largely taken from: https://msdn.microsoft.com/en-us/library/windows/desktop/ms683194(v=vs.85).aspx
 
 #ifdef Q_OS_WIN
@@ -220,6 +220,10 @@ struct MemoryInfo {
 
 bool getMemoryInfo(MemoryInfo& info);
 
+// Bytes of this process currently resident in physical memory, for measuring what a piece of code touches.
+// On Linux this counts pages mapped from files as well, elsewhere it falls back to getMemoryInfo's process usage.
+uint64_t getProcessResidentBytes();
+
 struct ProcessorInfo {
     int32_t numPhysicalProcessorPackages;
     int32_t numProcessorCores;
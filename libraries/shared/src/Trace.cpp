@@ -8,6 +8,7 @@
 
 #include "Trace.h"
 
+#include <algorithm>
 #include <chrono>
 
 #include <QtCore/QDebug>
@@ -24,6 +25,7 @@
 #include <QtCore/QDataStream>
 #include <QtCore/QTextStream>
 
+#include <QtCore/QJsonArray>
 #include <QtCore/QJsonObject>
 #include <QtCore/QJsonDocument>
 
@@ -39,24 +41,162 @@ bool tracing::enabled() {
     return DependencyManager::get<Tracer>()->isEnabled();
 }
 
+// how often the writer drains the thread buffers while tracing, well inside the time it takes a busy thread to wrap
+static const std::chrono::milliseconds DRAIN_INTERVAL { 100 };
+
+Tracer::~Tracer() {
+    if (_enabled || _flightRecording) {
+        _enabled = false;
+        _flightRecording = false;
+        updateRecording();
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(_writerMutex);
+        _writerQuit = true;
+    }
+    _writerCondition.notify_all();
+    if (_writerThread.joinable()) {
+        _writerThread.join();
+    }
+}
+
 void Tracer::startTracing() {
-    std::lock_guard<std::mutex> guard(_eventsMutex);
-    if (_enabled) {
-        qWarning() << "Tried to enable tracer, but already enabled";
-        return;
+    {
+        std::lock_guard<std::mutex> guard(_eventsMutex);
+        if (_enabled) {
+            qWarning() << "Tried to enable tracer, but already enabled";
+            return;
+        }
+
+        _events.clear();
+    }
+
+    {
+        // start each thread's session at its current head, so the session only holds events from now on
+        std::lock_guard<std::mutex> guard(_recordsMutex);
+        _threadRecords.clear();
+        for (auto& buffer : TraceBuffer::buffers()) {
+            ThreadRecords thread;
+            thread.buffer = buffer;
+            thread.position = buffer->head();
+            _threadRecords.push_back(std::move(thread));
+        }
     }
 
-    _events.clear();
     _enabled = true;
+    updateRecording();
+    startWriter();
 }
 
 void Tracer::stopTracing() {
-    std::lock_guard<std::mutex> guard(_eventsMutex);
-    if (!_enabled) {
-        qWarning() << "Cannot stop tracing, already disabled";
-        return;
+    {
+        std::lock_guard<std::mutex> guard(_eventsMutex);
+        if (!_enabled) {
+            qWarning() << "Cannot stop tracing, already disabled";
+            return;
+        }
+        _enabled = false;
     }
-    _enabled = false;
+    updateRecording();
+    drain();
+}
+
+void Tracer::startFlightRecorder() {
+    _flightRecording = true;
+    updateRecording();
+    startWriter();
+}
+
+void Tracer::stopFlightRecorder() {
+    _flightRecording = false;
+    updateRecording();
+}
+
+void Tracer::updateRecording() {
+    setRecording(_enabled || _flightRecording);
+}
+
+void Tracer::startWriter() {
+    std::lock_guard<std::mutex> guard(_writerMutex);
+    if (!_writerThread.joinable()) {
+        _writerThread = std::thread(&Tracer::writerLoop, this);
+    }
+}
+
+void Tracer::writerLoop() {
+    std::unique_lock<std::mutex> lock(_writerMutex);
+    while (!_writerQuit) {
+        _writerCondition.wait_for(lock, DRAIN_INTERVAL, [this] {
+            return _writerQuit || !_pendingDumps.empty();
+        });
+
+        std::vector<QString> dumps;
+        dumps.swap(_pendingDumps);
+        lock.unlock();
+
+        if (_enabled) {
+            drain();
+        }
+        for (const auto& path : dumps) {
+            auto written = writeFlightRecorder(path);
+            if (written.isEmpty()) {
+                qWarning() << "Failed to write flight recorder trace to" << path;
+            } else {
+                qDebug() << "Wrote flight recorder trace to" << written;
+            }
+        }
+
+        lock.lock();
+    }
+}
+
+void Tracer::drain() {
+    auto buffers = TraceBuffer::buffers();
+
+    std::lock_guard<std::mutex> guard(_recordsMutex);
+    for (auto& buffer : buffers) {
+        auto it = std::find_if(_threadRecords.begin(), _threadRecords.end(), [&](const ThreadRecords& thread) {
+            return thread.buffer == buffer;
+        });
+        if (it == _threadRecords.end()) {
+            // a thread that started recording during the session
+            ThreadRecords thread;
+            thread.buffer = buffer;
+            _threadRecords.push_back(std::move(thread));
+            it = _threadRecords.end() - 1;
+        }
+        it->lost += it->buffer->read(it->position, it->records);
+    }
+}
+
+void Tracer::dumpFlightRecorder(const QString& path) {
+    startWriter();
+    {
+        std::lock_guard<std::mutex> guard(_writerMutex);
+        _pendingDumps.push_back(path);
+    }
+    _writerCondition.notify_one();
+}
+
+QString Tracer::writeFlightRecorder(const QString& path) {
+    std::vector<ThreadRecords> threads;
+    for (auto& buffer : TraceBuffer::buffers()) {
+        ThreadRecords thread;
+        thread.buffer = buffer;
+        buffer->read(thread.position, thread.records);
+        if (!thread.records.empty()) {
+            threads.push_back(std::move(thread));
+        }
+    }
+
+    std::list<TraceEvent> metadataEvents;
+    {
+        std::lock_guard<std::mutex> guard(_eventsMutex);
+        metadataEvents = _metadataEvents;
+    }
+
+    return write(path, metadataEvents, threads);
 }
 
 void TraceEvent::writeJson(QTextStream& out) const {
@@ -104,7 +244,75 @@ void TraceEvent::writeJson(QTextStream& out) const {
 #endif
 }
 
-void Tracer::serialize(const QString& originalPath) {
+static void writeJsonString(QTextStream& out, const QString& value) {
+    // QJsonDocument has no standalone string serialization, so strip the enclosing array
+    auto json = QJsonDocument(QJsonArray { value }).toJson(QJsonDocument::Compact);
+    out << json.mid(1, json.size() - 2);
+}
+
+static void writeRecordJson(QTextStream& out, const TraceRecord& record, const std::vector<QString>& names,
+                            qint64 processID, int64_t threadID) {
+    // timestamps are recorded in nsecs, but the trace format is in usecs
+    out << "{\"name\":" << names[record.name];
+    out << ",\"cat\":" << names[record.category];
+    out << ",\"ph\":\"" << (char)record.type << '"';
+    out << ",\"ts\":" << (qulonglong)(record.timestamp / 1000) << '.'
+        << QString::number((uint)(record.timestamp % 1000)).rightJustified(3, '0');
+    out << ",\"pid\":" << processID;
+    out << ",\"tid\":" << (qlonglong)threadID;
+    if (record.scope) {
+        out << ",\"s\":\"" << record.scope << '"';
+    }
+    if (record.argType != TraceRecord::NoArg) {
+        out << ",\"args\":{" << names[record.argName] << ':';
+        if (record.argType == TraceRecord::DoubleArg) {
+            out << QString::number(record.doubleValue, 'g', 17);
+        } else {
+            out << (qulonglong)record.uintValue;
+        }
+        out << '}';
+    }
+    out << '}';
+}
+
+void Tracer::serialize(const QString& path) {
+    if (_enabled) {
+        drain();
+    }
+
+    std::list<TraceEvent> currentEvents;
+    {
+        std::lock_guard<std::mutex> guard(_eventsMutex);
+        currentEvents.swap(_events);
+        for (auto& event : _metadataEvents) {
+            currentEvents.push_back(event);
+        }
+    }
+
+    // keep the read positions, in case the session is still running
+    std::vector<ThreadRecords> currentThreads;
+    {
+        std::lock_guard<std::mutex> guard(_recordsMutex);
+        for (auto& thread : _threadRecords) {
+            ThreadRecords current;
+            current.buffer = thread.buffer;
+            current.lost = thread.lost;
+            current.records.swap(thread.records);
+            thread.lost = 0;
+            currentThreads.push_back(std::move(current));
+        }
+    }
+
+    for (const auto& thread : currentThreads) {
+        if (thread.lost > 0) {
+            qWarning() << "Thread" << thread.buffer->getThreadID() << "overwrote" << thread.lost << "trace events before they were written";
+        }
+    }
+
+    write(path, currentEvents, currentThreads);
+}
+
+QString Tracer::write(const QString& originalPath, const std::list<TraceEvent>& events, const std::vector<ThreadRecords>& threads) {
 
     QString path = originalPath;
 
@@ -126,20 +334,9 @@ void Tracer::serialize(const QString& originalPath) {
         }
     }
 
-
-
-    std::list<TraceEvent> currentEvents;
-    {
-        std::lock_guard<std::mutex> guard(_eventsMutex);
-        currentEvents.swap(_events);
-        for (auto& event : _metadataEvents) {
-            currentEvents.push_back(event);
-        }
-    }
-
     // If the file exists and we can't remove it, fail early
     if (QFileInfo(path).exists() && !QFile::remove(path)) {
-        return;
+        return QString();
     }
 
     // If we can't open a temp file for writing, fail early
@@ -148,7 +345,7 @@ void Tracer::serialize(const QString& originalPath) {
         QTextStream out(&data);
         out << "[\n";
         bool first = true;
-        for (const auto& event : currentEvents) {
+        for (const auto& event : events) {
             if (first) {
                 first = false;
             } else {
@@ -156,6 +353,29 @@ void Tracer::serialize(const QString& originalPath) {
             }
             event.writeJson(out);
         }
+
+        // names are escaped once up front, rather than for every record
+        std::vector<QString> names;
+        for (const auto& name : internedNames()) {
+            QString escaped;
+            QTextStream nameOut(&escaped);
+            writeJsonString(nameOut, name);
+            nameOut.flush();
+            names.push_back(escaped);
+        }
+
+        auto processID = QCoreApplication::applicationPid();
+        for (const auto& thread : threads) {
+            auto threadID = thread.buffer->getThreadID();
+            for (const auto& record : thread.records) {
+                if (first) {
+                    first = false;
+                } else {
+                    out << ",\n";
+                }
+                writeRecordJson(out, record, names, processID, threadID);
+            }
+        }
         out << "\n]";
     }
 
@@ -168,12 +388,14 @@ void Tracer::serialize(const QString& originalPath) {
     {
         QFile file(path);
         if (!file.open(QIODevice::WriteOnly)) {
-            return;
+            return QString();
         }
         file.write(data);
         file.close();
     }
 
+    return path;
+
 #if 0
     QByteArray data;
     {
@@ -240,9 +462,52 @@ void Tracer::traceEvent(const QLoggingCategory& category,
     }
 }
 
+// Whether an event fits a TraceRecord: no id, at most one numeric arg, and no extra fields other than an instant's scope
+static bool fitsRecord(EventType type, const QString& id, const QVariantMap& args, const QVariantMap& extra) {
+    if (!id.isEmpty() || args.size() > 1) {
+        return false;
+    }
+    if (!args.empty()) {
+        auto argType = (QMetaType::Type)args.first().type();
+        if (argType != QMetaType::Int && argType != QMetaType::UInt && argType != QMetaType::LongLong &&
+            argType != QMetaType::ULongLong && argType != QMetaType::Float && argType != QMetaType::Double) {
+            return false;
+        }
+    }
+    if (type == Instant) {
+        return extra.size() == 1 && extra.contains("s") && extra.first().toString().size() == 1;
+    }
+    return extra.empty();
+}
+
 void Tracer::traceEvent(const QLoggingCategory& category, 
     const QString& name, EventType type, const QString& id, 
     const QVariantMap& args, const QVariantMap& extra) {
+    if (type != Metadata && !recording()) {
+        return;
+    }
+
+    if (type != Metadata && fitsRecord(type, id, args, extra)) {
+        auto recordCategory = categoryID(category);
+        auto nameID = internName(name);
+        if (type == Instant) {
+            recordInstant(recordCategory, nameID, extra.first().toString()[0].toLatin1());
+        } else if (args.empty()) {
+            record(recordCategory, nameID, type);
+        } else {
+            auto argName = internName(args.firstKey());
+            const auto& value = args.first();
+            auto argType = (QMetaType::Type)value.type();
+            if (argType == QMetaType::Float || argType == QMetaType::Double || value.toLongLong() < 0) {
+                record(recordCategory, nameID, type, argName, value.toDouble());
+            } else {
+                record(recordCategory, nameID, type, TraceRecord::UIntArg, value.toULongLong(), argName);
+            }
+        }
+        return;
+    }
+
+    // Anything else is only kept for a tracing session
     if (!_enabled && type != Metadata) {
         return;
     }
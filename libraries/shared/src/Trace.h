@@ -10,8 +10,12 @@
 #ifndef hifi_Trace_h
 #define hifi_Trace_h
 
+#include <condition_variable>
 #include <cstdint>
+#include <list>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 #include <QtCore/QString>
 #include <QtCore/QVariantMap>
@@ -20,6 +24,7 @@
 #include <QtCore/QLoggingCategory>
 
 #include "DependencyManager.h"
+#include "TraceBuffer.h"
 
 namespace tracing {
 
@@ -76,8 +81,13 @@ struct TraceEvent {
     void writeJson(QTextStream& out) const;
 };
 
+// Events with a fixed shape (ranges, single value counters, instants) are recorded without locks into the
+// recording thread's TraceBuffer, and a background writer drains them while tracing. Anything else (ids,
+// arbitrary args) takes the slower path through _events and is only kept while tracing.
 class Tracer : public Dependency {
 public:
+    ~Tracer();
+
     void traceEvent(const QLoggingCategory& category, 
         const QString& name, EventType type,
         const QString& id = "", 
@@ -88,20 +98,57 @@ public:
     void serialize(const QString& file);
     bool isEnabled() const { return _enabled; }
 
+    // The flight recorder keeps the fixed shape events recording into each thread's ring buffer without a
+    // tracing session, so the last few seconds of every thread can be dumped on demand.
+    void startFlightRecorder();
+    void stopFlightRecorder();
+    bool isFlightRecording() const { return _flightRecording; }
+    // Queues a dump of the flight recorder to file for the writer thread
+    void dumpFlightRecorder(const QString& file);
+    // Writes the flight recorder to file on the calling thread, returning the path written or empty on failure
+    QString writeFlightRecorder(const QString& file);
+
 private:
+    struct ThreadRecords {
+        std::shared_ptr<TraceBuffer> buffer;
+        uint64_t position { 0 };
+        uint64_t lost { 0 };
+        std::vector<TraceRecord> records;
+    };
+
+    void updateRecording();
+    void startWriter();
+    void writerLoop();
+    void drain();
+    QString write(const QString& path, const std::list<TraceEvent>& events, const std::vector<ThreadRecords>& threads);
+
     void traceEvent(const QLoggingCategory& category, 
         const QString& name, EventType type,
         qint64 timestamp, qint64 processID, qint64 threadID,
         const QString& id = "",
         const QVariantMap& args = QVariantMap(), const QVariantMap& extra = QVariantMap());
 
-    bool _enabled { false };
+    std::atomic<bool> _enabled { false };
+    std::atomic<bool> _flightRecording { false };
     std::list<TraceEvent> _events;
     std::list<TraceEvent> _metadataEvents;
     std::mutex _eventsMutex;
+
+    // records drained from the thread buffers during the tracing session
+    std::vector<ThreadRecords> _threadRecords;
+    std::mutex _recordsMutex;
+
+    std::thread _writerThread;
+    std::mutex _writerMutex;
+    std::condition_variable _writerCondition;
+    std::vector<QString> _pendingDumps;
+    bool _writerQuit { false };
 };
 
 inline void traceEvent(const QLoggingCategory& category, const QString& name, EventType type, const QString& id = "", const QVariantMap& args = {}, const QVariantMap& extra = {}) {
+    if (type != Metadata && !recording()) {
+        return;
+    }
     const auto& tracer = DependencyManager::get<Tracer>();
     if (tracer) {
         tracer->traceEvent(category, name, type, id, args, extra);
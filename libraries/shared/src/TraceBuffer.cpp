@@ -0,0 +1,238 @@
+//
+//  TraceBuffer.cpp
+//  libraries/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TraceBuffer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+#include <QtCore/QHash>
+#include <QtCore/QThread>
+
+#include "Trace.h"
+#include "PortableHighResolutionClock.h"
+
+using namespace tracing;
+
+namespace {
+
+class NameTable {
+public:
+    NameTable() {
+        _names.push_back(QString());    // INVALID_NAME_ID
+    }
+
+    NameID intern(const QString& name) {
+        std::lock_guard<std::mutex> guard(_mutex);
+        auto it = _ids.find(name);
+        if (it != _ids.end()) {
+            return it.value();
+        }
+        NameID id = (NameID)_names.size();
+        _names.push_back(name);
+        _ids.insert(name, id);
+        return id;
+    }
+
+    QString name(NameID id) {
+        std::lock_guard<std::mutex> guard(_mutex);
+        return id < _names.size() ? _names[id] : QString();
+    }
+
+    std::vector<QString> names() {
+        std::lock_guard<std::mutex> guard(_mutex);
+        return _names;
+    }
+
+private:
+    std::mutex _mutex;
+    QHash<QString, NameID> _ids;
+    std::vector<QString> _names;
+};
+
+NameTable& nameTable() {
+    static NameTable table;
+    return table;
+}
+
+// direct mapped, keyed by the address of the static name
+struct StaticNameCache {
+    static const size_t SIZE = 256;
+    const char* keys[SIZE] {};
+    NameID ids[SIZE] {};
+};
+thread_local StaticNameCache staticNameCache;
+
+// Threads come and go (thread pools, script engines), so only the buffers of the most recently
+// exited threads are kept around for the flight recorder and the tracer's final drain.
+const size_t MAX_RETIRED_BUFFERS = 16;
+
+class BufferRegistry {
+public:
+    void add(const std::shared_ptr<TraceBuffer>& buffer) {
+        std::lock_guard<std::mutex> guard(_mutex);
+        size_t retired = std::count_if(_buffers.begin(), _buffers.end(), [](const std::shared_ptr<TraceBuffer>& buffer) {
+            return buffer->isRetired();
+        });
+        for (auto it = _buffers.begin(); retired > MAX_RETIRED_BUFFERS && it != _buffers.end(); ) {
+            if ((*it)->isRetired()) {
+                it = _buffers.erase(it);
+                --retired;
+            } else {
+                ++it;
+            }
+        }
+        _buffers.push_back(buffer);
+    }
+
+    std::vector<std::shared_ptr<TraceBuffer>> buffers() {
+        std::lock_guard<std::mutex> guard(_mutex);
+        return _buffers;
+    }
+
+private:
+    std::mutex _mutex;
+    std::vector<std::shared_ptr<TraceBuffer>> _buffers;
+};
+
+BufferRegistry& bufferRegistry() {
+    static BufferRegistry registry;
+    return registry;
+}
+
+struct LocalBuffer {
+    LocalBuffer() : buffer(std::make_shared<TraceBuffer>(int64_t(QThread::currentThreadId()))) {
+        bufferRegistry().add(buffer);
+    }
+    ~LocalBuffer() {
+        buffer->retire();
+    }
+    std::shared_ptr<TraceBuffer> buffer;
+};
+
+std::atomic<bool> recordingFlag { false };
+
+inline uint64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(p_high_resolution_clock::now().time_since_epoch()).count();
+}
+
+}
+
+NameID tracing::internName(const QString& name) {
+    return nameTable().intern(name);
+}
+
+NameID tracing::internStaticName(const char* name) {
+    auto& cache = staticNameCache;
+    size_t index = (reinterpret_cast<uintptr_t>(name) >> 3) & (StaticNameCache::SIZE - 1);
+    if (cache.keys[index] != name) {
+        cache.ids[index] = nameTable().intern(QString::fromUtf8(name));
+        cache.keys[index] = name;
+    }
+    return cache.ids[index];
+}
+
+QString tracing::nameForID(NameID id) {
+    return nameTable().name(id);
+}
+
+std::vector<QString> tracing::internedNames() {
+    return nameTable().names();
+}
+
+uint64_t TraceBuffer::read(uint64_t& position, std::vector<TraceRecord>& records) const {
+    uint64_t head = _head.load(std::memory_order_acquire);
+    uint64_t begin = std::max(position, head > CAPACITY ? head - CAPACITY : 0);
+
+    size_t offset = records.size();
+    for (uint64_t i = begin; i < head; ++i) {
+        records.push_back(_records[i & MASK]);
+    }
+
+    // Anything the writer may have started overwriting while we copied is stale. The writer can be
+    // at most one record past the head we read, which overwrites record (head + 1 - CAPACITY).
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t newHead = _head.load(std::memory_order_relaxed);
+    uint64_t oldest = newHead + 1 > CAPACITY ? newHead + 1 - CAPACITY : 0;
+    if (oldest > begin) {
+        size_t stale = (size_t)std::min(oldest - begin, head - begin);
+        records.erase(records.begin() + offset, records.begin() + offset + stale);
+        begin += stale;
+    }
+
+    uint64_t lost = begin - position;
+    position = head;
+    return lost;
+}
+
+TraceBuffer& TraceBuffer::local() {
+    // a plain pointer avoids the guard check of the non-trivial thread_local on every event
+    thread_local TraceBuffer* buffer { nullptr };
+    if (!buffer) {
+        thread_local LocalBuffer localBuffer;
+        buffer = localBuffer.buffer.get();
+    }
+    return *buffer;
+}
+
+std::vector<std::shared_ptr<TraceBuffer>> TraceBuffer::buffers() {
+    return bufferRegistry().buffers();
+}
+
+void tracing::record(NameID category, NameID name, EventType type, TraceRecord::ArgType argType, uint64_t uintValue, NameID argName) {
+    TraceRecord record;
+    record.timestamp = now();
+    record.uintValue = uintValue;
+    record.name = name;
+    record.category = category;
+    record.argName = argName;
+    record.type = type;
+    record.argType = argType;
+    record.scope = 0;
+    record.padding = 0;
+    TraceBuffer::local().push(record);
+}
+
+void tracing::record(NameID category, NameID name, EventType type, NameID argName, double value) {
+    TraceRecord record;
+    record.timestamp = now();
+    record.doubleValue = value;
+    record.name = name;
+    record.category = category;
+    record.argName = argName;
+    record.type = type;
+    record.argType = TraceRecord::DoubleArg;
+    record.scope = 0;
+    record.padding = 0;
+    TraceBuffer::local().push(record);
+}
+
+void tracing::recordInstant(NameID category, NameID name, char scope) {
+    TraceRecord record;
+    record.timestamp = now();
+    record.uintValue = 0;
+    record.name = name;
+    record.category = category;
+    record.argName = INVALID_NAME_ID;
+    record.type = Instant;
+    record.argType = TraceRecord::NoArg;
+    record.scope = scope;
+    record.padding = 0;
+    TraceBuffer::local().push(record);
+}
+
+bool tracing::recording() {
+    return recordingFlag.load(std::memory_order_relaxed);
+}
+
+void tracing::setRecording(bool recording) {
+    recordingFlag.store(recording, std::memory_order_relaxed);
+}
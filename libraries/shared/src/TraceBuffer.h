@@ -0,0 +1,121 @@
+//
+//  TraceBuffer.h
+//  libraries/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_TraceBuffer_h
+#define hifi_TraceBuffer_h
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QString>
+#include <QtCore/QLoggingCategory>
+
+namespace tracing {
+
+enum EventType : char;
+
+// Trace names and categories are interned into small IDs so a recorded event is a fixed size binary record.
+// IDs are never released, so only intern names from a bounded set (function names, literals, script names).
+using NameID = uint32_t;
+const NameID INVALID_NAME_ID = 0;
+
+NameID internName(const QString& name);
+// Interns a name that lives for the life of the process (a string literal or __FUNCTION__).
+// Lookups are cached per thread by address, so repeated calls don't hash or copy the string.
+NameID internStaticName(const char* name);
+QString nameForID(NameID id);
+// Snapshot of every interned name, indexed by NameID
+std::vector<QString> internedNames();
+
+struct TraceRecord {
+    enum ArgType : uint8_t {
+        NoArg = 0,
+        UIntArg,
+        DoubleArg
+    };
+
+    uint64_t timestamp;     // nsecs, p_high_resolution_clock
+    union {
+        uint64_t uintValue;
+        double doubleValue;
+    };
+    NameID name;
+    NameID category;
+    NameID argName;
+    EventType type;
+    ArgType argType;
+    char scope;             // instant events only
+    uint8_t padding;
+};
+static_assert(sizeof(TraceRecord) == 32, "TraceRecord should stay a compact 32 bytes");
+
+// Single producer ring of trace records, written without locks by the thread that owns it.
+// Once full the oldest records are overwritten, so the most recent CAPACITY events are always available
+// to a reader (a flight recorder), while a reader that keeps up (the tracer's writer) sees every event.
+class TraceBuffer {
+public:
+    static const uint64_t CAPACITY = 1 << 13;
+    static const uint64_t MASK = CAPACITY - 1;
+
+    TraceBuffer(int64_t threadID) : _threadID(threadID) {}
+
+    // Owning thread only
+    void push(const TraceRecord& record) {
+        uint64_t head = _head.load(std::memory_order_relaxed);
+        // publishing head = N in the last push must be ordered before overwriting record N - CAPACITY,
+        // so a reader that copied a slot while it was overwritten sees it in its second read of the head
+        std::atomic_thread_fence(std::memory_order_release);
+        _records[head & MASK] = record;
+        _head.store(head + 1, std::memory_order_release);
+    }
+
+    // Any thread. Appends the records written since position to records (at most the last CAPACITY),
+    // advances position and returns the number of records that were overwritten before they could be read.
+    uint64_t read(uint64_t& position, std::vector<TraceRecord>& records) const;
+
+    uint64_t head() const { return _head.load(std::memory_order_acquire); }
+    int64_t getThreadID() const { return _threadID; }
+
+    bool isRetired() const { return _retired.load(std::memory_order_acquire); }
+    void retire() { _retired.store(true, std::memory_order_release); }
+
+    // The calling thread's buffer, created and registered on its first event
+    static TraceBuffer& local();
+    // Snapshot of every registered buffer, including a bounded number from threads that have exited
+    static std::vector<std::shared_ptr<TraceBuffer>> buffers();
+
+private:
+    std::atomic<uint64_t> _head { 0 };
+    std::atomic<bool> _retired { false };
+    const int64_t _threadID;
+    TraceRecord _records[CAPACITY];
+};
+
+// Fast path for the fixed shape events (ranges, single value counters, instants).
+// Callers check recording() and the category before building the event.
+void record(NameID category, NameID name, EventType type,
+            TraceRecord::ArgType argType = TraceRecord::NoArg, uint64_t uintValue = 0, NameID argName = INVALID_NAME_ID);
+void record(NameID category, NameID name, EventType type, NameID argName, double value);
+void recordInstant(NameID category, NameID name, char scope);
+
+// True while a Tracer is tracing or running its flight recorder
+bool recording();
+void setRecording(bool recording);
+
+inline NameID categoryID(const QLoggingCategory& category) {
+    return internStaticName(category.categoryName());
+}
+
+}
+
+#endif // hifi_TraceBuffer_h
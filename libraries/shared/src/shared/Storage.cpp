@@ -8,10 +8,17 @@
 
 #include "Storage.h"
 
+#include <algorithm>
+
 #include <QtCore/QFileInfo>
 #include <QtCore/QDebug>
 #include <QtCore/QLoggingCategory>
 
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 Q_LOGGING_CATEGORY(storagelogging, "hifi.core.storage")
 
 using namespace storage;
@@ -98,4 +105,29 @@ FileStorage::~FileStorage() {
     if (_file.isOpen()) {
         _file.close();
     }
-}
\ No newline at end of file
+}
+
+void FileStorage::prefetch(size_t offset, size_t size, bool wait) const {
+    if (!_mapped || size == 0 || offset >= this->size()) {
+        return;
+    }
+    size = std::min(size, this->size() - offset);
+
+#ifdef Q_OS_UNIX
+    static const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    // madvise wants a page aligned start, the mapping itself always is
+    size_t alignedOffset = offset - (offset % pageSize);
+    madvise(_mapped + alignedOffset, size + (offset - alignedOffset), MADV_WILLNEED);
+#else
+    static const size_t pageSize = 4096;
+#endif
+
+    if (wait) {
+        // touch one byte per page so any fault happens here instead of in the reader
+        volatile uint8_t sink = 0;
+        for (size_t i = 0; i < size; i += pageSize) {
+            sink += _mapped[offset + i];
+        }
+        sink += _mapped[offset + size - 1];
+    }
+}
@@ -63,6 +63,12 @@ namespace storage {
         uint8_t* mutableData() override { return _hasWriteAccess ? _mapped : nullptr; }
         size_t size() const override { return _file.size(); }
         operator bool() const override { return _valid; }
+
+        // Hint that [offset, offset + size) of the mapping will be read soon.  By default the pages are read ahead
+        // in the background, with wait they are faulted in on the calling thread before returning, so that later
+        // reads (for instance texture uploads on the render thread) don't stall on disk.
+        void prefetch(size_t offset, size_t size, bool wait = false) const;
+
     private:
 
         bool _valid { false };
@@ -48,6 +48,14 @@ public:
         encodedBuffer.resize(_encodedSize);
         AudioEncoder::process((const int16_t*)decodedBuffer.constData(), (int16_t*)encodedBuffer.data(), AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
     }
+
+    virtual int encodeInto(const int16_t* decodedSamples, int numSamples, char* encodedBuffer, int maxEncodedSize) override {
+        if (maxEncodedSize < _encodedSize) {
+            return 0;
+        }
+        AudioEncoder::process(decodedSamples, (int16_t*)encodedBuffer, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        return _encodedSize;
+    }
 private:
     int _encodedSize;
 };
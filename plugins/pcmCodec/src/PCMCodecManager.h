@@ -12,6 +12,8 @@
 #ifndef hifi__PCMCodecManager_h
 #define hifi__PCMCodecManager_h
 
+#include <algorithm>
+
 #include <plugins/CodecPlugin.h>
 
 class PCMCodec : public CodecPlugin, public Encoder, public Decoder {
@@ -39,6 +41,12 @@ public:
         encodedBuffer = decodedBuffer;
     }
 
+    virtual int encodeInto(const int16_t* decodedSamples, int numSamples, char* encodedBuffer, int maxEncodedSize) override {
+        int encodedSize = std::min(numSamples * (int)sizeof(int16_t), maxEncodedSize);
+        memcpy(encodedBuffer, decodedSamples, encodedSize);
+        return encodedSize;
+    }
+
     virtual void decode(const QByteArray& encodedBuffer, QByteArray& decodedBuffer) override {
         decodedBuffer = encodedBuffer;
     }
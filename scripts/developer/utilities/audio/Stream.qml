@@ -39,6 +39,14 @@ ColumnLayout {
         label: "Available (avg)"
         source: stream.framesAvailable + " (" + stream.framesAvailableAvg + ") frames"
     }
+    Value {
+        label: "Target Delay"
+        source: stream.targetDelayMs + " ms"
+    }
+    Value {
+        label: "Stretched"
+        source: (stream.stretchedRateWindow * 100).toFixed(2) + "% of frames"
+    }
 
     Label {
         Layout.alignment: Qt.AlignCenter
@@ -65,5 +73,9 @@ ColumnLayout {
         color: "dimgrey"
         source: stream.lossRate.toFixed(2) + "% (" + stream.lossCount + " lost)"
     }
+    Value {
+        label: "Concealed"
+        source: (stream.concealedRateWindow * 100).toFixed(2) + "% (" + stream.concealedCount + " frames)"
+    }
 }
 
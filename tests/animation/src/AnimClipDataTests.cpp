@@ -0,0 +1,244 @@
+//
+//  AnimClipDataTests.cpp
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AnimClipDataTests.h"
+
+#include <algorithm>
+
+#include <AnimClipData.h>
+#include <AnimSkeleton.h>
+#include <AnimUtil.h>
+#include <FBXReader.h>
+#include <GLMHelpers.h>
+#include <NumericalConstants.h>
+
+QTEST_MAIN(AnimClipDataTests)
+
+namespace {
+    const int NUM_JOINTS = 64; // about the size of a typical avatar skeleton
+    const float BONE_LENGTH = 0.1f;
+    const float HIPS_HEIGHT = 1.0f;
+
+    // slightly over the compression tolerances, to allow for quantization at the keys
+    const float MAX_ROTATION_ERROR = 0.002f;
+    const float MAX_TRANSLATION_ERROR = 0.0011f;
+
+    // hips, then alternating left and right chains so that mirroring has something to swap
+    AnimSkeleton::ConstPointer makeSkeleton() {
+        std::vector<FBXJoint> joints;
+        FBXJoint joint;
+        joint.isFree = false;
+        joint.distanceToParent = BONE_LENGTH;
+        joint.preTransform = glm::mat4();
+        joint.preRotation = glm::quat();
+        joint.rotation = glm::quat();
+        joint.postRotation = glm::quat();
+        joint.postTransform = glm::mat4();
+        joint.rotationMin = glm::vec3(-PI);
+        joint.rotationMax = glm::vec3(PI);
+        joint.inverseDefaultRotation = glm::quat();
+        joint.inverseBindRotation = glm::quat();
+        joint.isSkeletonJoint = true;
+        for (int i = 0; i < NUM_JOINTS; ++i) {
+            if (i == 0) {
+                joint.name = "Hips";
+            } else if (i % 2 == 1) {
+                joint.name = QString("LeftJoint%1").arg((i + 1) / 2);
+            } else {
+                joint.name = QString("RightJoint%1").arg(i / 2);
+            }
+            joint.parentIndex = (i == 0) ? -1 : std::max(i - 2, 0);
+            joint.translation = (i == 0) ? glm::vec3(0.0f, HIPS_HEIGHT, 0.0f) : glm::vec3(0.0f, BONE_LENGTH, 0.0f);
+            glm::mat4 parentTransform = (i == 0) ? glm::mat4() : joints[joint.parentIndex].transform;
+            joint.transform = parentTransform * createMatFromQuatAndPos(glm::quat(), joint.translation);
+            joint.bindTransform = joint.transform;
+            joints.push_back(joint);
+        }
+        return std::make_shared<AnimSkeleton>(joints);
+    }
+
+    // a looping motion where every fourth joint holds still, like the fingers and face of most body animations
+    std::vector<AnimPoseVec> makeFrames(const AnimSkeleton& skeleton, int frameCount, float speed) {
+        std::vector<AnimPoseVec> frames(frameCount);
+        for (int frame = 0; frame < frameCount; frame++) {
+            float phase = TWO_PI * speed * (float)frame / (float)frameCount;
+            for (int joint = 0; joint < NUM_JOINTS; joint++) {
+                AnimPose pose = skeleton.getRelativeDefaultPose(joint);
+                glm::vec3 axis = glm::normalize(glm::vec3(1.0f, (float)(joint % 3), 0.5f));
+                if (joint % 4 == 0) {
+                    pose.rot() = glm::angleAxis(0.1f * (float)joint, axis);
+                } else {
+                    pose.rot() = glm::angleAxis(0.5f * sinf(phase + (float)joint), axis);
+                }
+                if (joint == 0) {
+                    pose.trans().y += 0.05f * sinf(2.0f * phase);
+                }
+                frames[frame].push_back(pose);
+            }
+        }
+        return frames;
+    }
+
+    float rotationError(const glm::quat& a, const glm::quat& b) {
+        return 2.0f * acosf(std::min(fabsf(glm::dot(a, b)), 1.0f));
+    }
+
+    void verifyPoses(const AnimClipData& clipData, const std::vector<AnimPoseVec>& frames) {
+        QCOMPARE(clipData.getFrameCount(), (int)frames.size());
+        QCOMPARE(clipData.getJointCount(), NUM_JOINTS);
+        for (int frame = 0; frame < clipData.getFrameCount(); frame++) {
+            for (int joint = 0; joint < NUM_JOINTS; joint++) {
+                AnimPose pose = clipData.getPose(frame, joint);
+                const AnimPose& expected = frames[frame][joint];
+                QVERIFY(rotationError(pose.rot(), expected.rot()) < MAX_ROTATION_ERROR);
+                QVERIFY(glm::distance(pose.trans(), expected.trans()) < MAX_TRANSLATION_ERROR);
+                QVERIFY(glm::distance(pose.scale(), expected.scale()) < MAX_TRANSLATION_ERROR);
+            }
+        }
+    }
+}
+
+void AnimClipDataTests::testCompressionAccuracy() {
+    auto skeleton = makeSkeleton();
+    std::vector<AnimPoseVec> frames = makeFrames(*skeleton, 120, 1.0f);
+    auto clipData = AnimClipData::create("accuracy", frames);
+    verifyPoses(*clipData, frames);
+
+    // in between frames blend exactly like the uncompressed clip did
+    AnimPoseVec poses(NUM_JOINTS);
+    AnimPoseVec expected(NUM_JOINTS);
+    clipData->evaluate(10, 11, 0.25f, &poses[0]);
+    ::blend(NUM_JOINTS, &frames[10][0], &frames[11][0], 0.25f, &expected[0]);
+    for (int joint = 0; joint < NUM_JOINTS; joint++) {
+        QVERIFY(rotationError(poses[joint].rot(), expected[joint].rot()) < MAX_ROTATION_ERROR);
+        QVERIFY(glm::distance(poses[joint].trans(), expected[joint].trans()) < MAX_TRANSLATION_ERROR);
+    }
+}
+
+void AnimClipDataTests::testConstantTracksCollapse() {
+    auto skeleton = makeSkeleton();
+    const int FRAME_COUNT = 120;
+    std::vector<AnimPoseVec> frames(FRAME_COUNT, skeleton->getRelativeDefaultPoses());
+    auto clipData = AnimClipData::create("still", frames);
+    verifyPoses(*clipData, frames);
+
+    // one key per track, no matter how many frames
+    std::vector<AnimPoseVec> longFrames(FRAME_COUNT * 10, skeleton->getRelativeDefaultPoses());
+    QCOMPARE(AnimClipData::create("still", longFrames)->getSize(), clipData->getSize());
+}
+
+void AnimClipDataTests::testSharedAcrossClips() {
+    auto skeleton = makeSkeleton();
+    QString key = "shared#" + AnimClipData::getSkeletonSignature(*skeleton).toHex();
+    int builds = 0;
+    auto build = [&] {
+        builds++;
+        return makeFrames(*skeleton, 30, 1.0f);
+    };
+
+    auto first = AnimClipData::get(key, build);
+    auto second = AnimClipData::get(key, build);
+    QCOMPARE(builds, 1);
+    QCOMPARE(first.get(), second.get());
+
+    // the same skeleton built again has the same signature
+    auto otherSkeleton = makeSkeleton();
+    QCOMPARE(AnimClipData::getSkeletonSignature(*otherSkeleton), AnimClipData::getSkeletonSignature(*skeleton));
+
+    // nothing is kept once the last clip lets go
+    first.reset();
+    second.reset();
+    AnimClipData::get(key, build);
+    QCOMPARE(builds, 2);
+}
+
+void AnimClipDataTests::testMirrored() {
+    auto skeleton = makeSkeleton();
+    auto clipData = AnimClipData::get("mirrored", [&] {
+        return makeFrames(*skeleton, 60, 1.0f);
+    });
+    auto mirrored = AnimClipData::getMirrored(clipData, *skeleton);
+    QCOMPARE(AnimClipData::getMirrored(clipData, *skeleton).get(), mirrored.get());
+
+    std::vector<AnimPoseVec> expected = clipData->decompress();
+    for (auto& relPoses : expected) {
+        skeleton->mirrorRelativePoses(relPoses);
+    }
+    verifyPoses(*mirrored, expected);
+}
+
+void AnimClipDataTests::benchmarkMemoryPerAvatar() {
+    auto skeleton = makeSkeleton();
+    QString signature = AnimClipData::getSkeletonSignature(*skeleton).toHex();
+
+    // idle, walk and run loops, with the mirrored versions every avatar ends up building
+    struct Clip {
+        QString url;
+        int frameCount;
+        float speed;
+    };
+    const Clip clips[] = { { "idle.fbx", 300, 1.0f }, { "walk.fbx", 35, 1.0f }, { "run.fbx", 21, 1.0f } };
+
+    const int NUM_AVATARS = 100;
+    size_t unsharedSize = 0;
+    size_t sharedSize = 0;
+    std::vector<AnimClipData::ConstPointer> crowdClips;
+    for (int avatar = 0; avatar < NUM_AVATARS; avatar++) {
+        for (const auto& clip : clips) {
+            unsharedSize += 2 * AnimClipData::getUncompressedSize(clip.frameCount, NUM_JOINTS);
+            auto clipData = AnimClipData::get(clip.url + "#" + signature, [&] {
+                return makeFrames(*skeleton, clip.frameCount, clip.speed);
+            });
+            crowdClips.push_back(clipData);
+            crowdClips.push_back(AnimClipData::getMirrored(clipData, *skeleton));
+        }
+    }
+    for (size_t i = 0; i < crowdClips.size(); i++) {
+        auto& clipData = crowdClips[i];
+        bool firstUse = std::find(crowdClips.begin(), crowdClips.begin() + i, clipData) == crowdClips.begin() + i;
+        if (firstUse) {
+            sharedSize += clipData->getSize();
+        }
+        sharedSize += sizeof(AnimClipData::ConstPointer);
+    }
+
+    qDebug() << NUM_AVATARS << "avatars, 3 clips + mirrors each:" << (unsharedSize / NUM_AVATARS) << "bytes/avatar unshared,"
+        << (sharedSize / NUM_AVATARS) << "bytes/avatar shared," << ((float)unsharedSize / (float)sharedSize) << "x";
+}
+
+void AnimClipDataTests::benchmarkSampling() {
+    auto skeleton = makeSkeleton();
+    const int FRAME_COUNT = 300;
+    std::vector<AnimPoseVec> frames = makeFrames(*skeleton, FRAME_COUNT, 1.0f);
+    auto clipData = AnimClipData::create("sampling", frames);
+
+    const int NUM_SAMPLES = 10000;
+    AnimPoseVec poses(NUM_JOINTS);
+    QElapsedTimer timer;
+
+    timer.start();
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        int frame = (i * 7) % (FRAME_COUNT - 1);
+        ::blend(NUM_JOINTS, &frames[frame][0], &frames[frame + 1][0], 0.5f, &poses[0]);
+    }
+    quint64 uncompressedTime = timer.nsecsElapsed();
+
+    timer.start();
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        int frame = (i * 7) % (FRAME_COUNT - 1);
+        clipData->evaluate(frame, frame + 1, 0.5f, &poses[0]);
+    }
+    quint64 compressedTime = timer.nsecsElapsed();
+
+    float uncompressedUsecs = (float)uncompressedTime / (float)(NUM_SAMPLES * NSECS_PER_USEC);
+    float compressedUsecs = (float)compressedTime / (float)(NUM_SAMPLES * NSECS_PER_USEC);
+    qDebug() << NUM_JOINTS << "joints:" << uncompressedUsecs << "usecs/evaluate uncompressed," << compressedUsecs
+        << "usecs/evaluate compressed," << clipData->getSize() << "bytes compressed vs"
+        << AnimClipData::getUncompressedSize(FRAME_COUNT, NUM_JOINTS) << "uncompressed";
+}
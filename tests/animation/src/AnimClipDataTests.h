@@ -0,0 +1,28 @@
+//
+//  AnimClipDataTests.h
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AnimClipDataTests_h
+#define hifi_AnimClipDataTests_h
+
+#include <QtTest/QtTest>
+
+// Compression accuracy and sharing of retargeted clip data, plus a report of clip memory per avatar in a crowd and
+// of sampling throughput compared to the uncompressed frames.
+class AnimClipDataTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testCompressionAccuracy();
+    void testConstantTracksCollapse();
+    void testSharedAcrossClips();
+    void testMirrored();
+    void benchmarkMemoryPerAvatar();
+    void benchmarkSampling();
+};
+
+#endif // hifi_AnimClipDataTests_h
@@ -0,0 +1,425 @@
+//
+//  AnimGraphTests.cpp
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AnimGraphTests.h"
+
+#include <map>
+#include <random>
+
+#include <AnimClip.h>
+#include <AnimClipData.h>
+#include <AnimContext.h>
+#include <AnimInverseKinematics.h>
+#include <AnimNodeLoader.h>
+#include <AnimSkeleton.h>
+#include <AnimUtil.h>
+#include <AnimationCache.h>
+#include <GLMHelpers.h>
+#include <NumericalConstants.h>
+
+QTEST_MAIN(AnimGraphTests)
+
+namespace {
+    const float EPSILON = 0.0001f;
+
+    const QString& getResourcesDir() {
+        static QString dir;
+        if (dir.isEmpty()) {
+            QDir path(__FILE__);
+            path.cdUp();
+            dir = path.cleanPath(path.absoluteFilePath("../../../interface/resources/")) + "/";
+        }
+        return dir;
+    }
+
+    // the joint names avatar-animation.json, its bone sets and its IK targets expect, scale converts its meters to model units
+    AnimSkeleton::ConstPointer makeHumanoidSkeleton(float scale = 1.0f) {
+        struct Bone {
+            QString name;
+            QString parent;
+            glm::vec3 offset;
+        };
+        std::vector<Bone> bones = {
+            { "Hips", "", glm::vec3(0.0f, 1.0f, 0.0f) },
+            { "Spine", "Hips", glm::vec3(0.0f, 0.1f, 0.0f) },
+            { "Spine1", "Spine", glm::vec3(0.0f, 0.1f, 0.0f) },
+            { "Spine2", "Spine1", glm::vec3(0.0f, 0.1f, 0.0f) },
+            { "Neck", "Spine2", glm::vec3(0.0f, 0.15f, 0.0f) },
+            { "Head", "Neck", glm::vec3(0.0f, 0.1f, 0.0f) },
+            { "HeadTop_End", "Head", glm::vec3(0.0f, 0.2f, 0.0f) }
+        };
+        const char* fingers[] = { "Thumb", "Index", "Middle", "Ring", "Pinky" };
+        for (float side : { 1.0f, -1.0f }) {
+            QString prefix = side > 0.0f ? "Left" : "Right";
+            bones.push_back({ prefix + "Shoulder", "Spine2", glm::vec3(side * 0.05f, 0.1f, 0.0f) });
+            bones.push_back({ prefix + "Arm", prefix + "Shoulder", glm::vec3(side * 0.1f, 0.0f, 0.0f) });
+            bones.push_back({ prefix + "ForeArm", prefix + "Arm", glm::vec3(side * 0.25f, 0.0f, 0.0f) });
+            bones.push_back({ prefix + "Hand", prefix + "ForeArm", glm::vec3(side * 0.25f, 0.0f, 0.0f) });
+            for (int i = 0; i < 5; i++) {
+                QString finger = prefix + "Hand" + fingers[i];
+                bones.push_back({ finger + "1", prefix + "Hand", glm::vec3(side * 0.05f, 0.0f, 0.02f * (float)(i - 2)) });
+                for (int j = 2; j <= 4; j++) {
+                    bones.push_back({ finger + QString::number(j), finger + QString::number(j - 1), glm::vec3(side * 0.02f, 0.0f, 0.0f) });
+                }
+            }
+            bones.push_back({ prefix + "UpLeg", "Hips", glm::vec3(side * 0.1f, 0.0f, 0.0f) });
+            bones.push_back({ prefix + "Leg", prefix + "UpLeg", glm::vec3(0.0f, -0.45f, 0.0f) });
+            bones.push_back({ prefix + "Foot", prefix + "Leg", glm::vec3(0.0f, -0.45f, 0.0f) });
+            bones.push_back({ prefix + "ToeBase", prefix + "Foot", glm::vec3(0.0f, -0.05f, 0.1f) });
+            bones.push_back({ prefix + "Toe_End", prefix + "ToeBase", glm::vec3(0.0f, 0.0f, 0.05f) });
+        }
+
+        std::vector<FBXJoint> joints;
+        QHash<QString, int> indices;
+        for (const auto& bone : bones) {
+            FBXJoint joint;
+            joint.isFree = false;
+            joint.name = bone.name;
+            joint.parentIndex = bone.parent.isEmpty() ? -1 : indices.value(bone.parent);
+            joint.distanceToParent = glm::length(scale * bone.offset);
+            joint.translation = scale * bone.offset;
+            joint.preTransform = glm::mat4();
+            joint.preRotation = glm::quat();
+            joint.rotation = glm::quat();
+            joint.postRotation = glm::quat();
+            joint.postTransform = glm::mat4();
+            joint.rotationMin = glm::vec3(-PI);
+            joint.rotationMax = glm::vec3(PI);
+            joint.inverseDefaultRotation = glm::quat();
+            joint.inverseBindRotation = glm::quat();
+            joint.isSkeletonJoint = true;
+            glm::mat4 parentTransform = (joint.parentIndex == -1) ? glm::mat4() : joints[joint.parentIndex].transform;
+            joint.transform = parentTransform * createMatFromQuatAndPos(glm::quat(), joint.translation);
+            joint.bindTransform = joint.transform;
+            indices.insert(joint.name, (int)joints.size());
+            joints.push_back(joint);
+        }
+        return std::make_shared<AnimSkeleton>(joints);
+    }
+
+    AnimPose randomPose(std::mt19937& generator, bool uniformScale) {
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        std::uniform_real_distribution<float> positive(0.5f, 2.0f);
+        glm::quat rot = glm::normalize(glm::quat(unit(generator), unit(generator), unit(generator), unit(generator)));
+        glm::vec3 scale = uniformScale ? glm::vec3(positive(generator)) : glm::vec3(positive(generator), positive(generator), positive(generator));
+        return AnimPose(scale, rot, glm::vec3(unit(generator), unit(generator), unit(generator)));
+    }
+
+    AnimPoseVec randomPoses(std::mt19937& generator, int numPoses) {
+        AnimPoseVec poses;
+        for (int i = 0; i < numPoses; i++) {
+            poses.push_back(randomPose(generator, i % 2 == 0));
+        }
+        return poses;
+    }
+
+    // the per joint math ::blend() used to do
+    void scalarBlend(size_t numPoses, const AnimPose* a, const AnimPose* b, const float* alphas, AnimPose* result) {
+        for (size_t i = 0; i < numPoses; i++) {
+            result[i].scale() = lerp(a[i].scale(), b[i].scale(), alphas[i]);
+            result[i].rot() = safeLerp(a[i].rot(), b[i].rot(), alphas[i]);
+            result[i].trans() = lerp(a[i].trans(), b[i].trans(), alphas[i]);
+        }
+    }
+
+    // what AnimPose::operator*(const AnimPose&) used to do for every pair
+    AnimPose matrixCompose(const AnimPose& a, const AnimPose& b) {
+        glm::mat4 result;
+        glm_mat4u_mul(a, b, result);
+        return AnimPose(result);
+    }
+
+    bool posesEqual(const AnimPose& a, const AnimPose& b) {
+        // q and -q are the same rotation
+        return glm::length(a.scale() - b.scale()) < EPSILON && glm::length(a.trans() - b.trans()) < EPSILON &&
+            1.0f - fabsf(glm::dot(a.rot(), b.rot())) < EPSILON;
+    }
+
+    float usecsPerCall(quint64 nsecs, int calls) {
+        return (float)nsecs / (float)(calls * NSECS_PER_USEC);
+    }
+}
+
+void AnimGraphTests::initTestCase() {
+    DependencyManager::set<AnimationCache>();
+    DependencyManager::set<ResourceCacheSharedItems>();
+}
+
+void AnimGraphTests::cleanupTestCase() {
+    DependencyManager::destroy<AnimationCache>();
+}
+
+void AnimGraphTests::testBlendMatchesScalar() {
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    // odd sizes, so the scalar remainder of each vectorized loop is covered too
+    for (int numPoses : { 1, 3, 4, 7, 8, 13, 65 }) {
+        AnimPoseVec a = randomPoses(generator, numPoses);
+        AnimPoseVec b = randomPoses(generator, numPoses);
+        std::vector<float> alphas(numPoses);
+        for (auto& alpha : alphas) {
+            alpha = unit(generator);
+        }
+
+        AnimPoseVec expected(numPoses);
+        AnimPoseVec result(numPoses);
+        scalarBlend(numPoses, &a[0], &b[0], &alphas[0], &expected[0]);
+        ::blend(numPoses, &a[0], &b[0], &alphas[0], &result[0]);
+        for (int i = 0; i < numPoses; i++) {
+            QVERIFY(posesEqual(result[i], expected[i]));
+        }
+
+        std::vector<float> uniformAlphas(numPoses, alphas[0]);
+        scalarBlend(numPoses, &a[0], &b[0], &uniformAlphas[0], &expected[0]);
+        ::blend(numPoses, &a[0], &b[0], alphas[0], &result[0]);
+        for (int i = 0; i < numPoses; i++) {
+            QVERIFY(posesEqual(result[i], expected[i]));
+        }
+
+        // in place, the way AnimInverseKinematics uses it
+        ::blend(numPoses, &a[0], &b[0], alphas[0], &a[0]);
+        for (int i = 0; i < numPoses; i++) {
+            QVERIFY(posesEqual(a[i], expected[i]));
+        }
+    }
+}
+
+void AnimGraphTests::testComposeMatchesMatrices() {
+    std::mt19937 generator(2);
+    for (int i = 0; i < 1000; i++) {
+        AnimPose parent = randomPose(generator, i % 2 == 0);
+        AnimPose child = randomPose(generator, i % 3 == 0);
+        QVERIFY(posesEqual(parent * child, matrixCompose(parent, child)));
+    }
+}
+
+void AnimGraphTests::benchmarkPoseKernels() {
+    auto skeleton = makeHumanoidSkeleton();
+    const int numJoints = skeleton->getNumJoints();
+    const int NUM_CALLS = 10000;
+
+    std::mt19937 generator(3);
+    AnimPoseVec a = randomPoses(generator, numJoints);
+    AnimPoseVec b = randomPoses(generator, numJoints);
+    AnimPoseVec result(numJoints);
+    std::vector<float> alphas(numJoints, 0.5f);
+    for (int i = 0; i < numJoints; i += 3) {
+        alphas[i] = 0.0f; // joints outside the bone set
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < NUM_CALLS; i++) {
+        scalarBlend(numJoints, &a[0], &b[0], &alphas[0], &result[0]);
+    }
+    float scalarBlendUsecs = usecsPerCall(timer.nsecsElapsed(), NUM_CALLS);
+
+    timer.start();
+    for (int i = 0; i < NUM_CALLS; i++) {
+        ::blend(numJoints, &a[0], &b[0], &alphas[0], &result[0]);
+    }
+    float blendUsecs = usecsPerCall(timer.nsecsElapsed(), NUM_CALLS);
+
+    const AnimPoseVec& relativePoses = skeleton->getRelativeDefaultPoses();
+    AnimPoseVec absolutePoses;
+    timer.start();
+    for (int i = 0; i < NUM_CALLS; i++) {
+        absolutePoses = relativePoses;
+        for (int j = 0; j < numJoints; j++) {
+            int parentIndex = skeleton->getParentIndex(j);
+            if (parentIndex != -1) {
+                absolutePoses[j] = matrixCompose(absolutePoses[parentIndex], absolutePoses[j]);
+            }
+        }
+    }
+    float scalarAbsoluteUsecs = usecsPerCall(timer.nsecsElapsed(), NUM_CALLS);
+
+    timer.start();
+    for (int i = 0; i < NUM_CALLS; i++) {
+        absolutePoses = relativePoses;
+        skeleton->convertRelativePosesToAbsolute(absolutePoses);
+    }
+    float absoluteUsecs = usecsPerCall(timer.nsecsElapsed(), NUM_CALLS);
+
+    qDebug() << numJoints << "joints: masked blend" << scalarBlendUsecs << "->" << blendUsecs << "usecs,"
+        << (scalarBlendUsecs / blendUsecs) << "x";
+    qDebug() << numJoints << "joints: relative to absolute" << scalarAbsoluteUsecs << "->" << absoluteUsecs << "usecs,"
+        << (scalarAbsoluteUsecs / absoluteUsecs) << "x";
+}
+
+void AnimGraphTests::benchmarkAvatarAnimationGraph() {
+    QFile file(getResourcesDir() + "avatar/avatar-animation.json");
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QByteArray contents = file.readAll();
+    QUrl jsonUrl = QUrl::fromLocalFile(file.fileName());
+
+    auto skeleton = makeHumanoidSkeleton();
+    const int numJoints = skeleton->getNumJoints();
+
+    // every rig plays the same clips, so like AnimClip they share one copy of each clip's frames
+    std::map<QString, AnimClipData::ConstPointer> clipData;
+    auto makeClipData = [&](const QString& url, int frameCount) {
+        std::vector<AnimPoseVec> frames(frameCount, skeleton->getRelativeDefaultPoses());
+        for (int frame = 0; frame < frameCount; frame++) {
+            float phase = TWO_PI * (float)frame / (float)frameCount;
+            for (int joint = 0; joint < numJoints; joint++) {
+                glm::vec3 axis = glm::normalize(glm::vec3(1.0f, (float)(joint % 3), 0.5f));
+                frames[frame][joint].rot() = glm::angleAxis(0.3f * sinf(phase + (float)joint), axis);
+            }
+        }
+        return AnimClipData::create(url, frames);
+    };
+
+    const int NUM_RIGS = 100;
+    std::vector<AnimNode::Pointer> rigs;
+    std::vector<AnimVariantMap> rigVars(NUM_RIGS);
+    for (int i = 0; i < NUM_RIGS; i++) {
+        AnimNode::Pointer root = AnimNodeLoader::load(contents, jsonUrl);
+        QVERIFY((bool)root);
+        root->setSkeleton(skeleton);
+        root->traverse([&](AnimNode::Pointer node) {
+            if (node->getType() == AnimNode::Type::Clip) {
+                auto clip = std::static_pointer_cast<AnimClip>(node);
+                auto& data = clipData[clip->_url];
+                if (!data) {
+                    data = makeClipData(clip->_url, std::max((int)clip->getEndFrame() + 1, 2));
+                }
+                clip->_networkAnim.reset();
+                clip->_anim = data;
+                clip->_poses.resize(numJoints);
+            }
+            return true;
+        });
+        rigs.push_back(root);
+
+        // a third of the crowd walking, a third idle and a third turning, all with hand overlays and IK active
+        AnimVariantMap& vars = rigVars[i];
+        vars.set("userAnimNone", true);
+        vars.set("isNotInAir", true);
+        vars.set("isNotFlying", true);
+        vars.set("isNotTakeoff", true);
+        vars.set("isMovingForward", i % 3 == 0);
+        vars.set("isNotMoving", i % 3 != 0);
+        vars.set("isTurningLeft", i % 3 == 2);
+        vars.set("isNotTurning", i % 3 != 2);
+        vars.set("moveForwardAlpha", 0.5f);
+        vars.set("ikOverlayAlpha", 1.0f);
+        vars.set("leftHandOverlayAlpha", 1.0f);
+        vars.set("rightHandOverlayAlpha", 1.0f);
+        vars.set("leftHandGraspAlpha", 0.5f);
+        vars.set("rightHandGraspAlpha", 0.5f);
+    }
+
+    AnimContext context(false, false, false, glm::mat4(), glm::mat4());
+    const float DT = 1.0f / 60.0f;
+    const int NUM_FRAMES = 100;
+    AnimNode::Triggers triggers;
+    AnimPoseVec absolutePoses;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        for (int i = 0; i < NUM_RIGS; i++) {
+            triggers.clear();
+            const AnimPoseVec& poses = rigs[i]->evaluate(rigVars[i], context, DT, triggers);
+            absolutePoses = poses;
+            skeleton->convertRelativePosesToAbsolute(absolutePoses);
+        }
+    }
+    quint64 elapsed = timer.nsecsElapsed();
+
+    size_t clipBytes = 0;
+    for (const auto& entry : clipData) {
+        clipBytes += entry.second->getSize();
+    }
+    qDebug() << NUM_RIGS << "rigs," << numJoints << "joints," << clipData.size() << "clips (" << clipBytes << "bytes shared):"
+        << usecsPerCall(elapsed, NUM_FRAMES * NUM_RIGS) << "usecs per rig evaluate,"
+        << usecsPerCall(elapsed, NUM_FRAMES) << "usecs per frame";
+}
+
+void AnimGraphTests::benchmarkTrackedHandsIK() {
+    // avatar models are in centimeters, the units the IK tolerances are in
+    auto skeleton = makeHumanoidSkeleton(100.0f);
+    const AnimPoseVec& underPoses = skeleton->getRelativeDefaultPoses();
+    const AnimPose leftHandPose = skeleton->getAbsoluteDefaultPose(skeleton->nameToJointIndex("LeftHand"));
+    const AnimPose rightHandPose = skeleton->getAbsoluteDefaultPose(skeleton->nameToJointIndex("RightHand"));
+    const AnimPose headPose = skeleton->getAbsoluteDefaultPose(skeleton->nameToJointIndex("Head"));
+    const AnimPose spine2Pose = skeleton->getAbsoluteDefaultPose(skeleton->nameToJointIndex("Spine2"));
+
+    // a remote avatar with tracked hands and head: hands held out in front, drifting slowly, like someone talking
+    auto makeVars = [&](AnimVariantMap& vars, int avatar, int frame) {
+        float t = (float)(frame + 7 * avatar) / 60.0f;
+        glm::vec3 reach(0.0f, -20.0f, 25.0f);
+        glm::vec3 drift(5.0f * sinf(0.5f * t), 3.0f * sinf(0.7f * t), 4.0f * cosf(0.3f * t));
+        glm::vec3 inward(15.0f, 0.0f, 0.0f);
+        glm::quat sway = glm::angleAxis(0.2f * sinf(0.4f * t), Vectors::UNIT_Y);
+        vars.set("leftHandPosition", leftHandPose.trans() - inward + reach + drift);
+        vars.set("leftHandRotation", sway * leftHandPose.rot());
+        vars.set("leftHandType", (int)IKTarget::Type::RotationAndPosition);
+        vars.set("rightHandPosition", rightHandPose.trans() + inward + reach - drift);
+        vars.set("rightHandRotation", sway * rightHandPose.rot());
+        vars.set("rightHandType", (int)IKTarget::Type::RotationAndPosition);
+        vars.set("headPosition", headPose.trans());
+        vars.set("headRotation", sway * headPose.rot());
+        vars.set("headType", (int)IKTarget::Type::HmdHead);
+        vars.set("spine2Position", spine2Pose.trans());
+        vars.set("spine2Rotation", spine2Pose.rot());
+        vars.set("spine2Type", (int)IKTarget::Type::Spline);
+    };
+
+    const int NUM_AVATARS = 100;
+    const int NUM_FRAMES = 120;
+    const float DT = 1.0f / 60.0f;
+    AnimContext context(false, false, false, glm::mat4(), glm::mat4());
+    AnimNode::Triggers triggers;
+    std::vector<float> noFlex;
+    std::vector<float> spineFlex = { 1.0f, 0.5f, 0.25f };
+
+    for (bool incremental : { false, true }) {
+        AnimInverseKinematics::useIncrementalSolve = incremental;
+
+        std::vector<std::shared_ptr<AnimInverseKinematics>> avatars;
+        std::vector<AnimVariantMap> avatarVars(NUM_AVATARS);
+        for (int i = 0; i < NUM_AVATARS; i++) {
+            auto ik = std::make_shared<AnimInverseKinematics>("ik");
+            ik->setTargetVars("LeftHand", "leftHandPosition", "leftHandRotation", "leftHandType", "", 1.0f, noFlex, "", "", "");
+            ik->setTargetVars("RightHand", "rightHandPosition", "rightHandRotation", "rightHandType", "", 1.0f, noFlex, "", "", "");
+            ik->setTargetVars("Head", "headPosition", "headRotation", "headType", "", 1.0f, noFlex, "", "", "");
+            ik->setTargetVars("Spine2", "spine2Position", "spine2Rotation", "spine2Type", "", 1.0f, spineFlex, "", "", "");
+            ik->setSkeleton(skeleton);
+            avatars.push_back(ik);
+        }
+
+        quint64 elapsed = 0;
+        int totalLoops = 0;
+        float totalError = 0.0f;
+        QElapsedTimer timer;
+        for (int frame = 0; frame < NUM_FRAMES; frame++) {
+            for (int i = 0; i < NUM_AVATARS; i++) {
+                makeVars(avatarVars[i], i, frame);
+            }
+            timer.start();
+            for (int i = 0; i < NUM_AVATARS; i++) {
+                triggers.clear();
+                avatars[i]->overlay(avatarVars[i], context, DT, triggers, underPoses);
+            }
+            elapsed += timer.nsecsElapsed();
+            for (auto& ik : avatars) {
+                totalLoops += ik->getNumLoopsOnLastSolve();
+                totalError += ik->getMaxErrorOnLastSolve();
+            }
+        }
+
+        int numSolves = NUM_FRAMES * NUM_AVATARS;
+        qDebug() << (incremental ? "incremental IK:" : "full IK:") << usecsPerCall(elapsed, numSolves) << "usecs per avatar,"
+            << (float)totalLoops / (float)numSolves << "iterations," << totalError / (float)numSolves << "cm max error";
+    }
+    AnimInverseKinematics::useIncrementalSolve = true;
+}
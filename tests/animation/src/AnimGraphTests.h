@@ -0,0 +1,29 @@
+//
+//  AnimGraphTests.h
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AnimGraphTests_h
+#define hifi_AnimGraphTests_h
+
+#include <QtTest/QtTest>
+
+// Checks the vectorized pose kernels against the scalar math they replace, times them, and evaluates the shipping
+// avatar-animation.json graph on a crowd of rigs with synthetic clip data.
+class AnimGraphTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void testBlendMatchesScalar();
+    void testComposeMatchesMatrices();
+    void benchmarkPoseKernels();
+    void benchmarkAvatarAnimationGraph();
+    void benchmarkTrackedHandsIK();
+};
+
+#endif // hifi_AnimGraphTests_h
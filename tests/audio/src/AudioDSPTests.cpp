@@ -0,0 +1,372 @@
+//
+//  AudioDSPTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioDSPTests.h"
+
+#include <random>
+
+#include <AudioConstants.h>
+#include <AudioLimiter.h>
+#include <AudioReverb.h>
+
+QTEST_MAIN(AudioDSPTests)
+
+static const int SAMPLE_RATE = AudioConstants::SAMPLE_RATE;
+static const int FRAMES_PER_BLOCK = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+
+// the AVX2 kernels use fused multiply-adds, which round differently than the scalar code
+static const float MAX_REVERB_ERROR = 1.0e-5f;
+
+// the limiters draw from one dither generator, so each sees different dither, within [-1, 1]
+// (and the reference tables were rendered by a process that had drawn a different amount of it)
+static const int MAX_LIMITER_ERROR = 3;
+
+// bursts of noise and silence, so the reverb tails and the limiter release get exercised too
+static std::vector<float> makeSignal(int numSamples, float amplitude) {
+    std::mt19937 generator(1234);
+    std::uniform_real_distribution<float> noise(-amplitude, amplitude);
+
+    std::vector<float> signal(numSamples);
+    for (int i = 0; i < numSamples; i++) {
+        bool isBurst = (i / (SAMPLE_RATE / 4)) % 3 == 0;
+        signal[i] = isBurst ? noise(generator) : 0.0f;
+    }
+    return signal;
+}
+
+static ReverbParameters makeReverbParameters(AudioReverb& reverb, int config) {
+    ReverbParameters parameters;
+    reverb.getParameters(&parameters);
+
+    if (config == 1) {
+        // smallest room, so the early taps and allpasses are shortest
+        parameters.roomSize = 0.0f;
+        parameters.density = 0.0f;
+        parameters.preDelay = 0.0f;
+        parameters.lateDelay = 0.0f;
+        parameters.earlyGain = 6.0f;
+        parameters.wetDryMix = 50.0f;
+    } else if (config == 2) {
+        // largest room, so the delays are longer than a block
+        parameters.roomSize = 100.0f;
+        parameters.preDelay = 333.0f;
+        parameters.lateDelay = 166.0f;
+        parameters.earlyDiffusion = 30.0f;
+        parameters.earlyMixLeft = 80.0f;
+    }
+    return parameters;
+}
+
+// a second of input, sampled at the end of every REFERENCE_STRIDE frames against the tables below
+static const int NUM_REFERENCE_FRAMES = 32;
+static const int REFERENCE_STRIDE = SAMPLE_RATE / NUM_REFERENCE_FRAMES;
+
+// like makeSignal, but from a generator that is the same on every platform, unlike the std distributions
+static std::vector<float> makeReferenceSignal(int numSamples, float amplitude) {
+    uint32_t seed = 1234;
+
+    std::vector<float> signal(numSamples);
+    for (int i = 0; i < numSamples; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        bool isBurst = (i / (SAMPLE_RATE / 4)) % 3 == 0;
+        signal[i] = isBurst ? amplitude * ((int32_t)seed * (1.0f / 2147483648.0f)) : 0.0f;
+    }
+    return signal;
+}
+
+// frames of the old, scalar only reverb output, for makeReferenceSignal(2 * SAMPLE_RATE, 0.5f),
+// rendered a frame at a time by the reverb at 24kHz and 48kHz, in each of the makeReverbParameters configs
+static const float REVERB_REFERENCE[2][3][2 * NUM_REFERENCE_FRAMES] = {
+    {
+        {
+            0.160938829f, -0.191946745f, -0.044234544f, -0.200250685f, 0.0291179866f, -0.384383231f,
+            0.0856021643f, -0.149060041f, -0.0818559229f, -0.0810753256f, 0.153434753f, -0.0372812189f,
+            -0.00425813952f, 0.0174284689f, -0.0807851404f, 0.0570379198f, 0.0170553178f, -0.00291630253f,
+            0.00258489233f, 0.0276893359f, -0.0232095756f, 0.0342692509f, 0.0601571538f, 0.00908844825f,
+            0.198429912f, -0.19867003f, -0.0492431521f, -0.116235837f, -0.0780520439f, 0.139372393f,
+            -0.0189586878f, 0.278102547f, -0.0215202644f, 0.0275728758f, 0.00919933058f, 0.000543724746f,
+            0.0478848517f, 0.101978943f, -0.0459847637f, 0.136660248f, 0.0361413099f, -0.0530799925f,
+            -0.0199709926f, 0.0065687811f, -0.000542091206f, 0.0397129357f, 0.0650008395f, 0.00325812143f,
+            -0.171808958f, -0.046697855f, 0.233396739f, -0.287269652f, 0.12210831f, -0.026130408f,
+            0.0536603928f, -0.0888821334f, 0.072171092f, 0.132238179f, -0.0237785168f, -0.0571969338f,
+            0.155292749f, -0.22155413f, 0.0340313241f, -0.0148337167f
+        },
+        {
+            -0.012519896f, -0.00815609097f, 0.128329858f, 0.136469319f, -0.218863606f, 0.0793861151f,
+            -0.0536558032f, 0.382466465f, 0.0865236595f, 0.0736706108f, 0.085411787f, 0.0502608009f,
+            -0.0145182405f, 0.0718764514f, -0.0292827711f, -0.0209664572f, -0.0493996143f, -0.0376314335f,
+            -0.0343608446f, 0.0314349197f, -0.0581358373f, -0.00384403393f, 0.00117201218f, -0.101148933f,
+            -0.288354188f, 0.208368331f, -0.1528669f, -0.165966362f, 0.0590072274f, 0.0934405774f,
+            -0.12160404f, -0.0294600725f, -0.0561828464f, -0.048736468f, 0.0773507282f, -0.0439474806f,
+            0.044747822f, -0.0381744802f, -0.00690413592f, 0.0578333437f, 0.0853592977f, -0.0493870601f,
+            0.0535488091f, -0.0470314287f, 0.0393509641f, -0.029552523f, 0.0244648382f, 0.0066342284f,
+            -0.150012523f, -0.326134384f, -0.0318550467f, 0.246088967f, -0.0623905361f, 0.0431378484f,
+            -0.409875453f, -0.370658159f, -0.069751747f, 0.117033504f, -0.00746434648f, -0.0701494589f,
+            0.0407633483f, -0.100759141f, 0.0252156667f, -0.0543368012f
+        },
+        {
+            0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+            0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+            0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+            0.0f, 0.0f, 0.00741094025f, -0.0327826366f, -0.060405802f, 0.0388002098f,
+            -0.0851214528f, -0.198337078f, 0.00368136168f, -0.0963517725f, -0.0122539997f, -0.011494711f,
+            0.0817381144f, 0.0370037556f, -0.014007071f, -0.016924195f, -0.00428947434f, -0.041844964f,
+            -0.00378113869f, -0.00914299767f, 0.00773698371f, 0.0199090149f, -0.0279312767f, -0.0540088043f,
+            -0.0182784107f, 0.0599031784f, -0.0684626698f, -0.0468267947f, -0.177394524f, 0.100828551f,
+            0.0331915021f, 0.104363084f, -0.0257579386f, -0.0148884356f, 0.00400096178f, -0.0706102252f,
+            -0.0339808166f, 0.0250359029f, -0.0149359861f, 0.0251381882f, -0.00977712683f, 0.0641514957f,
+            -0.0624075979f, -0.053344138f, -0.0250295941f, 0.00327194855f
+        }
+    },
+    {
+        {
+            0.0f, 0.0f, -0.0485550053f, 0.254036129f, 0.0563176721f, -0.24526003f,
+            -0.122139558f, 0.120236009f, 0.0811016858f, -0.080996342f, -0.0851150081f, 0.0953330696f,
+            0.000764735043f, -0.0309451111f, -0.0574648827f, 0.0671473667f, 0.0215563364f, -0.0343117192f,
+            -0.0449463911f, 0.0723856688f, 0.0562423319f, -0.0353612527f, -0.022054933f, 0.014777543f,
+            0.00251609087f, -0.0218903124f, 0.00527793169f, 0.0581120849f, 0.0383683741f, 0.1027897f,
+            0.165130138f, 0.104311377f, 0.0828183219f, 0.172245696f, -0.0100185117f, 0.131926283f,
+            -0.0204744078f, -0.054877162f, -0.00282925181f, 0.00529580424f, 7.78697431e-05f, -0.000416329131f,
+            -0.0701355934f, 0.0226338878f, 0.0321961045f, -0.113428414f, -0.0459998548f, -0.0145145217f,
+            -0.0221414566f, -0.00833564997f, 0.102056757f, 0.0991739631f, -0.0672481954f, 0.0516931713f,
+            0.00242292881f, -0.0521566868f, 0.0672464222f, -0.0837589726f, -0.0796382576f, -0.0621399581f,
+            0.0422395281f, -0.0796227604f, -0.0524017289f, -0.0199526921f
+        },
+        {
+            -0.0386850014f, 0.160200596f, -0.13557893f, 0.201463431f, 0.0710840076f, 0.105416924f,
+            -0.159086257f, 0.399633229f, -0.0337724015f, -0.0054798238f, 0.0994767249f, -0.0116674509f,
+            0.00151855871f, -0.114888534f, -0.00581914373f, -0.0851175711f, 0.0060190456f, 0.00350985862f,
+            -0.0141024403f, 0.0187566411f, -0.0529935062f, 0.0298507232f, -0.00403862353f, 0.0291034952f,
+            0.0624321401f, 0.268355757f, -0.115475684f, -0.13141489f, 0.267717183f, 0.080362618f,
+            -0.195872396f, -0.187572792f, 0.061703898f, 0.0660991594f, -0.088866353f, 0.0422688648f,
+            -0.0366313197f, -0.0505207293f, 0.0895764008f, -0.0504573286f, 0.00841668528f, 0.043337848f,
+            0.0261633247f, -0.0153442267f, -0.0101112053f, -0.0116650183f, 0.00439900719f, -0.00355717633f,
+            -0.335887611f, -0.29820925f, 0.0695573986f, 0.387678951f, -0.205501959f, 0.0473202169f,
+            0.224101275f, -0.187759295f, -0.00255074981f, 0.0184467621f, -0.0658794194f, 0.0500386879f,
+            -0.0432944782f, 0.0868741348f, 0.0147624612f, 0.130536869f
+        },
+        {
+            0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+            0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+            0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+            0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+            0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+            0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+            0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+            0.00383553747f, 0.0903493389f, -0.00811696425f, -0.159341261f, -0.0380836949f, -0.0260473751f,
+            0.0406698287f, -0.0784854293f, -0.104708403f, 0.0443010032f, -0.00797519088f, -4.55677509e-05f,
+            0.00278885663f, 0.00972039998f, 0.0341260508f, 0.0250110887f, -0.0397066139f, 0.0179466307f,
+            0.0507169664f, 0.00120456261f, 0.035409525f, 0.000459387433f
+        }
+    }
+};
+
+// frames of the old, scalar only limiter output, for makeReferenceSignal(numChannels * SAMPLE_RATE, 65536.0f),
+// rendered a frame at a time with a -6dB threshold
+static const int16_t LIMITER_REFERENCE_1[1 * NUM_REFERENCE_FRAMES] = {
+    -23313, 2801, -11168, 8734, 17133, 25057, -30042, -83, 0, 0, 0, 1, 1, 1, 0, -1,
+    -1, 0, 0, 0, 1, 0, 0, 0, 5743, -18001, -25077, -21735, 4535, -2354, -31129, 8550
+};
+static const int16_t LIMITER_REFERENCE_2[2 * NUM_REFERENCE_FRAMES] = {
+    8260, -3721, -31594, 22398, -11689, -5247, -18798, 8942, -1, -1, -1, -1, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 1, 1, -13336, -19054, 16003, -17685, 21234, -11984, -17833, 24749,
+    0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    -3951, 30429, 12505, -26132, 20432, -25022, -31051, -20897, 0, 0, 0, 0, 0, 0, 0, 0
+};
+static const int16_t LIMITER_REFERENCE_4[4 * NUM_REFERENCE_FRAMES] = {
+    12811, -22762, 24230, -4330, 27852, -7257, 14014, 2728, 0, 0, 0, 0, -1, -1, -1, -1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1387, -2863, 31418, -23010, 1172, 26268, 27904, 8359,
+    1, 1, 1, 1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0,
+    -21807, 10813, 28546, -30160, 15543, -9305, -15663, -16050, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, -8347, 6004, 23311, 21520, 28022, 16620, 5915, -3979,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    6757, -20716, -16611, 30380, 4176, -1196, 2518, 12845, -1, -1, -1, -1, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 18014, -27295, -15462, -4049, 31216, 7453, 4549, -28611
+};
+
+void AudioDSPTests::reverbBlocks() {
+    const int NUM_FRAMES = 2 * SAMPLE_RATE;
+    const int MAX_BLOCK_FRAMES = 1000;
+
+    std::vector<float> input = makeSignal(2 * NUM_FRAMES, 0.5f);
+
+    for (float sampleRate : { 24000.0f, 48000.0f }) {
+        for (int config = 0; config < 3; config++) {
+            AudioReverb frameReverb(sampleRate);
+            AudioReverb blockReverb(sampleRate);
+            ReverbParameters parameters = makeReverbParameters(frameReverb, config);
+            frameReverb.setParameters(&parameters);
+            blockReverb.setParameters(&parameters);
+
+            std::vector<float> frameOutput(2 * NUM_FRAMES);
+            std::vector<float> blockOutput(2 * NUM_FRAMES);
+
+            for (int i = 0; i < NUM_FRAMES; i++) {
+                frameReverb.render(&input[2 * i], &frameOutput[2 * i], 1);
+            }
+
+            // uneven blocks, longer than the internal block too
+            std::mt19937 generator(config);
+            std::uniform_int_distribution<int> blockFrames(1, MAX_BLOCK_FRAMES);
+            for (int i = 0; i < NUM_FRAMES; ) {
+                int numFrames = std::min(blockFrames(generator), NUM_FRAMES - i);
+                blockReverb.render(&input[2 * i], &blockOutput[2 * i], numFrames);
+                i += numFrames;
+            }
+
+            float maxError = 0.0f;
+            float peak = 0.0f;
+            for (int i = 0; i < 2 * NUM_FRAMES; i++) {
+                maxError = std::max(maxError, fabsf(blockOutput[i] - frameOutput[i]));
+                peak = std::max(peak, fabsf(frameOutput[i]));
+            }
+            QVERIFY2(maxError <= MAX_REVERB_ERROR,
+                     qPrintable(QString("config %1 at %2Hz: max error %3").arg(config).arg(sampleRate).arg(maxError)));
+            QVERIFY(peak > 0.0f);
+        }
+    }
+}
+
+void AudioDSPTests::limiterBlocks() {
+    const int NUM_FRAMES = 2 * SAMPLE_RATE;
+    const int MAX_BLOCK_FRAMES = 1000;
+
+    for (int numChannels : { 1, 2, 4 }) {
+
+        // well over the threshold, so the limiter is working
+        std::vector<float> input = makeSignal(numChannels * NUM_FRAMES, 65536.0f);
+
+        AudioLimiter frameLimiter(SAMPLE_RATE, numChannels);
+        AudioLimiter blockLimiter(SAMPLE_RATE, numChannels);
+        frameLimiter.setThreshold(-6.0f);
+        blockLimiter.setThreshold(-6.0f);
+
+        std::vector<int16_t> frameOutput(numChannels * NUM_FRAMES);
+        std::vector<int16_t> blockOutput(numChannels * NUM_FRAMES);
+
+        std::mt19937 generator(numChannels);
+        std::uniform_int_distribution<int> blockFrames(1, MAX_BLOCK_FRAMES);
+        for (int i = 0; i < NUM_FRAMES; ) {
+            int numFrames = std::min(blockFrames(generator), NUM_FRAMES - i);
+
+            bool frameHasAudio = false;
+            for (int j = i; j < i + numFrames; j++) {
+                frameHasAudio |= frameLimiter.render(&input[numChannels * j], &frameOutput[numChannels * j], 1);
+            }
+            bool blockHasAudio = blockLimiter.render(&input[numChannels * i], &blockOutput[numChannels * i], numFrames);
+            QCOMPARE(blockHasAudio, frameHasAudio);
+
+            i += numFrames;
+        }
+
+        int maxError = 0;
+        for (int i = 0; i < numChannels * NUM_FRAMES; i++) {
+            maxError = std::max(maxError, abs(blockOutput[i] - frameOutput[i]));
+        }
+        QVERIFY2(maxError <= MAX_LIMITER_ERROR, qPrintable(QString("%1 channels: max error %2").arg(numChannels).arg(maxError)));
+    }
+}
+
+void AudioDSPTests::reverbReference() {
+    const int NUM_FRAMES = SAMPLE_RATE;
+
+    std::vector<float> input = makeReferenceSignal(2 * NUM_FRAMES, 0.5f);
+
+    const float SAMPLE_RATES[] = { 24000.0f, 48000.0f };
+    for (int rate = 0; rate < 2; rate++) {
+        for (int config = 0; config < 3; config++) {
+            AudioReverb reverb(SAMPLE_RATES[rate]);
+            ReverbParameters parameters = makeReverbParameters(reverb, config);
+            reverb.setParameters(&parameters);
+
+            std::vector<float> output(2 * NUM_FRAMES);
+            for (int i = 0; i < NUM_FRAMES; i += FRAMES_PER_BLOCK) {
+                reverb.render(&input[2 * i], &output[2 * i], FRAMES_PER_BLOCK);
+            }
+
+            const float* reference = REVERB_REFERENCE[rate][config];
+            float maxError = 0.0f;
+            for (int j = 0; j < NUM_REFERENCE_FRAMES; j++) {
+                int i = (j + 1) * REFERENCE_STRIDE - 1;
+                maxError = std::max(maxError, fabsf(output[2 * i + 0] - reference[2 * j + 0]));
+                maxError = std::max(maxError, fabsf(output[2 * i + 1] - reference[2 * j + 1]));
+            }
+            QVERIFY2(maxError <= MAX_REVERB_ERROR, qPrintable(QString("config %1 at %2Hz: max error %3")
+                .arg(config).arg(SAMPLE_RATES[rate]).arg(maxError)));
+        }
+    }
+}
+
+void AudioDSPTests::limiterReference() {
+    const int NUM_FRAMES = SAMPLE_RATE;
+
+    const int16_t* REFERENCES[] = { LIMITER_REFERENCE_1, LIMITER_REFERENCE_2, LIMITER_REFERENCE_4 };
+    const int NUM_CHANNELS[] = { 1, 2, 4 };
+    for (int k = 0; k < 3; k++) {
+        int numChannels = NUM_CHANNELS[k];
+
+        std::vector<float> input = makeReferenceSignal(numChannels * NUM_FRAMES, 65536.0f);
+
+        AudioLimiter limiter(SAMPLE_RATE, numChannels);
+        limiter.setThreshold(-6.0f);
+
+        std::vector<int16_t> output(numChannels * NUM_FRAMES);
+        for (int i = 0; i < NUM_FRAMES; i += FRAMES_PER_BLOCK) {
+            limiter.render(&input[numChannels * i], &output[numChannels * i], FRAMES_PER_BLOCK);
+        }
+
+        int maxError = 0;
+        for (int j = 0; j < NUM_REFERENCE_FRAMES; j++) {
+            int i = (j + 1) * REFERENCE_STRIDE - 1;
+            for (int c = 0; c < numChannels; c++) {
+                maxError = std::max(maxError, abs(output[numChannels * i + c] - REFERENCES[k][numChannels * j + c]));
+            }
+        }
+        QVERIFY2(maxError <= MAX_LIMITER_ERROR, qPrintable(QString("%1 channels: max error %2").arg(numChannels).arg(maxError)));
+    }
+}
+
+void AudioDSPTests::benchmarkReverb() {
+    const int NUM_FRAMES = 10 * SAMPLE_RATE;
+    const float NSECS_PER_SECOND = 1.0e9f;
+
+    std::vector<float> input = makeSignal(2 * FRAMES_PER_BLOCK, 0.5f);
+    std::vector<float> output(2 * FRAMES_PER_BLOCK);
+
+    AudioReverb reverb(SAMPLE_RATE);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < NUM_FRAMES; i += FRAMES_PER_BLOCK) {
+        reverb.render(input.data(), output.data(), FRAMES_PER_BLOCK);
+    }
+    float seconds = timer.nsecsElapsed() / NSECS_PER_SECOND;
+
+    qDebug() << "reverb:" << NUM_FRAMES / seconds << "frames per second," << (float)NUM_FRAMES / SAMPLE_RATE / seconds << "x realtime";
+}
+
+void AudioDSPTests::benchmarkLimiter() {
+    const int NUM_FRAMES = 10 * SAMPLE_RATE;
+    const float NSECS_PER_SECOND = 1.0e9f;
+
+    std::vector<float> input = makeSignal(2 * FRAMES_PER_BLOCK, 65536.0f);
+    std::vector<int16_t> output(2 * FRAMES_PER_BLOCK);
+
+    AudioLimiter limiter(SAMPLE_RATE, 2);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < NUM_FRAMES; i += FRAMES_PER_BLOCK) {
+        limiter.render(input.data(), output.data(), FRAMES_PER_BLOCK);
+    }
+    float seconds = timer.nsecsElapsed() / NSECS_PER_SECOND;
+
+    qDebug() << "limiter:" << NUM_FRAMES / seconds << "frames per second," << (float)NUM_FRAMES / SAMPLE_RATE / seconds << "x realtime";
+}
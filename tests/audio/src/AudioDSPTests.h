@@ -0,0 +1,31 @@
+//
+//  AudioDSPTests.h
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioDSPTests_h
+#define hifi_AudioDSPTests_h
+
+#include <QtTest/QtTest>
+
+// Checks the vectorized reverb and limiter against their frame at a time results, and measures their throughput.
+// A single frame only runs the scalar tails of the SSE2/AVX2 kernels, so rendering a frame at a time gives the
+// scalar result to compare the block results against. The reference tests also hold block results against output
+// of the scalar only code from before the kernels, so a bug shared by both paths shows up too.
+class AudioDSPTests : public QObject {
+    Q_OBJECT
+private slots:
+    void reverbBlocks();
+    void limiterBlocks();
+    void reverbReference();
+    void limiterReference();
+    void benchmarkReverb();
+    void benchmarkLimiter();
+};
+
+#endif // hifi_AudioDSPTests_h
@@ -0,0 +1,290 @@
+//
+//  AudioJitterBufferTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioJitterBufferTests.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+#include <NLPacket.h>
+#include <NumericalConstants.h>
+#include <ReceivedMessage.h>
+#include <SharedUtil.h>
+
+#include "AudioConcealment.h"
+#include "AudioConstants.h"
+#include "AudioTimeStretch.h"
+#include "MixedAudioStream.h"
+
+QTEST_MAIN(AudioJitterBufferTests)
+
+// a minute of packets, starting at 1s since a receive time of 0 means the packet did not come from a socket
+static const int TRACE_PACKETS = 60 * 100;
+static const quint64 TRACE_START_USECS = USECS_PER_SECOND;
+static const quint64 BASE_LATENCY_USECS = 20 * 1000;
+
+static const int STREAM_CAPACITY_FRAMES = 100;
+
+// a 200Hz tone with a harmonic, so the concealment and the time stretching have a pitch to lock on to
+static void renderTone(int16_t* samples, int numFrames, int numChannels, int firstFrame) {
+    for (int i = 0; i < numFrames; i++) {
+        float t = (float)(firstFrame + i) / AudioConstants::SAMPLE_RATE;
+        float value = 8000.0f * sinf(2.0f * PI * 200.0f * t) + 3000.0f * sinf(2.0f * PI * 400.0f * t + 1.0f);
+        for (int j = 0; j < numChannels; j++) {
+            samples[i * numChannels + j] = (int16_t)lrintf(value);
+        }
+    }
+}
+
+static quint64 sendTime(int packet) {
+    return TRACE_START_USECS + (quint64)packet * AudioConstants::NETWORK_FRAME_USECS;
+}
+
+static void sortByArrival(QVector<AudioJitterBufferTests::Arrival>& trace) {
+    std::stable_sort(trace.begin(), trace.end(), [](const AudioJitterBufferTests::Arrival& a,
+                                                    const AudioJitterBufferTests::Arrival& b) {
+        return a.usecs < b.usecs;
+    });
+}
+
+// up to 2ms of jitter on a wired connection
+static QVector<AudioJitterBufferTests::Arrival> cleanTrace(std::mt19937& random) {
+    std::uniform_int_distribution<int> jitter(0, 2000);
+
+    QVector<AudioJitterBufferTests::Arrival> trace;
+    for (int i = 0; i < TRACE_PACKETS; i++) {
+        trace.push_back({ (quint16)i, sendTime(i) + BASE_LATENCY_USECS + jitter(random) });
+    }
+    sortByArrival(trace);
+    return trace;
+}
+
+// wifi that stalls for 60ms every 2s, then delivers everything it held back at once
+static QVector<AudioJitterBufferTests::Arrival> wifiTrace(std::mt19937& random) {
+    const int STALL_INTERVAL_PACKETS = 200;
+    const quint64 STALL_USECS = 60 * 1000;
+    std::uniform_int_distribution<int> jitter(0, 2000);
+
+    QVector<AudioJitterBufferTests::Arrival> trace;
+    for (int i = 0; i < TRACE_PACKETS; i++) {
+        quint64 stallStart = sendTime(i - i % STALL_INTERVAL_PACKETS);
+        quint64 arrival;
+        if (sendTime(i) < stallStart + STALL_USECS) {
+            arrival = stallStart + STALL_USECS + BASE_LATENCY_USECS;
+        } else {
+            arrival = sendTime(i) + BASE_LATENCY_USECS + jitter(random);
+        }
+        trace.push_back({ (quint16)i, arrival });
+    }
+    sortByArrival(trace);
+    return trace;
+}
+
+// 3% of packets lost at random, plus three in a row every 5s
+static QVector<AudioJitterBufferTests::Arrival> lossyTrace(std::mt19937& random) {
+    const int BURST_INTERVAL_PACKETS = 500;
+    const int BURST_PACKETS = 3;
+    std::uniform_int_distribution<int> jitter(0, 2000);
+    std::bernoulli_distribution isLost(0.03);
+
+    QVector<AudioJitterBufferTests::Arrival> trace;
+    for (int i = 0; i < TRACE_PACKETS; i++) {
+        bool isBurstLost = i > 0 && i % BURST_INTERVAL_PACKETS < BURST_PACKETS;
+        if (isLost(random) || isBurstLost) {
+            continue;
+        }
+        trace.push_back({ (quint16)i, sendTime(i) + BASE_LATENCY_USECS + jitter(random) });
+    }
+    sortByArrival(trace);
+    return trace;
+}
+
+static QVector<AudioJitterBufferTests::Arrival> readTrace(const QString& path) {
+    QVector<AudioJitterBufferTests::Arrival> trace;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return trace;
+    }
+
+    QTextStream stream(&file);
+    while (!stream.atEnd()) {
+        auto fields = stream.readLine().split(' ', QString::SkipEmptyParts);
+        if (fields.size() == 2) {
+            trace.push_back({ (quint16)fields[0].toUInt(), fields[1].toULongLong() });
+        }
+    }
+    return trace;
+}
+
+AudioJitterBufferTests::ReplayStats AudioJitterBufferTests::replay(const QVector<Arrival>& trace, const QString& name) {
+    ReplayStats stats;
+    if (trace.isEmpty()) {
+        return stats;
+    }
+
+    // the mixer's side of the stream, underruns are concealed on the spot
+    MixedAudioStream stream(STREAM_CAPACITY_FRAMES);
+    stream.setConcealUnderruns(true);
+
+    quint64 targetDelaySumMs = 0;
+    quint64 bufferedSumMs = 0;
+
+    quint64 now = trace.first().usecs;
+    int next = 0;
+    while (next < trace.size()) {
+        now += AudioConstants::NETWORK_FRAME_USECS;
+
+        for (; next < trace.size() && trace[next].usecs <= now; next++) {
+            const Arrival& arrival = trace[next];
+
+            int16_t samples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+            renderTone(samples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL, AudioConstants::STEREO,
+                       arrival.sequence * AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+
+            auto packet = NLPacket::create(PacketType::MixedAudio);
+            packet->writePrimitive(arrival.sequence);
+            packet->writeString(QString());
+            packet->write(reinterpret_cast<const char*>(samples), sizeof(samples));
+            packet->setReceiveTime(p_high_resolution_clock::time_point(std::chrono::microseconds(arrival.usecs)));
+            packet->seek(0);
+
+            ReceivedMessage message(*packet);
+            stream.parseData(message);
+            stats.packets++;
+        }
+
+        stream.popFrames(1, true);
+        stats.pops++;
+
+        if (stats.pops % 100 == 0) {
+            stream.perSecondCallbackForUpdatingStats();
+        }
+
+        int targetDelayMs = stream.getTargetDelayUsecs() / USECS_PER_MSEC;
+        targetDelaySumMs += targetDelayMs;
+        stats.maxTargetDelayMs = std::max(stats.maxTargetDelayMs, targetDelayMs);
+        bufferedSumMs += stream.getFramesAvailable() * AudioConstants::NETWORK_FRAME_USECS / USECS_PER_MSEC;
+    }
+
+    AudioStreamStats streamStats = stream.getAudioStreamStats();
+    stats.starves = stream.getStarveCount();
+    stats.framesConcealed = streamStats._framesConcealed;
+    stats.concealedRate = streamStats._concealedRate;
+    stats.stretchedRate = streamStats._stretchedRate;
+    stats.averageTargetDelayMs = (float)targetDelaySumMs / stats.pops;
+    stats.averageBufferedMs = (float)bufferedSumMs / stats.pops;
+
+    qDebug() << name << "packets:" << stats.packets << "starves:" << stats.starves
+        << "concealed:" << stats.framesConcealed << "concealed%_30s:" << stats.concealedRate * 100.0f
+        << "stretched%_30s:" << stats.stretchedRate * 100.0f
+        << "target delay avg/max ms:" << stats.averageTargetDelayMs << "/" << stats.maxTargetDelayMs
+        << "buffered avg ms:" << stats.averageBufferedMs;
+
+    return stats;
+}
+
+void AudioJitterBufferTests::cleanNetwork() {
+    std::mt19937 random(1);
+    auto stats = replay(cleanTrace(random), "clean");
+
+    QCOMPARE(stats.starves, 0);
+    QVERIFY(stats.concealedRate < 0.01f);
+    QVERIFY(stats.averageTargetDelayMs <= 20.0f);
+}
+
+void AudioJitterBufferTests::wifiBursts() {
+    std::mt19937 random(2);
+    auto stats = replay(wifiTrace(random), "wifi");
+
+    // once the stalls recur the buffer holds enough to ride them out
+    QCOMPARE(stats.starves, 0);
+    QVERIFY(stats.maxTargetDelayMs >= 60);
+    QVERIFY(stats.concealedRate < 0.01f);
+}
+
+void AudioJitterBufferTests::randomLoss() {
+    std::mt19937 random(3);
+    auto trace = lossyTrace(random);
+    auto stats = replay(trace, "lossy");
+
+    // every lost packet is concealed, and losses alone don't grow the buffer
+    QCOMPARE(stats.starves, 0);
+    QVERIFY(stats.framesConcealed >= TRACE_PACKETS - trace.size());
+    QVERIFY(stats.concealedRate < 0.06f);
+    QVERIFY(stats.averageTargetDelayMs <= 20.0f);
+}
+
+void AudioJitterBufferTests::recordedTraces() {
+    QString tracesPath = QString::fromLocal8Bit(qgetenv("AUDIO_JITTER_TRACES"));
+    if (tracesPath.isEmpty()) {
+        QSKIP("AUDIO_JITTER_TRACES is not set");
+    }
+
+    QDir tracesDir(tracesPath);
+    auto traceFiles = tracesDir.entryInfoList(QDir::Files, QDir::Name);
+    QVERIFY(!traceFiles.isEmpty());
+
+    for (auto& traceFile : traceFiles) {
+        auto trace = readTrace(traceFile.absoluteFilePath());
+        auto stats = replay(trace, traceFile.fileName());
+        QCOMPARE(stats.packets, trace.size());
+    }
+}
+
+void AudioJitterBufferTests::timeStretch() {
+    const int NUM_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+    const int NUM_CHANNELS = AudioConstants::STEREO;
+    const int SAMPLE_RATE = AudioConstants::SAMPLE_RATE;
+    const int MAX_LAG = AudioTimeStretch::getMaxLag(SAMPLE_RATE);
+
+    int16_t input[NUM_FRAMES * NUM_CHANNELS];
+    int16_t output[(NUM_FRAMES + 200) * NUM_CHANNELS];
+    QVERIFY(MAX_LAG <= 200);
+    renderTone(input, NUM_FRAMES, NUM_CHANNELS, 0);
+
+    // the tone repeats every 5ms, which is what both should step by
+    int compressedFrames = AudioTimeStretch::compress(input, output, NUM_FRAMES, NUM_CHANNELS, SAMPLE_RATE);
+    QCOMPARE(compressedFrames, NUM_FRAMES - SAMPLE_RATE / 200);
+    int expandedFrames = AudioTimeStretch::expand(input, output, NUM_FRAMES, NUM_CHANNELS, SAMPLE_RATE);
+    QCOMPARE(expandedFrames, NUM_FRAMES + SAMPLE_RATE / 200);
+
+    // both ends line up with the frames around it
+    QVERIFY(abs(output[0] - input[0]) <= 1);
+    QVERIFY(abs(output[(expandedFrames - 1) * NUM_CHANNELS] - input[(NUM_FRAMES - 1) * NUM_CHANNELS]) <= 1);
+
+    // noise has no period to step by, it is left alone
+    std::mt19937 random(4);
+    std::uniform_int_distribution<int> noise(-8000, 8000);
+    for (auto& sample : input) {
+        sample = (int16_t)noise(random);
+    }
+    QCOMPARE(AudioTimeStretch::compress(input, output, NUM_FRAMES, NUM_CHANNELS, SAMPLE_RATE), NUM_FRAMES);
+    QCOMPARE(AudioTimeStretch::expand(input, output, NUM_FRAMES, NUM_CHANNELS, SAMPLE_RATE), NUM_FRAMES);
+
+    // a lost frame carries on the tone, then fades out within 400ms
+    AudioConcealment concealment;
+    for (int i = 0; i < 4; i++) {
+        renderTone(input, NUM_FRAMES, NUM_CHANNELS, i * NUM_FRAMES);
+        concealment.receivedFrame(input, NUM_FRAMES, NUM_CHANNELS);
+    }
+    QVERIFY(concealment.concealFrame(output, NUM_FRAMES, NUM_CHANNELS));
+    renderTone(input, NUM_FRAMES, NUM_CHANNELS, 4 * NUM_FRAMES);
+    for (int i = 0; i < NUM_FRAMES * NUM_CHANNELS; i++) {
+        QVERIFY(abs(output[i] - input[i]) <= 1);
+    }
+
+    int concealedFrames = 1;
+    while (concealment.concealFrame(output, NUM_FRAMES, NUM_CHANNELS)) {
+        concealedFrames++;
+        QVERIFY(concealedFrames < 40);
+    }
+}
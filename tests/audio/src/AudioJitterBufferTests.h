@@ -0,0 +1,50 @@
+//
+//  AudioJitterBufferTests.h
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioJitterBufferTests_h
+#define hifi_AudioJitterBufferTests_h
+
+#include <QtTest/QtTest>
+
+// Replays packet arrival traces through an InboundAudioStream, popping a frame every 10ms like the mixer does.
+// A trace is a text file with a "<sequence> <arrival usecs>" line per packet received, in order of arrival; point
+// AUDIO_JITTER_TRACES at a directory of them to replay recorded traces next to the synthetic ones.
+class AudioJitterBufferTests : public QObject {
+    Q_OBJECT
+public:
+    struct Arrival {
+        quint16 sequence;
+        quint64 usecs;
+    };
+
+    struct ReplayStats {
+        int packets { 0 };
+        int pops { 0 };
+        int starves { 0 };
+        int framesConcealed { 0 };
+        float concealedRate { 0.0f };
+        float stretchedRate { 0.0f };
+        float averageTargetDelayMs { 0.0f };
+        int maxTargetDelayMs { 0 };
+        float averageBufferedMs { 0.0f };
+    };
+
+private slots:
+    void cleanNetwork();
+    void wifiBursts();
+    void randomLoss();
+    void recordedTraces();
+    void timeStretch();
+
+private:
+    ReplayStats replay(const QVector<Arrival>& trace, const QString& name);
+};
+
+#endif // hifi_AudioJitterBufferTests_h
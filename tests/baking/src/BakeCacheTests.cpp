@@ -0,0 +1,171 @@
+//
+//  BakeCacheTests.cpp
+//  tests/baking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BakeCacheTests.h"
+
+#include <QtCore/QThread>
+
+#include <BakeCache.h>
+
+QTEST_MAIN(BakeCacheTests)
+
+static const QByteArray SOURCE_CONTENT = "the content of the source file";
+static const QByteArray BAKED_CONTENT = "the baked output";
+
+void BakeCacheTests::init() {
+    // every test gets an empty cache
+    _directory.reset(new QTemporaryDir());
+    QVERIFY(_directory->isValid());
+}
+
+QString BakeCacheTests::writeSourceFile(const QString& fileName, const QByteArray& content) {
+    QString path = _directory->path() + "/files/" + fileName;
+    QDir().mkpath(QFileInfo(path).path());
+
+    QFile file { path };
+    if (!file.open(QIODevice::WriteOnly) || file.write(content) != content.size()) {
+        return QString();
+    }
+    return path;
+}
+
+void BakeCacheTests::testOwner() {
+    BakeCache cache { _directory->path() + "/cache" };
+    auto key = BakeCache::makeKey(BakeCache::hashContent(SOURCE_CONTENT), "test", 1);
+
+    // the first to ask bakes the entry, everyone after waits for it
+    QCOMPARE(cache.claim(key), BakeCache::Claim::Bake);
+    QCOMPARE(cache.claim(key), BakeCache::Claim::Wait);
+    QVERIFY(!cache.contains(key));
+    QCOMPARE(cache.getMisses(), 1);
+    QCOMPARE(cache.getHits(), 0);
+
+    // the same content baked differently is its own entry
+    auto otherKey = BakeCache::makeKey(BakeCache::hashContent(SOURCE_CONTENT), "test", 1, "other options");
+    QVERIFY(otherKey != key);
+    QCOMPARE(cache.claim(otherKey), BakeCache::Claim::Bake);
+}
+
+void BakeCacheTests::testWait() {
+    BakeCache cache { _directory->path() + "/cache" };
+    auto key = BakeCache::makeKey(BakeCache::hashContent(SOURCE_CONTENT), "test", 1);
+    QSignalSpy finishedSpy { &cache, &BakeCache::entryFinished };
+
+    QCOMPARE(cache.claim(key), BakeCache::Claim::Bake);
+    QCOMPARE(cache.claim(key), BakeCache::Claim::Wait);
+
+    auto bakedPath = writeSourceFile("baked.out", BAKED_CONTENT);
+    QVERIFY(cache.store(key, { { "baked", { bakedPath } } }, QJsonObject { { "file", "baked.out" } }));
+
+    QCOMPARE(finishedSpy.count(), 1);
+    QCOMPARE(finishedSpy[0][0].toString(), key);
+    QCOMPARE(finishedSpy[0][1].toBool(), true);
+
+    // the waiter finds the entry once it is told about it
+    QCOMPARE(cache.claim(key), BakeCache::Claim::Hit);
+    QCOMPARE(cache.getHits(), 1);
+}
+
+void BakeCacheTests::testWaitForFailedBake() {
+    BakeCache cache { _directory->path() + "/cache" };
+    auto key = BakeCache::makeKey(BakeCache::hashContent(SOURCE_CONTENT), "test", 1);
+    QSignalSpy finishedSpy { &cache, &BakeCache::entryFinished };
+
+    QCOMPARE(cache.claim(key), BakeCache::Claim::Bake);
+    QCOMPARE(cache.claim(key), BakeCache::Claim::Wait);
+
+    cache.release(key);
+
+    QCOMPARE(finishedSpy.count(), 1);
+    QCOMPARE(finishedSpy[0][1].toBool(), false);
+
+    // nothing was stored, so the waiter bakes it itself
+    QVERIFY(!cache.contains(key));
+    QCOMPARE(cache.claim(key), BakeCache::Claim::Bake);
+}
+
+void BakeCacheTests::testHit() {
+    auto key = BakeCache::makeKey(BakeCache::hashContent(SOURCE_CONTENT), "test", 1);
+    auto bakedPath = writeSourceFile("baked.out", BAKED_CONTENT);
+
+    {
+        BakeCache cache { _directory->path() + "/cache" };
+        QCOMPARE(cache.claim(key), BakeCache::Claim::Bake);
+        QVERIFY(cache.store(key, { { "baked", { bakedPath } } }, QJsonObject { { "file", "baked.out" } }));
+    }
+
+    // entries are kept between bakes
+    BakeCache cache { _directory->path() + "/cache" };
+    QVERIFY(cache.contains(key));
+    QCOMPARE(cache.claim(key), BakeCache::Claim::Hit);
+    QCOMPARE(cache.getManifest(key)["file"].toString(), QString("baked.out"));
+
+    auto restored = cache.restore(key, "baked", _directory->path() + "/restored");
+    QCOMPARE(restored.size(), 1);
+
+    QFile restoredFile { restored.first() };
+    QVERIFY(restoredFile.open(QIODevice::ReadOnly));
+    QCOMPARE(restoredFile.readAll(), BAKED_CONTENT);
+
+    auto restoredFilePath = _directory->path() + "/restored-file.out";
+    QVERIFY(cache.restoreFile(key, "baked", "baked.out", restoredFilePath));
+    QVERIFY(QFileInfo(restoredFilePath).exists());
+}
+
+void BakeCacheTests::testStaleEntry() {
+    BakeCache cache { _directory->path() + "/cache" };
+    auto key = BakeCache::makeKey(BakeCache::hashContent(SOURCE_CONTENT), "test", 1);
+    auto bakedPath = writeSourceFile("baked.out", BAKED_CONTENT);
+
+    QCOMPARE(cache.claim(key), BakeCache::Claim::Bake);
+    QVERIFY(cache.store(key, { { "baked", { bakedPath } } }));
+    QCOMPARE(cache.claim(key), BakeCache::Claim::Hit);
+
+    // what the bakers do when a file the entry was baked from has changed
+    cache.remove(key);
+    QVERIFY(!cache.contains(key));
+    QCOMPARE(cache.claim(key), BakeCache::Claim::Bake);
+
+    // and its replacement is stored over it
+    QVERIFY(cache.store(key, { { "baked", { bakedPath } } }));
+    QCOMPARE(cache.claim(key), BakeCache::Claim::Hit);
+}
+
+void BakeCacheTests::testWaitAcrossThreads() {
+    BakeCache cache { _directory->path() + "/cache" };
+    auto key = BakeCache::makeKey(BakeCache::hashContent(SOURCE_CONTENT), "test", 1);
+    auto bakedPath = writeSourceFile("baked.out", BAKED_CONTENT);
+
+    QCOMPARE(cache.claim(key), BakeCache::Claim::Bake);
+
+    // the owner finishes as soon as the waiter has claimed, as a baker on another thread might
+    QThread ownerThread;
+    QObject owner;
+    owner.moveToThread(&ownerThread);
+    ownerThread.start();
+
+    // connected before claiming, as the bakers do
+    bool wasNotified = false;
+    QObject waiter;
+    connect(&cache, &BakeCache::entryFinished, &waiter, [&](QString finishedKey, bool stored) {
+        wasNotified = (finishedKey == key && stored);
+    });
+
+    QCOMPARE(cache.claim(key), BakeCache::Claim::Wait);
+    QTimer::singleShot(0, &owner, [&] {
+        cache.store(key, { { "baked", { bakedPath } } });
+    });
+
+    QTRY_VERIFY(wasNotified);
+    QCOMPARE(cache.claim(key), BakeCache::Claim::Hit);
+
+    ownerThread.quit();
+    ownerThread.wait();
+}
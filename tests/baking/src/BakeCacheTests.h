@@ -0,0 +1,38 @@
+//
+//  BakeCacheTests.h
+//  tests/baking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BakeCacheTests_h
+#define hifi_BakeCacheTests_h
+
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QtTest>
+
+class BakeCacheTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    void testOwner();
+    void testWait();
+    void testWaitForFailedBake();
+    void testHit();
+    void testStaleEntry();
+
+    // the owner finishing on another thread right after the waiter claims must still reach the waiter
+    void testWaitAcrossThreads();
+
+private:
+    QString writeSourceFile(const QString& fileName, const QByteArray& content);
+
+    std::unique_ptr<QTemporaryDir> _directory;
+};
+
+#endif // hifi_BakeCacheTests_h
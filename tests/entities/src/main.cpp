@@ -8,6 +8,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include <QCoreApplication>
 #include <QFile>
 #include <QTimer>
@@ -18,6 +20,7 @@
 
 #include <ShapeEntityItem.h>
 #include <EntityItemProperties.h>
+#include <EntityTree.h>
 #include <Octree.h>
 #include <PathUtils.h>
 
@@ -135,6 +138,165 @@ void testPropertyFlags() {
     testPropertyFlags(0xFFFF);
 }
 
+void benchmarkEditPacketDecode() {
+    const int NUM_POINTS = 50;
+    const int DECODE_LOOPS = 100000;
+
+    // an edit with the kinds of properties that used to allocate a temporary per decode
+    EntityItemProperties properties;
+    properties.setType(EntityTypes::PolyLine);
+    properties.setName("decode benchmark");
+    properties.setUserData(QString(512, 'x'));
+    properties.setPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+    QVector<glm::vec3> points;
+    QVector<float> strokeWidths;
+    for (int i = 0; i < NUM_POINTS; ++i) {
+        points.push_back(glm::vec3((float)i, 0.0f, 0.0f));
+        strokeWidths.push_back(0.1f);
+    }
+    properties.setLinePoints(points);
+    properties.setNormals(points);
+    properties.setStrokeWidths(strokeWidths);
+
+    QByteArray buffer(NLPacket::maxPayloadSize(PacketType::EntityEdit), 0);
+    if (!EntityItemProperties::encodeEntityEditPacket(PacketType::EntityEdit, EntityItemID(QUuid::createUuid()),
+                                                      properties, buffer)) {
+        qDebug() << "failed to encode edit packet";
+        return;
+    }
+
+    StopWatch stopWatch;
+    stopWatch.start();
+    for (int i = 0; i < DECODE_LOOPS; ++i) {
+        EntityItemID entityID;
+        EntityItemProperties decoded;
+        int processedBytes = 0;
+        EntityItemProperties::decodeEntityEditPacket(reinterpret_cast<const unsigned char*>(buffer.constData()),
+                                                     buffer.size(), processedBytes, entityID, decoded);
+    }
+    stopWatch.stop();
+    qDebug() << "edit packet decode:" << ((float)stopWatch.getTotal() / (float)DECODE_LOOPS) << "usecs,"
+        << ((float)DECODE_LOOPS * (float)USECS_PER_SECOND / (float)stopWatch.getTotal()) << "decodes per second";
+}
+
+float randomCoordinate(float range) {
+    return range * ((float)rand() / (float)RAND_MAX);
+}
+
+glm::vec3 randomPosition(float range) {
+    return glm::vec3(randomCoordinate(range), randomCoordinate(range), randomCoordinate(range));
+}
+
+bool sameEntities(QVector<EntityItemPointer> a, QVector<EntityItemPointer> b) {
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    return a == b;
+}
+
+void benchmarkSpatialQueries(int numEntities) {
+    const float WORLD_SIZE = 2000.0f;
+    const float MAX_DIMENSION = 5.0f;
+    const float QUERY_RADIUS = 20.0f;
+    const int NUM_QUERIES = 1000;
+
+    srand(numEntities);
+    EntityTreePointer tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    for (int i = 0; i < numEntities; ++i) {
+        EntityItemProperties properties;
+        properties.setType(EntityTypes::Box);
+        properties.setPosition(randomPosition(WORLD_SIZE));
+        properties.setDimensions(glm::vec3(0.1f) + randomPosition(MAX_DIMENSION));
+        tree->addEntity(EntityItemID(QUuid::createUuid()), properties);
+    }
+    const EntitySpatialIndex& index = tree->getSpatialIndex();
+
+    QVector<glm::vec3> centers;
+    QVector<glm::vec3> directions;
+    for (int i = 0; i < NUM_QUERIES; ++i) {
+        centers.push_back(randomPosition(WORLD_SIZE));
+        directions.push_back(glm::normalize(randomPosition(1.0f) - glm::vec3(0.5f)));
+    }
+
+    StopWatch treeTimer;
+    StopWatch indexTimer;
+    int mismatches = 0;
+    int found = 0;
+
+    // spheres
+    for (int i = 0; i < NUM_QUERIES; ++i) {
+        QVector<EntityItemPointer> treeEntities;
+        QVector<EntityItemPointer> indexEntities;
+        treeTimer.start();
+        tree->withReadLock([&] {
+            tree->findEntities(centers[i], QUERY_RADIUS, treeEntities);
+        });
+        treeTimer.stop();
+        indexTimer.start();
+        index.findEntities(centers[i], QUERY_RADIUS, indexEntities);
+        indexTimer.stop();
+        found += treeEntities.size();
+        mismatches += sameEntities(treeEntities, indexEntities) ? 0 : 1;
+    }
+    qDebug() << numEntities << "entities, sphere queries: tree" << treeTimer.getAverage() << "usecs, index"
+        << indexTimer.getAverage() << "usecs," << ((float)found / (float)NUM_QUERIES) << "found per query,"
+        << mismatches << "mismatches";
+
+    // boxes
+    treeTimer.reset();
+    indexTimer.reset();
+    mismatches = 0;
+    found = 0;
+    for (int i = 0; i < NUM_QUERIES; ++i) {
+        AABox box(centers[i], glm::vec3(2.0f * QUERY_RADIUS));
+        QVector<EntityItemPointer> treeEntities;
+        QVector<EntityItemPointer> indexEntities;
+        treeTimer.start();
+        tree->withReadLock([&] {
+            tree->findEntities(box, treeEntities);
+        });
+        treeTimer.stop();
+        indexTimer.start();
+        index.findEntities(box, indexEntities);
+        indexTimer.stop();
+        found += treeEntities.size();
+        mismatches += sameEntities(treeEntities, indexEntities) ? 0 : 1;
+    }
+    qDebug() << numEntities << "entities, box queries: tree" << treeTimer.getAverage() << "usecs, index"
+        << indexTimer.getAverage() << "usecs," << ((float)found / (float)NUM_QUERIES) << "found per query,"
+        << mismatches << "mismatches";
+
+    // rays
+    treeTimer.reset();
+    indexTimer.reset();
+    mismatches = 0;
+    found = 0;
+    for (int i = 0; i < NUM_QUERIES; ++i) {
+        OctreeElementPointer element;
+        float treeDistance;
+        float indexDistance;
+        BoxFace face;
+        glm::vec3 normal;
+        EntityItem* treeEntity = nullptr;
+        EntityItem* indexEntity = nullptr;
+        treeTimer.start();
+        bool treeHit = tree->findRayIntersection(centers[i], directions[i], QVector<EntityItemID>(), QVector<EntityItemID>(),
+            false, false, false, element, treeDistance, face, normal, (void**)&treeEntity, Octree::Lock);
+        treeTimer.stop();
+        indexTimer.start();
+        bool indexHit = index.findRayIntersection(centers[i], directions[i], QVector<EntityItemID>(), QVector<EntityItemID>(),
+            false, false, false, element, indexDistance, face, normal, (void**)&indexEntity);
+        indexTimer.stop();
+        found += treeHit ? 1 : 0;
+        // equally close hits may be reported in either order
+        if (treeHit != indexHit || (treeHit && treeDistance != indexDistance)) {
+            mismatches++;
+        }
+    }
+    qDebug() << numEntities << "entities, ray queries: tree" << treeTimer.getAverage() << "usecs, index"
+        << indexTimer.getAverage() << "usecs," << found << "hits," << mismatches << "mismatches";
+}
+
 int main(int argc, char** argv) {
     QCoreApplication app(argc, argv);
     {
@@ -152,6 +314,10 @@ int main(int argc, char** argv) {
     }
     DependencyManager::set<NodeList>(NodeType::Unassigned);
 
+    benchmarkEditPacketDecode();
+    benchmarkSpatialQueries(10000);
+    benchmarkSpatialQueries(100000);
+
     QFile file(getTestResourceDir() + "packet.bin");
     if (!file.open(QIODevice::ReadOnly)) return -1;
     QByteArray packet = file.readAll();
@@ -0,0 +1,375 @@
+//
+//  FBXReaderTests.cpp
+//  tests/fbx/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "FBXReaderTests.h"
+
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+#include <QtCore/QBuffer>
+#include <QtCore/QDataStream>
+#include <QtCore/QTemporaryFile>
+#include <QtCore/QtEndian>
+
+#include <FBXReader.h>
+#include <FBXWriter.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(FBXReaderTests)
+
+namespace {
+    FBXNode makeNode(const QByteArray& name, const QVariantList& properties = QVariantList()) {
+        FBXNode node;
+        node.name = name;
+        node.properties = properties;
+        return node;
+    }
+
+    // a mesh roughly shaped like what an exporter writes, with arrays large enough to be compressed
+    FBXNode makeGeometryNode(int id, int numVertices) {
+        QVector<double> vertices;
+        QVector<double> normals;
+        QVector<double> uvs;
+        QVector<int> indices;
+        for (int i = 0; i < numVertices; i++) {
+            float angle = (float)i * 0.01f;
+            vertices << std::cos(angle) * (1.0 + 0.001 * (i % 97)) << std::sin(angle) << 0.0001 * i;
+            normals << std::cos(angle) << std::sin(angle) << 0.0;
+            uvs << (double)(i % 1024) / 1024.0 << (double)(i / 1024) / 1024.0;
+            // every third index ends a polygon
+            indices << ((i % 3 == 2) ? ~i : i);
+        }
+
+        FBXNode geometry = makeNode("Geometry", { QVariant::fromValue((qint64)id), QByteArray("Geometry::mesh"),
+                                                  QByteArray("Mesh") });
+        geometry.children << makeNode("Vertices", { QVariant::fromValue(vertices) });
+        geometry.children << makeNode("PolygonVertexIndex", { QVariant::fromValue(indices) });
+
+        FBXNode normalLayer = makeNode("LayerElementNormal", { 0 });
+        normalLayer.children << makeNode("MappingInformationType", { QByteArray("ByPolygonVertex") });
+        normalLayer.children << makeNode("Normals", { QVariant::fromValue(normals) });
+        geometry.children << normalLayer;
+
+        FBXNode uvLayer = makeNode("LayerElementUV", { 0 });
+        uvLayer.children << makeNode("UV", { QVariant::fromValue(uvs) });
+        uvLayer.children << makeNode("UVIndex", { QVariant::fromValue(indices) });
+        geometry.children << uvLayer;
+        return geometry;
+    }
+
+    FBXNode makeDocument(int numMeshes, int numVertices) {
+        FBXNode root;
+        FBXNode header = makeNode("FBXHeaderExtension");
+        header.children << makeNode("FBXHeaderVersion", { 1003 });
+        header.children << makeNode("Creator", { QByteArray("FBXReaderTests") });
+        root.children << header;
+
+        FBXNode objects = makeNode("Objects");
+        for (int i = 0; i < numMeshes; i++) {
+            objects.children << makeGeometryNode(i + 1, numVertices);
+        }
+        root.children << objects;
+        return root;
+    }
+
+    template <typename T>
+    bool compareVectors(const QVariant& a, const QVariant& b) {
+        return a.value<QVector<T>>() == b.value<QVector<T>>();
+    }
+
+    bool compareProperties(const QVariant& a, const QVariant& b) {
+        if (a.userType() != b.userType()) {
+            return false;
+        }
+        int type = a.userType();
+        if (type == qMetaTypeId<QVector<float>>()) {
+            return compareVectors<float>(a, b);
+        } else if (type == qMetaTypeId<QVector<double>>()) {
+            return compareVectors<double>(a, b);
+        } else if (type == qMetaTypeId<QVector<qint64>>()) {
+            return compareVectors<qint64>(a, b);
+        } else if (type == qMetaTypeId<QVector<qint32>>()) {
+            return compareVectors<qint32>(a, b);
+        } else if (type == qMetaTypeId<QVector<bool>>()) {
+            return compareVectors<bool>(a, b);
+        }
+        return a == b;
+    }
+
+    bool compareNodes(const FBXNode& a, const FBXNode& b) {
+        if (a.name != b.name || a.properties.size() != b.properties.size() || a.children.size() != b.children.size()) {
+            return false;
+        }
+        for (int i = 0; i < a.properties.size(); i++) {
+            if (!compareProperties(a.properties.at(i), b.properties.at(i))) {
+                return false;
+            }
+        }
+        for (int i = 0; i < a.children.size(); i++) {
+            if (!compareNodes(a.children.at(i), b.children.at(i))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    FBXNode parseBuffer(const QByteArray& data) {
+        QBuffer buffer;
+        buffer.setData(data);
+        buffer.open(QIODevice::ReadOnly);
+        return FBXReader::parseFBX(&buffer);
+    }
+
+    // what FBXReader::parseFBX() used to do with binary files: stream every node and property through a QDataStream,
+    // and inflate arrays through qUncompress()
+    template <typename T>
+    QVariant legacyReadArray(QDataStream& in, int& position) {
+        quint32 arrayLength;
+        quint32 encoding;
+        quint32 compressedLength;
+        in >> arrayLength >> encoding >> compressedLength;
+        position += sizeof(quint32) * 3;
+
+        QVector<T> values(arrayLength);
+        QByteArray arrayData;
+        if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
+            QByteArray compressed(sizeof(quint32) + compressedLength, 0);
+            *((quint32*)compressed.data()) = qToBigEndian<quint32>(arrayLength * sizeof(T));
+            in.readRawData(compressed.data() + sizeof(quint32), compressedLength);
+            position += compressedLength;
+            arrayData = qUncompress(compressed);
+        } else {
+            arrayData.resize(sizeof(T) * arrayLength);
+            position += sizeof(T) * arrayLength;
+            in.readRawData(arrayData.data(), arrayData.size());
+        }
+        if (arrayData.size() > 0) {
+            memcpy(&values[0], arrayData.constData(), arrayData.size());
+        }
+        return QVariant::fromValue(values);
+    }
+
+    QVariant legacyParseProperty(QDataStream& in, int& position) {
+        char ch;
+        in.device()->getChar(&ch);
+        position++;
+        switch (ch) {
+            case 'Y': { qint16 value; in >> value; position += sizeof(value); return QVariant::fromValue(value); }
+            case 'C': { bool value; in >> value; position++; return QVariant::fromValue(value); }
+            case 'I': { qint32 value; in >> value; position += sizeof(value); return QVariant::fromValue(value); }
+            case 'F': { float value; in >> value; position += sizeof(value); return QVariant::fromValue(value); }
+            case 'D': { double value; in >> value; position += sizeof(value); return QVariant::fromValue(value); }
+            case 'L': { qint64 value; in >> value; position += sizeof(value); return QVariant::fromValue(value); }
+            case 'f': return legacyReadArray<float>(in, position);
+            case 'd': return legacyReadArray<double>(in, position);
+            case 'l': return legacyReadArray<qint64>(in, position);
+            case 'i': return legacyReadArray<qint32>(in, position);
+            case 'b': return legacyReadArray<bool>(in, position);
+            default: {
+                quint32 length;
+                in >> length;
+                position += sizeof(quint32) + length;
+                return QVariant::fromValue(in.device()->read(length));
+            }
+        }
+    }
+
+    FBXNode legacyParseNode(QDataStream& in, int& position) {
+        qint32 endOffset;
+        quint32 propertyCount;
+        quint32 propertyListLength;
+        quint8 nameLength;
+        in >> endOffset >> propertyCount >> propertyListLength >> nameLength;
+        position += sizeof(quint32) * 3 + sizeof(quint8);
+
+        FBXNode node;
+        const int MIN_VALID_OFFSET = 40;
+        if (endOffset < MIN_VALID_OFFSET || nameLength == 0) {
+            return node;
+        }
+        node.name = in.device()->read(nameLength);
+        position += nameLength;
+        for (quint32 i = 0; i < propertyCount; i++) {
+            node.properties.append(legacyParseProperty(in, position));
+        }
+        while (endOffset > position) {
+            FBXNode child = legacyParseNode(in, position);
+            if (child.name.isNull()) {
+                return node;
+            }
+            node.children.append(child);
+        }
+        return node;
+    }
+
+    FBXNode legacyParse(QIODevice* device) {
+        QDataStream in(device);
+        in.setByteOrder(QDataStream::LittleEndian);
+        in.setVersion(QDataStream::Qt_4_5);
+        in.skipRawData(FBX_HEADER_BYTES_BEFORE_VERSION);
+        quint32 fileVersion;
+        in >> fileVersion;
+        int position = FBX_HEADER_BYTES_BEFORE_VERSION + sizeof(fileVersion);
+
+        FBXNode top;
+        while (device->bytesAvailable()) {
+            FBXNode next = legacyParseNode(in, position);
+            if (next.name.isNull()) {
+                break;
+            }
+            top.children.append(next);
+        }
+        return top;
+    }
+
+    // Runs parse() while another thread samples the resident set, and reports the time taken and the highest
+    // resident size seen over what was resident beforehand.
+    template <typename F>
+    void measureParse(F parse, quint64& nsecs, quint64& peakBytes) {
+        quint64 baseline = getProcessResidentBytes();
+        std::atomic<bool> done { false };
+        std::atomic<quint64> peak { baseline };
+        std::thread sampler([&] {
+            while (!done) {
+                quint64 resident = getProcessResidentBytes();
+                if (resident > peak) {
+                    peak = resident;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+
+        QElapsedTimer timer;
+        timer.start();
+        {
+            FBXNode root = parse();
+            nsecs = timer.nsecsElapsed();
+            done = true;
+            sampler.join();
+            QVERIFY(!root.children.isEmpty());
+        }
+        peakBytes = peak - baseline;
+    }
+}
+
+void FBXReaderTests::testBinaryRoundTrip() {
+    FBXNode root = makeDocument(3, 5000);
+
+    // every property type the format has
+    FBXNode properties = makeNode("Properties70");
+    properties.children << makeNode("P", { QVariant::fromValue((qint16)-7), true, -123456, 1.5f, 2.25,
+                                            QVariant::fromValue((qint64)1 << 40), QByteArray("raw\0bytes", 9) });
+    properties.children << makeNode("Small", { QVariant::fromValue(QVector<float>{ 1.0f, 2.0f }),
+                                               QVariant::fromValue(QVector<qint64>{ -1, 1LL << 50 }),
+                                               QVariant::fromValue(QVector<bool>{ true, false, true }),
+                                               QVariant::fromValue(QVector<int>()) });
+    root.children << properties;
+
+    QByteArray encoded = FBXWriter::encodeFBX(root);
+    FBXNode parsed = parseBuffer(encoded);
+    QVERIFY(compareNodes(root, parsed));
+
+    QBuffer buffer(&encoded);
+    buffer.open(QIODevice::ReadOnly);
+    QVERIFY(compareNodes(legacyParse(&buffer), parsed));
+
+    // the arrays are usable the same way extractFBXGeometry() uses them
+    const FBXNode& geometry = parsed.children.at(1).children.at(0);
+    QCOMPARE(FBXReader::getDoubleVector(geometry.children.at(0)).size(), 5000 * 3);
+    QCOMPARE(FBXReader::getIntVector(geometry.children.at(1)).size(), 5000);
+}
+
+void FBXReaderTests::testMappedFile() {
+    FBXNode root = makeDocument(2, 20000);
+    QByteArray encoded = FBXWriter::encodeFBX(root);
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write(encoded);
+    file.flush();
+    file.seek(0);
+
+    FBXNode parsed = FBXReader::parseFBX(&file);
+    QVERIFY(compareNodes(root, parsed));
+
+    // the tree is independent of the mapping
+    file.close();
+    QVERIFY(compareNodes(root, parsed));
+}
+
+void FBXReaderTests::testCorruptFile() {
+    QByteArray encoded = FBXWriter::encodeFBX(makeDocument(1, 5000));
+
+    bool threw = false;
+    try {
+        parseBuffer(encoded.left(encoded.size() / 2));
+    } catch (const QString&) {
+        threw = true;
+    }
+    QVERIFY(threw);
+
+    // flip some bits in the middle of the compressed vertex data
+    QByteArray vertices = encoded;
+    int vertexArray = vertices.indexOf("Vertices") + 8;
+    for (int i = 64; i < 80; i++) {
+        vertices[vertexArray + i] = vertices[vertexArray + i] ^ 0x5a;
+    }
+    threw = false;
+    try {
+        parseBuffer(vertices);
+    } catch (const QString&) {
+        threw = true;
+    }
+    QVERIFY(threw);
+}
+
+void FBXReaderTests::benchmarkParse() {
+    // about the size of a detailed avatar
+    const int NUM_MESHES = 24;
+    const int NUM_VERTICES = 100000;
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    {
+        QByteArray encoded = FBXWriter::encodeFBX(makeDocument(NUM_MESHES, NUM_VERTICES));
+        file.write(encoded);
+        file.flush();
+    }
+    qint64 fileSize = file.size();
+
+    // the new parser runs first, the peak of the old one is measured over whatever the new one left resident
+    quint64 streamingNsecs = 0;
+    quint64 streamingPeak = 0;
+    measureParse([&] {
+        file.seek(0);
+        return FBXReader::parseFBX(&file);
+    }, streamingNsecs, streamingPeak);
+
+    quint64 legacyNsecs = 0;
+    quint64 legacyPeak = 0;
+    measureParse([&] {
+        // readFBX() callers hand over the whole file
+        file.seek(0);
+        QByteArray contents = file.readAll();
+        QBuffer buffer(&contents);
+        buffer.open(QIODevice::ReadOnly);
+        return legacyParse(&buffer);
+    }, legacyNsecs, legacyPeak);
+
+    const float BYTES_PER_MEGABYTE = 1024.0f * 1024.0f;
+    qDebug() << "Parsing a" << (float)fileSize / BYTES_PER_MEGABYTE << "MB file:";
+    qDebug() << "    legacy:" << (float)legacyNsecs / (float)NSECS_PER_MSEC << "msecs,"
+        << (float)legacyPeak / BYTES_PER_MEGABYTE << "MB peak";
+    qDebug() << "    streaming:" << (float)streamingNsecs / (float)NSECS_PER_MSEC << "msecs,"
+        << (float)streamingPeak / BYTES_PER_MEGABYTE << "MB peak,"
+        << ((float)legacyNsecs / (float)streamingNsecs) << "x";
+}
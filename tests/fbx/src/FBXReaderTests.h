@@ -0,0 +1,25 @@
+//
+//  FBXReaderTests.h
+//  tests/fbx/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_FBXReaderTests_h
+#define hifi_FBXReaderTests_h
+
+#include <QtTest/QtTest>
+
+class FBXReaderTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testBinaryRoundTrip();
+    void testMappedFile();
+    void testCorruptFile();
+    void benchmarkParse();
+};
+
+#endif // hifi_FBXReaderTests_h
@@ -21,6 +21,7 @@
 #include <GeometryCache.h>
 #include <DeferredLightingEffect.h>
 #include <FramebufferCache.h>
+#include <LoaderScheduler.h>
 #include <TextureCache.h>
 
 #ifdef DEFERRED_LIGHTING
@@ -69,6 +70,7 @@ void TestWindow::initGl() {
     _renderArgs->_context = std::make_shared<gpu::Context>();
     _glContext.makeCurrent(this);
     DependencyManager::set<GeometryCache>();
+    DependencyManager::set<LoaderScheduler>();
     DependencyManager::set<TextureCache>();
     DependencyManager::set<FramebufferCache>();
     DependencyManager::set<DeferredLightingEffect>();
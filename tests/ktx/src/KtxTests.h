@@ -16,6 +16,8 @@ private slots:
     void testKtxEvalFunctions();
     void testKhronosCompressionFunctions();
     void testKtxSerialization();
+    void testMappedMipFaces();
+    void benchmarkWarmCacheLoad();
 };
 
 
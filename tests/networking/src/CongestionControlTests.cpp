@@ -0,0 +1,246 @@
+//
+//  CongestionControlTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CongestionControlTests.h"
+
+#include <algorithm>
+#include <deque>
+#include <random>
+
+#include <QtNetwork/QUdpSocket>
+
+#include <PortableHighResolutionClock.h>
+#include <udt/BBRCC.h>
+#include <udt/Packet.h>
+#include <udt/Socket.h>
+
+QTEST_MAIN(CongestionControlTests)
+
+using namespace std::chrono;
+
+namespace {
+
+const QStringList CONTROLLERS { "default", "vegas", "bbr" };
+const int TRANSFER_MSECS = 3000;
+
+struct LinkProfile {
+    int bandwidth; // bits per second, data direction only
+    int delay; // one way, milliseconds
+    double loss; // data direction only
+    int queuePackets; // bottleneck buffer, tail drop
+};
+
+// Relays datagrams between a sender and a receiver through a bottleneck with a fixed rate, a bounded
+// buffer, random loss and a propagation delay. ACKs and other reverse traffic are only delayed.
+class LinkEmulator : public QObject {
+public:
+    LinkEmulator(const LinkProfile& profile) : _profile(profile), _generator(742272) {
+        _senderSide.bind(QHostAddress::LocalHost);
+        _receiverSide.bind(QHostAddress::LocalHost);
+
+        connect(&_senderSide, &QUdpSocket::readyRead, this, [this] { readFromSender(); });
+        connect(&_receiverSide, &QUdpSocket::readyRead, this, [this] { readFromReceiver(); });
+
+        _timer.setTimerType(Qt::PreciseTimer);
+        connect(&_timer, &QTimer::timeout, this, [this] { deliver(); });
+        _timer.start(1);
+    }
+
+    HifiSockAddr senderFacingAddress() const { return HifiSockAddr(QHostAddress::LocalHost, _senderSide.localPort()); }
+    void setReceiver(const HifiSockAddr& receiver) { _receiver = receiver; }
+
+    int drops() const { return _drops; }
+    int overflows() const { return _overflows; }
+
+    // queueing delay at the bottleneck, microseconds
+    double meanQueueingDelay() const {
+        if (_queueingDelays.empty()) {
+            return 0.0;
+        }
+        double total = 0.0;
+        for (auto delay : _queueingDelays) {
+            total += delay;
+        }
+        return total / _queueingDelays.size();
+    }
+    double queueingDelayPercentile(double percentile) {
+        if (_queueingDelays.empty()) {
+            return 0.0;
+        }
+        std::sort(_queueingDelays.begin(), _queueingDelays.end());
+        return _queueingDelays[(size_t)(percentile * (_queueingDelays.size() - 1))];
+    }
+
+private:
+    struct Datagram {
+        QByteArray data;
+        p_high_resolution_clock::time_point deliveryTime;
+    };
+
+    void readFromSender() {
+        while (_senderSide.hasPendingDatagrams()) {
+            QByteArray data(_senderSide.pendingDatagramSize(), 0);
+            QHostAddress address;
+            quint16 port;
+            _senderSide.readDatagram(data.data(), data.size(), &address, &port);
+            _sender = HifiSockAddr(address, port);
+
+            auto now = p_high_resolution_clock::now();
+
+            if (std::uniform_real_distribution<>(0.0, 1.0)(_generator) < _profile.loss) {
+                ++_drops;
+                continue;
+            }
+
+            while (!_departures.empty() && _departures.front() <= now) {
+                _departures.pop_front();
+            }
+            if ((int)_departures.size() >= _profile.queuePackets) {
+                ++_overflows;
+                continue;
+            }
+
+            auto serialization = microseconds((int64_t)data.size() * 8 * 1000000 / _profile.bandwidth);
+            auto start = std::max(now, _linkFreeTime);
+            _linkFreeTime = start + serialization;
+            _departures.push_back(_linkFreeTime);
+            _queueingDelays.push_back((double)duration_cast<microseconds>(start - now).count());
+
+            _forward.push_back({ data, _linkFreeTime + milliseconds(_profile.delay) });
+        }
+    }
+
+    void readFromReceiver() {
+        while (_receiverSide.hasPendingDatagrams()) {
+            QByteArray data(_receiverSide.pendingDatagramSize(), 0);
+            _receiverSide.readDatagram(data.data(), data.size());
+            _reverse.push_back({ data, p_high_resolution_clock::now() + milliseconds(_profile.delay) });
+        }
+    }
+
+    void deliver() {
+        auto now = p_high_resolution_clock::now();
+        while (!_forward.empty() && _forward.front().deliveryTime <= now) {
+            _receiverSide.writeDatagram(_forward.front().data, _receiver.getAddress(), _receiver.getPort());
+            _forward.pop_front();
+        }
+        while (!_reverse.empty() && _reverse.front().deliveryTime <= now) {
+            _senderSide.writeDatagram(_reverse.front().data, _sender.getAddress(), _sender.getPort());
+            _reverse.pop_front();
+        }
+    }
+
+    LinkProfile _profile;
+    std::mt19937 _generator;
+
+    QUdpSocket _senderSide;
+    QUdpSocket _receiverSide;
+    QTimer _timer;
+
+    HifiSockAddr _sender;
+    HifiSockAddr _receiver;
+
+    std::deque<Datagram> _forward;
+    std::deque<Datagram> _reverse;
+    std::deque<p_high_resolution_clock::time_point> _departures;
+    p_high_resolution_clock::time_point _linkFreeTime;
+
+    std::vector<double> _queueingDelays;
+    int _drops { 0 };
+    int _overflows { 0 };
+};
+
+struct TransferResult {
+    double goodput; // Mbit/s
+    double meanQueueingDelay; // ms
+    double p95QueueingDelay; // ms
+    int overflows;
+};
+
+TransferResult runTransfer(const QString& controller, const LinkProfile& profile) {
+    LinkEmulator link(profile);
+
+    udt::Socket receiver;
+    receiver.bind(QHostAddress::LocalHost);
+    link.setReceiver(HifiSockAddr(QHostAddress::LocalHost, receiver.localPort()));
+
+    qint64 receivedBytes = 0;
+    receiver.setPacketHandler([&](std::unique_ptr<udt::Packet> packet) {
+        receivedBytes += packet->getPayloadSize();
+    });
+
+    udt::Socket sender;
+    sender.setCongestionControlFactory(udt::CongestionControlVirtualFactory::forName(controller));
+    sender.bind(QHostAddress::LocalHost);
+
+    // queue more than the link can carry, so the transfer is never application limited
+    int numPackets = (int)((qint64)profile.bandwidth * TRANSFER_MSECS / 1000 / 8 / udt::MAX_PACKET_SIZE) * 2;
+    for (int i = 0; i < numPackets; ++i) {
+        auto packet = udt::Packet::create(-1, true);
+        packet->setPayloadSize(packet->getPayloadCapacity());
+        sender.writePacket(std::move(packet), link.senderFacingAddress());
+    }
+
+    QEventLoop loop;
+    QTimer::singleShot(TRANSFER_MSECS, &loop, &QEventLoop::quit);
+    loop.exec();
+
+    const double USECS_PER_MSEC = 1000.0;
+    return {
+        (double)receivedBytes * 8 / (TRANSFER_MSECS * 1000.0),
+        link.meanQueueingDelay() / USECS_PER_MSEC,
+        link.queueingDelayPercentile(0.95) / USECS_PER_MSEC,
+        link.overflows()
+    };
+}
+
+void compareControllers(const LinkProfile& profile) {
+    qDebug() << "Link:" << profile.bandwidth / 1000000.0 << "Mbit/s," << profile.delay * 2 << "ms RTT,"
+        << profile.loss * 100 << "% loss," << profile.queuePackets << "packet buffer";
+
+    for (auto& controller : CONTROLLERS) {
+        auto result = runTransfer(controller, profile);
+
+        // RTT inflation is the queueing delay the controller keeps at the bottleneck on top of the base RTT
+        qDebug().noquote() << QString("%1 goodput %2 Mbit/s, RTT inflation mean %3 ms p95 %4 ms, %5 buffer overflows")
+            .arg(controller, -8)
+            .arg(result.goodput, 0, 'f', 2)
+            .arg(result.meanQueueingDelay, 0, 'f', 1)
+            .arg(result.p95QueueingDelay, 0, 'f', 1)
+            .arg(result.overflows);
+
+        QVERIFY(result.goodput > 0.0);
+    }
+}
+
+}
+
+void CongestionControlTests::testFactoryNames() {
+    for (auto& controller : CONTROLLERS) {
+        auto factory = udt::CongestionControlVirtualFactory::forName(controller);
+        QVERIFY(factory);
+        QVERIFY(factory->create());
+    }
+
+    auto bbrFactory = udt::CongestionControlVirtualFactory::forName("bbr");
+    QVERIFY(dynamic_cast<udt::BBRCC*>(bbrFactory->create().get()));
+
+    QVERIFY(!udt::CongestionControlVirtualFactory::forName("cubic"));
+}
+
+void CongestionControlTests::benchmarkLossyLink() {
+    // a long, shallow buffered path with random loss, where loss based control underuses the link
+    compareControllers({ 20 * 1000 * 1000, 25, 0.01, 50 });
+}
+
+void CongestionControlTests::benchmarkDeepBuffer() {
+    // a clean path with a bloated buffer, where filling the buffer only adds delay
+    compareControllers({ 20 * 1000 * 1000, 25, 0.0, 1000 });
+}
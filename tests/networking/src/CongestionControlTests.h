@@ -0,0 +1,29 @@
+//
+//  CongestionControlTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CongestionControlTests_h
+#define hifi_CongestionControlTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class CongestionControlTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testFactoryNames();
+
+    // bulk reliable transfer through an emulated link for each built-in controller,
+    // reporting goodput and the queueing delay (RTT inflation) each one causes
+    void benchmarkLossyLink();
+    void benchmarkDeepBuffer();
+};
+
+#endif // hifi_CongestionControlTests_h
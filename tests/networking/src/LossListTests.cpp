@@ -0,0 +1,319 @@
+//
+//  LossListTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LossListTests.h"
+
+#include <memory>
+#include <random>
+
+#include <udt/ControlPacket.h>
+#include <udt/LossList.h>
+#include <udt/SequenceRingBuffer.h>
+#include <udt/Socket.h>
+
+QTEST_MAIN(LossListTests)
+
+using namespace udt;
+
+namespace {
+
+SequenceNumber seq(SequenceNumber::Type value) {
+    return SequenceNumber(value);
+}
+
+// the (first, last) pairs a loss report would carry
+std::vector<std::pair<SequenceNumber, SequenceNumber>> writtenRanges(LossList& lossList, int maxPairs = -1) {
+    auto packet = ControlPacket::create(ControlPacket::NAK);
+    lossList.write(*packet, maxPairs);
+    packet->seek(0);
+
+    std::vector<std::pair<SequenceNumber, SequenceNumber>> ranges;
+    SequenceNumber first, last;
+    while (packet->bytesLeftToRead() >= (qint64)(2 * sizeof(SequenceNumber))) {
+        packet->readPrimitive(&first);
+        packet->readPrimitive(&last);
+        ranges.push_back({ first, last });
+    }
+    return ranges;
+}
+
+}
+
+void LossListTests::testSequenceNumberWrap() {
+    const SequenceNumber::Type MAX = SequenceNumber::MAX;
+
+    QCOMPARE(seq(0) - 1, seq(MAX));
+    QCOMPARE(seq(0) - 2, seq(MAX - 1));
+    QCOMPARE(seq(5) - 10, seq(MAX - 4));
+    QCOMPARE(seq(5) - 5, seq(0));
+    QCOMPARE(seq(10) - 5, seq(5));
+
+    // the initial sequence number the congestion controls step back from
+    SequenceNumber initial = seq(0);
+    QCOMPARE(initial - 1 + 1, initial);
+    QCOMPARE(seq(MAX) + 1, seq(0));
+    QCOMPARE(seq(MAX - 4) + 10, seq(5));
+
+    SequenceNumber decremented = seq(3);
+    --decremented;
+    decremented -= 3; // from 2
+    QCOMPARE(decremented, seq(MAX));
+    QCOMPARE(seqoff(seq(MAX - 4), seq(5)), 10);
+}
+
+void LossListTests::testAppendAndRemove() {
+    LossList lossList;
+    QVERIFY(lossList.isEmpty());
+
+    lossList.append(seq(10));
+    lossList.append(seq(12), seq(20));
+    QCOMPARE(lossList.getLength(), 10);
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(10));
+
+    QVERIFY(lossList.remove(seq(15)));
+    QVERIFY(!lossList.remove(seq(15)));
+    QVERIFY(!lossList.remove(seq(11)));
+    QVERIFY(!lossList.remove(seq(1000)));
+    QCOMPARE(lossList.getLength(), 9);
+
+    QCOMPARE(lossList.popFirstSequenceNumber(), seq(10));
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(12));
+
+    // removing a range that only partly overlaps
+    lossList.remove(seq(5), seq(13));
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(14));
+    lossList.remove(seq(18), seq(100));
+    QCOMPARE(lossList.getLength(), 3); // 14, 16, 17
+
+    lossList.clear();
+    QVERIFY(lossList.isEmpty());
+    lossList.append(seq(500));
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(500));
+}
+
+void LossListTests::testInsertMerges() {
+    LossList lossList;
+    lossList.insert(seq(1000), seq(1010));
+    lossList.insert(seq(900), seq(905)); // before the first loss
+    lossList.insert(seq(1005), seq(1020)); // overlapping
+    lossList.insert(seq(906), seq(999)); // filling the gap
+
+    QCOMPARE(lossList.getLength(), 1020 - 900 + 1);
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(900));
+
+    auto ranges = writtenRanges(lossList);
+    QCOMPARE((int)ranges.size(), 1);
+    QCOMPARE(ranges[0].first, seq(900));
+    QCOMPARE(ranges[0].second, seq(1020));
+}
+
+void LossListTests::testWrapAround() {
+    const SequenceNumber::Type MAX = SequenceNumber::MAX;
+
+    LossList lossList;
+    lossList.append(seq(MAX - 5), seq(MAX));
+    lossList.append(seq(0), seq(3));
+    lossList.insert(seq(MAX - 100), seq(MAX - 100));
+    QCOMPARE(lossList.getLength(), 11);
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(MAX - 100));
+
+    QVERIFY(lossList.remove(seq(MAX - 100)));
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(MAX - 5));
+
+    auto ranges = writtenRanges(lossList);
+    QCOMPARE((int)ranges.size(), 1);
+    QCOMPARE(ranges[0].first, seq(MAX - 5));
+    QCOMPARE(ranges[0].second, seq(3));
+
+    lossList.remove(seq(MAX - 10), seq(1));
+    QCOMPARE(lossList.getLength(), 2);
+    QCOMPARE(lossList.popFirstSequenceNumber(), seq(2));
+    QCOMPARE(lossList.popFirstSequenceNumber(), seq(3));
+    QVERIFY(lossList.isEmpty());
+}
+
+void LossListTests::testNAKOutsideWindow() {
+    const SequenceNumber::Type MAX = SequenceNumber::MAX;
+
+    // a NAK whose range covers nearly half the sequence space, as a peer could send it
+    auto packet = ControlPacket::create(ControlPacket::NAK);
+    packet->writePrimitive(seq(MAX + 1 + 1100 - SequenceNumber::THRESHOLD / 2));
+    packet->writePrimitive(seq(1000 + SequenceNumber::THRESHOLD / 2));
+    packet->seek(0);
+
+    SequenceNumber start, end;
+    packet->readPrimitive(&start);
+    packet->readPrimitive(&end);
+
+    // what SendQueue::nak does with it, sent up to 1100 and ACKed up to 999
+    LossList lossList;
+    lossList.insertWithin(start, end, seq(1000), seq(1100));
+    QCOMPARE(lossList.getLength(), 101);
+    QVERIFY(lossList.getCapacity() <= 256);
+
+    lossList.clear();
+    // ranges past either end of the window are clamped to it, ranges outside of it dropped
+    lossList.insertWithin(seq(900), seq(1010), seq(1000), seq(1100));
+    lossList.insertWithin(seq(1090), seq(5000), seq(1000), seq(1100));
+    lossList.insertWithin(seq(MAX - 10), seq(10), seq(1000), seq(1100));
+    lossList.insertWithin(seq(2000), seq(3000), seq(1000), seq(1100));
+    lossList.insertWithin(seq(1050), seq(1040), seq(1000), seq(1100));
+    QCOMPARE(writtenRanges(lossList), (std::vector<std::pair<SequenceNumber, SequenceNumber>> {
+        { seq(1000), seq(1010) }, { seq(1090), seq(1100) }
+    }));
+    QVERIFY(lossList.getCapacity() <= 256);
+
+    // and a window across the wrap
+    lossList.clear();
+    lossList.insertWithin(seq(MAX - 2000), seq(2000), seq(MAX - 10), seq(10));
+    QCOMPARE(lossList.getLength(), 22);
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(MAX - 10));
+    QVERIFY(lossList.getCapacity() <= 256);
+}
+
+void LossListTests::testWrite() {
+    LossList lossList;
+    lossList.append(seq(1));
+    lossList.append(seq(63), seq(64)); // across a word
+    lossList.append(seq(70), seq(300)); // spanning whole words
+    lossList.append(seq(320));
+
+    auto ranges = writtenRanges(lossList);
+    QCOMPARE((int)ranges.size(), 4);
+    QCOMPARE(ranges[0], std::make_pair(seq(1), seq(1)));
+    QCOMPARE(ranges[1], std::make_pair(seq(63), seq(64)));
+    QCOMPARE(ranges[2], std::make_pair(seq(70), seq(300)));
+    QCOMPARE(ranges[3], std::make_pair(seq(320), seq(320)));
+
+    QCOMPARE((int)writtenRanges(lossList, 2).size(), 2);
+}
+
+void LossListTests::testSequenceRingBuffer() {
+    SequenceRingBuffer<std::unique_ptr<int>> buffer;
+    for (int i = 0; i < 1000; ++i) {
+        buffer.insert(seq(SequenceNumber::MAX - 500 + i), std::unique_ptr<int>(new int(i)));
+    }
+    QCOMPARE(buffer.size(), 1000);
+    QCOMPARE(**buffer.find(seq(SequenceNumber::MAX)), 500);
+    QCOMPARE(**buffer.find(seq(0)), 501);
+    QVERIFY(!buffer.find(seq(SequenceNumber::MAX - 501)));
+
+    buffer.eraseUpTo(seq(10));
+    QCOMPARE(buffer.size(), 1000 - 512);
+    QVERIFY(!buffer.find(seq(10)));
+    QCOMPARE(**buffer.find(seq(11)), 512);
+
+    // bounded, the oldest are dropped to make room
+    SequenceRingBuffer<int> bounded(100);
+    for (int i = 0; i < 1000; ++i) {
+        bounded.insert(seq(i), i);
+    }
+    QCOMPARE(bounded.size(), 100);
+    QVERIFY(!bounded.find(seq(899)));
+    QCOMPARE(*bounded.find(seq(900)), 900);
+}
+
+void LossListTests::benchmarkLargeWindow() {
+    const int WINDOW = MAX_PACKETS_IN_FLIGHT;
+    const int ROUNDS = 100;
+    std::mt19937 generator(1881);
+    std::uniform_real_distribution<double> loss(0.0, 1.0);
+
+    LossList lossList;
+    QElapsedTimer timer;
+    timer.start();
+
+    int operations = 0;
+    SequenceNumber base = seq(0);
+    for (int round = 0; round < ROUNDS; ++round) {
+        // the receiver reports 5% of a window lost, one NAK each
+        for (int i = 0; i < WINDOW; ++i) {
+            if (loss(generator) < 0.05) {
+                lossList.insert(base + i, base + i);
+                ++operations;
+            }
+        }
+
+        // the sender retransmits them, and an ACK clears whatever is left
+        while (lossList.getLength() > WINDOW / 100) {
+            lossList.popFirstSequenceNumber();
+            ++operations;
+        }
+        lossList.remove(base, base + WINDOW);
+        ++operations;
+
+        base = base + WINDOW;
+    }
+
+    auto elapsed = timer.nsecsElapsed();
+    QVERIFY(lossList.isEmpty());
+    qDebug() << operations << "loss list operations over a" << WINDOW << "packet window," << elapsed / operations << "ns each";
+}
+
+void LossListTests::benchmarkLossyTransfer() {
+    const int BANDWIDTH = 100 * 1000 * 1000;
+    const int NUM_PACKETS = 40000; // about 5 seconds at the cap
+    const int TIMEOUT_MSECS = 60 * 1000;
+
+    ImpairmentProfile profile;
+    profile.name = "lossy";
+    ImpairmentStage stage;
+    stage.send.loss = 0.05;
+    stage.send.bandwidth = BANDWIDTH;
+    stage.send.queue = 1000;
+    profile.stages.push_back(stage);
+
+    Socket receiver;
+    receiver.bind(QHostAddress::LocalHost);
+
+    Socket sender;
+    sender.setImpairmentProfile(profile);
+    sender.bind(QHostAddress::LocalHost);
+
+    QEventLoop loop;
+    int receivedPackets = 0;
+    qint64 receivedBytes = 0;
+    receiver.setPacketHandler([&](std::unique_ptr<Packet> packet) {
+        ++receivedPackets;
+        receivedBytes += packet->getPayloadSize();
+        if (receivedPackets == NUM_PACKETS) {
+            loop.quit();
+        }
+    });
+
+    HifiSockAddr destination(QHostAddress::LocalHost, receiver.localPort());
+    for (int i = 0; i < NUM_PACKETS; ++i) {
+        auto packet = Packet::create(-1, true);
+        packet->setPayloadSize(packet->getPayloadCapacity());
+        sender.writePacket(std::move(packet), destination);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QTimer::singleShot(TIMEOUT_MSECS, &loop, &QEventLoop::quit);
+    loop.exec();
+
+    auto elapsed = timer.elapsed();
+    auto impairmentStats = sender.getImpairmentStats(NetworkImpairment::Send);
+
+    int retransmissions = 0;
+    for (auto& connectionStats : sender.sampleStatsForAllConnections()) {
+        retransmissions += connectionStats.second.events[ConnectionStats::Stats::Retransmission];
+    }
+
+    qDebug() << "Delivered" << receivedPackets << "of" << NUM_PACKETS << "packets in" << elapsed << "ms,"
+        << (double)receivedBytes * 8 / (elapsed * 1000.0) << "Mbit/s goodput";
+    qDebug() << impairmentStats.lost << "datagrams lost and" << impairmentStats.overflowed << "overflowed of"
+        << impairmentStats.datagrams << "sent," << retransmissions << "retransmissions";
+
+    // every packet makes it despite the loss
+    QCOMPARE(receivedPackets, NUM_PACKETS);
+}
@@ -0,0 +1,36 @@
+//
+//  LossListTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LossListTests_h
+#define hifi_LossListTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class LossListTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testSequenceNumberWrap();
+    void testAppendAndRemove();
+    void testInsertMerges();
+    void testWrapAround();
+    void testNAKOutsideWindow();
+    void testWrite();
+    void testSequenceRingBuffer();
+
+    // NAK bookkeeping for a full flow window of scattered losses
+    void benchmarkLargeWindow();
+
+    // a reliable bulk transfer at 100 Mbit/s with 5% random loss, over loopback
+    void benchmarkLossyTransfer();
+};
+
+#endif // hifi_LossListTests_h
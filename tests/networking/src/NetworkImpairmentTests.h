@@ -0,0 +1,27 @@
+//
+//  NetworkImpairmentTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_NetworkImpairmentTests_h
+#define hifi_NetworkImpairmentTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class NetworkImpairmentTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testProfileParsing();
+    void testLossRate();
+    void testDelayAndOrdering();
+    void testBandwidthCap();
+};
+
+#endif // hifi_NetworkImpairmentTests_h
@@ -0,0 +1,272 @@
+//
+//  ReceivedMessageTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ReceivedMessageTests.h"
+
+#include <NLPacket.h>
+#include <NLPacketList.h>
+#include <ReceivedMessage.h>
+#include <udt/Connection.h>
+#include <udt/Socket.h>
+
+QTEST_MAIN(ReceivedMessageTests)
+
+namespace {
+
+const int SEGMENT_SIZE = 100;
+const int NUM_SEGMENTS = 5;
+
+QByteArray patternData(int size) {
+    QByteArray data(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i) {
+        data[i] = (char)(i % 251);
+    }
+    return data;
+}
+
+std::unique_ptr<NLPacket> createPart(const QByteArray& data, int partNumber, udt::Packet::PacketPosition position) {
+    auto packet = NLPacket::create(PacketType::AssetGetReply, -1, true, true);
+    packet->write(data);
+    packet->writeMessageNumber(1, position, partNumber);
+    packet->seek(0);
+    return packet;
+}
+
+// the same data a received message would hold, one packet per SEGMENT_SIZE bytes
+QSharedPointer<ReceivedMessage> createSegmentedMessage(const QByteArray& data) {
+    int numParts = (data.size() + SEGMENT_SIZE - 1) / SEGMENT_SIZE;
+    QSharedPointer<ReceivedMessage> message;
+
+    for (int part = 0; part < numParts; ++part) {
+        auto position = part == 0 ? udt::Packet::PacketPosition::FIRST
+            : part == numParts - 1 ? udt::Packet::PacketPosition::LAST : udt::Packet::PacketPosition::MIDDLE;
+        auto packet = createPart(data.mid(part * SEGMENT_SIZE, SEGMENT_SIZE), part, position);
+
+        if (part == 0) {
+            message = QSharedPointer<ReceivedMessage>::create(std::move(packet));
+        } else {
+            message->appendPacket(std::move(packet));
+        }
+    }
+
+    return message;
+}
+
+}
+
+void ReceivedMessageTests::testReadAcrossSegments() {
+    auto data = patternData(SEGMENT_SIZE * NUM_SEGMENTS);
+    auto message = createSegmentedMessage(data);
+
+    QVERIFY(message->isComplete());
+    QCOMPARE(message->getSize(), (qint64)data.size());
+    QCOMPARE(message->getNumSegments(), (size_t)NUM_SEGMENTS);
+
+    // a primitive that straddles the first boundary
+    message->seek(SEGMENT_SIZE - 2);
+    uint32_t value;
+    QCOMPARE(message->peekPrimitive(&value), (qint64)sizeof(value));
+    QCOMPARE(memcmp(&value, data.constData() + SEGMENT_SIZE - 2, sizeof(value)), 0);
+    QCOMPARE(message->getPosition(), (qint64)SEGMENT_SIZE - 2);
+    message->readPrimitive(&value);
+    QCOMPARE(message->getPosition(), (qint64)SEGMENT_SIZE + 2);
+
+    // a read spanning several segments
+    QCOMPARE(message->read(SEGMENT_SIZE * 2 + 10), data.mid(SEGMENT_SIZE + 2, SEGMENT_SIZE * 2 + 10));
+    QCOMPARE(message->readAll(), data.mid(SEGMENT_SIZE * 3 + 12));
+    QCOMPARE(message->getBytesLeftToRead(), (qint64)0);
+
+    // the head is copied for other threads, from the first segment
+    message->seek(0);
+    QCOMPARE(message->readHead(10), data.mid(0, 10));
+
+    // none of this needed the message flattened
+    QCOMPARE(message->getNumSegments(), (size_t)NUM_SEGMENTS);
+}
+
+void ReceivedMessageTests::testReadViews() {
+    auto data = patternData(SEGMENT_SIZE * NUM_SEGMENTS);
+    auto message = createSegmentedMessage(data);
+
+    message->seek(SEGMENT_SIZE / 2);
+    auto views = message->readViews(SEGMENT_SIZE * 2);
+
+    QCOMPARE(views.size(), (size_t)3);
+    QCOMPARE(views[0].size(), SEGMENT_SIZE / 2);
+    QCOMPARE(views[1].size(), SEGMENT_SIZE);
+    QCOMPARE(views[2].size(), SEGMENT_SIZE / 2);
+
+    QByteArray joined;
+    for (const auto& view : views) {
+        joined.append(view);
+    }
+    QCOMPARE(joined, data.mid(SEGMENT_SIZE / 2, SEGMENT_SIZE * 2));
+    QCOMPARE(message->getPosition(), (qint64)SEGMENT_SIZE * 5 / 2);
+
+    // views past the end stop at the end
+    views = message->readViews(data.size());
+    QCOMPARE(views.size(), (size_t)3);
+    QCOMPARE(message->getBytesLeftToRead(), (qint64)0);
+    QCOMPARE(message->getNumSegments(), (size_t)NUM_SEGMENTS);
+}
+
+void ReceivedMessageTests::testReadWithoutCopy() {
+    auto data = patternData(SEGMENT_SIZE * NUM_SEGMENTS);
+    auto message = createSegmentedMessage(data);
+
+    // inside one segment the view is of the packet itself
+    message->seek(10);
+    QCOMPARE(message->readWithoutCopy(20), data.mid(10, 20));
+    QCOMPARE(message->getNumSegments(), (size_t)NUM_SEGMENTS);
+
+    // a string that spans segments is decoded from a copy
+    QString string { "spans a segment boundary" };
+    auto utf8 = string.toUtf8();
+    QByteArray stringData;
+    uint32_t stringSize = utf8.size();
+    stringData.append(reinterpret_cast<const char*>(&stringSize), sizeof(stringSize));
+    stringData.append(utf8);
+    data.replace(SEGMENT_SIZE - 8, stringData.size(), stringData);
+    message = createSegmentedMessage(data);
+    message->seek(SEGMENT_SIZE - 8);
+    QCOMPARE(message->readString(), string);
+    QCOMPARE(message->getNumSegments(), (size_t)NUM_SEGMENTS);
+
+    // across segments it has to be made contiguous
+    message->seek(SEGMENT_SIZE - 10);
+    QCOMPARE(message->readWithoutCopy(20), data.mid(SEGMENT_SIZE - 10, 20));
+    QCOMPARE(message->getNumSegments(), (size_t)1);
+}
+
+void ReceivedMessageTests::testFlatten() {
+    auto data = patternData(SEGMENT_SIZE * NUM_SEGMENTS - 7);
+    auto message = createSegmentedMessage(data);
+
+    // views taken before flattening stay valid after it
+    message->seek(10);
+    auto view = message->readWithoutCopy(20);
+    auto views = message->readViews(SEGMENT_SIZE * 2);
+
+    message->seek(SEGMENT_SIZE + 3);
+
+    QCOMPARE(message->getMessage(), data);
+    QCOMPARE(view, data.mid(10, 20));
+    QByteArray joined;
+    for (const auto& segmentView : views) {
+        joined.append(segmentView);
+    }
+    QCOMPARE(joined, data.mid(30, SEGMENT_SIZE * 2));
+    QCOMPARE(message->getNumSegments(), (size_t)1);
+    QCOMPARE(memcmp(message->getRawMessage(), data.constData(), data.size()), 0);
+
+    // flattening doesn't move the read position
+    QCOMPARE(message->getPosition(), (qint64)SEGMENT_SIZE + 3);
+    QCOMPARE(message->readAll(), data.mid(SEGMENT_SIZE + 3));
+}
+
+void ReceivedMessageTests::testEmptyMessage() {
+    auto packet = createPart(QByteArray(), 0, udt::Packet::PacketPosition::ONLY);
+    auto message = QSharedPointer<ReceivedMessage>::create(std::move(packet));
+
+    QVERIFY(message->isComplete());
+    QCOMPARE(message->getSize(), (qint64)0);
+    QCOMPARE(message->getNumSegments(), (size_t)0);
+    QVERIFY(message->readAll().isEmpty());
+    QVERIFY(message->readViews(10).empty());
+    QVERIFY(message->getMessage().isEmpty());
+}
+
+void ReceivedMessageTests::testPendingPartTooFarAhead() {
+    auto createRawPart = [](udt::Packet::MessagePartNumber partNumber, udt::Packet::PacketPosition position) {
+        auto packet = udt::Packet::create(-1, true, true);
+        packet->writeMessageNumber(1, position, partNumber);
+        return packet;
+    };
+
+    udt::PendingReceivedMessage pendingMessage;
+
+    // a part number no sender could have reached is dropped rather than leaving a gap for every part before it
+    pendingMessage.enqueuePacket(createRawPart(0xFFFFFFF0, udt::Packet::PacketPosition::LAST));
+    QVERIFY(pendingMessage._packets.empty());
+    QVERIFY(!pendingMessage.isComplete());
+
+    pendingMessage.enqueuePacket(createRawPart(1, udt::Packet::PacketPosition::LAST));
+    QVERIFY(!pendingMessage.hasAvailablePackets());
+    pendingMessage.enqueuePacket(createRawPart(0, udt::Packet::PacketPosition::FIRST));
+
+    QVERIFY(pendingMessage.removeNextPacket());
+    QVERIFY(pendingMessage.removeNextPacket());
+    QVERIFY(pendingMessage.isComplete());
+}
+
+void ReceivedMessageTests::benchmark100MBLoopback() {
+    const int MESSAGE_SIZE = 100 * 1024 * 1024;
+    const int TIMEOUT_MSECS = 120 * 1000;
+
+    udt::Socket receiver;
+    receiver.bind(QHostAddress::LocalHost);
+
+    udt::Socket sender;
+    sender.bind(QHostAddress::LocalHost);
+
+    QSharedPointer<ReceivedMessage> message;
+    QElapsedTimer reassemblyTimer;
+    qint64 reassemblyNSecs = 0;
+
+    QEventLoop loop;
+
+    receiver.setMessageHandler([&](std::unique_ptr<udt::Packet> packet) {
+        auto nlPacket = NLPacket::fromBase(std::move(packet));
+
+        reassemblyTimer.start();
+        if (!message) {
+            message = QSharedPointer<ReceivedMessage>::create(std::move(nlPacket));
+        } else {
+            message->appendPacket(std::move(nlPacket));
+        }
+        reassemblyNSecs += reassemblyTimer.nsecsElapsed();
+
+        if (message->isComplete()) {
+            loop.quit();
+        }
+    });
+
+    auto data = patternData(MESSAGE_SIZE);
+    auto packetList = NLPacketList::create(PacketType::AssetGetReply, QByteArray(), true, true);
+    packetList->write(data);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    sender.writePacketList(std::move(packetList), HifiSockAddr(QHostAddress::LocalHost, receiver.localPort()));
+
+    QTimer::singleShot(TIMEOUT_MSECS, &loop, &QEventLoop::quit);
+    loop.exec();
+
+    auto elapsed = timer.elapsed();
+
+    QVERIFY(message);
+    QVERIFY(message->isComplete());
+    QCOMPARE(message->getSize(), (qint64)MESSAGE_SIZE);
+
+    // check the data as a consumer streaming it would see it, without flattening
+    qint64 offset = 0;
+    for (const auto& view : message->readViews(MESSAGE_SIZE)) {
+        QVERIFY(memcmp(view.constData(), data.constData() + offset, view.size()) == 0);
+        offset += view.size();
+    }
+    QCOMPARE(offset, (qint64)MESSAGE_SIZE);
+
+    const double BYTES_PER_MB = 1024.0 * 1024.0;
+    qDebug() << "Received" << MESSAGE_SIZE / BYTES_PER_MB << "MB in" << message->getNumPackets() << "packets,"
+        << elapsed << "ms," << (MESSAGE_SIZE / BYTES_PER_MB) / (elapsed / 1000.0) << "MB/s";
+    qDebug() << "Reassembly took" << reassemblyNSecs / 1000000.0 << "ms in total,"
+        << (double)reassemblyNSecs / message->getNumPackets() << "ns per packet";
+}
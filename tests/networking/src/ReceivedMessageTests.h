@@ -0,0 +1,32 @@
+//
+//  ReceivedMessageTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ReceivedMessageTests_h
+#define hifi_ReceivedMessageTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class ReceivedMessageTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testReadAcrossSegments();
+    void testReadViews();
+    void testReadWithoutCopy();
+    void testFlatten();
+    void testEmptyMessage();
+    void testPendingPartTooFarAhead();
+
+    // a 100 MB reliable message between two sockets over loopback, reassembled into a ReceivedMessage
+    void benchmark100MBLoopback();
+};
+
+#endif // hifi_ReceivedMessageTests_h
@@ -7,11 +7,18 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <cfloat>
+#include <mutex>
+#include <random>
+
 #include <QNetworkDiskCache>
 
+#include "NumericalConstants.h"
 #include "ResourceCache.h"
 #include "NetworkAccessManager.h"
 #include "DependencyManager.h"
+#include "LoaderScheduler.h"
+#include "StatTracker.h"
 
 #include "ResourceTests.h"
 
@@ -19,7 +26,9 @@ QTEST_MAIN(ResourceTests)
 
 void ResourceTests::initTestCase() {
 
+    DependencyManager::set<StatTracker>();
     auto resourceCacheSharedItems = DependencyManager::set<ResourceCacheSharedItems>();
+    DependencyManager::set<LoaderScheduler>();
 
     const qint64 MAXIMUM_CACHE_SIZE = 1024 * 1024 * 1024; // 1GB
 
@@ -82,3 +91,186 @@ void ResourceTests::downloadAgain() {
 
     QVERIFY(resource->isLoaded());
 }
+
+namespace {
+    // a domain's worth of textures and models, a few of them on disk
+    QList<QSharedPointer<Resource>> makePendingResources(QObject* owner, int count) {
+        std::mt19937 generator(1);
+        std::uniform_real_distribution<float> priorities(-100.0f, 100.0f);
+        QList<QSharedPointer<Resource>> resources;
+        for (int i = 0; i < count; i++) {
+            QUrl url = (i % 10 == 0) ? QUrl(QString("file:///resources/%1.fbx").arg(i)) :
+                QUrl(QString("http://localhost/textures/%1.ktx").arg(i));
+            auto resource = QSharedPointer<Resource>::create(url);
+            resource->setSelf(resource);
+            resource->setLoadPriority(owner, priorities(generator));
+            resources.append(resource);
+        }
+        return resources;
+    }
+
+    // what ResourceCacheSharedItems::getHighestPendingRequest() used to do: scan every pending request
+    QSharedPointer<Resource> takeHighestByScan(QList<QWeakPointer<Resource>>& pendingRequests) {
+        int highestIndex = -1;
+        float highestPriority = -FLT_MAX;
+        QSharedPointer<Resource> highestResource;
+        bool currentHighestIsFile = false;
+        for (int i = 0; i < pendingRequests.size();) {
+            auto resource = pendingRequests.at(i).lock();
+            if (!resource) {
+                pendingRequests.removeAt(i);
+                continue;
+            }
+            float priority = resource->getLoadPriority();
+            bool isFile = resource->getURL().scheme() == URL_SCHEME_FILE;
+            if (priority >= highestPriority && (isFile || !currentHighestIsFile)) {
+                highestPriority = priority;
+                highestIndex = i;
+                highestResource = resource;
+                currentHighestIsFile = isFile;
+            }
+            i++;
+        }
+        if (highestIndex >= 0) {
+            pendingRequests.takeAt(highestIndex);
+        }
+        return highestResource;
+    }
+}
+
+void ResourceTests::testPendingRequestOrder() {
+    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+    QObject owner;
+    auto resources = makePendingResources(&owner, 1000);
+    for (auto& resource : resources) {
+        sharedItems->appendPendingRequest(resource);
+    }
+    QCOMPARE(sharedItems->getPendingRequestsCount(), (uint32_t)resources.size());
+
+    // requests that go away are skipped
+    resources[502].clear();
+
+    // a request whose priority drops after it was queued is re-checked before it is handed out
+    QSharedPointer<Resource> highestNetworkResource;
+    for (auto& resource : resources) {
+        if (resource && resource->getURL().scheme() != URL_SCHEME_FILE &&
+            (!highestNetworkResource || resource->getLoadPriority() > highestNetworkResource->getLoadPriority())) {
+            highestNetworkResource = resource;
+        }
+    }
+    highestNetworkResource->setLoadPriority(&owner, -1000.0f);
+
+    // files first, then the network, each in priority order
+    bool seenNetwork = false;
+    float lastPriority = FLT_MAX;
+    int count = 0;
+    QSharedPointer<Resource> lastResource;
+    while (auto resource = sharedItems->getHighestPendingRequest()) {
+        bool isFile = resource->getURL().scheme() == URL_SCHEME_FILE;
+        if (!isFile && !seenNetwork) {
+            seenNetwork = true;
+            lastPriority = FLT_MAX;
+        }
+        QVERIFY(!(isFile && seenNetwork));
+        QVERIFY(resource->getLoadPriority() <= lastPriority);
+        lastPriority = resource->getLoadPriority();
+        lastResource = resource;
+        count++;
+    }
+    QCOMPARE(count, resources.size() - 1);
+    QCOMPARE(lastResource, highestNetworkResource);
+    QCOMPARE(sharedItems->getPendingRequestsCount(), (uint32_t)0);
+}
+
+void ResourceTests::benchmarkPendingRequests() {
+    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+    QObject owner;
+    const int NUM_RESOURCES = 10000;
+    auto resources = makePendingResources(&owner, NUM_RESOURCES);
+
+    // queue everything, then hand out one request each time a slot frees up
+    QElapsedTimer timer;
+    timer.start();
+    QList<QWeakPointer<Resource>> pendingRequests;
+    for (auto& resource : resources) {
+        pendingRequests.append(resource);
+    }
+    int scanned = 0;
+    while (takeHighestByScan(pendingRequests)) {
+        scanned++;
+    }
+    quint64 scanTime = timer.nsecsElapsed();
+
+    timer.start();
+    for (auto& resource : resources) {
+        sharedItems->appendPendingRequest(resource);
+    }
+    int popped = 0;
+    while (sharedItems->getHighestPendingRequest()) {
+        popped++;
+    }
+    quint64 queueTime = timer.nsecsElapsed();
+
+    QCOMPARE(scanned, NUM_RESOURCES);
+    QCOMPARE(popped, NUM_RESOURCES);
+    qDebug() << NUM_RESOURCES << "pending requests:" << (float)scanTime / (float)NSECS_PER_MSEC << "msecs scanning,"
+        << (float)queueTime / (float)NSECS_PER_MSEC << "msecs queued," << ((float)scanTime / (float)queueTime) << "x";
+}
+
+void ResourceTests::testLoaderJobOrder() {
+    auto scheduler = DependencyManager::get<LoaderScheduler>();
+    const auto type = LoaderScheduler::JobType::Geometry;
+    int originalLimit = scheduler->getConcurrencyLimit(type);
+    scheduler->setConcurrencyLimit(type, 1);
+
+    QObject owner;
+    auto resources = makePendingResources(&owner, 20);
+
+    // hold the only geometry slot so everything else queues up behind it
+    QSemaphore gate;
+    QSemaphore done;
+    scheduler->queueJob(type, resources[0], [&] {
+        gate.acquire();
+        done.release();
+    });
+
+    std::mutex mutex;
+    QList<int> order;
+    for (int i = 1; i < resources.size(); i++) {
+        scheduler->queueJob(type, resources[i], [&, i] {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                order.append(i);
+            }
+            done.release();
+        });
+    }
+
+    // jobs for resources that go away never run
+    resources[7].clear();
+
+    // priorities that change while jobs wait are picked up by the refresh on this thread
+    resources[12]->setLoadPriority(&owner, 1000.0f);
+    QTest::qWait(100);
+
+    gate.release();
+    QVERIFY(done.tryAcquire(resources.size() - 1, (int)(5 * MSECS_PER_SECOND)));
+    QVERIFY(!done.tryAcquire(1, 100));
+
+    QCOMPARE(order.size(), resources.size() - 2);
+    QCOMPARE(order.first(), 12);
+    for (int i = 1; i < order.size(); i++) {
+        QVERIFY(resources[order[i]]->getLoadPriority() <= resources[order[i - 1]]->getLoadPriority());
+    }
+
+    auto stats = scheduler->getStats()[LoaderScheduler::getJobTypeName(type)].toMap();
+    QCOMPARE(stats["queued"].toInt(), 0);
+    QCOMPARE(stats["runMsecs"].toList().size(), LoaderScheduler::NUM_HISTOGRAM_BUCKETS);
+
+    QCOMPARE(LoaderScheduler::getHistogramBucket(500), 0);
+    QCOMPARE(LoaderScheduler::getHistogramBucket(1500), 1);
+    QCOMPARE(LoaderScheduler::getHistogramBucket(3 * USECS_PER_MSEC), 2);
+    QCOMPARE(LoaderScheduler::getHistogramBucket(10 * USECS_PER_SECOND), LoaderScheduler::NUM_HISTOGRAM_BUCKETS - 1);
+
+    scheduler->setConcurrencyLimit(type, originalLimit);
+}
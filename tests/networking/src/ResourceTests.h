@@ -18,6 +18,9 @@ private slots:
     void initTestCase();
     void downloadFirst();
     void downloadAgain();
+    void testPendingRequestOrder();
+    void benchmarkPendingRequests();
+    void testLoaderJobOrder();
 };
 
 #endif // hifi_ResourceTests_h
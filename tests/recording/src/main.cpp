@@ -2,11 +2,17 @@
 #include <QtTest/QtTest>
 #include <QtCore/QTemporaryFile>
 #include <QtCore/QString>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
 
 #ifdef Q_OS_WIN32
 #include <Windows.h>
 #endif
 
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
 #include <recording/Clip.h>
 #include <recording/Frame.h>
 
@@ -97,6 +103,144 @@ void testClipOrdering() {
     Q_UNUSED(lastFrameTimeOffset); // FIXME - Unix build not yet upgraded to Qt 5.5.1 we can remove this once it is
 }
 
+// something like an avatar frame: mostly the same from one frame to the next
+QByteArray makeFrameData(int frame) {
+    QByteArray data(400 + (frame % 7) * 20, 0);
+    for (int i = 0; i < data.size(); ++i) {
+        data[i] = (char)((i * 31 + (i % 16 == 0 ? frame : 0)) & 0xFF);
+    }
+    return data;
+}
+
+Clip::Pointer makeLongClip(int frameCount) {
+    auto clip = Clip::newClip();
+    for (int i = 0; i < frameCount; ++i) {
+        // about 90 frames per second, with some empty frames mixed in
+        clip->addFrame(std::make_shared<Frame>(TEST_FRAME_TYPE, (float)(i * 11), i % 5 == 0 ? QByteArray() : makeFrameData(i)));
+    }
+    return clip;
+}
+
+QString makeTemporaryFileName(QTemporaryFile& file) {
+    QString fileName;
+    if (file.open()) {
+        fileName = file.fileName();
+        file.close();
+    }
+    return fileName;
+}
+
+void testBlockCompressedPersist() {
+    QTemporaryFile file;
+    QString fileName = makeTemporaryFileName(file);
+
+    // enough frames for many blocks
+    const int FRAME_COUNT = 2000;
+    auto writeClip = makeLongClip(FRAME_COUNT);
+    Clip::toFile(fileName, writeClip);
+    QVERIFY(QFileInfo(fileName).size() < FRAME_COUNT * 400);
+
+    auto readClip = Clip::fromFile(fileName);
+    QVERIFY(readClip != Clip::Pointer());
+    QVERIFY(readClip->frameCount() == (size_t)FRAME_COUNT);
+    QVERIFY(readClip->duration() == writeClip->duration());
+
+    readClip->seek(0);
+    writeClip->seek(0);
+    for (auto readFrame = readClip->nextFrame(), writeFrame = writeClip->nextFrame(); readFrame && writeFrame;
+        readFrame = readClip->nextFrame(), writeFrame = writeClip->nextFrame()) {
+        QVERIFY(readFrame->type == writeFrame->type);
+        QVERIFY(readFrame->timeOffset == writeFrame->timeOffset);
+        QVERIFY(readFrame->data == writeFrame->data);
+    }
+
+    // seeking backwards and forwards across blocks
+    for (float position : { 20.0f, 1.0f, 15.5f, 0.0f, 21.0f }) {
+        readClip->seek(position);
+        writeClip->seek(position);
+        auto readFrame = readClip->nextFrame();
+        auto writeFrame = writeClip->nextFrame();
+        QVERIFY(readFrame && writeFrame);
+        QVERIFY(readFrame->timeOffset == writeFrame->timeOffset);
+        QVERIFY(readFrame->data == writeFrame->data);
+    }
+}
+
+void writeLegacyFrame(QFile& output, FrameType type, Frame::Time timeOffset, const QByteArray& data) {
+    FrameSize size = data.size();
+    output.write((const char*)&type, sizeof(FrameType));
+    output.write((const char*)&timeOffset, sizeof(Frame::Time));
+    output.write((const char*)&size, sizeof(FrameSize));
+    output.write(data);
+}
+
+void testLegacyFileRead() {
+    QTemporaryFile file;
+    QString fileName = makeTemporaryFileName(file);
+
+    // a version 1 file: the header frame, then individually compressed frames
+    const int FRAME_COUNT = 100;
+    {
+        QFile output(fileName);
+        QVERIFY(output.open(QFile::Truncate | QFile::WriteOnly));
+        QJsonObject frameTypes;
+        frameTypes[TEST_NAME] = TEST_FRAME_TYPE;
+        QJsonObject header;
+        header.insert(Clip::FRAME_TYPE_MAP, frameTypes);
+        header.insert(Clip::FRAME_COMREPSSION_FLAG, true);
+        writeLegacyFrame(output, Frame::TYPE_HEADER, 0, QJsonDocument(header).toBinaryData());
+        for (int i = 0; i < FRAME_COUNT; ++i) {
+            writeLegacyFrame(output, TEST_FRAME_TYPE, i * 10, qCompress(makeFrameData(i)));
+        }
+    }
+
+    auto readClip = Clip::fromFile(fileName);
+    QVERIFY(readClip != Clip::Pointer());
+    QVERIFY(readClip->frameCount() == (size_t)FRAME_COUNT);
+    readClip->seek(0);
+    int i = 0;
+    for (auto readFrame = readClip->nextFrame(); readFrame; readFrame = readClip->nextFrame(), ++i) {
+        QVERIFY(readFrame->timeOffset == (Frame::Time)(i * 10));
+        QVERIFY(readFrame->data == makeFrameData(i));
+    }
+    QVERIFY(i == FRAME_COUNT);
+}
+
+// what a bot farm does: many agents each playing back a long recording
+void benchmarkPlayback() {
+    QTemporaryFile file;
+    QString fileName = makeTemporaryFileName(file);
+    const int FRAME_COUNT = 90 * 60 * 5; // about five minutes
+    Clip::toFile(fileName, makeLongClip(FRAME_COUNT));
+
+    const int NUM_CLIPS = 200;
+    const int NUM_PLAYBACK_FRAMES = 900;
+    quint64 startResident = getProcessResidentBytes();
+    std::vector<Clip::Pointer> clips;
+    for (int i = 0; i < NUM_CLIPS; ++i) {
+        clips.push_back(Clip::fromFile(fileName));
+        clips.back()->seek((float)(i % 50) * 5.0f);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    size_t bytes = 0;
+    for (int frame = 0; frame < NUM_PLAYBACK_FRAMES; ++frame) {
+        for (auto& clip : clips) {
+            auto next = clip->nextFrame();
+            if (next) {
+                bytes += next->data.size();
+            }
+        }
+    }
+    quint64 elapsed = timer.nsecsElapsed();
+    quint64 endResident = getProcessResidentBytes();
+
+    qDebug() << NUM_CLIPS << "clips of" << FRAME_COUNT << "frames (" << QFileInfo(fileName).size() << "bytes):"
+        << (float)elapsed / (float)(NUM_CLIPS * NUM_PLAYBACK_FRAMES * NSECS_PER_USEC) << "usecs per frame,"
+        << (float)(endResident - startResident) / (float)NUM_CLIPS << "bytes resident per clip," << bytes << "bytes played";
+}
+
 #ifdef Q_OS_WIN32
 void myMessageHandler(QtMsgType type, const QMessageLogContext & context, const QString & msg) {
     OutputDebugStringA(msg.toLocal8Bit().toStdString().c_str());
@@ -111,4 +255,7 @@ int main(int, const char**) {
     testFrameTypeRegistration();
     testFilePersist();
     testClipOrdering();
+    testBlockCompressedPersist();
+    testLegacyFileRead();
+    benchmarkPlayback();
 }
\ No newline at end of file
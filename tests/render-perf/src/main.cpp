@@ -60,6 +60,7 @@
 #include <render/Engine.h>
 #include <Model.h>
 #include <model/Stage.h>
+#include <LoaderScheduler.h>
 #include <TextureCache.h>
 #include <FramebufferCache.h>
 #include <model-networking/ModelCache.h>
@@ -491,6 +492,7 @@ public:
         DependencyManager::set<NodeList>(NodeType::Agent);
         DependencyManager::set<DeferredLightingEffect>();
         DependencyManager::set<ResourceCacheSharedItems>();
+        DependencyManager::set<LoaderScheduler>();
         DependencyManager::set<TextureCache>();
         DependencyManager::set<FramebufferCache>();
         DependencyManager::set<GeometryCache>();
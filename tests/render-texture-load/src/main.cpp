@@ -51,6 +51,7 @@
 #include <GenericThread.h>
 #include <AddressManager.h>
 #include <NodeList.h>
+#include <LoaderScheduler.h>
 #include <TextureCache.h>
 #include <FramebufferCache.h>
 #include <GeometryCache.h>
@@ -284,6 +285,7 @@ public:
         DependencyManager::set<AddressManager>();
         DependencyManager::set<NodeList>(NodeType::Agent);
         DependencyManager::set<ResourceCacheSharedItems>();
+        DependencyManager::set<LoaderScheduler>();
         DependencyManager::set<TextureCache>();
         DependencyManager::set<FramebufferCache>();
         DependencyManager::set<GeometryCache>();
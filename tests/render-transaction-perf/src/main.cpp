@@ -0,0 +1,134 @@
+//
+//  main.cpp
+//  tests/render-transaction-perf/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+// Headless benchmark of the cost of building and applying render::Transactions, shaped like a busy domain: many
+// models, each updating the transforms of all of their mesh parts every frame.
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QDebug>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <render/Scene.h>
+
+namespace {
+    // stands in for a mesh part payload
+    struct TestPart {
+        glm::vec3 position;
+        glm::quat rotation;
+        glm::mat4 transform;
+        render::ItemKey key { render::ItemKey::Builder::opaqueShape() };
+
+        void updateTransform(const glm::vec3& newPosition, const glm::quat& newRotation) {
+            position = newPosition;
+            rotation = newRotation;
+            transform = glm::translate(glm::mat4(), position) * glm::mat4_cast(rotation);
+        }
+    };
+    using TestPartPayload = render::Payload<TestPart>;
+}
+
+namespace render {
+    template <> const ItemKey payloadGetKey(const std::shared_ptr<TestPart>& part) { return part->key; }
+    template <> const Item::Bound payloadGetBound(const std::shared_ptr<TestPart>& part) {
+        return Item::Bound(part->position - glm::vec3(0.5f), 1.0f);
+    }
+}
+
+struct FrameTimes {
+    quint64 buildNsecs { 0 };
+    quint64 applyNsecs { 0 };
+};
+
+FrameTimes runFrames(render::Scene& scene, const std::vector<render::ItemID>& items, int partsPerModel, int frames, bool concurrent) {
+    FrameTimes times;
+    QElapsedTimer timer;
+    for (int frame = 0; frame < frames; ++frame) {
+        timer.start();
+        // one transaction per model, enqueued from the "main thread" the way Model::updateRenderItems does it
+        for (size_t first = 0; first < items.size(); first += partsPerModel) {
+            render::Transaction transaction;
+            glm::vec3 modelPosition((float)(first % 100), (float)frame * 0.01f, (float)(first / 100));
+            glm::quat modelRotation = glm::angleAxis((float)frame * 0.01f, glm::vec3(0.0f, 1.0f, 0.0f));
+            size_t last = std::min(items.size(), first + partsPerModel);
+            for (size_t i = first; i < last; ++i) {
+                auto update = [modelPosition, modelRotation](TestPart& part) {
+                    part.updateTransform(modelPosition, modelRotation);
+                };
+                if (concurrent) {
+                    transaction.updateItemConcurrently<TestPart>(items[i], update);
+                } else {
+                    transaction.updateItem<TestPart>(items[i], update);
+                }
+            }
+            scene.enqueueTransaction(std::move(transaction));
+        }
+        times.buildNsecs += timer.nsecsElapsed();
+
+        // and consolidated and applied on the "render thread"
+        timer.start();
+        scene.enqueueFrame();
+        scene.processTransactionQueue();
+        times.applyNsecs += timer.nsecsElapsed();
+    }
+    times.buildNsecs /= frames;
+    times.applyNsecs /= frames;
+    return times;
+}
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addOptions({
+        { "items", "Number of render items", "count", "20000" },
+        { "parts", "Render items per model (per transaction)", "count", "20" },
+        { "frames", "Frames to run in each mode", "count", "300" }
+    });
+    parser.process(app);
+
+    const int numItems = parser.value("items").toInt();
+    const int partsPerModel = std::max(1, parser.value("parts").toInt());
+    const int frames = std::max(1, parser.value("frames").toInt());
+
+    render::Scene scene(glm::vec3(-1000.0f), 2000.0f);
+
+    std::vector<render::ItemID> items;
+    {
+        render::Transaction transaction;
+        for (int i = 0; i < numItems; ++i) {
+            auto id = scene.allocateID();
+            auto part = std::make_shared<TestPart>();
+            part->position = glm::vec3((float)(i % 100), 0.0f, (float)(i / 100));
+            transaction.resetItem(id, std::make_shared<TestPartPayload>(part));
+            items.push_back(id);
+        }
+        scene.enqueueTransaction(std::move(transaction));
+        scene.enqueueFrame();
+        scene.processTransactionQueue();
+    }
+
+    // warm up, so the transaction arena pool and the scene's scratch space are allocated
+    runFrames(scene, items, partsPerModel, 10, true);
+
+    qDebug() << numItems << "items," << partsPerModel << "per transaction," << frames << "frames";
+    for (bool concurrent : { false, true }) {
+        auto times = runFrames(scene, items, partsPerModel, frames, concurrent);
+        qDebug().nospace() << (concurrent ? "  concurrent updates: " : "  serial updates:     ")
+            << "build " << (double)times.buildNsecs / 1000.0 << " usecs/frame, "
+            << "apply " << (double)times.applyNsecs / 1000.0 << " usecs/frame";
+    }
+
+    return 0;
+}
@@ -0,0 +1,149 @@
+//
+//  PropertyFlagsTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PropertyFlagsTests.h"
+
+#include <PropertyFlags.h>
+
+QTEST_MAIN(PropertyFlagsTests)
+
+// two otherwise identical property lists, one using the default QBitArray storage and one using fixed storage
+enum DynamicPropertyList {
+    DYNAMIC_PROP_FIRST = 0,
+    DYNAMIC_PROP_AFTER_LAST_ITEM = 150
+};
+
+enum FixedPropertyList {
+    FIXED_PROP_FIRST = 0,
+    FIXED_PROP_AFTER_LAST_ITEM = 150
+};
+
+template<> struct PropertyFlagsStorage<FixedPropertyList> : FixedPropertyFlagsStorage<FIXED_PROP_AFTER_LAST_ITEM> {};
+
+typedef PropertyFlags<DynamicPropertyList> DynamicPropertyFlags;
+typedef PropertyFlags<FixedPropertyList> FixedPropertyFlags;
+
+const int NUM_RANDOM_FLAG_SETS = 1000;
+const int MAX_FLAGS_PER_SET = 20;
+
+static void makeRandomFlags(DynamicPropertyFlags& dynamicFlags, FixedPropertyFlags& fixedFlags) {
+    int numFlags = qrand() % MAX_FLAGS_PER_SET;
+    for (int i = 0; i < numFlags; i++) {
+        int flag = qrand() % FIXED_PROP_AFTER_LAST_ITEM;
+        dynamicFlags.setHasProperty((DynamicPropertyList)flag);
+        fixedFlags.setHasProperty((FixedPropertyList)flag);
+    }
+}
+
+void PropertyFlagsTests::testFixedEncodingMatchesDynamic() {
+    qsrand(1);
+    for (int i = 0; i < NUM_RANDOM_FLAG_SETS; i++) {
+        DynamicPropertyFlags dynamicFlags;
+        FixedPropertyFlags fixedFlags;
+        makeRandomFlags(dynamicFlags, fixedFlags);
+
+        QByteArray expected = dynamicFlags.encode();
+        QCOMPARE(fixedFlags.encode(), expected);
+        QCOMPARE(fixedFlags.getEncodedSize(), expected.size());
+
+        uint8_t buffer[FixedPropertyFlagsStorage<FIXED_PROP_AFTER_LAST_ITEM>::MAX_ENCODED_SIZE];
+        int length = fixedFlags.encode(buffer, sizeof(buffer));
+        QCOMPARE(QByteArray((const char*)buffer, length), expected);
+
+        // a buffer that is too small is left alone
+        QCOMPARE(fixedFlags.encode(buffer, expected.size() - 1), 0);
+    }
+}
+
+void PropertyFlagsTests::testDecode() {
+    qsrand(2);
+    for (int i = 0; i < NUM_RANDOM_FLAG_SETS; i++) {
+        DynamicPropertyFlags dynamicFlags;
+        FixedPropertyFlags fixedFlags;
+        makeRandomFlags(dynamicFlags, fixedFlags);
+        QByteArray encoded = dynamicFlags.encode();
+
+        FixedPropertyFlags decoded;
+        size_t bytesConsumed = decoded.decode(reinterpret_cast<const uint8_t*>(encoded.constData()), encoded.size());
+        QCOMPARE((int)bytesConsumed, encoded.size());
+        QCOMPARE(decoded.getEncodedLength(), encoded.size());
+        for (int flag = 0; flag < FIXED_PROP_AFTER_LAST_ITEM; flag++) {
+            QCOMPARE(decoded.getHasProperty((FixedPropertyList)flag), dynamicFlags.getHasProperty((DynamicPropertyList)flag));
+        }
+    }
+}
+
+void PropertyFlagsTests::testSetOperations() {
+    qsrand(3);
+    for (int i = 0; i < NUM_RANDOM_FLAG_SETS; i++) {
+        DynamicPropertyFlags dynamicA, dynamicB;
+        FixedPropertyFlags fixedA, fixedB;
+        makeRandomFlags(dynamicA, fixedA);
+        makeRandomFlags(dynamicB, fixedB);
+
+        QCOMPARE((fixedA | fixedB).encode(), (dynamicA | dynamicB).encode());
+        QCOMPARE((fixedA & fixedB).encode(), (dynamicA & dynamicB).encode());
+        QCOMPARE((fixedA ^ fixedB).encode(), (dynamicA ^ dynamicB).encode());
+        QCOMPARE((fixedA - fixedB).encode(), (dynamicA - dynamicB).encode());
+        QCOMPARE((fixedA + fixedB).encode(), (dynamicA + dynamicB).encode());
+    }
+}
+
+void PropertyFlagsTests::benchmarkEncodeDecode() {
+    const int LOOPS = 1000000;
+    const float NSECS_PER_SECOND = 1.0e9f;
+
+    DynamicPropertyFlags dynamicFlags;
+    FixedPropertyFlags fixedFlags;
+    for (int flag = 0; flag < FIXED_PROP_AFTER_LAST_ITEM; flag += 3) {
+        dynamicFlags.setHasProperty((DynamicPropertyList)flag);
+        fixedFlags.setHasProperty((FixedPropertyList)flag);
+    }
+    QByteArray encoded = dynamicFlags.encode();
+    const uint8_t* encodedData = reinterpret_cast<const uint8_t*>(encoded.constData());
+    uint8_t buffer[FixedPropertyFlagsStorage<FIXED_PROP_AFTER_LAST_ITEM>::MAX_ENCODED_SIZE];
+    int checksum = 0;
+
+    {
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < LOOPS; ++i) {
+            checksum += dynamicFlags.encode().size();
+        }
+        qDebug() << "QBitArray encode" << (float)LOOPS / timer.nsecsElapsed() * NSECS_PER_SECOND << "per second";
+    }
+    {
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < LOOPS; ++i) {
+            checksum += fixedFlags.encode(buffer, sizeof(buffer));
+        }
+        qDebug() << "FixedBitArray encode" << (float)LOOPS / timer.nsecsElapsed() * NSECS_PER_SECOND << "per second";
+    }
+    {
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < LOOPS; ++i) {
+            DynamicPropertyFlags decoded;
+            checksum += (int)decoded.decode(encodedData, encoded.size());
+        }
+        qDebug() << "QBitArray decode" << (float)LOOPS / timer.nsecsElapsed() * NSECS_PER_SECOND << "per second";
+    }
+    {
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < LOOPS; ++i) {
+            FixedPropertyFlags decoded;
+            checksum += (int)decoded.decode(encodedData, encoded.size());
+        }
+        qDebug() << "FixedBitArray decode" << (float)LOOPS / timer.nsecsElapsed() * NSECS_PER_SECOND << "per second";
+    }
+    QVERIFY(checksum > 0);
+}
@@ -0,0 +1,25 @@
+//
+//  PropertyFlagsTests.h
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PropertyFlagsTests_h
+#define hifi_PropertyFlagsTests_h
+
+#include <QtTest/QtTest>
+
+class PropertyFlagsTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testFixedEncodingMatchesDynamic();
+    void testDecode();
+    void testSetOperations();
+    void benchmarkEncodeDecode();
+};
+
+#endif // hifi_PropertyFlagsTests_h
@@ -8,10 +8,13 @@
 
 #include "TraceTests.h"
 
+#include <thread>
+
 #include <QtTest/QtTest>
 #include <QtGui/QDesktopServices>
 
 #include <Profile.h>
+#include <TraceBuffer.h>
 
 #include <NumericalConstants.h>
 #include <../QTestExtensions.h>
@@ -45,3 +48,117 @@ void TraceTests::testTraceSerialization() {
     qDebug() << "Done";
 }
 
+
+void TraceTests::testTraceBufferOverwrite() {
+    tracing::TraceBuffer buffer(0);
+
+    tracing::TraceRecord record {};
+    const uint64_t NUM_RECORDS = tracing::TraceBuffer::CAPACITY + 100;
+    for (uint64_t i = 0; i < NUM_RECORDS; ++i) {
+        record.timestamp = i;
+        buffer.push(record);
+    }
+
+    // a reader that falls behind loses the oldest records, but gets the rest in order
+    uint64_t position = 0;
+    std::vector<tracing::TraceRecord> records;
+    auto lost = buffer.read(position, records);
+    QCOMPARE(position, NUM_RECORDS);
+    QCOMPARE((uint64_t)(lost + records.size()), NUM_RECORDS);
+    QVERIFY(records.size() >= tracing::TraceBuffer::CAPACITY - 1);
+    for (size_t i = 0; i < records.size(); ++i) {
+        QCOMPARE(records[i].timestamp, (uint64_t)(lost + i));
+    }
+
+    // one that keeps up gets everything
+    records.clear();
+    for (uint64_t i = 0; i < 10; ++i) {
+        record.timestamp = NUM_RECORDS + i;
+        buffer.push(record);
+    }
+    QCOMPARE(buffer.read(position, records), (uint64_t)0);
+    QCOMPARE(records.size(), (size_t)10);
+    QCOMPARE(records.front().timestamp, NUM_RECORDS);
+
+    // and a concurrent reader never sees a record out of order
+    std::atomic<bool> done { false };
+    std::thread writer([&] {
+        for (uint64_t i = 0; i < 50 * tracing::TraceBuffer::CAPACITY; ++i) {
+            record.timestamp = NUM_RECORDS + 10 + i;
+            buffer.push(record);
+        }
+        done = true;
+    });
+    uint64_t last = records.back().timestamp;
+    uint64_t seen = records.size();
+    uint64_t dropped = 0;
+    while (!done) {
+        records.clear();
+        dropped += buffer.read(position, records);
+        for (const auto& read : records) {
+            QVERIFY(read.timestamp > last);
+            last = read.timestamp;
+        }
+        seen += records.size();
+    }
+    writer.join();
+    records.clear();
+    dropped += buffer.read(position, records);
+    seen += records.size();
+    QCOMPARE(seen + dropped, buffer.head());
+}
+
+void TraceTests::testFlightRecorder() {
+    auto tracer = DependencyManager::set<tracing::Tracer>();
+    tracer->startFlightRecorder();
+    QVERIFY(tracing::recording());
+    {
+        PROFILE_RANGE(test, "FlightRecorderEvent");
+        PROFILE_COUNTER(test, "FlightRecorderCounter", { { "value", 42 } });
+        PROFILE_INSTANT(test, "FlightRecorderInstant");
+    }
+
+    QString path = QDir::temp().absoluteFilePath("flightRecorderTest.json");
+    QCOMPARE(tracer->writeFlightRecorder(path), path);
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QJsonParseError error;
+    auto document = QJsonDocument::fromJson(file.readAll(), &error);
+    file.close();
+    QFile::remove(path);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+
+    QMap<QString, QString> phases;
+    for (const auto& value : document.array()) {
+        auto event = value.toObject();
+        if (event["cat"].toString() == "trace.test") {
+            phases[event["name"].toString()] += event["ph"].toString();
+        }
+    }
+    QCOMPARE(phases["FlightRecorderEvent"], QString("BE"));
+    QCOMPARE(phases["FlightRecorderCounter"], QString("C"));
+    QCOMPARE(phases["FlightRecorderInstant"], QString("i"));
+
+    tracer->stopFlightRecorder();
+    QVERIFY(!tracing::recording());
+}
+
+void TraceTests::benchmarkProfileRange() {
+    auto tracer = DependencyManager::set<tracing::Tracer>();
+    const int NUM_RANGES = 1000000;
+
+    auto timeRanges = [&] {
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < NUM_RANGES; ++i) {
+            PROFILE_RANGE(test, "BenchmarkRange");
+        }
+        return (double)timer.nsecsElapsed() / NUM_RANGES;
+    };
+
+    qDebug() << "PROFILE_RANGE idle:" << timeRanges() << "ns";
+    tracer->startFlightRecorder();
+    qDebug() << "PROFILE_RANGE flight recording:" << timeRanges() << "ns";
+    tracer->stopFlightRecorder();
+}
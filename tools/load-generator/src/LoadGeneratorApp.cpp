@@ -0,0 +1,509 @@
+//
+//  LoadGeneratorApp.cpp
+//  tools/load-generator/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LoadGeneratorApp.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QUrl>
+
+#include <AudioConstants.h>
+#include <AvatarData.h>
+#include <DomainHandler.h>
+#include <LogHandler.h>
+#include <NetworkLogging.h>
+#include <NodeList.h>
+#include <NumericalConstants.h>
+#include <SharedLogging.h>
+#include <SharedUtil.h>
+#include <Sound.h>
+#include <recording/Clip.h>
+#include <recording/Frame.h>
+#include <shared/NetworkUtils.h>
+
+const QCommandLineOption DOMAIN_OPTION {
+    "domain", "domain-server to connect the agents to (default is 127.0.0.1:"
+        + QString::number(DEFAULT_DOMAIN_SERVER_PORT) + ")", "IP:PORT"
+};
+const QCommandLineOption AGENTS {
+    "agents", "number of agents to run (default is 100)", "count"
+};
+const QCommandLineOption SPAWN_INTERVAL {
+    "spawn-interval", "time between starting each agent (default is 20ms)", "milliseconds"
+};
+const QCommandLineOption WAV {
+    "wav", "WAV file each agent loops as its microphone, from its own offset (default is a tone)", "path"
+};
+const QCommandLineOption TONE {
+    "tone", "frequency of the tone agents send when there's no WAV (default is 440Hz)", "hertz"
+};
+const QCommandLineOption RECORDING {
+    "recording", "avatar recording each agent loops, moved to its own spot (default is to walk in a circle)", "path"
+};
+const QCommandLineOption WALK_RADIUS {
+    "walk-radius", "radius of the circle agents walk without a recording (default is 2m)", "meters"
+};
+const QCommandLineOption WALK_SPEED {
+    "walk-speed", "speed agents walk at without a recording (default is 1m/s)", "meters per second"
+};
+const QCommandLineOption QUERY_RATE {
+    "query-rate", "entity queries and view frustums each agent sends per second (default is 2)", "hertz"
+};
+const QCommandLineOption MAX_QUERY_PPS {
+    "max-query-pps", "entity packets per second each agent asks the entity-server for (default is its default)", "pps"
+};
+const QCommandLineOption NO_AUDIO {
+    "no-audio", "don't connect to the audio-mixer"
+};
+const QCommandLineOption NO_AVATAR {
+    "no-avatar", "don't connect to the avatar-mixer"
+};
+const QCommandLineOption NO_QUERIES {
+    "no-queries", "don't connect to the entity-server"
+};
+const QCommandLineOption VERBOSE {
+    "v", "verbose networking output"
+};
+
+// agents send avatar data as often as an Agent assignment does
+static const int AVATAR_DATA_HZ = 45;
+static const int PROGRESS_INTERVAL_MSECS = 5000;
+
+// after a stall, send at most this many frames of audio to catch up and drop the rest
+static const int MAX_AUDIO_CATCH_UP_FRAMES = 5;
+
+static const float TONE_AMPLITUDE = 0.25f; // of full scale
+
+static const double BITS_PER_BYTE = 8.0;
+static const double BITS_PER_MEGABIT = 1000.0 * 1000.0;
+static const double USECS_PER_MSEC_F = 1000.0;
+
+LoadGeneratorApp::LoadGeneratorApp(int& argc, char** argv) :
+    QCoreApplication(argc, argv)
+{
+    qInstallMessageHandler(LogHandler::verboseMessageHandler);
+
+    parseArguments();
+
+    if (!_argumentParser.isSet(VERBOSE)) {
+        // hundreds of sockets each have something to say about their buffers
+        const_cast<QLoggingCategory*>(&networking())->setEnabled(QtDebugMsg, false);
+        const_cast<QLoggingCategory*>(&networking())->setEnabled(QtInfoMsg, false);
+        const_cast<QLoggingCategory*>(&shared())->setEnabled(QtDebugMsg, false);
+        const_cast<QLoggingCategory*>(&shared())->setEnabled(QtInfoMsg, false);
+    }
+
+    NodeType::init();
+
+    QString domainString = _argumentParser.isSet(DOMAIN_OPTION) ? _argumentParser.value(DOMAIN_OPTION) : "127.0.0.1";
+    int colonIndex = domainString.indexOf(':');
+    QHostAddress domainAddress { domainString.left(colonIndex) };
+    quint16 domainPort = colonIndex >= 0 ? (quint16)domainString.mid(colonIndex + 1).toUInt() : DEFAULT_DOMAIN_SERVER_PORT;
+
+    if (domainAddress.isNull() || domainPort == 0) {
+        qCritical() << "Could not parse an IP address and port combination from" << domainString;
+        QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        return;
+    }
+
+    _settings.domainServer = HifiSockAddr(domainAddress, domainPort);
+    _settings.localAddress = domainAddress.isLoopback() ? QHostAddress(QHostAddress::LocalHost) : getGuessedLocalAddress();
+
+    if (_argumentParser.isSet(AGENTS)) {
+        _numAgents = _argumentParser.value(AGENTS).toInt();
+    }
+
+    _settings.sendAudio = !_argumentParser.isSet(NO_AUDIO);
+    _settings.sendAvatar = !_argumentParser.isSet(NO_AVATAR);
+    _settings.sendQueries = !_argumentParser.isSet(NO_QUERIES);
+
+    if (_settings.sendAudio) {
+        if (_argumentParser.isSet(WAV)) {
+            if (!loadAudio(_argumentParser.value(WAV))) {
+                QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+                return;
+            }
+        } else {
+            generateTone(_argumentParser.isSet(TONE) ? _argumentParser.value(TONE).toFloat() : 440.0f);
+        }
+    }
+
+    if (_argumentParser.isSet(RECORDING)) {
+        if (!loadRecording(_argumentParser.value(RECORDING))) {
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+            return;
+        }
+    } else {
+        if (_argumentParser.isSet(WALK_RADIUS)) {
+            _settings.walkRadius = _argumentParser.value(WALK_RADIUS).toFloat();
+        }
+        if (_argumentParser.isSet(WALK_SPEED)) {
+            _settings.walkSpeed = _argumentParser.value(WALK_SPEED).toFloat();
+        }
+        _avatarSource = QString("walk, %1m radius at %2m/s").arg(_settings.walkRadius).arg(_settings.walkSpeed);
+    }
+
+    if (_argumentParser.isSet(MAX_QUERY_PPS)) {
+        _settings.maxQueryPacketsPerSecond = _argumentParser.value(MAX_QUERY_PPS).toInt();
+    }
+
+    // the report of each agent's latency, loss and received bandwidth is written on exit
+    if (!_testRun.start(_argumentParser, [this] { return buildReport(); })) {
+        QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        return;
+    }
+    _settings.impairment = _testRun.getImpairmentProfile();
+
+    qDebug() << "Starting" << _numAgents << "agents against the domain-server at" << _settings.domainServer;
+    if (_settings.sendAudio) {
+        qDebug() << "Audio:" << _audioSource;
+    }
+    if (_settings.sendAvatar) {
+        qDebug() << "Avatar:" << _avatarSource;
+    }
+
+    // every agent runs on this thread, driven by these timers
+    _agents.reserve(_numAgents);
+    connect(&_spawnTimer, &QTimer::timeout, this, &LoadGeneratorApp::spawnAgent);
+    _spawnTimer.start(_argumentParser.isSet(SPAWN_INTERVAL) ? _argumentParser.value(SPAWN_INTERVAL).toInt() : 20);
+
+    connect(&_checkInTimer, &QTimer::timeout, this, &LoadGeneratorApp::checkIn);
+    _checkInTimer.start((int)DOMAIN_SERVER_CHECK_IN_MSECS);
+
+    connect(&_audioTimer, &QTimer::timeout, this, &LoadGeneratorApp::sendAudio);
+    _audioTimer.setTimerType(Qt::PreciseTimer);
+    _audioTimer.start(AudioConstants::NETWORK_FRAME_USECS / (int)USECS_PER_MSEC);
+    _audioClock.start();
+
+    connect(&_avatarTimer, &QTimer::timeout, this, &LoadGeneratorApp::sendAvatarData);
+    _avatarTimer.setTimerType(Qt::PreciseTimer);
+    _avatarTimer.start((int)MSECS_PER_SECOND / AVATAR_DATA_HZ);
+
+    float queryRate = _argumentParser.isSet(QUERY_RATE) ? _argumentParser.value(QUERY_RATE).toFloat() : 2.0f;
+    connect(&_queryTimer, &QTimer::timeout, this, &LoadGeneratorApp::sendQueries);
+    _queryTimer.start((int)(MSECS_PER_SECOND / std::max(queryRate, 0.1f)));
+
+    connect(&_progressTimer, &QTimer::timeout, this, &LoadGeneratorApp::printProgress);
+    _progressTimer.start(PROGRESS_INTERVAL_MSECS);
+}
+
+void LoadGeneratorApp::parseArguments() {
+    _argumentParser.setApplicationDescription("High Fidelity Load Generator");
+
+    const QCommandLineOption helpOption = _argumentParser.addHelpOption();
+
+    _argumentParser.addOptions({
+        DOMAIN_OPTION, AGENTS, SPAWN_INTERVAL, WAV, TONE, RECORDING, WALK_RADIUS, WALK_SPEED,
+        QUERY_RATE, MAX_QUERY_PPS, NO_AUDIO, NO_AVATAR, NO_QUERIES, VERBOSE
+    });
+    udt::NetworkTestRun::addOptions(_argumentParser);
+
+    if (!_argumentParser.parse(arguments())) {
+        qCritical() << _argumentParser.errorText();
+        _argumentParser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    if (_argumentParser.isSet(helpOption)) {
+        _argumentParser.showHelp();
+        Q_UNREACHABLE();
+    }
+}
+
+bool LoadGeneratorApp::loadAudio(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCritical() << "Could not open" << path << "-" << file.errorString();
+        return false;
+    }
+
+    // the same parsing and resampling a Sound gets, run here rather than on the thread pool
+    SoundProcessor processor(QUrl::fromLocalFile(path), file.readAll(), false, false);
+
+    bool succeeded = false;
+    connect(&processor, &SoundProcessor::onSuccess, this, [&](QByteArray data, bool stereo, bool ambisonic, float duration) {
+        int numChannels = ambisonic ? AudioConstants::AMBISONIC : (stereo ? AudioConstants::STEREO : AudioConstants::MONO);
+        int numFrames = data.size() / (numChannels * AudioConstants::SAMPLE_SIZE);
+        auto samples = reinterpret_cast<const AudioConstants::AudioSample*>(data.constData());
+
+        // agents send mono, so average stereo down and keep the omnidirectional channel of ambisonics
+        _settings.audio.resize(numFrames * AudioConstants::SAMPLE_SIZE);
+        auto mono = reinterpret_cast<AudioConstants::AudioSample*>(_settings.audio.data());
+        for (int i = 0; i < numFrames; ++i) {
+            if (numChannels == AudioConstants::STEREO) {
+                mono[i] = (AudioConstants::AudioSample)(((int)samples[2 * i] + samples[2 * i + 1]) / 2);
+            } else {
+                mono[i] = samples[i * numChannels];
+            }
+        }
+
+        _audioSource = QString("%1, %2s").arg(path).arg(duration);
+        succeeded = numFrames > 0;
+    });
+    processor.run();
+
+    if (!succeeded) {
+        qCritical() << "Could not read audio from" << path;
+    }
+    return succeeded;
+}
+
+void LoadGeneratorApp::generateTone(float frequency) {
+    // a second of it, which loops without a click for whole numbers of hertz
+    const int numSamples = AudioConstants::SAMPLE_RATE;
+    _settings.audio.resize(numSamples * AudioConstants::SAMPLE_SIZE);
+
+    auto samples = reinterpret_cast<AudioConstants::AudioSample*>(_settings.audio.data());
+    for (int i = 0; i < numSamples; ++i) {
+        float phase = TWO_PI * frequency * i / AudioConstants::SAMPLE_RATE;
+        samples[i] = (AudioConstants::AudioSample)(TONE_AMPLITUDE * AudioConstants::MAX_SAMPLE_VALUE * sinf(phase));
+    }
+
+    _audioSource = QString("%1Hz tone").arg(frequency);
+}
+
+bool LoadGeneratorApp::loadRecording(const QString& path) {
+    auto clip = recording::Clip::fromFile(path);
+    if (!clip) {
+        qCritical() << "Could not load a recording from" << path;
+        return false;
+    }
+
+    // read the avatar frames once, every agent plays them back from its own position in the list
+    auto avatarFrameType = recording::Frame::registerFrameType(AvatarData::FRAME_NAME);
+    clip->seek(0.0f);
+    for (auto frame = clip->nextFrame(); frame; frame = clip->nextFrame()) {
+        if (frame->type == avatarFrameType) {
+            _settings.avatarFrames.push_back(frame);
+        }
+    }
+
+    if (_settings.avatarFrames.empty()) {
+        qCritical() << "The recording at" << path << "has no avatar frames";
+        return false;
+    }
+
+    _settings.avatarFramesDuration = recording::Frame::secondsToFrameTime(clip->duration());
+    _avatarSource = QString("%1, %2 frames over %3s").arg(path).arg(_settings.avatarFrames.size()).arg(clip->duration());
+    return true;
+}
+
+void LoadGeneratorApp::spawnAgent() {
+    if ((int)_agents.size() >= _numAgents) {
+        _spawnTimer.stop();
+        return;
+    }
+
+    _agents.emplace_back(new SyntheticAgent((int)_agents.size(), _settings));
+
+    // say hello right away rather than on the next check in
+    _agents.back()->checkIn();
+}
+
+void LoadGeneratorApp::checkIn() {
+    for (auto& agent : _agents) {
+        agent->checkIn();
+    }
+}
+
+void LoadGeneratorApp::sendAudio() {
+    // the timer only roughly keeps time, the clock decides how many frames are due
+    qint64 framesDue = _audioClock.nsecsElapsed() / (AudioConstants::NETWORK_FRAME_USECS * 1000);
+    if (framesDue - _numAudioFrames > MAX_AUDIO_CATCH_UP_FRAMES) {
+        _numAudioFrames = framesDue - MAX_AUDIO_CATCH_UP_FRAMES;
+    }
+
+    for (; _numAudioFrames < framesDue; ++_numAudioFrames) {
+        for (auto& agent : _agents) {
+            agent->sendAudioFrame();
+        }
+    }
+}
+
+void LoadGeneratorApp::sendAvatarData() {
+    for (auto& agent : _agents) {
+        agent->sendAvatarData();
+    }
+}
+
+void LoadGeneratorApp::sendQueries() {
+    for (auto& agent : _agents) {
+        agent->sendQuery();
+    }
+}
+
+void LoadGeneratorApp::printProgress() {
+    int numConnected = 0;
+    qint64 receivedBytes = 0;
+    for (auto& agent : _agents) {
+        if (agent->isConnected()) {
+            ++numConnected;
+        }
+        for (const auto& server : agent->getStats().servers) {
+            receivedBytes += server.second.receivedBytes;
+        }
+    }
+
+    double seconds = _testRun.getElapsedSeconds();
+    qDebug().noquote() << QString("%1s: %2 of %3 agents connected, receiving %4 Mb/s in all")
+        .arg(seconds, 0, 'f', 0)
+        .arg(numConnected)
+        .arg(_agents.size())
+        .arg(receivedBytes * BITS_PER_BYTE / BITS_PER_MEGABIT / std::max(seconds, 1.0), 0, 'f', 2);
+}
+
+static QJsonObject streamStats(const PacketStreamStats& stats) {
+    return {
+        { "received", (qint64)stats._received },
+        { "lost", (qint64)stats._lost },
+        { "late", (qint64)stats._late },
+        { "lossRate", stats.getLostRate() }
+    };
+}
+
+QJsonObject LoadGeneratorApp::buildReport() {
+    static const double MSECS_PER_USEC = 1.0 / USECS_PER_MSEC_F;
+    static const double KILOBITS_PER_BYTE = BITS_PER_BYTE / 1000.0;
+
+    auto now = usecTimestampNow();
+    int numConnected = 0;
+
+    // across agents: samples pooled from all of them, or one value per agent
+    std::map<NodeType_t, std::vector<double>> rtts;
+    std::map<NodeType_t, std::vector<double>> receivedKbps;
+    std::vector<double> connectTimes;
+    std::vector<double> downstreamAudioLoss;
+    std::vector<double> upstreamAudioLoss;
+    std::vector<double> audioJitter;
+    std::vector<double> entityLoss;
+    std::vector<double> entityLatencies;
+
+    QJsonArray perAgent;
+
+    for (auto& agent : _agents) {
+        const auto& stats = agent->getStats();
+        double seconds = std::max(1.0, (double)(now - stats.startTime) / USECS_PER_SECOND);
+
+        QJsonObject servers;
+        for (const auto& server : stats.servers) {
+            std::vector<double> serverRTTs(server.second.rtts.begin(), server.second.rtts.end());
+            double kbps = server.second.receivedBytes * KILOBITS_PER_BYTE / seconds;
+
+            rtts[server.first].insert(rtts[server.first].end(), serverRTTs.begin(), serverRTTs.end());
+            receivedKbps[server.first].push_back(kbps);
+
+            servers[NodeType::getNodeTypeName(server.first)] = QJsonObject {
+                { "rttMs", udt::NetworkTestRun::summarize(serverRTTs, MSECS_PER_USEC) },
+                { "receivedKbps", kbps },
+                { "receivedPackets", server.second.receivedPackets }
+            };
+        }
+
+        QJsonObject agentReport {
+            { "agent", agent->getIndex() },
+            { "connected", agent->isConnected() },
+            { "sentKbps", stats.sentBytes * KILOBITS_PER_BYTE / seconds },
+            { "servers", servers }
+        };
+
+        if (stats.connectTime > 0) {
+            ++numConnected;
+            double connectMs = (stats.connectTime - stats.startTime) * MSECS_PER_USEC;
+            connectTimes.push_back(connectMs);
+            agentReport["connectMs"] = connectMs;
+        }
+
+        if (_settings.sendAudio) {
+            downstreamAudioLoss.push_back(stats.mixedAudio.getLostRate());
+            upstreamAudioLoss.push_back(stats.upstreamAudio.getLostRate());
+            audioJitter.push_back(stats.audioJitter * MSECS_PER_USEC);
+
+            agentReport["audio"] = QJsonObject {
+                { "sentFrames", stats.sentAudioFrames },
+                { "downstream", streamStats(stats.mixedAudio) },
+                { "upstream", streamStats(stats.upstreamAudio) },
+                { "jitterMs", stats.audioJitter * MSECS_PER_USEC }
+            };
+        }
+
+        if (_settings.sendAvatar) {
+            agentReport["avatar"] = QJsonObject {
+                { "sentPackets", stats.sentAvatarPackets }
+            };
+        }
+
+        if (_settings.sendQueries) {
+            entityLoss.push_back(stats.entityData.getLostRate());
+            entityLatencies.insert(entityLatencies.end(), stats.entityLatencies.begin(), stats.entityLatencies.end());
+
+            std::vector<double> latencies(stats.entityLatencies.begin(), stats.entityLatencies.end());
+            agentReport["entities"] = QJsonObject {
+                { "sentQueries", stats.sentQueries },
+                { "received", streamStats(stats.entityData) },
+                { "latencyMs", udt::NetworkTestRun::summarize(latencies, MSECS_PER_USEC) }
+            };
+        }
+
+        perAgent.append(agentReport);
+    }
+
+    QJsonObject rttReport;
+    for (const auto& samples : rtts) {
+        rttReport[NodeType::getNodeTypeName(samples.first)] = udt::NetworkTestRun::summarize(samples.second, MSECS_PER_USEC);
+    }
+
+    QJsonObject receivedKbpsReport;
+    for (const auto& values : receivedKbps) {
+        receivedKbpsReport[NodeType::getNodeTypeName(values.first)] = udt::NetworkTestRun::summarize(values.second);
+    }
+
+    QJsonObject report {
+        { "domain", _settings.domainServer.toString() },
+        { "seconds", _testRun.getElapsedSeconds() },
+        { "agents", (int)_agents.size() },
+        { "connected", numConnected },
+        { "connectMs", udt::NetworkTestRun::summarize(connectTimes) },
+        { "rttMs", rttReport },
+        { "receivedKbps", receivedKbpsReport },
+        { "perAgent", perAgent }
+    };
+
+    if (_settings.sendAudio) {
+        report["audio"] = QJsonObject {
+            { "source", _audioSource },
+            { "downstreamLossRate", udt::NetworkTestRun::summarize(downstreamAudioLoss) },
+            { "upstreamLossRate", udt::NetworkTestRun::summarize(upstreamAudioLoss) },
+            { "jitterMs", udt::NetworkTestRun::summarize(audioJitter) }
+        };
+    }
+    if (_settings.sendAvatar) {
+        report["avatar"] = QJsonObject {
+            { "source", _avatarSource }
+        };
+    }
+    if (_settings.sendQueries) {
+        report["entities"] = QJsonObject {
+            { "lossRate", udt::NetworkTestRun::summarize(entityLoss) },
+            { "latencyMs", udt::NetworkTestRun::summarize(entityLatencies, MSECS_PER_USEC) }
+        };
+    }
+    if (_settings.impairment.isValid()) {
+        report["impairment"] = _settings.impairment.name;
+    }
+
+    return report;
+}
+}
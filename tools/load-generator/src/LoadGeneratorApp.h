@@ -0,0 +1,71 @@
+//
+//  LoadGeneratorApp.h
+//  tools/load-generator/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_LoadGeneratorApp_h
+#define hifi_LoadGeneratorApp_h
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QTimer>
+
+#include <udt/NetworkTestRun.h>
+
+#include "SyntheticAgent.h"
+
+// Runs many SyntheticAgents against a local domain from one process and one event loop, to load test the
+// audio-mixer, avatar-mixer and entity-server, then reports what each agent saw.
+class LoadGeneratorApp : public QCoreApplication {
+    Q_OBJECT
+public:
+    LoadGeneratorApp(int& argc, char** argv);
+
+private slots:
+    void spawnAgent();
+    void checkIn();
+    void sendAudio();
+    void sendAvatarData();
+    void sendQueries();
+    void printProgress();
+
+private:
+    void parseArguments();
+    bool loadAudio(const QString& path); // from a WAV, as mono 24kHz PCM
+    void generateTone(float frequency);
+    bool loadRecording(const QString& path);
+    QJsonObject buildReport();
+
+    QCommandLineParser _argumentParser;
+    AgentSettings _settings;
+
+    int _numAgents { 100 };
+    std::vector<std::unique_ptr<SyntheticAgent>> _agents;
+
+    QString _audioSource;
+    QString _avatarSource;
+
+    QTimer _spawnTimer;
+    QTimer _checkInTimer;
+    QTimer _audioTimer;
+    QTimer _avatarTimer;
+    QTimer _queryTimer;
+    QTimer _progressTimer;
+
+    udt::NetworkTestRun _testRun;
+    QElapsedTimer _audioClock;
+    qint64 _numAudioFrames { 0 }; // frames each agent should have sent by now
+};
+
+#endif // hifi_LoadGeneratorApp_h
@@ -0,0 +1,577 @@
+//
+//  SyntheticAgent.cpp
+//  tools/load-generator/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SyntheticAgent.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDebug>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <AudioConstants.h>
+#include <AudioStreamStats.h>
+#include <GLMHelpers.h>
+#include <NodeList.h>
+#include <NodePermissions.h>
+#include <NumericalConstants.h>
+#include <OctreePacketData.h>
+#include <SharedUtil.h>
+#include <UUID.h>
+#include <recording/Frame.h>
+#include <udt/PacketHeaders.h>
+
+static const QString PCM_CODEC_NAME = "pcm";
+
+// agents are spread out on a sunflower spiral, about this far apart
+static const float AGENT_SPACING = 3.0f; // meters
+static const float GOLDEN_ANGLE = PI * (3.0f - sqrtf(5.0f)); // radians
+
+static const float EYE_HEIGHT = 0.6f; // above the avatar position, meters
+static const float LOOK_AROUND_ANGLE = PI / 3.0f; // the camera sweeps this far either side of the walk direction
+static const float LOOK_AROUND_RATE = 0.5f; // radians per second
+
+// the far clip an interface with the default LOD would query with, rather than the view frustum default
+static const float QUERY_FAR_CLIP = 500.0f; // meters
+
+static const size_t MAX_LATENCY_SAMPLES = 10000;
+
+SyntheticAgent::SyntheticAgent(int index, const AgentSettings& settings, QObject* parent) :
+    QObject(parent),
+    _index(index),
+    _settings(settings)
+{
+    if (_settings.impairment.isValid()) {
+        _socket.setImpairmentProfile(_settings.impairment);
+    }
+    _socket.bind(QHostAddress::AnyIPv4);
+    _localSockAddr = HifiSockAddr(_settings.localAddress, _socket.localPort());
+
+    auto handler = [this](std::unique_ptr<udt::Packet> packet) {
+        processPacket(NLPacket::fromBase(std::move(packet)));
+    };
+    _socket.setPacketHandler(handler);
+    _socket.setMessageHandler(handler);
+
+    float radius = AGENT_SPACING * sqrtf((float)index);
+    float angle = GOLDEN_ANGLE * index;
+    _origin = glm::vec3(radius * cosf(angle), 0.0f, radius * sinf(angle));
+    _walkPhase = randFloat() * TWO_PI;
+    _lookPhase = randFloat() * TWO_PI;
+
+    _stats.startTime = usecTimestampNow();
+
+    if (!_settings.audio.isEmpty()) {
+        _audioOffset = randIntInRange(0, _settings.audio.size() / AudioConstants::SAMPLE_SIZE - 1);
+    }
+
+    // start somewhere in the recording, so agents playing the same one aren't in step
+    _playbackStartTime = _stats.startTime - (quint64)(randFloat() * _settings.avatarFramesDuration) * USECS_PER_MSEC;
+
+    _viewFrustum.setProjection(glm::perspective(glm::radians(DEFAULT_FIELD_OF_VIEW_DEGREES), DEFAULT_ASPECT_RATIO,
+                                                DEFAULT_NEAR_CLIP, QUERY_FAR_CLIP));
+    if (_settings.maxQueryPacketsPerSecond > 0) {
+        _octreeQuery.setMaxQueryPacketsPerSecond(_settings.maxQueryPacketsPerSecond);
+    }
+
+    updateMotion();
+}
+
+void SyntheticAgent::checkIn() {
+    if (_numNoReplyCheckIns >= MAX_SILENT_DOMAIN_SERVER_CHECK_INS) {
+        qDebug() << "Agent" << _index << "hasn't heard from the domain-server in" << _numNoReplyCheckIns
+            << "check ins, reconnecting";
+        disconnectFromDomain();
+    }
+
+    sendDomainServerCheckIn();
+
+    for (const auto& server : _servers) {
+        if (server.activeSocket.isNull()) {
+            // like NodeList::pingPunchForInactiveNode, whichever socket answers first becomes the active one
+            sendPing(server, server.publicSocket, PingType::Public);
+            if (server.localSocket != server.publicSocket) {
+                sendPing(server, server.localSocket, PingType::Local);
+            }
+        } else {
+            sendPing(server, server.activeSocket, PingType::Agnostic);
+        }
+    }
+}
+
+void SyntheticAgent::sendAudioFrame() {
+    if (!_settings.sendAudio || _settings.audio.isEmpty()) {
+        return;
+    }
+
+    auto audioMixer = soloActiveServer(NodeType::AudioMixer);
+    if (!audioMixer) {
+        return;
+    }
+
+    // the same layout AbstractAudioInterface::emitAudioPacket writes, for one mono PCM frame
+    auto audioPacket = NLPacket::create(PacketType::MicrophoneAudioNoEcho);
+    audioPacket->writePrimitive(_audioSequence++);
+    audioPacket->writeString(PCM_CODEC_NAME);
+
+    quint8 isStereo = 0;
+    audioPacket->writePrimitive(isStereo);
+
+    audioPacket->writePrimitive(_avatar.getPosition());
+    audioPacket->writePrimitive(_avatar.getOrientation());
+    audioPacket->writePrimitive(_avatar.getPosition());
+    audioPacket->writePrimitive(glm::vec3(0.0f));
+
+    // loop the shared audio from where this agent is up to
+    const int numSamples = _settings.audio.size() / AudioConstants::SAMPLE_SIZE;
+    int samplesLeft = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+    while (samplesLeft > 0) {
+        int samplesToCopy = std::min(samplesLeft, numSamples - _audioOffset);
+        audioPacket->write(_settings.audio.constData() + _audioOffset * AudioConstants::SAMPLE_SIZE,
+                           samplesToCopy * AudioConstants::SAMPLE_SIZE);
+        samplesLeft -= samplesToCopy;
+        _audioOffset = (_audioOffset + samplesToCopy) % numSamples;
+    }
+
+    sendPacket(*audioPacket, audioMixer->activeSocket, audioMixer->connectionSecret);
+    ++_stats.sentAudioFrames;
+}
+
+void SyntheticAgent::sendAvatarData() {
+    updateMotion();
+
+    if (!_settings.sendAvatar) {
+        return;
+    }
+
+    auto avatarMixer = soloActiveServer(NodeType::AvatarMixer);
+    if (!avatarMixer) {
+        return;
+    }
+
+    // as Agent::processAgentAvatar does it
+    AvatarData::AvatarDataDetail dataDetail = (randFloat() < AVATAR_SEND_FULL_UPDATE_RATIO) ?
+        AvatarData::SendAllData : AvatarData::CullSmallData;
+    QByteArray avatarByteArray = _avatar.toByteArrayStateful(dataDetail);
+
+    int maximumByteArraySize = NLPacket::maxPayloadSize(PacketType::AvatarData) - sizeof(AvatarDataSequenceNumber);
+    if (avatarByteArray.size() > maximumByteArraySize) {
+        avatarByteArray = _avatar.toByteArrayStateful(dataDetail, true);
+
+        if (avatarByteArray.size() > maximumByteArraySize) {
+            avatarByteArray = _avatar.toByteArrayStateful(AvatarData::MinimumData, true);
+
+            if (avatarByteArray.size() > maximumByteArraySize) {
+                return;
+            }
+        }
+    }
+
+    _avatar.doneEncoding(true);
+
+    auto avatarPacket = NLPacket::create(PacketType::AvatarData, avatarByteArray.size() + sizeof(_avatarSequence));
+    avatarPacket->writePrimitive(_avatarSequence++);
+    avatarPacket->write(avatarByteArray);
+
+    sendPacket(*avatarPacket, avatarMixer->activeSocket, avatarMixer->connectionSecret);
+    ++_stats.sentAvatarPackets;
+}
+
+void SyntheticAgent::sendQuery() {
+    // look from the avatar's eyes, sweeping either side of the way it faces
+    float seconds = (float)(usecTimestampNow() - _stats.startTime) / USECS_PER_SECOND;
+    float lookAngle = LOOK_AROUND_ANGLE * sinf(_lookPhase + seconds * LOOK_AROUND_RATE);
+
+    _viewFrustum.setPosition(_avatar.getPosition() + glm::vec3(0.0f, EYE_HEIGHT, 0.0f));
+    _viewFrustum.setOrientation(_avatar.getOrientation() * glm::angleAxis(lookAngle, Vectors::UP));
+    _viewFrustum.calculate();
+
+    if (_settings.sendQueries) {
+        if (auto entityServer = soloActiveServer(NodeType::EntityServer)) {
+            // as Application::queryOctree fills it in from its view frustum
+            _octreeQuery.setCameraPosition(_viewFrustum.getPosition());
+            _octreeQuery.setCameraOrientation(_viewFrustum.getOrientation());
+            _octreeQuery.setCameraFov(_viewFrustum.getFieldOfView());
+            _octreeQuery.setCameraAspectRatio(_viewFrustum.getAspectRatio());
+            _octreeQuery.setCameraNearClip(_viewFrustum.getNearClip());
+            _octreeQuery.setCameraFarClip(_viewFrustum.getFarClip());
+            _octreeQuery.setCameraEyeOffsetPosition(glm::vec3());
+            _octreeQuery.setCameraCenterRadius(_viewFrustum.getCenterRadius());
+
+            auto queryPacket = NLPacket::create(PacketType::EntityQuery);
+            int packetSize = _octreeQuery.getBroadcastData(reinterpret_cast<unsigned char*>(queryPacket->getPayload()));
+            queryPacket->setPayloadSize(packetSize);
+
+            sendPacket(*queryPacket, entityServer->activeSocket, entityServer->connectionSecret);
+            ++_stats.sentQueries;
+        }
+    }
+
+    // the avatar-mixer decides which avatars to send us with the same frustum
+    if (auto avatarMixer = soloActiveServer(NodeType::AvatarMixer)) {
+        QByteArray viewFrustumByteArray = _viewFrustum.toByteArray();
+        auto viewFrustumPacket = NLPacket::create(PacketType::ViewFrustum, viewFrustumByteArray.size());
+        viewFrustumPacket->write(viewFrustumByteArray);
+
+        sendPacket(*viewFrustumPacket, avatarMixer->activeSocket, avatarMixer->connectionSecret);
+    }
+}
+
+void SyntheticAgent::processPacket(std::unique_ptr<NLPacket> packet) {
+    auto dataSize = packet->getDataSize();
+    ReceivedMessage message(std::move(packet));
+
+    if (PacketTypeEnum::getNonSourcedPackets().contains(message.getType())) {
+        // of the nodes we talk to, only the domain-server sends without a source
+        auto& serverStats = _stats.servers[NodeType::DomainServer];
+        serverStats.receivedBytes += dataSize;
+        ++serverStats.receivedPackets;
+
+        switch (message.getType()) {
+            case PacketType::DomainList:
+                processDomainList(message);
+                break;
+            case PacketType::DomainServerAddedNode: {
+                QDataStream packetStream(message.getMessage());
+                parseServer(packetStream);
+                break;
+            }
+            case PacketType::DomainServerRemovedNode:
+                _servers.remove(QUuid::fromRfc4122(message.readWithoutCopy(NUM_BYTES_RFC4122_UUID)));
+                break;
+            case PacketType::DomainConnectionDenied: {
+                quint8 reasonCode;
+                message.readPrimitive(&reasonCode);
+                quint16 reasonSize;
+                message.readPrimitive(&reasonSize);
+                qWarning() << "Agent" << _index << "was refused by the domain-server -"
+                    << QString::fromUtf8(message.readWithoutCopy(reasonSize));
+                break;
+            }
+            default:
+                break;
+        }
+        return;
+    }
+
+    auto it = _servers.find(message.getSourceID());
+    if (it == _servers.end()) {
+        return;
+    }
+
+    auto& serverStats = _stats.servers[it->type];
+    serverStats.receivedBytes += dataSize;
+    ++serverStats.receivedPackets;
+
+    switch (message.getType()) {
+        case PacketType::Ping:
+            processPing(message, *it);
+            break;
+        case PacketType::PingReply:
+            processPingReply(message, *it);
+            break;
+        case PacketType::MixedAudio:
+        case PacketType::SilentAudioFrame:
+            processAudio(message);
+            break;
+        case PacketType::AudioStreamStats:
+            processAudioStreamStats(message);
+            break;
+        case PacketType::EntityData:
+            processEntityData(message);
+            break;
+        default:
+            // bulk avatar data, identities, octree stats and the rest only count towards the received bandwidth
+            break;
+    }
+}
+
+void SyntheticAgent::processDomainList(ReceivedMessage& message) {
+    // the same layout NodeList::processDomainServerList reads
+    _numNoReplyCheckIns = 0;
+
+    QDataStream packetStream(message.getMessage());
+
+    QUuid domainUUID;
+    packetStream >> domainUUID;
+
+    if (_isConnected && domainUUID != _domainUUID) {
+        return;
+    }
+
+    packetStream >> _sessionUUID;
+
+    if (!_isConnected) {
+        _isConnected = true;
+        _domainUUID = domainUUID;
+        _avatar.setSessionUUID(_sessionUUID);
+
+        if (_stats.connectTime == 0) {
+            _stats.connectTime = usecTimestampNow();
+        }
+    }
+
+    NodePermissions permissions;
+    packetStream >> permissions;
+
+    while (!packetStream.atEnd()) {
+        parseServer(packetStream);
+    }
+}
+
+void SyntheticAgent::parseServer(QDataStream& packetStream) {
+    // the same layout NodeList::parseNodeFromPacketStream reads
+    qint8 nodeType;
+    QUuid nodeUUID, connectionSecret;
+    HifiSockAddr publicSocket, localSocket;
+    NodePermissions permissions;
+    bool isReplicated;
+
+    packetStream >> nodeType >> nodeUUID >> publicSocket >> localSocket >> permissions >> isReplicated >> connectionSecret;
+
+    // if the public socket address is 0 then it's reachable at the same IP as the domain server
+    if (publicSocket.getAddress().isNull()) {
+        publicSocket.setAddress(_settings.domainServer.getAddress());
+    }
+
+    auto it = _servers.find(nodeUUID);
+    if (it == _servers.end()) {
+        _servers.insert(nodeUUID, { (NodeType_t)nodeType, publicSocket, localSocket, HifiSockAddr(), connectionSecret });
+    } else {
+        if (it->publicSocket != publicSocket || it->localSocket != localSocket) {
+            it->publicSocket = publicSocket;
+            it->localSocket = localSocket;
+            it->activeSocket = HifiSockAddr();
+        }
+        it->connectionSecret = connectionSecret;
+    }
+}
+
+void SyntheticAgent::processPing(ReceivedMessage& message, const Server& server) {
+    // the mixers decide which of our sockets to use from these replies, so they're sent back the way the ping came
+    PingType_t typeFromOriginalPing;
+    quint64 timeFromOriginalPing;
+    message.readPrimitive(&typeFromOriginalPing);
+    message.readPrimitive(&timeFromOriginalPing);
+
+    int packetSize = sizeof(PingType_t) + sizeof(quint64) + sizeof(quint64);
+    auto replyPacket = NLPacket::create(PacketType::PingReply, packetSize);
+    replyPacket->writePrimitive(typeFromOriginalPing);
+    replyPacket->writePrimitive(timeFromOriginalPing);
+    replyPacket->writePrimitive(usecTimestampNow());
+
+    sendPacket(*replyPacket, message.getSenderSockAddr(), server.connectionSecret);
+}
+
+void SyntheticAgent::processPingReply(ReceivedMessage& message, Server& server) {
+    PingType_t pingType;
+    quint64 ourOriginalTime;
+    message.readPrimitive(&pingType);
+    message.readPrimitive(&ourOriginalTime);
+
+    _stats.servers[server.type].rtts.push_back((int)(usecTimestampNow() - ourOriginalTime));
+
+    const auto& senderSockAddr = message.getSenderSockAddr();
+    if (server.activeSocket.isNull()
+        && (senderSockAddr == server.publicSocket || senderSockAddr == server.localSocket)) {
+        server.activeSocket = senderSockAddr;
+    }
+}
+
+void SyntheticAgent::processAudio(ReceivedMessage& message) {
+    // mixed and silent frames both start with the sequence number, which is all we need from them
+    quint16 sequence;
+    message.readPrimitive(&sequence);
+
+    auto arrivalInfo = _mixedAudioSequenceStats.sequenceNumberReceived(sequence);
+    _stats.mixedAudio = _mixedAudioSequenceStats.getStats();
+
+    if (arrivalInfo._status == SequenceNumberStats::OnTime || arrivalInfo._status == SequenceNumberStats::Early) {
+        auto now = usecTimestampNow();
+
+        if (_lastAudioArrival > 0) {
+            // interarrival jitter (RFC 3550), against the frame time the sequence numbers say has passed
+            qint64 expectedGap = (qint64)(quint16)(sequence - _lastAudioSequence) * AudioConstants::NETWORK_FRAME_USECS;
+            qint64 difference = (qint64)(now - _lastAudioArrival) - expectedGap;
+            _stats.audioJitter += (std::abs((float)difference) - _stats.audioJitter) / 16.0f;
+        }
+
+        _lastAudioArrival = now;
+        _lastAudioSequence = sequence;
+    }
+}
+
+void SyntheticAgent::processAudioStreamStats(ReceivedMessage& message) {
+    // the audio-mixer's view of our streams, the microphone stream is the one without an identifier
+    quint8 appendFlag;
+    quint16 numStreamStats;
+    message.readPrimitive(&appendFlag);
+    message.readPrimitive(&numStreamStats);
+
+    for (int i = 0; i < numStreamStats; ++i) {
+        AudioStreamStats streamStats;
+        message.readPrimitive(&streamStats);
+
+        if (streamStats._streamIdentifier.isNull()) {
+            _stats.upstreamAudio = streamStats._packetStreamStats;
+        }
+    }
+}
+
+void SyntheticAgent::processEntityData(ReceivedMessage& message) {
+    OCTREE_PACKET_FLAGS flags;
+    OCTREE_PACKET_SEQUENCE sequence;
+    OCTREE_PACKET_SENT_TIME sentAt;
+    message.readPrimitive(&flags);
+    message.readPrimitive(&sequence);
+    message.readPrimitive(&sentAt);
+
+    _entitySequenceStats.sequenceNumberReceived(sequence);
+    _stats.entityData = _entitySequenceStats.getStats();
+
+    // every server is on this machine, so there's no clock skew to correct for
+    int latency = (int)(usecTimestampNow() - sentAt);
+
+    // keep a uniform sample of a long run rather than every packet
+    ++_numEntityLatencies;
+    if (_stats.entityLatencies.size() < MAX_LATENCY_SAMPLES) {
+        _stats.entityLatencies.push_back(latency);
+    } else {
+        qint64 slot = (qint64)(randFloat() * _numEntityLatencies);
+        if (slot < (qint64)MAX_LATENCY_SAMPLES) {
+            _stats.entityLatencies[slot] = latency;
+        }
+    }
+}
+
+void SyntheticAgent::sendDomainServerCheckIn() {
+    // the same layout NodeList::sendDomainServerCheckIn writes, for an anonymous agent
+    PacketType packetType = _isConnected ? PacketType::DomainListRequest : PacketType::DomainConnectRequest;
+    auto domainPacket = NLPacket::create(packetType);
+
+    QDataStream packetStream(domainPacket.get());
+
+    if (packetType == PacketType::DomainConnectRequest) {
+        // not an assignment, and not reached through ICE
+        packetStream << QUuid();
+
+        QByteArray protocolVersionSig = protocolVersionsSignature();
+        packetStream.writeBytes(protocolVersionSig.constData(), protocolVersionSig.size());
+
+        packetStream << QString(); // hardware address
+        packetStream << _machineFingerprint;
+    }
+
+    NodeSet nodeTypesOfInterest;
+    if (_settings.sendAudio) {
+        nodeTypesOfInterest << NodeType::AudioMixer;
+    }
+    if (_settings.sendAvatar) {
+        nodeTypesOfInterest << NodeType::AvatarMixer;
+    }
+    if (_settings.sendQueries) {
+        nodeTypesOfInterest << NodeType::EntityServer;
+    }
+
+    packetStream << NodeType::Agent << _localSockAddr << _localSockAddr << nodeTypesOfInterest.toList();
+    packetStream << QString(); // place name
+
+    if (packetType == PacketType::DomainConnectRequest) {
+        packetStream << QString(); // username
+    }
+
+    sendPacket(*domainPacket, _settings.domainServer);
+    ++_numNoReplyCheckIns;
+}
+
+void SyntheticAgent::sendPing(const Server& server, const HifiSockAddr& sockAddr, PingType_t pingType) {
+    int packetSize = sizeof(PingType_t) + sizeof(quint64);
+    auto pingPacket = NLPacket::create(PacketType::Ping, packetSize);
+    pingPacket->writePrimitive(pingType);
+    pingPacket->writePrimitive(usecTimestampNow());
+
+    sendPacket(*pingPacket, sockAddr, server.connectionSecret);
+}
+
+void SyntheticAgent::sendPacket(NLPacket& packet, const HifiSockAddr& sockAddr, const QUuid& connectionSecret) {
+    // what LimitedNodeList::fillPacketHeader does
+    if (!PacketTypeEnum::getNonSourcedPackets().contains(packet.getType())) {
+        packet.writeSourceID(_sessionUUID);
+
+        if (!connectionSecret.isNull() && !PacketTypeEnum::getNonVerifiedPackets().contains(packet.getType())) {
+            packet.writeVerificationHashGivenSecret(connectionSecret);
+        }
+    }
+
+    auto bytesWritten = _socket.writePacket(packet, sockAddr);
+    if (bytesWritten > 0) {
+        _stats.sentBytes += bytesWritten;
+    }
+}
+
+const SyntheticAgent::Server* SyntheticAgent::soloActiveServer(NodeType_t type) const {
+    for (const auto& server : _servers) {
+        if (server.type == type && !server.activeSocket.isNull()) {
+            return &server;
+        }
+    }
+    return nullptr;
+}
+
+void SyntheticAgent::disconnectFromDomain() {
+    _isConnected = false;
+    _numNoReplyCheckIns = 0;
+    _servers.clear();
+}
+
+void SyntheticAgent::updateMotion() {
+    auto now = usecTimestampNow();
+
+    if (!_settings.avatarFrames.empty()) {
+        const auto& frames = _settings.avatarFrames;
+        quint64 duration = std::max<quint64>(_settings.avatarFramesDuration, 1) * USECS_PER_MSEC;
+
+        if (now - _playbackStartTime >= duration) {
+            // loop, starting over from the first frame
+            _playbackStartTime += ((now - _playbackStartTime) / duration) * duration;
+            _avatarFrameIndex = 0;
+        }
+
+        auto frameTime = (recording::Frame::Time)((now - _playbackStartTime) / USECS_PER_MSEC);
+        while (_avatarFrameIndex + 1 < frames.size() && frames[_avatarFrameIndex + 1]->timeOffset <= frameTime) {
+            ++_avatarFrameIndex;
+        }
+
+        const auto& frame = frames[_avatarFrameIndex];
+        if (frame.get() != _appliedFrame) {
+            // recordings hold world positions, move this agent's copy to its own spot
+            AvatarData::fromFrame(frame->data, _avatar, false);
+            _avatar.setPosition(_avatar.getPosition() + _origin);
+            _appliedFrame = frame.get();
+        }
+        return;
+    }
+
+    // walk a circle around the origin, facing the way we're going
+    glm::vec3 position = _origin;
+    float heading = _walkPhase;
+
+    if (_settings.walkRadius > 0.0f) {
+        float seconds = (float)(now - _stats.startTime) / USECS_PER_SECOND;
+        heading += seconds * _settings.walkSpeed / _settings.walkRadius;
+        position += _settings.walkRadius * glm::vec3(cosf(heading), 0.0f, sinf(heading));
+    }
+
+    // avatars face -z, so a yaw of PI - heading points them along the circle
+    _avatar.setPosition(position);
+    _avatar.setOrientation(glm::angleAxis(PI - heading, Vectors::UP));
+}
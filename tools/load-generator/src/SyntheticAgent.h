@@ -0,0 +1,171 @@
+//
+//  SyntheticAgent.h
+//  tools/load-generator/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_SyntheticAgent_h
+#define hifi_SyntheticAgent_h
+
+#include <map>
+#include <vector>
+
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QUuid>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <AvatarData.h>
+#include <HifiSockAddr.h>
+#include <LimitedNodeList.h>
+#include <NLPacket.h>
+#include <NodeType.h>
+#include <OctreeQuery.h>
+#include <ReceivedMessage.h>
+#include <SequenceNumberStats.h>
+#include <ViewFrustum.h>
+#include <recording/Forward.h>
+#include <udt/NetworkImpairment.h>
+#include <udt/Socket.h>
+
+// what every agent in a run shares, set up once by the LoadGeneratorApp
+struct AgentSettings {
+    HifiSockAddr domainServer;
+    QHostAddress localAddress; // the address agents give the domain-server for themselves
+
+    bool sendAudio { true };
+    bool sendAvatar { true };
+    bool sendQueries { true };
+
+    QByteArray audio; // mono 24kHz 16 bit PCM, looped by every agent from its own offset
+
+    // avatar frames of a recording, in order, played back instead of the walk when there are any
+    std::vector<recording::FrameConstPointer> avatarFrames;
+    quint32 avatarFramesDuration { 0 }; // milliseconds
+
+    float walkRadius { 2.0f }; // meters
+    float walkSpeed { 1.0f }; // meters per second
+
+    int maxQueryPacketsPerSecond { 0 }; // 0 leaves the entity-server default
+
+    udt::ImpairmentProfile impairment;
+};
+
+// One lightweight client of a local domain. It speaks the domain protocol on its own udt::Socket (NodeList is one
+// per process), sends microphone audio, avatar data and entity queries to the servers the domain tells it about,
+// and keeps what it needs to report latency, loss and received bandwidth. All agents live on the main thread and
+// are driven by the LoadGeneratorApp's timers.
+class SyntheticAgent : public QObject {
+    Q_OBJECT
+public:
+    struct ServerStats {
+        std::vector<int> rtts; // microseconds, one sample per ping reply
+        qint64 receivedBytes { 0 };
+        qint64 receivedPackets { 0 };
+    };
+
+    struct Stats {
+        quint64 startTime { 0 }; // usecs since epoch
+        quint64 connectTime { 0 }; // when the first domain list arrived, 0 if it hasn't
+
+        std::map<NodeType_t, ServerStats> servers;
+
+        qint64 sentAudioFrames { 0 };
+        qint64 sentAvatarPackets { 0 };
+        qint64 sentQueries { 0 };
+        qint64 sentBytes { 0 };
+
+        PacketStreamStats mixedAudio; // downstream, from the sequence numbers of mixed and silent frames
+        PacketStreamStats upstreamAudio; // our microphone stream as the audio-mixer last reported it
+        float audioJitter { 0.0f }; // interarrival jitter of downstream frames (RFC 3550), microseconds
+
+        PacketStreamStats entityData;
+        std::vector<int> entityLatencies; // one way, microseconds, from the octree packet sent time
+    };
+
+    SyntheticAgent(int index, const AgentSettings& settings, QObject* parent = nullptr);
+
+    int getIndex() const { return _index; }
+    bool isConnected() const { return _isConnected; }
+    const Stats& getStats() const { return _stats; }
+
+    // called by the LoadGeneratorApp on its shared timers
+    void checkIn(); // domain-server check in and server pings, about once a second
+    void sendAudioFrame();
+    void sendAvatarData();
+    void sendQuery();
+
+private:
+    struct Server {
+        NodeType_t type;
+        HifiSockAddr publicSocket;
+        HifiSockAddr localSocket;
+        HifiSockAddr activeSocket; // null until one of the others answers a ping
+        QUuid connectionSecret;
+    };
+
+    void processPacket(std::unique_ptr<NLPacket> packet);
+    void processDomainList(ReceivedMessage& message);
+    void parseServer(QDataStream& stream);
+    void processPing(ReceivedMessage& message, const Server& server);
+    void processPingReply(ReceivedMessage& message, Server& server);
+    void processAudio(ReceivedMessage& message);
+    void processAudioStreamStats(ReceivedMessage& message);
+    void processEntityData(ReceivedMessage& message);
+
+    void sendDomainServerCheckIn();
+    void sendPing(const Server& server, const HifiSockAddr& sockAddr, PingType_t pingType);
+    // fills in the source and verification hash the way a NodeList does, then sends
+    void sendPacket(NLPacket& packet, const HifiSockAddr& sockAddr, const QUuid& connectionSecret = QUuid());
+    const Server* soloActiveServer(NodeType_t type) const;
+    void disconnectFromDomain();
+
+    void updateMotion(); // moves the avatar and the camera that follows it
+
+    const int _index;
+    const AgentSettings& _settings;
+
+    udt::Socket _socket;
+    HifiSockAddr _localSockAddr;
+
+    QUuid _sessionUUID;
+    QUuid _domainUUID;
+    QUuid _machineFingerprint { QUuid::createUuid() }; // so the domain-server sees each agent as its own machine
+    bool _isConnected { false };
+    int _numNoReplyCheckIns { 0 };
+
+    QHash<QUuid, Server> _servers;
+
+    quint16 _audioSequence { 0 };
+    int _audioOffset { 0 }; // in samples
+
+    AvatarData _avatar;
+    AvatarDataSequenceNumber _avatarSequence { 0 };
+    glm::vec3 _origin; // where this agent walks around, or where its recording is moved to
+    float _walkPhase; // radians, where on its circle the walk starts
+    float _lookPhase; // radians, so agents don't all look around in step
+    size_t _avatarFrameIndex { 0 };
+    const recording::Frame* _appliedFrame { nullptr };
+    quint64 _playbackStartTime { 0 }; // usecs since epoch, moves forward a clip length each time the recording loops
+
+    ViewFrustum _viewFrustum;
+    OctreeQuery _octreeQuery;
+
+    SequenceNumberStats _mixedAudioSequenceStats;
+    SequenceNumberStats _entitySequenceStats;
+    quint64 _lastAudioArrival { 0 };
+    quint16 _lastAudioSequence { 0 };
+    qint64 _numEntityLatencies { 0 }; // seen, of which at most MAX_LATENCY_SAMPLES are kept
+
+    Stats _stats;
+};
+
+#endif // hifi_SyntheticAgent_h
@@ -12,17 +12,23 @@
 #include <QObject>
 #include <QImageReader>
 #include <QtCore/QDebug>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTextStream>
 
 #include "ModelBakingLoggingCategory.h"
 #include "Oven.h"
 #include "BakerCLI.h"
+#include "DomainBaker.h"
 #include "FBXBaker.h"
 #include "TextureBaker.h"
 
 BakerCLI::BakerCLI(Oven* parent) : QObject(parent) {
 }
 
-void BakerCLI::bakeFile(QUrl inputUrl, const QString outputPath) {
+void BakerCLI::bakeFile(QUrl inputUrl, const QString outputPath, const QUrl& destinationPath) {
 
     // if the URL doesn't have a scheme, assume it is a local file
     if (inputUrl.scheme() != "http" && inputUrl.scheme() != "https" && inputUrl.scheme() != "ftp") {
@@ -30,17 +36,31 @@ void BakerCLI::bakeFile(QUrl inputUrl, const QString outputPath) {
     }
 
     static const QString MODEL_EXTENSION { ".fbx" };
+    static const QString DOMAIN_EXTENSION { ".json" };
+    static const QString COMPRESSED_DOMAIN_EXTENSION { ".json.gz" };
 
     // check what kind of baker we should be creating
     bool isFBX = inputUrl.toDisplayString().endsWith(MODEL_EXTENSION, Qt::CaseInsensitive);
+    bool isDomain = inputUrl.toDisplayString().endsWith(DOMAIN_EXTENSION, Qt::CaseInsensitive)
+        || inputUrl.toDisplayString().endsWith(COMPRESSED_DOMAIN_EXTENSION, Qt::CaseInsensitive);
     bool isSupportedImage = false;
 
     for (QByteArray format : QImageReader::supportedImageFormats()) {
         isSupportedImage |= inputUrl.toDisplayString().endsWith(format, Qt::CaseInsensitive);
     }
 
+    _inputUrl = inputUrl;
+    _outputPath = outputPath;
+    _bakeTimer.start();
+
     // create our appropiate baker
-    if (isFBX) {
+    if (isDomain) {
+        // the domain name is only used to name the output folder, so use the name of the entities file
+        QString domainName = QFileInfo(inputUrl.path()).baseName();
+        QUrl destination = destinationPath.isEmpty() ? QUrl::fromLocalFile(outputPath) : destinationPath;
+        _baker = std::unique_ptr<Baker> { new DomainBaker(inputUrl, domainName, outputPath, destination) };
+        _baker->moveToThread(qApp->getNextWorkerThread());
+    } else if (isFBX) {
         _baker = std::unique_ptr<Baker> { new FBXBaker(inputUrl, []() -> QThread* { return qApp->getNextWorkerThread(); }, outputPath) };
         _baker->moveToThread(qApp->getNextWorkerThread());
     } else if (isSupportedImage) {
@@ -60,5 +80,27 @@ void BakerCLI::bakeFile(QUrl inputUrl, const QString outputPath) {
 
 void BakerCLI::handleFinishedBaker() {
     qCDebug(model_baking) << "Finished baking file.";
+
+    // a machine readable summary of the bake on stdout, so build scripts can track bake times and cache hit rates
+    QJsonObject report;
+    report["input"] = _inputUrl.toString();
+    report["output"] = _outputPath;
+    report["succeeded"] = !_baker->hasErrors();
+    report["msecs"] = _bakeTimer.elapsed();
+    report["errors"] = QJsonArray::fromStringList(_baker->getErrors());
+    report["warnings"] = QJsonArray::fromStringList(_baker->getWarnings());
+
+    QJsonArray outputFiles;
+    for (auto& file : _baker->getOutputFiles()) {
+        outputFiles.append(file);
+    }
+    report["outputFiles"] = outputFiles;
+
+    if (auto domainBaker = qobject_cast<DomainBaker*>(_baker.get())) {
+        report["domain"] = domainBaker->getTimingReport();
+    }
+
+    QTextStream(stdout) << QJsonDocument(report).toJson(QJsonDocument::Compact) << endl;
+
     QApplication::exit(_baker.get()->hasErrors());
 }
@@ -12,6 +12,7 @@
 #ifndef hifi_BakerCLI_h
 #define hifi_BakerCLI_h
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QObject>
 
 #include "Baker.h"
@@ -22,13 +23,16 @@ class BakerCLI : public QObject {
 
 public:
     BakerCLI(Oven* parent);
-    void bakeFile(QUrl inputUrl, const QString outputPath);
+    void bakeFile(QUrl inputUrl, const QString outputPath, const QUrl& destinationPath = QUrl());
 
 private slots:
     void handleFinishedBaker();  
 
 private:
     std::unique_ptr<Baker> _baker;
+    QUrl _inputUrl;
+    QString _outputPath;
+    QElapsedTimer _bakeTimer;
 };
 
 #endif // hifi_BakerCLI_h
\ No newline at end of file
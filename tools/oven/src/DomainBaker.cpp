@@ -22,12 +22,15 @@
 
 #include "DomainBaker.h"
 
+static const QString BAKE_CACHE_FOLDER_NAME = "bake-cache";
+
 DomainBaker::DomainBaker(const QUrl& localModelFileURL, const QString& domainName,
                          const QString& baseOutputPath, const QUrl& destinationPath,
                          bool shouldRebakeOriginals) :
     _localEntitiesFileURL(localModelFileURL),
     _domainName(domainName),
     _baseOutputPath(baseOutputPath),
+    _bakeCache(new BakeCache(QDir(baseOutputPath).absoluteFilePath(BAKE_CACHE_FOLDER_NAME))),
     _shouldRebakeOriginals(shouldRebakeOriginals)
 {
     // make sure the destination path has a trailing slash
@@ -39,6 +42,8 @@ DomainBaker::DomainBaker(const QUrl& localModelFileURL, const QString& domainNam
 }
 
 void DomainBaker::bake() {
+    _bakeTimer.start();
+
     setupOutputFolder();
 
     if (hasErrors()) {
@@ -206,6 +211,8 @@ void DomainBaker::enumerateEntities() {
                             &FBXBaker::deleteLater
                         };
 
+                        baker->setBakeCache(_bakeCache);
+
                         // make sure our handler is called when the baker is done
                         connect(baker.data(), &Baker::finished, this, &DomainBaker::handleFinishedModelBaker);
 
@@ -214,6 +221,7 @@ void DomainBaker::enumerateEntities() {
 
                         // move the baker to the baker thread
                         // and kickoff the bake
+                        _modelBakeStartMsecs[modelURL] = _bakeTimer.elapsed();
                         baker->moveToThread(qApp->getNextWorkerThread());
                         QMetaObject::invokeMethod(baker.data(), "bake");
 
@@ -302,6 +310,13 @@ void DomainBaker::handleFinishedModelBaker() {
     auto baker = qobject_cast<FBXBaker*>(sender());
 
     if (baker) {
+        QJsonObject modelTiming;
+        modelTiming["url"] = baker->getFBXUrl().toString();
+        modelTiming["msecs"] = _bakeTimer.elapsed() - _modelBakeStartMsecs.take(baker->getFBXUrl());
+        modelTiming["cached"] = baker->wasRestoredFromCache();
+        modelTiming["succeeded"] = !baker->hasErrors();
+        _modelTimings.append(modelTiming);
+
         if (!baker->hasErrors()) {
             // this FBXBaker is done and everything went according to plan
             qDebug() << "Re-writing entity references to" << baker->getFBXUrl();
@@ -470,6 +485,8 @@ void DomainBaker::checkIfRewritingComplete() {
             return;
         }
 
+        _totalBakeMsecs = _bakeTimer.elapsed();
+
         // we've now written out our new models file - time to say that we are finished up
         emit finished();
     }
@@ -512,3 +529,14 @@ void DomainBaker::writeNewEntitiesFile() {
     qDebug() << "Exported entities file with baked model URLs to" << bakedEntitiesFilePath;
 }
 
+QJsonObject DomainBaker::getTimingReport() const {
+    QJsonObject cache;
+    cache["hits"] = _bakeCache->getHits();
+    cache["misses"] = _bakeCache->getMisses();
+
+    QJsonObject report;
+    report["msecs"] = _totalBakeMsecs;
+    report["models"] = _modelTimings;
+    report["cache"] = cache;
+    return report;
+}
@@ -12,11 +12,14 @@
 #ifndef hifi_DomainBaker_h
 #define hifi_DomainBaker_h
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
 #include <QtCore/QObject>
 #include <QtCore/QUrl>
 #include <QtCore/QThread>
 
+#include "BakeCache.h"
 #include "Baker.h"
 #include "FBXBaker.h"
 #include "TextureBaker.h"
@@ -31,6 +34,9 @@ public:
                 const QString& baseOutputPath, const QUrl& destinationPath,
                 bool shouldRebakeOriginals = false);
 
+    // How long the bake and each model in it took, and which models were restored from the bake cache.
+    QJsonObject getTimingReport() const;
+
 signals:
     void allModelsFinished();
     void bakeProgress(int baked, int total);
@@ -61,11 +67,19 @@ private:
 
     QJsonArray _entities;
 
+    // shared by every bake into the same base output folder, so re-baking a domain only bakes what changed
+    QSharedPointer<BakeCache> _bakeCache;
+
     QHash<QUrl, QSharedPointer<FBXBaker>> _modelBakers;
     QHash<QUrl, QSharedPointer<TextureBaker>> _skyboxBakers;
     
     QMultiHash<QUrl, QJsonValueRef> _entitiesNeedingRewrite;
 
+    QElapsedTimer _bakeTimer;
+    qint64 _totalBakeMsecs { 0 };
+    QHash<QUrl, qint64> _modelBakeStartMsecs;
+    QJsonArray _modelTimings;
+
     int _totalNumberOfSubBakes { 0 };
     int _completedSubBakes { 0 };
 
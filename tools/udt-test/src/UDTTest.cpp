@@ -11,7 +11,12 @@
 
 #include "UDTTest.h"
 
+#include <algorithm>
+
 #include <QtCore/QDebug>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTimer>
 
 #include <udt/Constants.h>
 #include <udt/Packet.h>
@@ -55,6 +60,12 @@ const QCommandLineOption MESSAGE_SEED {
 const QCommandLineOption STATS_INTERVAL {
     "stats-interval", "stats output interval (default is 100ms)", "milliseconds"
 };
+const QCommandLineOption CONGESTION_CONTROL {
+    "congestion-control", "congestion control for connections: default, vegas or bbr (default is vegas)", "name"
+};
+const QCommandLineOption FLOWS {
+    "flows", "number of concurrent connections to the target, each from its own socket (default is 1)", "count"
+};
 
 const QStringList CLIENT_STATS_TABLE_HEADERS {
     "Send (Mb/s)", "Est. Max (Mb/s)", "RTT (ms)", "CW (P)", "Period (us)",
@@ -78,8 +89,23 @@ UDTTest::UDTTest(int& argc, char** argv) :
     // randomize the seed for packet size randomization
     srand(time(NULL));
 
+    if (_argumentParser.isSet(CONGESTION_CONTROL)) {
+        _congestionControl = _argumentParser.value(CONGESTION_CONTROL);
+
+        if (!udt::CongestionControlVirtualFactory::forName(_congestionControl)) {
+            qCritical() << "Unknown congestion control" << _congestionControl;
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        }
+    }
+
+    // the report of goodput, RTT and retransmissions is written on exit
+    if (!_testRun.start(_argumentParser, [this] { return buildReport(); })) {
+        QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+    }
+
     _socket.bind(QHostAddress::AnyIPv4, _argumentParser.value(PORT_OPTION).toUInt());
     qDebug() << "Test socket is listening on" << _socket.localPort();
+    setupSocket(_socket);
     
     if (_argumentParser.isSet(TARGET_OPTION)) {
         // parse the IP and port combination for this target
@@ -98,6 +124,25 @@ UDTTest::UDTTest(int& argc, char** argv) :
             qDebug() << "Packets will be sent to" << _target;
         }
     }
+
+    if (_argumentParser.isSet(FLOWS) && !_target.isNull()) {
+        int numFlows = _argumentParser.value(FLOWS).toInt();
+
+        if (numFlows > 1 && _argumentParser.isSet(ORDERED_PACKETS)) {
+            qCritical() << "Multiple flows can't be used with ordered packets.";
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        } else {
+            // _socket is the first flow
+            for (int i = 1; i < numFlows; ++i) {
+                auto flow = std::unique_ptr<Flow>(new Flow(*this));
+                flow->socket.bind(QHostAddress::AnyIPv4);
+                setupSocket(flow->socket);
+                _flows.push_back(std::move(flow));
+            }
+
+            qDebug() << "Sending to the target over" << numFlows << "connections";
+        }
+    }
     
     if (_argumentParser.isSet(PACKET_SIZE)) {
         // parse the desired packet size
@@ -218,6 +263,21 @@ UDTTest::UDTTest(int& argc, char** argv) :
     statsTimer->start(_statsInterval);
 }
 
+void Flow::refillPacket() {
+    _test.sendPacket(socket);
+}
+
+void UDTTest::setupSocket(udt::Socket& socket) {
+    auto ccFactory = udt::CongestionControlVirtualFactory::forName(_congestionControl);
+    if (ccFactory) {
+        socket.setCongestionControlFactory(std::move(ccFactory));
+    }
+
+    if (_testRun.getImpairmentProfile().isValid()) {
+        socket.setImpairmentProfile(_testRun.getImpairmentProfile());
+    }
+}
+
 void UDTTest::parseArguments() {
     // use a QCommandLineParser to setup command line arguments and give helpful output
     _argumentParser.setApplicationDescription("High Fidelity UDT Protocol Test Client");
@@ -228,8 +288,9 @@ void UDTTest::parseArguments() {
     _argumentParser.addOptions({
         PORT_OPTION, TARGET_OPTION, PACKET_SIZE, MIN_PACKET_SIZE, MAX_PACKET_SIZE,
         MAX_SEND_BYTES, MAX_SEND_PACKETS, UNRELIABLE_PACKETS, ORDERED_PACKETS,
-        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL
+        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL, CONGESTION_CONTROL, FLOWS
     });
+    udt::NetworkTestRun::addOptions(_argumentParser);
     
     if (!_argumentParser.parse(arguments())) {
         qCritical() << _argumentParser.errorText();
@@ -245,7 +306,26 @@ void UDTTest::parseArguments() {
 
 void UDTTest::sendInitialPackets() {
     static const int NUM_INITIAL_PACKETS = 500;
+    static const int MIN_INITIAL_PACKETS_PER_FLOW = 32;
     
+    if (!_flows.empty()) {
+        // split the initial queue between the flows, so hundreds of them don't queue up hundreds of megabytes
+        int packetsPerFlow = std::max(MIN_INITIAL_PACKETS_PER_FLOW, NUM_INITIAL_PACKETS / (int)(_flows.size() + 1));
+
+        for (int i = 0; i < packetsPerFlow; ++i) {
+            sendPacket(_socket);
+            for (auto& flow : _flows) {
+                sendPacket(flow->socket);
+            }
+        }
+
+        _socket.connectToSendSignal(_target, this, SLOT(refillPacket()));
+        for (auto& flow : _flows) {
+            flow->socket.connectToSendSignal(_target, flow.get(), SLOT(refillPacket()));
+        }
+        return;
+    }
+
     int numPackets = std::max(NUM_INITIAL_PACKETS, _maxSendPackets);
     
     for (int i = 0; i < numPackets; ++i) {
@@ -258,7 +338,7 @@ void UDTTest::sendInitialPackets() {
     }
 }
 
-void UDTTest::sendPacket() {
+void UDTTest::sendPacket(udt::Socket& socket) {
     
     if (_maxSendPackets != -1 && _totalQueuedPackets > _maxSendPackets) {
         // don't send more packets, we've hit max
@@ -314,7 +394,7 @@ void UDTTest::sendPacket() {
             _totalQueuedBytes += (int)packetList->getDataSize();
             _totalQueuedPackets += (int)packetList->getNumPackets();
             
-            _socket.writePacketList(std::move(packetList), _target);
+            socket.writePacketList(std::move(packetList), _target);
         }
         
     } else {
@@ -325,9 +405,9 @@ void UDTTest::sendPacket() {
         
         // queue or send this packet by calling write packet on the socket for our target
         if (_sendReliable) {
-            _socket.writePacket(std::move(newPacket), _target);
+            socket.writePacket(std::move(newPacket), _target);
         } else {
-            _socket.writePacket(*newPacket, _target);
+            socket.writePacket(*newPacket, _target);
         }
         
         ++_totalQueuedPackets;
@@ -378,6 +458,13 @@ void UDTTest::sampleStats() {
         
         udt::ConnectionStats::Stats stats = _socket.sampleStatsForConnection(_target);
         
+        if (_testRun.isReporting()) {
+            recordStats(QString::number(_socket.localPort()), stats);
+            for (auto& flow : _flows) {
+                recordStats(QString::number(flow->socket.localPort()), flow->socket.sampleStatsForConnection(_target));
+            }
+        }
+        
         int headerIndex = -1;
         
         // setup a list of left justified values
@@ -410,6 +497,13 @@ void UDTTest::sampleStats() {
         if (sockets.size() > 0) {
             udt::ConnectionStats::Stats stats = _socket.sampleStatsForConnection(sockets.front());
             
+            if (_testRun.isReporting()) {
+                recordStats(sockets.front().toString(), stats);
+                for (size_t i = 1; i < sockets.size(); ++i) {
+                    recordStats(sockets[i].toString(), _socket.sampleStatsForConnection(sockets[i]));
+                }
+            }
+            
             int headerIndex = -1;
             
             double megabitsPerSecond = (stats.receivedBytes * MEGABITS_PER_BYTE * MS_PER_SECOND) / _statsInterval;
@@ -434,3 +528,110 @@ void UDTTest::sampleStats() {
         }
     }
 }
+
+void UDTTest::recordStats(const QString& flowName, const udt::ConnectionStats::Stats& stats) {
+    auto& record = _flowRecords[flowName];
+
+    record.sentPackets += stats.sentPackets;
+    record.sentUtilBytes += stats.sentUtilBytes;
+    record.retransmissions += stats.events[udt::ConnectionStats::Stats::Retransmission];
+    record.receivedPackets += stats.receivedPackets;
+    record.receivedUtilBytes += stats.receivedUtilBytes;
+    record.duplicates += stats.events[udt::ConnectionStats::Stats::Duplicate];
+
+    if (stats.rtt > 0) {
+        record.rtts.push_back(stats.rtt);
+    }
+}
+
+QJsonObject UDTTest::buildReport() {
+    static const double MEGABITS_PER_BYTE = 8.0 / 1000000.0;
+    static const double MSECS_PER_USEC = 1.0 / 1000.0;
+
+    bool isSender = !_target.isNull();
+    double seconds = _testRun.getElapsedSeconds();
+
+    // a sender counts the payload of packets sent for the first time, a receiver the payload of packets that weren't duplicates
+    auto goodput = [&](const FlowRecord& record) {
+        return (isSender ? record.sentUtilBytes : record.receivedUtilBytes) * MEGABITS_PER_BYTE / seconds;
+    };
+    auto retransmitRatio = [](const FlowRecord& record) {
+        return record.sentPackets > 0 ? (double)record.retransmissions / record.sentPackets : 0.0;
+    };
+
+    FlowRecord total;
+    QJsonArray flows;
+
+    for (auto it = _flowRecords.begin(); it != _flowRecords.end(); ++it) {
+        const auto& record = it.value();
+
+        total.sentPackets += record.sentPackets;
+        total.sentUtilBytes += record.sentUtilBytes;
+        total.retransmissions += record.retransmissions;
+        total.receivedPackets += record.receivedPackets;
+        total.receivedUtilBytes += record.receivedUtilBytes;
+        total.duplicates += record.duplicates;
+        total.rtts.insert(total.rtts.end(), record.rtts.begin(), record.rtts.end());
+
+        flows.append(QJsonObject {
+            { "flow", it.key() },
+            { "goodputMbps", goodput(record) },
+            { "rttMs", udt::NetworkTestRun::summarize(record.rtts, MSECS_PER_USEC) },
+            { "retransmitRatio", retransmitRatio(record) },
+            { "sentPackets", record.sentPackets },
+            { "retransmissions", record.retransmissions },
+            { "receivedPackets", record.receivedPackets },
+            { "duplicates", record.duplicates }
+        });
+    }
+
+    auto impairmentStats = [&](udt::NetworkImpairment::Direction direction) {
+        std::vector<udt::Socket*> sockets { &_socket };
+        for (auto& flow : _flows) {
+            sockets.push_back(&flow->socket);
+        }
+
+        udt::NetworkImpairment::Stats sum;
+        for (auto socket : sockets) {
+            auto stats = socket->getImpairmentStats(direction);
+            sum.datagrams += stats.datagrams;
+            sum.lost += stats.lost;
+            sum.overflowed += stats.overflowed;
+            sum.duplicated += stats.duplicated;
+            sum.reordered += stats.reordered;
+        }
+
+        return QJsonObject {
+            { "datagrams", sum.datagrams },
+            { "lost", sum.lost },
+            { "overflowed", sum.overflowed },
+            { "duplicated", sum.duplicated },
+            { "reordered", sum.reordered }
+        };
+    };
+
+    QJsonObject report {
+        { "role", isSender ? "sender" : "receiver" },
+        { "congestionControl", _congestionControl },
+        { "seconds", seconds },
+        { "flows", flows.size() },
+        { "goodputMbps", goodput(total) },
+        { "rttMs", udt::NetworkTestRun::summarize(total.rtts, MSECS_PER_USEC) },
+        { "retransmitRatio", retransmitRatio(total) },
+        { "sentPackets", total.sentPackets },
+        { "retransmissions", total.retransmissions },
+        { "receivedPackets", total.receivedPackets },
+        { "duplicates", total.duplicates },
+        { "perFlow", flows }
+    };
+
+    if (_testRun.getImpairmentProfile().isValid()) {
+        report["impairment"] = QJsonObject {
+            { "profile", _testRun.getImpairmentProfile().name },
+            { "send", impairmentStats(udt::NetworkImpairment::Send) },
+            { "receive", impairmentStats(udt::NetworkImpairment::Receive) }
+        };
+    }
+
+    return report;
+}
@@ -19,8 +19,10 @@
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QCommandLineParser>
+#include <QtCore/QMap>
 
 #include <udt/Constants.h>
+#include <udt/NetworkTestRun.h>
 #include <udt/Socket.h>
 
 #include <ReceivedMessage.h>
@@ -30,8 +32,26 @@ struct Message {
     QByteArray data;
 };
 
+class UDTTest;
+
+// an extra sender with its own socket, and so its own connection to the target
+class Flow : public QObject {
+    Q_OBJECT
+public:
+    Flow(UDTTest& test) : _test(test) {}
+
+    udt::Socket socket;
+
+public slots:
+    void refillPacket();
+
+private:
+    UDTTest& _test;
+};
+
 class UDTTest : public QCoreApplication {
     Q_OBJECT
+    friend class Flow;
 public:
     UDTTest(int& argc, char** argv);
 
@@ -40,11 +60,26 @@ public slots:
     void sampleStats();
     
 private:
+    // totals for one connection over the run, for the report
+    struct FlowRecord {
+        qint64 sentPackets { 0 };
+        qint64 sentUtilBytes { 0 };
+        qint64 retransmissions { 0 };
+        qint64 receivedPackets { 0 };
+        qint64 receivedUtilBytes { 0 };
+        qint64 duplicates { 0 };
+        std::vector<int> rtts; // one sample per stats interval, microseconds
+    };
+
     void parseArguments();
+    QJsonObject buildReport();
     void handleMessage(std::unique_ptr<Message> message);
     
+    void setupSocket(udt::Socket& socket); // applies the congestion control and impairment options
     void sendInitialPackets(); // fills the queue with packets to start
-    void sendPacket(); // constructs and sends a packet according to the test parameters
+    void sendPacket() { sendPacket(_socket); }
+    void sendPacket(udt::Socket& socket); // constructs and sends a packet according to the test parameters
+    void recordStats(const QString& flowName, const udt::ConnectionStats::Stats& stats);
     
     QCommandLineParser _argumentParser;
     udt::Socket _socket;
@@ -71,6 +106,11 @@ private:
     int _totalQueuedBytes { 0 }; // keeps track of the number of bytes we have already queued
     
     int _statsInterval { 100 }; // recording interval for stats in milliseconds
+
+    std::vector<std::unique_ptr<Flow>> _flows; // senders beyond _socket
+    QString _congestionControl { "vegas" };
+    udt::NetworkTestRun _testRun; // impairment profile, duration and report options
+    QMap<QString, FlowRecord> _flowRecords;
 };
 
 #endif // hifi_UDTTest_h